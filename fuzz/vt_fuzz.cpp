@@ -0,0 +1,319 @@
+/**
+ * libFuzzer Harness for the VT Terminal Model
+ * Feeds arbitrary host output to the escape-sequence parser and grid
+ *
+ * Per input, besides the sanitizers' own checks:
+ * - no heap allocation while parsing or rendering: the model allocates
+ *   its grid and scrollback in begin() and nothing after, so memory
+ *   stays bounded whatever the remote sends
+ * - cursor, scroll region and scrollback stay inside the grid
+ * - sixel images stay on screen and inside the tile pool; one that runs
+ *   out of decode work gets new frames, and must go on in each
+ * - renderRepaint() (mosh diffs) reproduces the screen when parsed
+ * - time per byte stays under a budget: VT_FUZZ_SLOW_FACTOR (default 8)
+ *   times that of back-to-back full-screen clears, measured at startup,
+ *   or VT_FUZZ_NS_PER_BYTE if set. Inputs over it abort, so libFuzzer
+ *   keeps them as crash-* files.
+ *
+ * The first input byte picks the geometry and how the rest is split
+ * into write() calls, so sequences cut across reads get exercised.
+ *
+ *   clang++ -g -O1 -fsanitize=fuzzer,address,undefined -I tlorapager_terminal \
+ *       fuzz/vt_fuzz.cpp tlorapager_terminal/vt_terminal.cpp tlorapager_terminal/sixel.cpp \
+ *       tlorapager_terminal/render_kernels.cpp -o vt_fuzz
+ *   ./vt_fuzz -dict=fuzz/vt.dict -max_len=65536 fuzz/corpus
+ *
+ * Without libFuzzer (g++), add -D VT_FUZZ_MAIN and -fsanitize=address:
+ * ./vt_fuzz FILE... runs the checks on each file.
+ */
+
+#include "vt_terminal.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Allocation hooks come with the ASan runtime
+#if defined(__SANITIZE_ADDRESS__)
+#define VT_FUZZ_HOOKS 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VT_FUZZ_HOOKS 1
+#endif
+#endif
+
+#ifdef VT_FUZZ_HOOKS
+// Not every toolchain ships <sanitizer/allocator_interface.h>
+extern "C" int __sanitizer_install_malloc_and_free_hooks(
+    void (*mallocHook)(const volatile void *, size_t), void (*freeHook)(const volatile void *));
+#endif
+
+#define VT_FUZZ_SCROLLBACK 200
+#define VT_FUZZ_MIN_TIMED 512        // Shorter inputs are all timer noise
+#define VT_FUZZ_SLOW_FACTOR 8
+#define VT_FUZZ_CALIBRATE_BYTES 65536
+#define VT_FUZZ_OUT_CAP ((132 + 1) * (20 + VT_FUZZ_SCROLLBACK) + 1)
+#define VT_FUZZ_TILES 8              // Small pool, so eviction gets exercised
+#define VT_FUZZ_CELL_W 5             // The device's cell size
+#define VT_FUZZ_CELL_H 15
+
+typedef struct {
+    uint16_t cols;
+    uint16_t rows;
+    uint16_t scrollback;
+} Geometry_t;
+
+// Device screen, a 132-column PTY, and the smallest possible grids
+static const Geometry_t geometries[] = {
+    {80, 20, VT_FUZZ_SCROLLBACK},
+    {132, 20, VT_FUZZ_SCROLLBACK},
+    {1, 1, 0},
+    {3, 2, 4},
+};
+#define GEOMETRY_COUNT (sizeof(geometries) / sizeof(geometries[0]))
+
+static VtTerminal terms[GEOMETRY_COUNT];
+static VtTerminal mirrors[GEOMETRY_COUNT];
+static SixelCache caches[GEOMETRY_COUNT];
+static char textOut[VT_FUZZ_OUT_CAP];
+static char repaintOut[VT_FUZZ_OUT_CAP * 8];
+static double budgetNsPerByte = 0;
+
+// Allocations counted while the model runs
+static volatile bool counting = false;
+static volatile size_t allocCount = 0;
+
+#ifdef VT_FUZZ_HOOKS
+static void mallocHook(const volatile void *ptr, size_t size) {
+    (void)ptr;
+    (void)size;
+    if (counting) allocCount++;
+}
+
+static void freeHook(const volatile void *ptr) {
+    (void)ptr;
+}
+#endif
+
+static void ignoreReply(const char *data, size_t len) {
+    (void)data;
+    (void)len;
+}
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void fail(const char *what, size_t size) {
+    fprintf(stderr, "vt_fuzz: %s (input %zu bytes)\n", what, size);
+    abort();
+}
+
+// Parse data in chunks of `chunk` bytes (0 = all at once). A sixel
+// image out of decode work gets a new frame, as the UI loop gives it.
+static void feed(VtTerminal &t, const uint8_t *data, size_t size, size_t chunk) {
+    if (chunk == 0) chunk = size;
+    bool newFrame = false;
+    for (size_t pos = 0; pos < size;) {
+        size_t n = size - pos < chunk ? size - pos : chunk;
+        size_t taken = t.write((const char *)data + pos, n);
+        if (taken == 0 && newFrame) fail("sixel decoding stuck", size);
+        newFrame = taken < n;
+        if (newFrame) t.imageFrame();
+        pos += taken;
+    }
+}
+
+static double timeFeed(VtTerminal &t, const uint8_t *data, size_t size, size_t chunk) {
+    t.imageFrame();
+    uint64_t start = nowNs();
+    feed(t, data, size, chunk);
+    return (double)(nowNs() - start) / size;
+}
+
+static void checkGrid(const VtTerminal &t, const Geometry_t &g, size_t size) {
+    if (t.cols() != g.cols || t.rows() != g.rows) fail("geometry changed", size);
+    if (t.cursorX() >= g.cols || t.cursorY() >= g.rows) fail("cursor outside the grid", size);
+    if (t.scrollbackCount() < 0 || t.scrollbackCount() > g.scrollback) fail("scrollback over capacity", size);
+    // Every history row at this width, bottom to top
+    uint16_t len;
+    bool wrapped;
+    const VtCell *cells;
+    for (int up = 0; (cells = t.historyRow(up, &len, &wrapped)) != NULL; up++) {
+        if (len > g.cols || up >= 2 * g.scrollback) fail("history row out of bounds", size);
+        for (int x = 0; x < len; x++) {
+            if (cells[x].ch < 0x20 || cells[x].ch >= 0x7F) fail("unprintable byte in history", size);
+        }
+    }
+    for (int y = 0; y < g.rows; y++) {
+        const VtRow &row = t.row(y);
+        for (int x = 0; x < g.cols; x++) {
+            uint8_t ch = row.cells[x].ch;
+            if (ch < 0x20 || ch >= 0x7F) fail("unprintable byte in a cell", size);
+        }
+    }
+}
+
+static void checkImages(const SixelCache &cache, const Geometry_t &g, size_t size) {
+    bool owned[SIXEL_MAX_TILES] = {false};
+    int tiles = 0;
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        const SixelImage &img = cache.image(i);
+        if (!img.used) continue;
+        if (img.left + img.cols > g.cols || img.rows > g.rows || img.rows > SIXEL_MAX_ROWS) {
+            fail("image larger than the grid", size);
+        }
+        // (One just started has no rows yet)
+        if (img.top + img.rows > g.rows || (img.rows > 0 && img.top + img.rows <= 0)) {
+            fail("image off screen", size);
+        }
+        for (int r = 0; r < SIXEL_MAX_ROWS; r++) {
+            int16_t tile = img.tile[r];
+            if (tile < 0) continue;
+            if (r >= img.rows || tile >= cache.tileCount() || owned[tile]) fail("image tile not its own", size);
+            owned[tile] = true;
+            tiles++;
+        }
+    }
+    if (tiles + cache.tilesFree() != cache.tileCount()) fail("tile pool leaked", size);
+}
+
+// The repaint parsed into a clean terminal must give the same screen
+static void checkRepaint(const VtTerminal &t, VtTerminal &mirror, size_t size) {
+    size_t n = t.renderRepaint(repaintOut, sizeof(repaintOut));
+    if (n >= sizeof(repaintOut)) fail("repaint overran its buffer", size);
+    mirror.reset();
+    mirror.write(repaintOut, n);
+    for (int y = 0; y < t.rows(); y++) {
+        if (memcmp(t.row(y).cells, mirror.row(y).cells, t.cols() * sizeof(VtCell)) != 0) {
+            fail("repaint does not reproduce the screen", size);
+        }
+    }
+    if (mirror.cursorX() != t.cursorX() || mirror.cursorY() != t.cursorY()) {
+        fail("repaint does not restore the cursor", size);
+    }
+}
+
+// Per-byte cost of full-screen clears on the biggest grid: as much work
+// per byte as a host can ask for with an everyday sequence (RIS, two
+// screens for two bytes, comes to about 4x this)
+static double calibrate() {
+    static uint8_t buf[VT_FUZZ_CALIBRATE_BYTES];
+    VtTerminal &t = terms[1];
+    size_t size = 0;
+    while (size + 4 <= sizeof(buf)) {
+        memcpy(buf + size, "\x1b[2J", 4);
+        size += 4;
+    }
+
+    double best = 1e18;
+    for (int run = 0; run < 3; run++) {
+        t.reset();
+        double ns = timeFeed(t, buf, size, 0);
+        if (ns < best) best = ns;
+    }
+    t.reset();
+    return best;
+}
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    (void)argc;
+    (void)argv;
+    for (size_t i = 0; i < GEOMETRY_COUNT; i++) {
+        const Geometry_t &g = geometries[i];
+        if (!terms[i].begin(g.cols, g.rows, g.scrollback) || !mirrors[i].begin(g.cols, g.rows, 0)) {
+            fprintf(stderr, "vt_fuzz: allocation failed\n");
+            exit(1);
+        }
+        terms[i].setResponder(ignoreReply);
+        mirrors[i].setResponder(ignoreReply);
+
+        size_t bytes = VT_FUZZ_TILES * SixelCache::tileBytes(VT_FUZZ_CELL_W, VT_FUZZ_CELL_H);
+        caches[i].begin(malloc(bytes), bytes, VT_FUZZ_CELL_W, VT_FUZZ_CELL_H);
+        terms[i].setImageCache(&caches[i]);
+    }
+
+    const char *fixed = getenv("VT_FUZZ_NS_PER_BYTE");
+    if (fixed != NULL) {
+        budgetNsPerByte = atof(fixed);
+    } else {
+        const char *factor = getenv("VT_FUZZ_SLOW_FACTOR");
+        double base = calibrate();
+        budgetNsPerByte = base * (factor ? atof(factor) : VT_FUZZ_SLOW_FACTOR);
+        fprintf(stderr, "vt_fuzz: screen clear %.1f ns/byte, budget %.1f ns/byte\n",
+                base, budgetNsPerByte);
+    }
+
+#ifdef VT_FUZZ_HOOKS
+    __sanitizer_install_malloc_and_free_hooks(mallocHook, freeHook);
+#else
+    fprintf(stderr, "vt_fuzz: built without ASan, allocations not checked\n");
+#endif
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size == 0) return 0;
+
+    // First byte: geometry (low 2 bits) and write() chunk size (rest)
+    uint8_t ctl = data[0];
+    const Geometry_t &g = geometries[ctl % GEOMETRY_COUNT];
+    VtTerminal &t = terms[ctl % GEOMETRY_COUNT];
+    VtTerminal &mirror = mirrors[ctl % GEOMETRY_COUNT];
+    size_t chunk = ctl >> 2;  // 0 = whole input in one write
+    data++;
+    size--;
+
+    t.reset();
+    t.takeBells();
+
+    allocCount = 0;
+    counting = true;
+    double ns = timeFeed(t, data, size, chunk);
+    size_t cursorIndex = 0;
+    size_t textLen = t.renderText(textOut, sizeof(textOut), 0, g.scrollback, 0, g.cols, &cursorIndex);
+    counting = false;
+
+    if (allocCount != 0) fail("heap allocation while parsing or rendering", size);
+    if (textLen >= sizeof(textOut) || cursorIndex > textLen) fail("renderText out of bounds", size);
+    checkGrid(t, g, size);
+    checkImages(caches[ctl % GEOMETRY_COUNT], g, size);
+    checkRepaint(t, mirror, size);
+
+    // Time per byte, retried so one scheduler hiccup is not a finding
+    if (size >= VT_FUZZ_MIN_TIMED && ns > budgetNsPerByte) {
+        for (int retry = 0; retry < 2 && ns > budgetNsPerByte; retry++) {
+            t.reset();
+            double again = timeFeed(t, data, size, chunk);
+            if (again < ns) ns = again;
+        }
+        if (ns > budgetNsPerByte) {
+            fprintf(stderr, "vt_fuzz: %.1f ns/byte over the %.1f ns/byte budget\n", ns, budgetNsPerByte);
+            fail("slow input", size);
+        }
+    }
+    return 0;
+}
+
+#ifdef VT_FUZZ_MAIN
+// Run the checks on files, for builds without libFuzzer
+int main(int argc, char **argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+        if (f == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        static uint8_t buf[1 << 20];
+        size_t n = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+        LLVMFuzzerTestOneInput(buf, n);
+        printf("%s: ok (%zu bytes)\n", argv[i], n);
+    }
+    return 0;
+}
+#endif
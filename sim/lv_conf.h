@@ -0,0 +1,38 @@
+/**
+ * LVGL Configuration for the T-LoRa Pager Simulator
+ * Only what differs from LVGL's defaults (lv_conf_internal.h fills in
+ * the rest). Keep the display format and fonts in line with the device.
+ */
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+// Built-in allocator with room for the settings menus
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_BUILTIN
+#define LV_MEM_SIZE (256 * 1024)
+
+#define LV_USE_OS LV_OS_NONE
+#define LV_DEF_REFR_PERIOD 33
+
+// No randomness or wall time in the rendering: snapshots must repeat
+#define LV_USE_LOG 0
+#define LV_USE_SYSMON 0
+#define LV_USE_PERF_MONITOR 0
+
+#define LV_FONT_MONTSERRAT_10 1
+#define LV_FONT_MONTSERRAT_12 1
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_MONTSERRAT_18 1
+#define LV_FONT_MONTSERRAT_28 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+#define LV_USE_XML 0
+
+// Fills, glyph blends and the RGB565 swap through the render kernels,
+// as on the device (tlorapager_terminal/lv_conf.h)
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_CUSTOM
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_blend_rk.h"
+
+#endif // LV_CONF_H
@@ -0,0 +1,107 @@
+/**
+ * Arduino Core Shim for the T-LoRa Pager Simulator
+ * Just enough of the Arduino API for the UI sources to build on Linux
+ *
+ * Time is virtual: millis() only moves when the simulator (or delay())
+ * advances it, so a script replays to the same frames on every run.
+ * Serial goes to stderr; stdout carries the simulator's own results.
+ */
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <string>
+
+#define HIGH 1
+#define LOW 0
+#define IRAM_ATTR
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Virtual clock (sim_shims.cpp)
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void simAdvance(uint32_t ms);
+
+// Live sessions: delay() also sleeps, so blocking waits in a transport
+// give the remote real time to answer
+void simSetRealtime(bool on);
+
+// PSRAM (sim_shims.cpp): heap_caps_malloc(MALLOC_CAP_SPIRAM)
+void *ps_malloc(size_t size);
+
+#ifndef min
+template <typename A, typename B> inline auto min(A a, B b) -> decltype(a < b ? a : b) { return a < b ? a : b; }
+#endif
+#ifndef max
+template <typename A, typename B> inline auto max(A a, B b) -> decltype(a > b ? a : b) { return a > b ? a : b; }
+#endif
+
+class String {
+public:
+    String(const char *s = "") : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    const char *c_str() const { return _s.c_str(); }
+    size_t length() const { return _s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool startsWith(const char *p) const { return _s.compare(0, strlen(p), p) == 0; }
+    bool endsWith(const char *p) const {
+        size_t n = strlen(p);
+        return n <= _s.size() && _s.compare(_s.size() - n, n, p) == 0;
+    }
+    String substring(size_t from, size_t to) const { return String(_s.substr(from, to - from)); }
+    bool operator==(const char *s) const { return _s == s; }
+    bool operator!=(const char *s) const { return _s != s; }
+    bool operator==(const String &s) const { return _s == s._s; }
+    String &operator+=(const char *s) { _s += s; return *this; }
+
+private:
+    std::string _s;
+};
+
+class SimSerial {
+public:
+    void begin(unsigned long) {}
+    size_t print(const char *s) { return fputs(s, stderr) >= 0 ? strlen(s) : 0; }
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t println(const char *s = "") { size_t n = print(s); fputc('\n', stderr); return n + 1; }
+    size_t println(const String &s) { return println(s.c_str()); }
+    // As Print::printf(): a 64-byte stack buffer, the heap for longer lines
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char loc[64];
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(loc, sizeof(loc), fmt, ap);
+        va_end(ap);
+        if (n < 0) return 0;
+        char *line = loc;
+        if (n >= (int)sizeof(loc)) {
+            line = (char *)malloc(n + 1);
+            if (line == NULL) return 0;
+            va_start(ap, fmt);
+            vsnprintf(line, n + 1, fmt, ap);
+            va_end(ap);
+        }
+        fputs(line, stderr);
+        if (line != loc) free(line);
+        return n;
+    }
+};
+extern SimSerial Serial;
+
+class SimEsp {
+public:
+    void restart();
+};
+extern SimEsp ESP;
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,27 @@
+/**
+ * LilyGoLib Shim for the T-LoRa Pager Simulator
+ * The board object as far as the UI uses it: haptic driver and backlight.
+ * Both only count, for the simulator's summary.
+ */
+
+#ifndef SIM_LILYGOLIB_H
+#define SIM_LILYGOLIB_H
+
+#include <Arduino.h>
+
+class SimHaptic {
+public:
+    void setWaveform(uint8_t slot, uint8_t effect) { (void)slot; (void)effect; }
+    void run() { runs++; }
+    uint32_t runs = 0;
+};
+
+class SimBoard {
+public:
+    void setBrightness(uint8_t level) { brightness = level; }
+    SimHaptic drv;
+    uint8_t brightness = 0;
+};
+extern SimBoard instance;
+
+#endif // SIM_LILYGOLIB_H
@@ -0,0 +1,54 @@
+/**
+ * LittleFS Shim for the T-LoRa Pager Simulator
+ * The filesystem is a host directory ("data", the image PlatformIO
+ * uploads, unless simSetFsRoot() picks another). Paths work both through
+ * LittleFS.open() and, under CONFIG_FS_ROOT, through POSIX open() as the
+ * VFS mount does on the device. Only directory listing is provided.
+ */
+
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include <Arduino.h>
+#include <dirent.h>
+#include <memory>
+
+// Host directory standing in for the mount point (sim_shims.cpp)
+const char *simFsRoot();
+void simSetFsRoot(const char *dir);
+
+#define CONFIG_FS_ROOT simFsRoot()
+
+class File {
+public:
+    File() {}
+    File(const std::string &path, bool dir) : _path(path), _dir(dir) {
+        if (dir) _entries.reset(opendir(path.c_str()), closedir);
+    }
+
+    explicit operator bool() const { return !_path.empty(); }
+    bool isDirectory() const { return _dir; }
+
+    // Entry name, as the device's (no directory part)
+    const char *name() const {
+        size_t slash = _path.rfind('/');
+        return _path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    }
+
+    File openNextFile();
+    void close() { _entries.reset(); }
+
+private:
+    std::string _path;
+    bool _dir = false;
+    std::shared_ptr<DIR> _entries;
+};
+
+class SimLittleFS {
+public:
+    bool begin(bool formatOnFail = false) { (void)formatOnFail; return true; }
+    File open(const char *path, const char *mode = "r");
+};
+extern SimLittleFS LittleFS;
+
+#endif // SIM_LITTLEFS_H
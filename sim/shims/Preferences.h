@@ -0,0 +1,79 @@
+/**
+ * Preferences (NVS) Shim for the T-LoRa Pager Simulator
+ * In-memory blobs: every run starts from defaults, as a fresh device.
+ * Reads do not allocate (the key is looked up from a stack buffer), so
+ * they do not show in the simulator's malloc count.
+ */
+
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define SIM_PREFS_KEY_MAX 32   // "namespace/key", both at most 15 on the device
+
+class Preferences {
+public:
+    bool begin(const char *ns, bool readOnly = false) { _ns = ns; (void)readOnly; return true; }
+    void end() {}
+    bool clear() { _blobs.clear(); return true; }
+    bool remove(const char *key) {
+        auto it = find(key);
+        if (it == _blobs.end()) return false;
+        _blobs.erase(it);
+        return true;
+    }
+    bool isKey(const char *key) { return find(key) != _blobs.end(); }
+
+    size_t getBytesLength(const char *key) {
+        auto it = find(key);
+        return it == _blobs.end() ? 0 : it->second.size();
+    }
+    size_t getBytes(const char *key, void *buf, size_t maxLen) {
+        auto it = find(key);
+        if (it == _blobs.end()) return 0;
+        size_t n = min(maxLen, it->second.size());
+        memcpy(buf, it->second.data(), n);
+        return n;
+    }
+    size_t putBytes(const char *key, const void *value, size_t len) {
+        const uint8_t *p = (const uint8_t *)value;
+        _blobs[_ns + "/" + key].assign(p, p + len);
+        return len;
+    }
+
+    // As nvs_get_str(): nothing (0) if missing or it does not fit
+    size_t getString(const char *key, char *value, size_t maxLen) {
+        auto it = find(key);
+        if (it == _blobs.end() || it->second.size() > maxLen) return 0;
+        memcpy(value, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+    String getString(const char *key, String defaultValue = String()) {
+        auto it = find(key);
+        return it == _blobs.end() ? defaultValue : String((const char *)it->second.data());
+    }
+    size_t putString(const char *key, const char *value) {
+        return putBytes(key, value, strlen(value) + 1) - 1;
+    }
+    size_t putString(const char *key, const String &value) { return putString(key, value.c_str()); }
+
+private:
+    typedef std::map<std::string, std::vector<uint8_t>, std::less<>> Blobs;
+
+    Blobs::iterator find(const char *key) {
+        char full[SIM_PREFS_KEY_MAX];
+        int n = snprintf(full, sizeof(full), "%s/%s", _ns.c_str(), key);
+        if (n < 0 || n >= (int)sizeof(full)) return _blobs.end();
+        return _blobs.find(std::string_view(full, n));
+    }
+
+    std::string _ns;
+    Blobs _blobs;
+};
+
+#endif // SIM_PREFERENCES_H
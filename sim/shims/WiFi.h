@@ -0,0 +1,39 @@
+/**
+ * Wi-Fi Shim for the T-LoRa Pager Simulator
+ * Always connected to "sim-net"; a scan finds a fixed set of networks
+ * one call after it was started, so the scan menu renders the same way
+ * on every run.
+ */
+
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class SimWiFi {
+public:
+    wl_status_t status() { return WL_CONNECTED; }
+    String SSID() { return String("sim-net"); }
+    int32_t RSSI() { return -55; }
+
+    int16_t scanNetworks(bool async = false);
+    int16_t scanComplete();
+    void scanDelete() { _scanState = WIFI_SCAN_FAILED; }
+    String SSID(uint8_t i);
+    int32_t RSSI(uint8_t i);
+
+private:
+    int16_t _scanState = WIFI_SCAN_FAILED;
+};
+extern SimWiFi WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,33 @@
+/**
+ * ROM miniz Shim for the T-LoRa Pager Simulator
+ * tinfl's one-shot inflate on zlib (link with -lz)
+ */
+
+#ifndef SIM_ROM_MINIZ_H
+#define SIM_ROM_MINIZ_H
+
+#include <stddef.h>
+#include <zlib.h>
+
+#define TINFL_FLAG_PARSE_ZLIB_HEADER 1
+#define TINFL_DECOMPRESS_MEM_TO_MEM_FAILED ((size_t)(-1))
+
+// Bytes written to out, or TINFL_DECOMPRESS_MEM_TO_MEM_FAILED if the
+// stream is corrupt, truncated or does not fit
+static inline size_t tinfl_decompress_mem_to_mem(void *out, size_t outLen, const void *in,
+                                                 size_t inLen, int flags) {
+    z_stream z = {};
+    if (inflateInit2(&z, flags & TINFL_FLAG_PARSE_ZLIB_HEADER ? MAX_WBITS : -MAX_WBITS) != Z_OK) {
+        return TINFL_DECOMPRESS_MEM_TO_MEM_FAILED;
+    }
+    z.next_in = (Bytef *)in;
+    z.avail_in = (uInt)inLen;
+    z.next_out = (Bytef *)out;
+    z.avail_out = (uInt)outLen;
+    int rc = inflate(&z, Z_FINISH);
+    size_t n = z.total_out;
+    inflateEnd(&z);
+    return rc == Z_STREAM_END ? n : TINFL_DECOMPRESS_MEM_TO_MEM_FAILED;
+}
+
+#endif // SIM_ROM_MINIZ_H
@@ -0,0 +1,44 @@
+/**
+ * Heap Capabilities Shim for the T-LoRa Pager Simulator
+ * "Internal RAM" is a 512KB budget minus what the process has allocated
+ * (glibc's in-use bytes); allocated_blocks counts live malloc() blocks.
+ * simHeapAllocCount() counts every malloc(), calloc() and realloc() call
+ * so far (C++ new included), for checks that code does not allocate.
+ * There is no fragmentation model: the largest free block is all of the
+ * free space. MALLOC_CAP_SPIRAM allocations are mapped outside that
+ * budget and never freed; PSRAM reports no size.
+ */
+
+#ifndef SIM_ESP_HEAP_CAPS_H
+#define SIM_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+#define SIM_HEAP_SIZE (512 * 1024)
+
+typedef struct {
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps);
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+
+// Simulator only (sim_shims.cpp)
+size_t simHeapAllocCount();
+
+#endif // SIM_ESP_HEAP_CAPS_H
@@ -0,0 +1,18 @@
+/**
+ * esp_timer Shim for the T-LoRa Pager Simulator
+ * Real monotonic time, for measuring (unlike the virtual millis())
+ */
+
+#ifndef SIM_ESP_TIMER_H
+#define SIM_ESP_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+static inline int64_t esp_timer_get_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif // SIM_ESP_TIMER_H
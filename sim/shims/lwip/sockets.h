@@ -0,0 +1,32 @@
+/**
+ * lwIP Sockets Shim for the T-LoRa Pager Simulator
+ * The lwip_ calls are the host's BSD sockets
+ */
+
+#ifndef SIM_LWIP_SOCKETS_H
+#define SIM_LWIP_SOCKETS_H
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+static inline int lwip_socket(int domain, int type, int protocol) {
+    return socket(domain, type, protocol);
+}
+
+static inline int lwip_close(int s) {
+    return close(s);
+}
+
+static inline ssize_t lwip_sendto(int s, const void *data, size_t size, int flags,
+                                  const struct sockaddr *to, socklen_t tolen) {
+    return sendto(s, data, size, flags, to, tolen);
+}
+
+static inline ssize_t lwip_recvfrom(int s, void *mem, size_t len, int flags,
+                                    struct sockaddr *from, socklen_t *fromlen) {
+    return recvfrom(s, mem, len, flags, from, fromlen);
+}
+
+#endif // SIM_LWIP_SOCKETS_H
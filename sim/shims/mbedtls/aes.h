@@ -0,0 +1,51 @@
+/**
+ * mbedTLS AES Shim for the T-LoRa Pager Simulator
+ * The block cipher calls ocb_aes.cpp makes, on OpenSSL's AES (link
+ * with -lcrypto)
+ */
+
+#ifndef SIM_MBEDTLS_AES_H
+#define SIM_MBEDTLS_AES_H
+
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include <openssl/aes.h>
+#include <string.h>
+
+#define MBEDTLS_AES_ENCRYPT 1
+#define MBEDTLS_AES_DECRYPT 0
+#define MBEDTLS_ERR_AES_INVALID_KEY_LENGTH -0x0020
+
+typedef struct {
+    AES_KEY key;
+} mbedtls_aes_context;
+
+static inline void mbedtls_aes_init(mbedtls_aes_context *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+static inline void mbedtls_aes_free(mbedtls_aes_context *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+static inline int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
+                                         unsigned int keybits) {
+    return AES_set_encrypt_key(key, keybits, &ctx->key) == 0 ? 0 : MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+}
+
+static inline int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key,
+                                         unsigned int keybits) {
+    return AES_set_decrypt_key(key, keybits, &ctx->key) == 0 ? 0 : MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+}
+
+// One 16-byte block; input and output may overlap, as in mbedTLS
+static inline int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode,
+                                        const unsigned char input[16], unsigned char output[16]) {
+    if (mode == MBEDTLS_AES_ENCRYPT) {
+        AES_encrypt(input, output, &ctx->key);
+    } else {
+        AES_decrypt(input, output, &ctx->key);
+    }
+    return 0;
+}
+
+#endif // SIM_MBEDTLS_AES_H
@@ -0,0 +1,50 @@
+/**
+ * mbedTLS Base64 Shim for the T-LoRa Pager Simulator
+ * Decode only, with mbedTLS's return codes
+ */
+
+#ifndef SIM_MBEDTLS_BASE64_H
+#define SIM_MBEDTLS_BASE64_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL -0x002A
+#define MBEDTLS_ERR_BASE64_INVALID_CHARACTER -0x002C
+
+static inline int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen,
+                                        const unsigned char *src, size_t slen) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t pad = 0;
+    while (pad < 2 && slen > pad && src[slen - 1 - pad] == '=') pad++;
+    if (slen % 4 != 0) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+
+    size_t need = slen / 4 * 3 - pad;
+    *olen = need;
+    if (dst == NULL || dlen < need) return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+
+    uint32_t bits = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < slen - pad; i++) {
+        const char *c = src[i] ? strchr(alphabet, src[i]) : NULL;
+        if (c == NULL) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        bits = bits << 6 | (uint32_t)(c - alphabet);
+        if (i % 4 == 3) {
+            dst[n++] = (unsigned char)(bits >> 16);
+            dst[n++] = (unsigned char)(bits >> 8);
+            dst[n++] = (unsigned char)bits;
+            bits = 0;
+        }
+    }
+    // Last quad short of its padding
+    if (pad == 1) {
+        dst[n++] = (unsigned char)(bits >> 10);
+        dst[n++] = (unsigned char)(bits >> 2);
+    } else if (pad == 2) {
+        dst[n++] = (unsigned char)(bits >> 4);
+    }
+    return 0;
+}
+
+#endif // SIM_MBEDTLS_BASE64_H
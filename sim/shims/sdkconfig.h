@@ -0,0 +1,11 @@
+/**
+ * sdkconfig Shim for the T-LoRa Pager Simulator
+ * The target the sources pick ROM headers by
+ */
+
+#ifndef SIM_SDKCONFIG_H
+#define SIM_SDKCONFIG_H
+
+#define CONFIG_IDF_TARGET_ESP32S3 1
+
+#endif // SIM_SDKCONFIG_H
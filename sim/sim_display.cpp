@@ -0,0 +1,114 @@
+/**
+ * Framebuffer Display Implementation
+ */
+
+#include "sim_display.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <vector>
+
+static uint16_t framebuffer[SIM_DISP_W * SIM_DISP_H];
+static uint16_t drawBuf[SIM_DISP_W * SIM_DRAW_LINES];
+static lv_display_t *display = NULL;
+
+static FILE *frameLog = NULL;
+static SimFrame_t current;
+static int64_t refrStartUs = 0;
+static int64_t lastFlushUs = 0;
+static std::vector<uint32_t> renderTimes;
+static uint64_t totalPixels = 0;
+
+static void flushCb(lv_display_t *disp, const lv_area_t *area, uint8_t *pxMap) {
+    int32_t w = lv_area_get_width(area);
+    const uint16_t *src = (const uint16_t *)pxMap;
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(&framebuffer[y * SIM_DISP_W + area->x1], src, w * sizeof(uint16_t));
+        src += w;
+    }
+    current.pixels += w * lv_area_get_height(area);
+    current.areas++;
+    lastFlushUs = esp_timer_get_time();
+    lv_display_flush_ready(disp);
+}
+
+static void refrEventCb(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_REFR_START) {
+        memset(&current, 0, sizeof(current));
+        refrStartUs = esp_timer_get_time();
+        return;
+    }
+
+    // LV_EVENT_REFR_READY: a refresh with nothing invalid is not a frame
+    if (current.pixels == 0) return;
+    current.atMs = millis();
+    current.renderUs = (uint32_t)(lastFlushUs - refrStartUs);
+    renderTimes.push_back(current.renderUs);
+    totalPixels += current.pixels;
+    if (frameLog) {
+        fprintf(frameLog, "%u,%u,%u,%u,%u\n", (unsigned)renderTimes.size(), (unsigned)current.atMs,
+                (unsigned)current.renderUs, (unsigned)current.pixels, (unsigned)current.areas);
+    }
+}
+
+lv_display_t *simDisplayBegin() {
+    display = lv_display_create(SIM_DISP_W, SIM_DISP_H);
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(display, drawBuf, NULL, sizeof(drawBuf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(display, flushCb);
+    lv_display_add_event_cb(display, refrEventCb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display, refrEventCb, LV_EVENT_REFR_READY, NULL);
+    return display;
+}
+
+void simDisplayLogFrames(FILE *f) {
+    frameLog = f;
+    if (frameLog) fprintf(frameLog, "frame,ms,render_us,pixels,areas\n");
+}
+
+void simDisplayRefresh() {
+    lv_refr_now(display);
+}
+
+uint64_t simDisplayHash() {
+    const uint8_t *p = (const uint8_t *)framebuffer;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < sizeof(framebuffer); i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+bool simDisplayDump(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", SIM_DISP_W, SIM_DISP_H);
+    for (int i = 0; i < SIM_DISP_W * SIM_DISP_H; i++) {
+        uint16_t c = framebuffer[i];
+        uint8_t rgb[3] = {
+            (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+            (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((c & 0x1F) * 255 / 31)
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+}
+
+void simDisplayPrintSummary() {
+    if (renderTimes.empty()) {
+        printf("frames: none\n");
+        return;
+    }
+    std::vector<uint32_t> sorted = renderTimes;
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t sum = 0;
+    for (uint32_t us : sorted) sum += us;
+    size_t n = sorted.size();
+    printf("frames: %u, %llu pixels flushed (%.1f screens)\n", (unsigned)n,
+           (unsigned long long)totalPixels, (double)totalPixels / (SIM_DISP_W * SIM_DISP_H));
+    printf("render: avg %.0fus  p50 %uus  p95 %uus  max %uus\n", (double)sum / n,
+           (unsigned)sorted[n / 2], (unsigned)sorted[n * 95 / 100], (unsigned)sorted[n - 1]);
+}
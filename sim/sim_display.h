@@ -0,0 +1,43 @@
+/**
+ * Framebuffer Display for the T-LoRa Pager Simulator
+ * 480x222 RGB565 in memory, with per-frame timing and pixel counts
+ */
+
+#ifndef SIM_DISPLAY_H
+#define SIM_DISPLAY_H
+
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_DISP_W 480
+#define SIM_DISP_H 222
+#define SIM_DRAW_LINES 40  // Partial draw buffer height
+
+// One display refresh that flushed something
+typedef struct {
+    uint32_t atMs;       // Virtual time
+    uint32_t renderUs;   // Real time from refresh start to the last flush
+    uint32_t pixels;     // Pixels flushed
+    uint16_t areas;      // Flush calls
+} SimFrame_t;
+
+// Create the LVGL display (after lv_init)
+lv_display_t *simDisplayBegin();
+
+// Write one CSV line per frame to f (NULL: keep only the totals)
+void simDisplayLogFrames(FILE *f);
+
+// Draw anything pending now
+void simDisplayRefresh();
+
+// FNV-1a 64 of the framebuffer
+uint64_t simDisplayHash();
+
+// Write the framebuffer as a binary PPM
+bool simDisplayDump(const char *path);
+
+// Frames, pixels and render time percentiles to stdout
+void simDisplayPrintSummary();
+
+#endif // SIM_DISPLAY_H
@@ -0,0 +1,553 @@
+/**
+ * T-LoRa Pager Simulator
+ * Headless Linux build of the pager UI: intro, terminal screen, settings
+ * menus and terminal renderer on an in-memory 480x222 display
+ *
+ *   sim [--script FILE] [--replay FILE | --ssh [USER@]HOST[:PORT] |
+ *        --mosh [USER@]HOST[:PORT]] [--golden FILE [--update-golden]] [--frames CSV] [--dump DIR]
+ *       [--no-intro] [--soak N] [--config DIR]
+ *
+ * Input comes from the script, one command per line (# comments):
+ *   wait MS         run the UI loop for MS of virtual time
+ *   type TEXT       keys, with \r \n \t \b \e \\ \xNN escapes
+ *   key NAME        enter, esc, tab, bs, space
+ *   ctrl X          Ctrl-X
+ *   rotate N        N encoder detents (negative = counter-clockwise)
+ *   click / hold    rotary button short / long (back) press
+ *   print TEXT      local message into the terminal (as terminalPrint)
+ *   resize C R      terminal to C columns x R rows (and the session PTY)
+ *   pan N           move the viewport of a wide grid N columns
+ *   connect         open the --replay / --ssh / --mosh session
+ *   disconnect      close it
+ *   snap NAME       draw, hash the framebuffer and check it against the
+ *                   golden file
+ * Without a script the session is opened, run for 5s and snapped as
+ * "final".
+ *
+ * --soak N runs N soak iterations instead (see soak.h): connect, bulk
+ * output (the replay, or `seq` over --ssh), every settings menu, every
+ * theme, disconnect, then memory samples. Exit status 1 if a metric
+ * trends worse.
+ *
+ * Time is virtual and advances 5ms per loop step, as the sketch's
+ * loop() does, so snapshots are reproducible; with --ssh or --mosh the
+ * loop (and delay()) also sleeps for real so the remote can keep up.
+ * --mosh runs the device's mosh client (mosh_transport.cpp) and prints
+ * its counters (the `mosh` command) before disconnecting. Frames go to --frames as
+ * CSV; stdout gets the snapshot results and a summary. The exit status
+ * is 1 if a snapshot did not match its golden hash, or has none (only
+ * --update-golden records new ones).
+ *
+ * The configuration is loaded from --config (a LittleFS image directory,
+ * "data" by default) as setup() loads it, and the summary reports the
+ * heap allocations loadConfig() made: there should be none.
+ */
+
+#include <Arduino.h>
+#include <LilyGoLib.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include "sim_display.h"
+#include "sim_transport.h"
+#include "mosh_transport.h"
+#include "terminal_ui.h"
+#include "settings.h"
+#include "settings_ui.h"
+#include "pipeline_stats.h"
+#include "soak.h"
+#include "haptics.h"
+#include "audio.h"
+#include "ConfigLoader.h"
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+#define SIM_STEP_MS 5             // loop() delay on the device
+#define SIM_CLICK_MS 50
+#define SIM_HOLD_MS 600           // > LONG_PRESS_MS
+#define SIM_DEFAULT_RUN_MS 5000
+#define SIM_SETTLE_MS 500
+#define SIM_SOAK_BULK_CMD "seq 1 20000\n"
+#define SIM_SOAK_BULK_MS 10000    // Longest bulk phase
+#define SIM_SOAK_QUIET_MS 200     // Bulk phase ends after this long without output
+
+static const SessionTransport_t *session = NULL;
+static void *sessionTarget = NULL;
+static bool sessionOpen = false;
+static bool realtime = false;
+
+// Output the model left for the next step (a sixel image out of work)
+static char rxBuf[SIM_REPLAY_CHUNK];
+static int rxHeld = 0;
+
+static std::map<std::string, uint64_t> golden;
+static const char *goldenPath = NULL;
+static bool updateGolden = false;
+static const char *dumpDir = NULL;
+static int snapsOk = 0, snapsNew = 0, snapsFailed = 0;
+static uint32_t bells = 0;
+static uint32_t audioPlayed = 0;
+
+// Hooks the UI sources expect from the sketch
+
+void sshSendData(const char *data, size_t len) {
+    if (sessionOpen) session->write(data, (int)len);
+}
+
+void sessionResize() {
+    if (sessionOpen && session->resize) session->resize(termModel.cols(), termModel.rows());
+}
+
+// Played at once: there is no haptic task, and no rate limit
+bool hapticPlay(HapticEvent_t event) {
+    (void)event;
+    instance.drv.run();
+    return true;
+}
+
+void hapticsWaitIdle(uint32_t timeoutMs) {
+    (void)timeoutMs;
+}
+
+void hapticClick() {
+    hapticPlay(HAPTIC_CLICK);
+}
+
+// No speaker: counted only
+bool audioPlay(AudioSample_t sample) {
+    (void)sample;
+    if (!settings.soundEnabled || settings.volume == 0) return false;
+    audioPlayed++;
+    return true;
+}
+
+void audioSetVolume(uint8_t volume) {
+    (void)volume;
+}
+
+void connectToServer() {
+    if (session == NULL || sessionOpen) return;
+    sessionOpen = session->open(sessionTarget, termModel.cols(), termModel.rows());
+    updateStatus(sessionOpen ? "Connected" : "Connection failed");
+}
+
+static void disconnectSession() {
+    if (!sessionOpen) return;
+    session->close();
+    sessionOpen = false;
+    rxHeld = 0;
+    updateStatus("Disconnected");
+}
+
+// One pass of the sketch's loop(): LVGL, then terminal output
+static void simStep() {
+    lv_timer_handler();
+
+    if (settingsUIIsVisible() && settingsUIGetState() == MENU_WIFI_SCAN) {
+        settingsUIUpdateWiFiList();
+    }
+
+    if (!settingsUIIsVisible() && sessionOpen) {
+        int n = rxHeld > 0 ? rxHeld : session->read(rxBuf, sizeof(rxBuf));
+        if (n > 0) {
+            int64_t t0 = esp_timer_get_time();
+            termModel.imageFrame();
+            int taken = termModel.write(rxBuf, n);
+            rxHeld = n - taken;
+            memmove(rxBuf, rxBuf + taken, rxHeld);
+            terminalRender();
+            pipelineStats.renderUs += esp_timer_get_time() - t0;
+            pipelineStats.renderBytes += taken;
+            pipelineStats.renderCalls++;
+            bells += termModel.takeBells();
+        } else if (n < 0 || !session->isOpen()) {
+            disconnectSession();
+        }
+    }
+
+    if (realtime) usleep(SIM_STEP_MS * 1000);
+    simAdvance(SIM_STEP_MS);
+}
+
+static void simRun(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += SIM_STEP_MS) simStep();
+}
+
+// As processKeyboard() / the settings branch of loop()
+static void simKey(char key) {
+    if (!settingsUIIsVisible()) terminalScrollReset();
+    if (settingsUIIsVisible()) {
+        settingsUIHandleKey(key);
+    } else if (sessionOpen) {
+        if (key == '\r') key = '\n';
+        if (key == '\b') key = 0x7F;
+        sshSendData(&key, 1);
+    } else if (key == '\n' || key == '\r') {
+        terminalPrint("\n> ");
+    } else if (key == '\b' || key == 127) {
+        terminalPrint("\b \b");
+    } else if (key >= 32 && key < 127) {
+        terminalPrintChar(key);
+    }
+    simStep();
+}
+
+static void simRotate(int detents) {
+    int direction = detents > 0 ? 1 : -1;
+    for (int i = 0; i < abs(detents); i++) {
+        if (settingsUIIsVisible()) {
+            settingsUIHandleRotary(direction);
+        } else {
+            terminalScroll(direction);
+        }
+        simStep();
+    }
+}
+
+static void simButton(bool longPress) {
+    simRun(longPress ? SIM_HOLD_MS : SIM_CLICK_MS);
+    if (longPress) {
+        if (settingsUIIsVisible()) {
+            MenuState_t state = settingsUIGetState();
+            if (state == MENU_WIFI_ADD || state == MENU_WIFI_EDIT) {
+                settingsUICancelInput();
+            } else {
+                settingsUIHandleKey('q');
+            }
+        }
+    } else if (settingsUIIsVisible()) {
+        settingsUIHandleRotary(0);
+    } else {
+        settingsUIShow();
+    }
+    simStep();
+}
+
+static void simSnap(const char *name) {
+    simDisplayRefresh();
+    uint64_t hash = simDisplayHash();
+
+    auto it = golden.find(name);
+    const char *result;
+    if (it == golden.end()) {
+        // A typo in a script must not pass as a new snapshot
+        if (goldenPath && !updateGolden) {
+            result = "UNKNOWN";
+            snapsFailed++;
+        } else {
+            result = "new";
+            snapsNew++;
+        }
+    } else if (it->second == hash) {
+        result = "ok";
+        snapsOk++;
+    } else {
+        result = updateGolden ? "updated" : "MISMATCH";
+        if (!updateGolden) snapsFailed++;
+    }
+    printf("snap %-20s %016llx %s\n", name, (unsigned long long)hash, result);
+    if (updateGolden) golden[name] = hash;
+
+    if (dumpDir) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s.ppm", dumpDir, name);
+        if (!simDisplayDump(path)) fprintf(stderr, "sim: cannot write %s\n", path);
+    }
+}
+
+// Decode \r \n \t \b \e \\ \xNN in place; returns the length
+static size_t unescape(char *s) {
+    char *out = s;
+    for (char *p = s; *p; p++) {
+        if (*p != '\\' || p[1] == '\0') {
+            *out++ = *p;
+            continue;
+        }
+        switch (*++p) {
+            case 'r': *out++ = '\r'; break;
+            case 'n': *out++ = '\n'; break;
+            case 't': *out++ = '\t'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'e': *out++ = 0x1B; break;
+            case 'x': {
+                char hex[3] = {p[1], p[1] ? p[2] : '\0', '\0'};
+                *out++ = (char)strtol(hex, NULL, 16);
+                p += strlen(hex);
+                break;
+            }
+            default: *out++ = *p; break;
+        }
+    }
+    *out = '\0';
+    return out - s;
+}
+
+static bool runCommand(char *cmd, char *arg, int lineNo) {
+    if (strcmp(cmd, "wait") == 0) {
+        simRun(atoi(arg));
+    } else if (strcmp(cmd, "type") == 0) {
+        size_t len = unescape(arg);
+        for (size_t i = 0; i < len; i++) simKey(arg[i]);
+    } else if (strcmp(cmd, "key") == 0) {
+        static const struct { const char *name; char key; } keys[] = {
+            {"enter", '\r'}, {"esc", 0x1B}, {"tab", '\t'}, {"bs", '\b'}, {"space", ' '}
+        };
+        for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+            if (strcmp(arg, keys[i].name) == 0) {
+                simKey(keys[i].key);
+                return true;
+            }
+        }
+        fprintf(stderr, "sim: line %d: unknown key '%s'\n", lineNo, arg);
+        return false;
+    } else if (strcmp(cmd, "ctrl") == 0 && arg[0]) {
+        simKey(arg[0] & 0x1F);
+    } else if (strcmp(cmd, "rotate") == 0) {
+        simRotate(atoi(arg));
+    } else if (strcmp(cmd, "click") == 0) {
+        simButton(false);
+    } else if (strcmp(cmd, "hold") == 0) {
+        simButton(true);
+    } else if (strcmp(cmd, "print") == 0) {
+        unescape(arg);
+        terminalPrint(arg);
+        simStep();
+    } else if (strcmp(cmd, "resize") == 0) {
+        int cols = 0, rows = 0;
+        if (sscanf(arg, "%d %d", &cols, &rows) != 2 || cols <= 0 || rows <= 0 ||
+            !terminalResize(cols, rows)) {
+            fprintf(stderr, "sim: line %d: bad size '%s'\n", lineNo, arg);
+            return false;
+        }
+        sessionResize();
+        simStep();
+    } else if (strcmp(cmd, "pan") == 0) {
+        terminalPan(atoi(arg));
+        simStep();
+    } else if (strcmp(cmd, "connect") == 0) {
+        connectToServer();
+    } else if (strcmp(cmd, "disconnect") == 0) {
+        disconnectSession();
+    } else if (strcmp(cmd, "snap") == 0 && arg[0]) {
+        simSnap(arg);
+    } else {
+        fprintf(stderr, "sim: line %d: unknown command '%s'\n", lineNo, cmd);
+        return false;
+    }
+    return true;
+}
+
+static bool runScript(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "sim: cannot open %s\n", path);
+        return false;
+    }
+    char line[512];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        lineNo++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *cmd = line + strspn(line, " \t");
+        if (*cmd == '\0' || *cmd == '#') continue;
+        char *arg = cmd + strcspn(cmd, " \t");
+        if (*arg) {
+            *arg++ = '\0';
+            arg += strspn(arg, " \t");
+        }
+        ok = runCommand(cmd, arg, lineNo);
+    }
+    fclose(f);
+    return ok;
+}
+
+static void simPump(uint32_t ms) {
+    simRun(ms);
+}
+
+// One connect / bulk / UI / disconnect cycle per iteration
+static bool simSoak(uint32_t count) {
+    soakBegin();
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t start = millis();
+        connectToServer();
+        if (!sessionOpen) {
+            soakConnectFailed();
+        } else {
+            soakRecord(SOAK_CONNECT_MS, millis() - start);
+            sshSendData(SIM_SOAK_BULK_CMD, strlen(SIM_SOAK_BULK_CMD));
+            uint32_t lastBytes = pipelineStats.renderBytes;
+            uint32_t quietSince = millis();
+            while (millis() - start < SIM_SOAK_BULK_MS && millis() - quietSince < SIM_SOAK_QUIET_MS) {
+                simStep();
+                if (pipelineStats.renderBytes != lastBytes) {
+                    lastBytes = pipelineStats.renderBytes;
+                    quietSince = millis();
+                }
+            }
+        }
+
+        soakExerciseUi(simPump);
+        disconnectSession();
+        simRun(SIM_SETTLE_MS);
+        soakSampleMemory();
+        if (!soakEndIteration()) break;
+    }
+    soakPrintSummary();
+    return soakFailure() == NULL;
+}
+
+// Hashes are only comparable under the LVGL release that drew them
+static bool loadGolden(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return true;  // First run: everything is unknown
+    char name[128];
+    unsigned long long hash;
+    char line[256];
+    int major, minor, patch;
+    bool sameLvgl = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "# lvgl %d.%d.%d", &major, &minor, &patch) == 3) {
+            sameLvgl = major == LVGL_VERSION_MAJOR && minor == LVGL_VERSION_MINOR &&
+                       patch == LVGL_VERSION_PATCH;
+        }
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%127s %llx", name, &hash) == 2) golden[name] = hash;
+    }
+    fclose(f);
+    if (sameLvgl) return true;
+
+    golden.clear();
+    if (updateGolden) return true;
+    fprintf(stderr, "sim: %s is not from LVGL %d.%d.%d; check the UI, then rerun with --update-golden\n",
+            path, LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH);
+    return false;
+}
+
+static bool saveGolden(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# T-LoRa Pager simulator golden framebuffer hashes (sim --update-golden)\n");
+    fprintf(f, "# lvgl %d.%d.%d\n", LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH);
+    for (const auto &g : golden) {
+        fprintf(f, "%s %016llx\n", g.first.c_str(), (unsigned long long)g.second);
+    }
+    fclose(f);
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: sim [--script FILE] [--replay FILE | --ssh [USER@]HOST[:PORT] |\n"
+                    "            --mosh [USER@]HOST[:PORT]]\n"
+                    "           [--golden FILE [--update-golden]] [--frames CSV] [--dump DIR] [--no-intro]\n"
+                    "           [--soak N] [--config DIR]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *scriptPath = NULL;
+    const char *framesPath = NULL;
+    bool intro = true;
+    uint32_t soakCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--script") == 0 && v) {
+            scriptPath = argv[++i];
+        } else if (strcmp(a, "--replay") == 0 && v) {
+            session = &simReplayTransport;
+            sessionTarget = argv[++i];
+        } else if (strcmp(a, "--ssh") == 0 && v) {
+            session = &simSshTransport;
+            sessionTarget = argv[++i];
+            realtime = true;
+        } else if (strcmp(a, "--mosh") == 0 && v) {
+            session = &moshTransport;
+            sessionTarget = simMoshServer(argv[++i]);
+            realtime = true;
+        } else if (strcmp(a, "--golden") == 0 && v) {
+            goldenPath = argv[++i];
+        } else if (strcmp(a, "--update-golden") == 0) {
+            updateGolden = true;
+        } else if (strcmp(a, "--frames") == 0 && v) {
+            framesPath = argv[++i];
+        } else if (strcmp(a, "--dump") == 0 && v) {
+            dumpDir = argv[++i];
+        } else if (strcmp(a, "--no-intro") == 0) {
+            intro = false;
+        } else if (strcmp(a, "--soak") == 0 && v) {
+            soakCount = atoi(argv[++i]);
+        } else if (strcmp(a, "--config") == 0 && v) {
+            simSetFsRoot(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    FILE *frames = NULL;
+    if (framesPath) {
+        frames = fopen(framesPath, "w");
+        if (!frames) {
+            fprintf(stderr, "sim: cannot write %s\n", framesPath);
+            return 2;
+        }
+    }
+    if (goldenPath && !loadGolden(goldenPath)) return 2;
+    simSetRealtime(realtime);
+
+    // As setup(), minus the hardware
+    configLoader.begin();
+    size_t allocsBefore = simHeapAllocCount();
+    configLoader.loadConfig();
+    size_t configAllocs = simHeapAllocCount() - allocsBefore;
+    lv_init();
+    lv_tick_set_cb(millis);
+    simDisplayBegin();
+    simDisplayLogFrames(frames);
+    settingsInit();
+    statsReset();
+    if (intro) showIntro();
+    setupTerminalUI();
+    applyTheme();
+    settingsUIInit();
+    terminalPrint("T-LoRa Pager Terminal v1.0\n");
+    terminalPrint("Press rotary button for settings\n\n");
+    updateStatus("IP: 10.0.0.2");
+
+    bool ok = true;
+    bool soakOk = true;
+    int64_t t0 = esp_timer_get_time();
+    if (soakCount > 0) {
+        soakOk = simSoak(soakCount);
+    } else if (scriptPath) {
+        ok = runScript(scriptPath);
+    } else {
+        connectToServer();
+        simRun(SIM_DEFAULT_RUN_MS);
+        simRun(SIM_SETTLE_MS);
+        simSnap("final");
+    }
+    int64_t wallUs = esp_timer_get_time() - t0;
+    if (session == &moshTransport && sessionOpen) moshPrintStatus();
+    disconnectSession();
+
+    printf("ran %.1fs virtual in %.1fs\n", millis() / 1000.0, wallUs / 1e6);
+    simDisplayPrintSummary();
+    printf("terminal: %u bytes parsed in %.1fms, %u text updates, %u bells\n",
+           (unsigned)pipelineStats.renderBytes, pipelineStats.renderUs / 1000.0,
+           (unsigned)pipelineStats.renderFrames, (unsigned)bells);
+    printf("haptics: %u, audio: %u\n", (unsigned)instance.drv.runs, (unsigned)audioPlayed);
+    printf("config: %s, %u heap allocations while loading\n",
+           configLoader.getConfig().gateway.host.c_str(), (unsigned)configAllocs);
+    printf("snapshots: %d ok, %d new, %d failed\n", snapsOk, snapsNew, snapsFailed);
+
+    if (frames) fclose(frames);
+    if (goldenPath && updateGolden && !saveGolden(goldenPath)) {
+        fprintf(stderr, "sim: cannot write %s\n", goldenPath);
+    }
+    if (!ok) return 2;
+    return snapsFailed > 0 || !soakOk ? 1 : 0;
+}
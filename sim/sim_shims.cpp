@@ -0,0 +1,204 @@
+/**
+ * Shim Globals for the T-LoRa Pager Simulator
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <LilyGoLib.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SimSerial Serial;
+SimEsp ESP;
+SimWiFi WiFi;
+SimBoard instance;
+SimLittleFS LittleFS;
+
+static uint32_t simNowMs = 0;
+static bool simRealtime = false;
+
+uint32_t millis() {
+    return simNowMs;
+}
+
+uint32_t micros() {
+    return simNowMs * 1000;
+}
+
+// Blocking on the device: the clock moves, nothing else runs
+void delay(uint32_t ms) {
+    if (simRealtime) usleep(ms * 1000);
+    simAdvance(ms);
+}
+
+void simAdvance(uint32_t ms) {
+    simNowMs += ms;
+}
+
+void simSetRealtime(bool on) {
+    simRealtime = on;
+}
+
+void SimEsp::restart() {
+    printf("restart requested, exiting\n");
+    exit(0);
+}
+
+static const struct {
+    const char *ssid;
+    int32_t rssi;
+} simNetworks[] = {
+    {"sim-net", -55},
+    {"office-5g", -67},
+    {"guest", -81},
+};
+#define SIM_NETWORK_COUNT (int)(sizeof(simNetworks) / sizeof(simNetworks[0]))
+
+int16_t SimWiFi::scanNetworks(bool async) {
+    _scanState = async ? WIFI_SCAN_RUNNING : SIM_NETWORK_COUNT;
+    return _scanState;
+}
+
+// An async scan finishes on the first poll
+int16_t SimWiFi::scanComplete() {
+    int16_t state = _scanState;
+    if (_scanState == WIFI_SCAN_RUNNING) _scanState = SIM_NETWORK_COUNT;
+    return state;
+}
+
+String SimWiFi::SSID(uint8_t i) {
+    return String(i < SIM_NETWORK_COUNT ? simNetworks[i].ssid : "");
+}
+
+int32_t SimWiFi::RSSI(uint8_t i) {
+    return i < SIM_NETWORK_COUNT ? simNetworks[i].rssi : 0;
+}
+
+static const char *simFsDir = "data";
+
+const char *simFsRoot() {
+    return simFsDir;
+}
+
+void simSetFsRoot(const char *dir) {
+    simFsDir = dir;
+}
+
+// Directories and files only for reading; "w" is not supported
+File SimLittleFS::open(const char *path, const char *mode) {
+    std::string full = std::string(simFsDir) + path;
+    struct stat st;
+    if (strcmp(mode, "r") != 0 || stat(full.c_str(), &st) != 0) return File();
+    return File(full, S_ISDIR(st.st_mode));
+}
+
+File File::openNextFile() {
+    if (!_entries) return File();
+    struct dirent *e;
+    while ((e = readdir(_entries.get())) != NULL) {
+        std::string path = _path + "/" + e->d_name;
+        struct stat st;
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0 && stat(path.c_str(), &st) == 0) {
+            return File(path, S_ISDIR(st.st_mode));
+        }
+    }
+    return File();
+}
+
+// Live malloc() blocks, for heap_caps_get_info(), and every allocation
+// made, for simHeapAllocCount(): the allocator entry points are replaced
+// and forward to glibc's
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+}
+
+static size_t simLiveBlocks = 0;
+static size_t simAllocCount = 0;
+static size_t simMinFree = SIM_HEAP_SIZE;
+
+extern "C" void *malloc(size_t size) {
+    void *p = __libc_malloc(size);
+    simAllocCount++;
+    if (p) simLiveBlocks++;
+    return p;
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+    void *p = __libc_calloc(n, size);
+    simAllocCount++;
+    if (p) simLiveBlocks++;
+    return p;
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    void *p = __libc_realloc(ptr, size);
+    if (ptr == NULL || size > 0) simAllocCount++;
+    if (ptr == NULL && p) simLiveBlocks++;
+    if (ptr && size == 0) simLiveBlocks--;
+    return p;
+}
+
+extern "C" void free(void *ptr) {
+    if (ptr && simLiveBlocks > 0) simLiveBlocks--;
+    __libc_free(ptr);
+}
+
+size_t simHeapAllocCount() {
+    return simAllocCount;
+}
+
+static size_t simFree() {
+    size_t used = mallinfo2().uordblks;
+    size_t avail = used < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - used : 0;
+    if (avail < simMinFree) simMinFree = avail;
+    return avail;
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+    if (caps & MALLOC_CAP_SPIRAM) {
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? NULL : p;
+    }
+    return malloc(size);
+}
+
+void *ps_malloc(size_t size) {
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+}
+
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps) {
+    memset(info, 0, sizeof(*info));
+    if (caps & MALLOC_CAP_SPIRAM) return;
+    info->total_free_bytes = simFree();
+    info->total_allocated_bytes = SIM_HEAP_SIZE - info->total_free_bytes;
+    info->largest_free_block = info->total_free_bytes;
+    info->minimum_free_bytes = simMinFree;
+    info->allocated_blocks = simLiveBlocks;
+    info->total_blocks = simLiveBlocks;
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? 0 : SIM_HEAP_SIZE;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? 0 : simFree();
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    if (caps & MALLOC_CAP_SPIRAM) return 0;
+    simFree();
+    return simMinFree;
+}
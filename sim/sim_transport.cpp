@@ -0,0 +1,259 @@
+/**
+ * Simulator Session Transports Implementation
+ */
+
+#include "sim_transport.h"
+#include "ssh_transport.h"
+#include "dns_cache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <arpa/inet.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <esp_timer.h>
+
+// Replay
+
+static char *replayData = NULL;
+static size_t replayLen = 0;
+static size_t replayPos = 0;
+
+static bool replayOpen(void *target, uint16_t cols, uint16_t rows) {
+    const char *path = (const char *)target;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        Serial.printf("Replay: cannot open %s\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    replayData = (char *)malloc(len > 0 ? len : 1);
+    replayLen = replayData ? fread(replayData, 1, len, f) : 0;
+    replayPos = 0;
+    fclose(f);
+    Serial.printf("Replay: %s, %u bytes (%ux%u)\n", path, (unsigned)replayLen, cols, rows);
+    return replayData != NULL;
+}
+
+// Stays open when the recording ends, so the last screen can be checked
+static int replayRead(char *buf, int room) {
+    size_t n = min(replayLen - replayPos, (size_t)min(room, SIM_REPLAY_CHUNK));
+    memcpy(buf, replayData + replayPos, n);
+    replayPos += n;
+    return (int)n;
+}
+
+static int replayWrite(const char *data, int len) {
+    (void)data;
+    return len;
+}
+
+static bool replayIsOpen() {
+    return replayData != NULL;
+}
+
+static void replayClose() {
+    free(replayData);
+    replayData = NULL;
+}
+
+const SessionTransport_t simReplayTransport = {
+    "replay",
+    replayOpen,
+    replayRead,
+    replayWrite,
+    replayIsOpen,
+    NULL,
+    NULL,
+    replayClose
+};
+
+// ssh client in a PTY
+
+static int ptyFd = -1;
+static pid_t sshPid = -1;
+
+static bool sshOpen(void *target, uint16_t cols, uint16_t rows) {
+    char dest[128];
+    char port[8] = "22";
+    snprintf(dest, sizeof(dest), "%s", (const char *)target);
+    char *colon = strrchr(dest, ':');
+    if (colon) {
+        *colon = '\0';
+        snprintf(port, sizeof(port), "%s", colon + 1);
+    }
+
+    struct winsize ws = {};
+    ws.ws_col = cols;
+    ws.ws_row = rows;
+    sshPid = forkpty(&ptyFd, NULL, NULL, &ws);
+    if (sshPid < 0) {
+        Serial.printf("SSH: forkpty failed (%d)\n", errno);
+        return false;
+    }
+    if (sshPid == 0) {
+        // Same terminal type the device asks for
+        setenv("TERM", "xterm", 1);
+        execlp("ssh", "ssh", "-tt", "-p", port, dest, (char *)NULL);
+        _exit(127);
+    }
+    fcntl(ptyFd, F_SETFL, fcntl(ptyFd, F_GETFL) | O_NONBLOCK);
+    Serial.printf("SSH: ssh -p %s %s (pid %d, %ux%u)\n", port, dest, (int)sshPid, cols, rows);
+    return true;
+}
+
+static int sshRead(char *buf, int room) {
+    if (ptyFd < 0) return -1;
+    ssize_t n = read(ptyFd, buf, room);
+    if (n > 0) return (int)n;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+    return -1;  // EIO once ssh exits
+}
+
+static int sshWrite(const char *data, int len) {
+    if (ptyFd < 0) return -1;
+    return (int)write(ptyFd, data, len);
+}
+
+static bool sshIsOpen() {
+    if (sshPid > 0 && waitpid(sshPid, NULL, WNOHANG) == sshPid) sshPid = -1;
+    return ptyFd >= 0 && sshPid > 0;
+}
+
+// ssh forwards the SIGWINCH as a window-change
+static void sshResize(uint16_t cols, uint16_t rows) {
+    if (ptyFd < 0) return;
+    struct winsize ws = {};
+    ws.ws_col = cols;
+    ws.ws_row = rows;
+    ioctl(ptyFd, TIOCSWINSZ, &ws);
+}
+
+static void sshClose() {
+    if (sshPid > 0) {
+        kill(sshPid, SIGHUP);
+        waitpid(sshPid, NULL, 0);
+        sshPid = -1;
+    }
+    if (ptyFd >= 0) {
+        close(ptyFd);
+        ptyFd = -1;
+    }
+}
+
+const SessionTransport_t simSshTransport = {
+    "ssh",
+    sshOpen,
+    sshRead,
+    sshWrite,
+    sshIsOpen,
+    NULL,
+    sshResize,
+    sshClose
+};
+
+// mosh bootstrap: what mosh_transport.cpp takes from the SSH transport
+// and the DNS cache
+
+static ServerConfig_t moshServer;
+
+ServerConfig_t *simMoshServer(const char *spec) {
+    char dest[sizeof(moshServer.host) + sizeof(moshServer.username)];
+    snprintf(dest, sizeof(dest), "%s", spec);
+    memset(&moshServer, 0, sizeof(moshServer));
+    moshServer.port = 22;
+
+    char *host = dest;
+    char *at = strchr(dest, '@');
+    if (at) {
+        *at = '\0';
+        snprintf(moshServer.username, sizeof(moshServer.username), "%s", dest);
+        host = at + 1;
+    }
+    char *colon = strrchr(host, ':');
+    if (colon) {
+        *colon = '\0';
+        moshServer.port = (uint16_t)atoi(colon + 1);
+    }
+    snprintf(moshServer.host, sizeof(moshServer.host), "%s", host);
+    return &moshServer;
+}
+
+// The system ssh client (keys and agent, no password), stdout only.
+// Timed in real time: the virtual clock does not move while this blocks.
+bool sshExec(ServerConfig_t *server, const char *command, const char *until,
+             char *out, size_t cap, uint32_t timeoutMs) {
+    char port[8], dest[sizeof(server->host) + sizeof(server->username) + 1];
+    snprintf(port, sizeof(port), "%u", server->port);
+    if (strlen(server->username) > 0) {
+        snprintf(dest, sizeof(dest), "%s@%s", server->username, server->host);
+    } else {
+        snprintf(dest, sizeof(dest), "%s", server->host);
+    }
+
+    int fds[2];
+    if (cap == 0 || pipe(fds) != 0) return false;
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execlp("ssh", "ssh", "-n", "-o", "BatchMode=yes", "-p", port, dest, command, (char *)NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+
+    // stdout until EOF, or until a whole line containing `until`
+    size_t len = 0;
+    out[0] = '\0';
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeoutMs * 1000;
+    while (len + 1 < cap && esp_timer_get_time() < deadline) {
+        struct pollfd p = {fds[0], POLLIN, 0};
+        if (poll(&p, 1, 100) <= 0) continue;
+        ssize_t n = read(fds[0], out + len, cap - 1 - len);
+        if (n <= 0) break;
+        len += n;
+        out[len] = '\0';
+        const char *hit = until ? strstr(out, until) : NULL;
+        if (hit && strchr(hit, '\n')) break;
+    }
+    close(fds[0]);
+
+    // mosh-server has detached by now; ssh itself may still be waiting
+    int status = 0;
+    if (waitpid(pid, &status, WNOHANG) == 0) {
+        kill(pid, SIGTERM);
+        waitpid(pid, &status, 0);
+        return true;
+    }
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 255) {
+        Serial.printf("SSH: exec failed: ssh -p %s %s\n", port, dest);
+        return false;
+    }
+    return true;
+}
+
+DnsAnswer_t dnsResolve(const char *host, uint32_t *ip) {
+    struct in_addr addr;
+    if (inet_pton(AF_INET, host, &addr) == 1) {
+        *ip = addr.s_addr;
+        return DNS_ANSWER_LITERAL;
+    }
+    struct addrinfo hints = {}, *res = NULL;
+    hints.ai_family = AF_INET;
+    if (getaddrinfo(host, NULL, &hints, &res) != 0 || res == NULL) return DNS_ANSWER_NONE;
+    *ip = ((struct sockaddr_in *)res->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(res);
+    return DNS_ANSWER_RESOLVED;
+}
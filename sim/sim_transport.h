@@ -0,0 +1,31 @@
+/**
+ * Simulator Session Transports
+ * Stand-ins for the SSH transport, with the same SessionTransport_t shape
+ *
+ * replay: plays back a recording of terminal output (for example from
+ *   `script -q -c 'ssh host' out.log` or `ssh -tt host | tee out.log`),
+ *   SIM_REPLAY_CHUNK bytes per loop step. Keystrokes are dropped.
+ * ssh: runs the system ssh client against a real (local) sshd in a
+ *   pseudo-terminal of the pager's size; target is [user@]host[:port].
+ * mosh: the pager's own SSP client (mosh_transport.cpp) against a real
+ *   mosh-server. Its bootstrap sshExec() runs `mosh-server new` through
+ *   the system ssh client, and dnsResolve() is the host's resolver;
+ *   target is simMoshServer([user@]host[:port]).
+ */
+
+#ifndef SIM_TRANSPORT_H
+#define SIM_TRANSPORT_H
+
+#include "session.h"
+#include "settings.h"
+
+#define SIM_REPLAY_CHUNK 512  // matches the SSH read size
+
+extern const SessionTransport_t simReplayTransport;
+extern const SessionTransport_t simSshTransport;
+
+// Server for moshTransport from [user@]host[:port] (the SSH port for
+// the bootstrap; one static config)
+ServerConfig_t *simMoshServer(const char *spec);
+
+#endif // SIM_TRANSPORT_H
@@ -0,0 +1,215 @@
+/**
+ * Host Test for the Config Loader
+ * loadConfig() and loadGatewayProfile() on the simulator's LittleFS and
+ * NVS shims, counting heap allocations with its malloc hook
+ *
+ * - tests/fixtures/littlefs: main config, theme, keymap and profile with
+ *   every value off its default, comments, entities, character
+ *   references, hex numbers and single-quoted attributes; each value is
+ *   checked, and neither load may allocate
+ * - files written at run time: a missing file, an unterminated root, a
+ *   field too long for its buffer, and files of exactly CONFIG_FILE_MAX
+ *   and one byte more
+ *
+ * The count needs the simulator's malloc(), so no sanitizers (they bring
+ * their own):
+ *
+ *   g++ -std=gnu++17 -O2 -Wall -I sim/shims -I tlorapager_terminal tests/config_loader_test.cpp \
+ *       tlorapager_terminal/ConfigLoader.cpp tlorapager_terminal/xml_reader.cpp sim/sim_shims.cpp \
+ *       -o config_loader_test
+ *   ./config_loader_test
+ *
+ * Run from the repository root. Exits non-zero if any check fails.
+ */
+
+#include "ConfigLoader.h"
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FIXTURE_ROOT "tests/fixtures/littlefs"
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static int failures = 0;
+static char scratch[64];
+
+static void check(bool ok, const char *what, int line) {
+    if (!ok) {
+        printf("FAIL line %d: %s\n", line, what);
+        failures++;
+    }
+}
+
+static bool rgbIs(const uint8_t *rgb, uint8_t r, uint8_t g, uint8_t b) {
+    return rgb[0] == r && rgb[1] == g && rgb[2] == b;
+}
+
+static const KeyMapping *findKey(const KeymapConfig &km, const char *id) {
+    for (int i = 0; i < km.keyCount; i++) {
+        if (km.keys[i].id == id) return &km.keys[i];
+    }
+    return NULL;
+}
+
+static void checkFixtures() {
+    simSetFsRoot(FIXTURE_ROOT);
+    ConfigLoader loader;
+    loader.begin();
+
+    size_t before = simHeapAllocCount();
+    bool ok = loader.loadConfig();
+    size_t allocs = simHeapAllocCount() - before;
+    CHECK(ok);
+    CHECK(allocs == 0);
+    if (allocs) printf("  loadConfig() made %u heap allocations\n", (unsigned)allocs);
+
+    const TLoraConfig &c = loader.getConfig();
+    CHECK(c.wifi.ssid == "lab & bench");
+    CHECK(c.wifi.password == "p<ass");
+    CHECK(c.gateway.host == "ttyd.example.net");
+    CHECK(c.gateway.port == 8443);
+    CHECK(c.gateway.path == "/term/ws");
+    CHECK(c.gateway.useSsl);
+    CHECK(c.gateway.sni == "ttyd.example.net");
+    CHECK(c.gateway.connectTimeoutMs == 6000);
+    CHECK(c.gateway.reconnectDelayMs == 1000);
+    CHECK(c.gateway.maxReconnectDelayMs == 10000);
+    CHECK(c.gateway.pingIntervalMs == 20000);
+    CHECK(c.terminal.cols == 53 && c.terminal.rows == 16);
+    CHECK(c.terminal.scrollbackLines == 200);
+    CHECK(c.terminal.fontName == "terminus" && c.terminal.fontSize == 12);
+    CHECK(c.input.keyboard.debounceMs == 20);
+    CHECK(!c.input.encoder.pressSendsEnter);
+    CHECK(c.input.encoder.rotateScrollEnabled);
+    CHECK(c.input.encoder.rotateStepLines == 3);
+    CHECK(!c.haptics.enabled);
+    CHECK(c.haptics.keypressMs == 0);
+    CHECK(c.haptics.bellMs == 40);   // Not a number: default kept
+    CHECK(!c.ui.statusBarEnabled);
+    CHECK(c.logging.serialBaud == 921600);
+    CHECK(c.logging.debugWebSocket);
+    CHECK(!c.logging.debugKeyboard);
+
+    CHECK(c.theme.name == "amber");
+    CHECK(rgbIs(c.theme.colors.fg, 255, 176, 0));
+    CHECK(rgbIs(c.theme.colors.statusBg, 30, 20, 0));
+    CHECK(c.theme.cursor.style == "underline" && !c.theme.cursor.blink);
+    CHECK(!c.theme.selectionInvert);
+    CHECK(c.theme.statusBar.heightPx == 20 && !c.theme.statusBar.icons);
+    CHECK(!c.theme.statusBar.showWebSocket && c.theme.statusBar.showModifiers);
+
+    CHECK(c.keymap.name == "us_qwerty");
+    CHECK(c.keymap.keyCount == 9);   // The commented-out key is not one
+    CHECK(c.keymap.modifierCount == 2);
+    const KeyMapping *k;
+    CHECK((k = findKey(c.keymap, "COMMA")) && k->normal == "," && k->shift == "<" && k->code == -1);
+    CHECK((k = findKey(c.keymap, "QUOTE")) && k->normal == "'" && k->shift == "\"");
+    CHECK((k = findKey(c.keymap, "AMP")) && k->normal == "&" && k->shift == "\xE2\x86\x92");
+    CHECK((k = findKey(c.keymap, "ENTER")) && k->code == 13 && k->normal == "");
+    CHECK((k = findKey(c.keymap, "ESC")) && k->code == 27);
+    CHECK(c.keymap.modifiers[1].id == "CTRL" && c.keymap.modifiers[1].mode == "sticky");
+
+    // The first load saves the name to NVS; reloading it, as
+    // setup() does, must not allocate either
+    char last[CONFIG_NAME_LEN + 1];
+    CHECK(!loader.getLastProfile(last, sizeof(last)));
+    CHECK(loader.loadGatewayProfile("lan"));
+    CHECK(loader.getLastProfile(last, sizeof(last)) && strcmp(last, "lan") == 0);
+    before = simHeapAllocCount();
+    ok = loader.loadGatewayProfile(last);
+    allocs = simHeapAllocCount() - before;
+    CHECK(ok);
+    CHECK(allocs == 0);
+    if (allocs) printf("  loadGatewayProfile() made %u heap allocations\n", (unsigned)allocs);
+    CHECK(c.gateway.host == "192.168.1.42" && c.gateway.port == 7681);
+    CHECK(!c.gateway.useSsl && c.gateway.sni == "");
+    CHECK(!loader.loadGatewayProfile("missing"));
+}
+
+static void writeFile(const char *name, const char *text, size_t len) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/config/%s", scratch, name);
+    FILE *f = fopen(path, "wb");
+    fwrite(text, 1, len, f);
+    fclose(f);
+}
+
+// Main config with the gateway host given, padded with a comment to len
+// bytes (if longer)
+static void writeConfig(const char *name, const char *host, size_t len) {
+    static char doc[CONFIG_FILE_MAX + 2];
+    int n = snprintf(doc, sizeof(doc),
+                     "<tloraTerminalConfig><gateway><host>%s</host></gateway>"
+                     "<ui><themeFile></themeFile></ui><input><keyboard><keymapFile></keymapFile>"
+                     "</keyboard></input></tloraTerminalConfig>\n<!--",
+                     host);
+    while ((size_t)n + 4 < len) doc[n++] = '-';
+    memcpy(doc + n, "-->\n", 4);
+    n += 4;
+    writeFile(name, doc, n);
+}
+
+static void checkBadFiles() {
+    snprintf(scratch, sizeof(scratch), "/tmp/config_loader_test.XXXXXX");
+    if (mkdtemp(scratch) == NULL) {
+        printf("FAIL: no scratch directory\n");
+        failures++;
+        return;
+    }
+    char dir[96];
+    snprintf(dir, sizeof(dir), "%s/config", scratch);
+    mkdir(dir, 0755);
+    simSetFsRoot(scratch);
+
+    char longHost[CONFIG_HOST_LEN + 20];
+    memset(longHost, 'h', sizeof(longHost) - 1);
+    longHost[sizeof(longHost) - 1] = '\0';
+
+    static const char unterminated[] = "<tloraTerminalConfig><gateway><host>x</host></gateway>";
+    writeFile("unterminated.xml", unterminated, sizeof(unterminated) - 1);
+    writeConfig("long.xml", longHost, 0);
+    writeConfig("max.xml", "max.example", CONFIG_FILE_MAX);
+    writeConfig("over.xml", "over.example", CONFIG_FILE_MAX + 1);
+
+    ConfigLoader loader;
+    loader.begin();
+    const TLoraConfig &c = loader.getConfig();
+
+    // Missing: defaults
+    CHECK(loader.loadConfig("/config/missing.xml"));
+    CHECK(c.gateway.host == "192.168.1.100");
+
+    CHECK(!loader.loadConfig("/config/unterminated.xml"));
+    CHECK(c.gateway.host == "192.168.1.100");
+
+    // Too long: truncated to the field
+    CHECK(loader.loadConfig("/config/long.xml"));
+    CHECK(c.gateway.host.length() == CONFIG_HOST_LEN);
+    CHECK(strncmp(c.gateway.host.c_str(), longHost, CONFIG_HOST_LEN) == 0);
+
+    CHECK(loader.loadConfig("/config/max.xml"));
+    CHECK(c.gateway.host == "max.example");
+
+    // Over the buffer: not read at all, the config is unchanged
+    CHECK(loader.loadConfig("/config/over.xml"));
+    CHECK(c.gateway.host == "max.example");
+
+    static const char *const names[] = {"unterminated.xml", "long.xml", "max.xml", "over.xml"};
+    for (const char *name : names) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        unlink(path);
+    }
+    rmdir(dir);
+    rmdir(scratch);
+}
+
+int main() {
+    checkFixtures();
+    checkBadFiles();
+    printf("config loader: %s\n", failures ? "FAILED" : "fixtures parsed, no heap allocations");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * Host Test for AES-128-OCB3
+ * ocbEncrypt()/ocbDecrypt() against the RFC 7253 Appendix A vectors
+ *
+ * - the six sample results without associated data (mosh sends none):
+ *   0, 8, 16, 24, 32 and 40 bytes, so whole blocks, a partial last
+ *   block and both at once
+ * - each one decrypts back, and fails with the output zeroed when one
+ *   bit of the tag or of the ciphertext is flipped, or it is cut short
+ * - round trips of every length 0-300 under random keys and nonces
+ *
+ * AES comes from the simulator's mbedTLS shim, on OpenSSL:
+ *
+ *   g++ -std=gnu++17 -O2 -Wall -fsanitize=address,undefined -I sim/shims -I tlorapager_terminal \
+ *       tests/ocb_aes_test.cpp tlorapager_terminal/ocb_aes.cpp -lcrypto -o ocb_aes_test
+ *   ./ocb_aes_test
+ *
+ * Exits non-zero if any check fails.
+ */
+
+#include "ocb_aes.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define OCB_TEST_MAX 300
+#define OCB_TEST_ROUNDS 4    // Random keys per length
+
+typedef struct {
+    uint8_t nonceLast;     // N = BBAA998877665544332211xx
+    const char *cipher;    // C (ciphertext || tag), hex
+} OcbVector_t;
+
+// K = 000102030405060708090A0B0C0D0E0F, A = "", P = 000102... of len(C) - 16
+static const OcbVector_t vectors[] = {
+    {0x00, "785407BFFFC8AD9EDCC5520AC9111EE6"},
+    {0x03, "45DD69F8F5AAE72414054CD1F35D82760B2CD00D2F99BFA9"},
+    {0x06, "5CE88EC2E0692706A915C00AEB8B2396F40E1C743F52436BDF06D8FA1ECA343D"},
+    {0x09, "221BD0DE7FA6FE993ECCD769460A0AF2D6CDED0C395B1C3CE725F32494B9F914"
+           "D85C0B1EB38357FF"},
+    {0x0C, "2942BFC773BDA23CABC6ACFD9BFD5835BD300F0973792EF46040C53F1432BCDF"
+           "B5E1DDE3BC18A5F840B52E653444D5DF"},
+    {0x0F, "4412923493C57D5DE0D700F753CCE0D1D2D95060122E9F15A5DDBFC5787E50B5"
+           "CC55EE507BCB084E479AD363AC366B95A98CA5F3000B1479"},
+};
+
+static uint32_t rngState = 0x9E3779B9;
+static int failures = 0;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static size_t fromHex(const char *hex, uint8_t *out) {
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2) {
+        unsigned byte;
+        sscanf(hex, "%2x", &byte);
+        out[n++] = (uint8_t)byte;
+    }
+    return n;
+}
+
+static void fail(const char *what, int vector, size_t len) {
+    printf("FAIL: %s (vector %d, %u bytes)\n", what, vector, (unsigned)len);
+    failures++;
+}
+
+// ocbDecrypt() must refuse the packet and leave no plaintext behind
+static void checkRejected(OcbKey_t *key, const uint8_t *nonce, const uint8_t *packet,
+                          size_t len, const char *what, int vector) {
+    uint8_t out[OCB_TEST_MAX + OCB_TAG_LEN];
+    memset(out, 0xA5, sizeof(out));
+    if (ocbDecrypt(key, nonce, packet, len, out)) {
+        fail(what, vector, len);
+        return;
+    }
+    size_t plain = len >= OCB_TAG_LEN ? len - OCB_TAG_LEN : 0;
+    for (size_t i = 0; i < plain; i++) {
+        if (out[i] != 0) {
+            fail("plaintext left after a failed tag check", vector, len);
+            return;
+        }
+    }
+}
+
+static void checkTampering(OcbKey_t *key, const uint8_t *nonce, const uint8_t *packet,
+                           size_t len, int vector) {
+    uint8_t bad[OCB_TEST_MAX + OCB_TAG_LEN];
+
+    // Every bit of the tag
+    for (size_t bit = 0; bit < OCB_TAG_LEN * 8; bit++) {
+        memcpy(bad, packet, len);
+        bad[len - OCB_TAG_LEN + bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        checkRejected(key, nonce, bad, len, "tag with a flipped bit accepted", vector);
+    }
+
+    // First and last ciphertext byte
+    if (len > OCB_TAG_LEN) {
+        memcpy(bad, packet, len);
+        bad[0] ^= 0x01;
+        checkRejected(key, nonce, bad, len, "ciphertext with a flipped bit accepted", vector);
+        memcpy(bad, packet, len);
+        bad[len - OCB_TAG_LEN - 1] ^= 0x80;
+        checkRejected(key, nonce, bad, len, "ciphertext with a flipped bit accepted", vector);
+    }
+
+    // Truncated, and too short to hold a tag
+    checkRejected(key, nonce, packet, len - 1, "truncated packet accepted", vector);
+    checkRejected(key, nonce, packet, OCB_TAG_LEN - 1, "packet shorter than a tag accepted", vector);
+
+    // Another nonce
+    uint8_t other[OCB_NONCE_LEN];
+    memcpy(other, nonce, sizeof(other));
+    other[0] ^= 0x01;
+    checkRejected(key, other, packet, len, "packet accepted under another nonce", vector);
+}
+
+static void checkVectors() {
+    uint8_t secret[OCB_KEY_LEN];
+    for (int i = 0; i < OCB_KEY_LEN; i++) secret[i] = (uint8_t)i;
+    OcbKey_t key;
+    if (!ocbInit(&key, secret)) {
+        fail("ocbInit", -1, 0);
+        return;
+    }
+
+    for (int v = 0; v < (int)(sizeof(vectors) / sizeof(vectors[0])); v++) {
+        uint8_t nonce[OCB_NONCE_LEN] = {0xBB, 0xAA, 0x99, 0x88, 0x77, 0x66,
+                                        0x55, 0x44, 0x33, 0x22, 0x11, vectors[v].nonceLast};
+        uint8_t expected[64 + OCB_TAG_LEN];
+        size_t len = fromHex(vectors[v].cipher, expected);
+        size_t plainLen = len - OCB_TAG_LEN;
+        uint8_t plain[64];
+        for (size_t i = 0; i < plainLen; i++) plain[i] = (uint8_t)i;
+
+        uint8_t packet[64 + OCB_TAG_LEN];
+        ocbEncrypt(&key, nonce, plain, plainLen, packet);
+        if (memcmp(packet, expected, len) != 0) {
+            fail("ciphertext or tag differs from RFC 7253", v, plainLen);
+            continue;
+        }
+
+        uint8_t out[64];
+        if (!ocbDecrypt(&key, nonce, packet, len, out) || memcmp(out, plain, plainLen) != 0) {
+            fail("RFC 7253 vector does not decrypt", v, plainLen);
+            continue;
+        }
+        checkTampering(&key, nonce, packet, len, v);
+    }
+    ocbFree(&key);
+}
+
+static void checkRoundTrips() {
+    uint8_t plain[OCB_TEST_MAX], packet[OCB_TEST_MAX + OCB_TAG_LEN], out[OCB_TEST_MAX];
+    for (int round = 0; round < OCB_TEST_ROUNDS && failures == 0; round++) {
+        uint8_t secret[OCB_KEY_LEN];
+        for (int i = 0; i < OCB_KEY_LEN; i++) secret[i] = (uint8_t)rng();
+        OcbKey_t key;
+        ocbInit(&key, secret);
+
+        for (size_t len = 0; len <= OCB_TEST_MAX && failures == 0; len++) {
+            uint8_t nonce[OCB_NONCE_LEN];
+            for (int i = 0; i < OCB_NONCE_LEN; i++) nonce[i] = (uint8_t)rng();
+            for (size_t i = 0; i < len; i++) plain[i] = (uint8_t)rng();
+
+            ocbEncrypt(&key, nonce, plain, len, packet);
+            if (!ocbDecrypt(&key, nonce, packet, len + OCB_TAG_LEN, out) ||
+                memcmp(out, plain, len) != 0) {
+                fail("round trip", -1, len);
+            }
+            packet[rng() % (len + OCB_TAG_LEN)] ^= (uint8_t)(1 << (rng() % 8));
+            checkRejected(&key, nonce, packet, len + OCB_TAG_LEN, "random bit flip accepted", -1);
+        }
+        ocbFree(&key);
+    }
+}
+
+int main() {
+    checkVectors();
+    checkRoundTrips();
+    printf("ocb aes: %s\n", failures ? "FAILED" : "RFC 7253 vectors ok, tampering rejected");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * Host Test for the Render Kernels
+ * The word-at-a-time kernels against their scalar references, bit for bit
+ *
+ * benchRenderSelfTest() does the same on the device with random inputs;
+ * this covers the cases exhaustively on the host:
+ * - every alpha value 0-255, as a whole run and alone among skipped
+ *   (alpha < 4) or solid (255) quads
+ * - random and extreme colours over random backgrounds
+ * - every length 0-67 and random longer ones, from both an aligned and
+ *   a misaligned (odd pixel) start, with guard pixels either side
+ *
+ *   g++ -std=gnu++17 -O2 -Wall -fsanitize=address,undefined -I tlorapager_terminal \
+ *       tests/render_kernels_test.cpp tlorapager_terminal/render_kernels.cpp -o render_kernels_test
+ *   ./render_kernels_test
+ *
+ * The blend reference itself is checked against a copy of LVGL 9's
+ * lv_color_16_16_mix(), which the hooked renderer replaces.
+ *
+ * Exits non-zero on the first mismatch.
+ */
+
+#include "render_kernels.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RK_TEST_PIXELS 1024
+#define RK_TEST_GUARD 4              // Pixels either side that must not change
+#define RK_TEST_SHORT 68             // Every length below this
+#define RK_TEST_RANDOM_ROUNDS 2000
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+// Word-aligned so offset 0 is aligned and offset 1 is not
+static uint32_t bufA[(RK_TEST_PIXELS + 2 * RK_TEST_GUARD) / 2 + 1];
+static uint32_t bufB[(RK_TEST_PIXELS + 2 * RK_TEST_GUARD) / 2 + 1];
+static uint8_t alpha[RK_TEST_PIXELS];
+static int failures = 0;
+
+static uint16_t *pixA() { return (uint16_t *)bufA; }
+static uint16_t *pixB() { return (uint16_t *)bufB; }
+
+static void randomBackground() {
+    for (int i = 0; i < RK_TEST_PIXELS + 2 * RK_TEST_GUARD; i++) {
+        pixA()[i] = pixB()[i] = (uint16_t)rng();
+    }
+}
+
+static bool same(const char *kernel, size_t offset, size_t count, const char *what) {
+    if (memcmp(bufA, bufB, sizeof(bufA)) == 0) return true;
+    for (int i = 0; i < RK_TEST_PIXELS + 2 * RK_TEST_GUARD; i++) {
+        if (pixA()[i] != pixB()[i]) {
+            printf("%s mismatch (%s, offset %u, count %u): pixel %d is %04x, reference %04x\n",
+                   kernel, what, (unsigned)offset, (unsigned)count, i - RK_TEST_GUARD - (int)offset,
+                   pixA()[i], pixB()[i]);
+            break;
+        }
+    }
+    failures++;
+    return false;
+}
+
+static bool checkFill(size_t offset, size_t count, uint16_t color) {
+    randomBackground();
+    rkFill565(pixA() + RK_TEST_GUARD + offset, count, color);
+    rkFill565Ref(pixB() + RK_TEST_GUARD + offset, count, color);
+    return same("fill", offset, count, "random");
+}
+
+static bool checkSwap(size_t offset, size_t count) {
+    randomBackground();
+    rkSwap565(pixA() + RK_TEST_GUARD + offset, count);
+    rkSwap565Ref(pixB() + RK_TEST_GUARD + offset, count);
+    return same("swap", offset, count, "random");
+}
+
+static bool checkBlend(size_t offset, size_t count, uint16_t color, const char *what) {
+    randomBackground();
+    rkBlendA8To565(pixA() + RK_TEST_GUARD + offset, alpha, count, color);
+    rkBlendA8To565Ref(pixB() + RK_TEST_GUARD + offset, alpha, count, color);
+    return same("blend", offset, count, what);
+}
+
+// Glyph-like coverage: transparent gaps and solid strokes of random
+// length, with antialiased edges between them
+static void randomAlpha(size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        uint32_t r = rng();
+        size_t run = 1 + (r >> 24) % 9;
+        for (; run > 0 && i < count; run--, i++) {
+            uint32_t e = rng();
+            switch (r & 3) {
+            case 0: alpha[i] = (uint8_t)(e & 3); break;   // Weight 0
+            case 1: alpha[i] = 255; break;
+            default: alpha[i] = (uint8_t)e; break;
+            }
+        }
+    }
+}
+
+// LVGL 9's lv_color_16_16_mix() (lv_color_op.h), as LVGL's software
+// renderer blends a glyph when no hook is installed
+static uint16_t lvglMix(uint16_t c1, uint16_t c2, uint8_t mix) {
+    if (mix == 255) return c1;
+    if (mix == 0) return c2;
+    if (c1 == c2) return c1;
+
+    uint16_t ret;
+    mix = (uint32_t)((uint32_t)mix + 4) >> 3;
+    uint32_t bg = (uint32_t)(c2 | ((uint32_t)c2 << 16)) & 0x7E0F81F;
+    uint32_t fg = (uint32_t)(c1 | ((uint32_t)c1 << 16)) & 0x7E0F81F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    ret = (uint16_t)(result >> 16) | result;
+    return ret;
+}
+
+// The reference against LVGL: every alpha over random and extreme
+// colour pairs
+static void checkLvglMix() {
+    static const uint16_t extremes[] = {0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x8410, 0x7BEF};
+    const size_t n = sizeof(extremes) / sizeof(extremes[0]);
+    for (int pair = 0; pair < 4000 && failures == 0; pair++) {
+        uint16_t fg = pair < (int)(n * n) ? extremes[pair % n] : (uint16_t)rng();
+        uint16_t bg = pair < (int)(n * n) ? extremes[pair / n] : (uint16_t)rng();
+        for (int a = 0; a < 256; a++) {
+            uint16_t px = bg;
+            uint8_t cov = (uint8_t)a;
+            rkBlendA8To565Ref(&px, &cov, 1, fg);
+            if (px != lvglMix(fg, bg, cov)) {
+                printf("blend reference differs from LVGL: fg %04x bg %04x alpha %d: %04x, LVGL %04x\n",
+                       fg, bg, a, px, lvglMix(fg, bg, cov));
+                failures++;
+                break;
+            }
+        }
+    }
+}
+
+int main() {
+    checkLvglMix();
+
+    // Every alpha value, whole runs and alone among skipped or solid quads
+    static const uint8_t around[] = {0, 3, 255};
+    for (int a = 0; a < 256 && failures == 0; a++) {
+        for (size_t offset = 0; offset < 2; offset++) {
+            size_t count = RK_TEST_SHORT + offset;
+            memset(alpha, a, count);
+            checkBlend(offset, count, (uint16_t)rng(), "one alpha value");
+            for (size_t at = 0; at < 12; at++) {
+                memset(alpha, around[at % 3], count);
+                alpha[at] = (uint8_t)a;
+                checkBlend(offset, count, (uint16_t)rng(), "alpha among skipped or solid quads");
+            }
+        }
+    }
+    // Extreme colours against every alpha value
+    static const uint16_t extremes[] = {0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F};
+    for (size_t c = 0; c < sizeof(extremes) / sizeof(extremes[0]) && failures == 0; c++) {
+        for (int i = 0; i < 256; i++) alpha[i] = (uint8_t)i;
+        checkBlend(1, 256, extremes[c], "alpha ramp");
+        checkFill(0, RK_TEST_SHORT, extremes[c]);
+        checkFill(1, RK_TEST_SHORT, extremes[c]);
+    }
+
+    // Every short length, aligned and misaligned
+    for (size_t count = 0; count < RK_TEST_SHORT && failures == 0; count++) {
+        for (size_t offset = 0; offset < 2; offset++) {
+            checkFill(offset, count, (uint16_t)rng());
+            checkSwap(offset, count);
+            randomAlpha(count);
+            checkBlend(offset, count, (uint16_t)rng(), "random alpha");
+        }
+    }
+
+    // Random lengths up to the buffer
+    for (int round = 0; round < RK_TEST_RANDOM_ROUNDS && failures == 0; round++) {
+        size_t offset = rng() & 1;
+        size_t count = rng() % (RK_TEST_PIXELS - 1);
+        checkFill(offset, count, (uint16_t)rng());
+        checkSwap(offset, count);
+        randomAlpha(count);
+        checkBlend(offset, count, (uint16_t)rng(), "random alpha");
+    }
+
+    printf("render kernels: %s\n", failures ? "FAILED" : "bit-exact");
+    return failures ? 1 : 0;
+}
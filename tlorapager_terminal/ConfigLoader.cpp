@@ -1,13 +1,65 @@
 #include "ConfigLoader.h"
+#include "xml_reader.h"
 #include <LittleFS.h>
-#include <tinyxml2.h>
+#include <esp_heap_caps.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+// Where LittleFS.begin() mounts the filesystem in the VFS
+#ifndef CONFIG_FS_ROOT
+#define CONFIG_FS_ROOT "/littlefs"
+#endif
+
+#define CONFIG_LOG_MAX 128
+
+// The file being parsed: one at a time, from the UI loop only
+static char fileBuf[CONFIG_FILE_MAX + 1];
+
+// Serial.printf() heap-allocates lines of 64 characters or more
+static void configLog(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+static void configLog(const char* fmt, ...) {
+    char line[CONFIG_LOG_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    Serial.print(line);
+}
 
-using namespace tinyxml2;
+// Element text into a fixed-capacity field, warning if it did not fit
+template <size_t N>
+static void setText(InlineString<N>& field, const XmlElement& el) {
+    char text[N];
+    bool fits = el.text(text, sizeof(text));
+    field = text;
+    if (!fits) {
+        char name[CONFIG_NAME_LEN + 1];
+        el.name(name, sizeof(name));
+        configLog("[ConfigLoader] <%s> longer than %u characters, truncated\n",
+            name, (unsigned)field.capacity());
+    }
+}
+
+// Attribute into a fixed-capacity field; false if there is none
+template <size_t N>
+static bool setAttribute(InlineString<N>& field, const XmlElement& el, const char* name) {
+    char text[N];
+    if (!el.attribute(name, text, sizeof(text))) return false;
+    field = text;
+    return true;
+}
+
+static size_t heapBlocksAllocated() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    return info.allocated_blocks;
+}
 
 // Global instance
 ConfigLoader configLoader;
 
-ConfigLoader::ConfigLoader() : _loaded(false), _nvsOpen(false) {
+ConfigLoader::ConfigLoader() : _loaded(false), _nvsOpen(false), _loadHeapBlocks(0) {
     setDefaults();
 }
 
@@ -108,29 +160,55 @@ bool ConfigLoader::begin() {
     return true;
 }
 
-String ConfigLoader::readFile(const char* path) {
-    File file = LittleFS.open(path, "r");
-    if (!file) {
-        Serial.printf("[ConfigLoader] Failed to open: %s\n", path);
-        return "";
-    }
-
-    String content = file.readString();
-    file.close();
-    return content;
+// Straight through the VFS: Arduino's File allocates a path copy, a
+// shared handle and a stdio buffer on every open
+size_t ConfigLoader::readFile(const char* path) {
+    char fsPath[CONFIG_FS_PATH_MAX];
+    if ((size_t)snprintf(fsPath, sizeof(fsPath), "%s%s", CONFIG_FS_ROOT, path) >= sizeof(fsPath)) {
+        configLog("[ConfigLoader] Path too long: %s\n", path);
+        return 0;
+    }
+    int fd = open(fsPath, O_RDONLY);
+    if (fd < 0) {
+        configLog("[ConfigLoader] Failed to open: %s\n", path);
+        return 0;
+    }
+
+    // One byte more than fits, to tell a full buffer from a cut-off file
+    size_t len = 0;
+    ssize_t n;
+    while (len <= CONFIG_FILE_MAX && (n = read(fd, fileBuf + len, CONFIG_FILE_MAX + 1 - len)) > 0) {
+        len += n;
+    }
+    close(fd);
+    if (len > CONFIG_FILE_MAX) {
+        configLog("[ConfigLoader] %s is larger than %d bytes, ignored\n", path, CONFIG_FILE_MAX);
+        return 0;
+    }
+    fileBuf[len] = '\0';
+    return len;
 }
 
 bool ConfigLoader::loadConfig(const char* path) {
-    Serial.printf("[ConfigLoader] Loading config: %s\n", path);
+    size_t blocksBefore = heapBlocksAllocated();
+    bool ok = loadConfigFiles(path);
+
+    // Parse buffers are freed by now: anything left is held by the config
+    _loadHeapBlocks = (int)heapBlocksAllocated() - (int)blocksBefore;
+    return ok;
+}
+
+bool ConfigLoader::loadConfigFiles(const char* path) {
+    configLog("[ConfigLoader] Loading config: %s\n", path);
 
-    String xml = readFile(path);
-    if (xml.isEmpty()) {
+    size_t len = readFile(path);
+    if (len == 0) {
         Serial.println("[ConfigLoader] Config file empty or not found, using defaults");
         _loaded = true;
         return true;
     }
 
-    if (!parseMainConfig(xml.c_str())) {
+    if (!parseMainConfig(fileBuf, len)) {
         Serial.println("[ConfigLoader] Failed to parse main config");
         return false;
     }
@@ -155,119 +233,112 @@ bool ConfigLoader::loadConfig(const char* path) {
     return true;
 }
 
-bool ConfigLoader::parseMainConfig(const char* xml) {
-    XMLDocument doc;
-    if (doc.Parse(xml) != XML_SUCCESS) {
-        Serial.printf("[ConfigLoader] XML parse error: %s\n", doc.ErrorStr());
-        return false;
-    }
-
-    XMLElement* root = doc.FirstChildElement("tloraTerminalConfig");
+bool ConfigLoader::parseMainConfig(const char* xml, size_t len) {
+    XmlElement root = xmlRoot(xml, len, "tloraTerminalConfig");
     if (!root) {
-        Serial.println("[ConfigLoader] Missing root element");
+        Serial.println("[ConfigLoader] Missing or unterminated root element");
         return false;
     }
 
     // Parse wifi section
-    XMLElement* wifi = root->FirstChildElement("wifi");
+    XmlElement wifi = root.firstChild("wifi");
     if (wifi) {
-        XMLElement* el;
-        if ((el = wifi->FirstChildElement("ssid"))) _config.wifi.ssid = el->GetText() ? el->GetText() : "";
-        if ((el = wifi->FirstChildElement("password"))) _config.wifi.password = el->GetText() ? el->GetText() : "";
+        XmlElement el;
+        if ((el = wifi.firstChild("ssid"))) setText(_config.wifi.ssid, el);
+        if ((el = wifi.firstChild("password"))) setText(_config.wifi.password, el);
     }
 
     // Parse gateway section
-    XMLElement* gateway = root->FirstChildElement("gateway");
+    XmlElement gateway = root.firstChild("gateway");
     if (gateway) {
-        XMLElement* el;
-        if ((el = gateway->FirstChildElement("host"))) _config.gateway.host = el->GetText() ? el->GetText() : "";
-        if ((el = gateway->FirstChildElement("port"))) el->QueryUnsignedText((unsigned int*)&_config.gateway.port);
-        if ((el = gateway->FirstChildElement("path"))) _config.gateway.path = el->GetText() ? el->GetText() : "";
-        if ((el = gateway->FirstChildElement("useSsl"))) _config.gateway.useSsl = strcmp(el->GetText(), "true") == 0;
-        if ((el = gateway->FirstChildElement("sni"))) _config.gateway.sni = el->GetText() ? el->GetText() : "";
-        if ((el = gateway->FirstChildElement("connectTimeoutMs"))) el->QueryUnsignedText(&_config.gateway.connectTimeoutMs);
-        if ((el = gateway->FirstChildElement("reconnectDelayMs"))) el->QueryUnsignedText(&_config.gateway.reconnectDelayMs);
-        if ((el = gateway->FirstChildElement("maxReconnectDelayMs"))) el->QueryUnsignedText(&_config.gateway.maxReconnectDelayMs);
-        if ((el = gateway->FirstChildElement("pingIntervalMs"))) el->QueryUnsignedText(&_config.gateway.pingIntervalMs);
+        XmlElement el;
+        unsigned int tmp;
+        if ((el = gateway.firstChild("host"))) setText(_config.gateway.host, el);
+        if ((el = gateway.firstChild("port")) && el.queryUnsigned(&tmp)) _config.gateway.port = tmp;
+        if ((el = gateway.firstChild("path"))) setText(_config.gateway.path, el);
+        if ((el = gateway.firstChild("useSsl"))) _config.gateway.useSsl = el.textIs("true");
+        if ((el = gateway.firstChild("sni"))) setText(_config.gateway.sni, el);
+        if ((el = gateway.firstChild("connectTimeoutMs")) && el.queryUnsigned(&tmp)) _config.gateway.connectTimeoutMs = tmp;
+        if ((el = gateway.firstChild("reconnectDelayMs")) && el.queryUnsigned(&tmp)) _config.gateway.reconnectDelayMs = tmp;
+        if ((el = gateway.firstChild("maxReconnectDelayMs")) && el.queryUnsigned(&tmp)) _config.gateway.maxReconnectDelayMs = tmp;
+        if ((el = gateway.firstChild("pingIntervalMs")) && el.queryUnsigned(&tmp)) _config.gateway.pingIntervalMs = tmp;
     }
 
     // Parse terminal section
-    XMLElement* terminal = root->FirstChildElement("terminal");
+    XmlElement terminal = root.firstChild("terminal");
     if (terminal) {
-        XMLElement* el;
+        XmlElement el;
         unsigned int tmp;
-        if ((el = terminal->FirstChildElement("cols"))) { el->QueryUnsignedText(&tmp); _config.terminal.cols = tmp; }
-        if ((el = terminal->FirstChildElement("rows"))) { el->QueryUnsignedText(&tmp); _config.terminal.rows = tmp; }
-        if ((el = terminal->FirstChildElement("scrollbackLines"))) { el->QueryUnsignedText(&tmp); _config.terminal.scrollbackLines = tmp; }
+        if ((el = terminal.firstChild("cols")) && el.queryUnsigned(&tmp)) _config.terminal.cols = tmp;
+        if ((el = terminal.firstChild("rows")) && el.queryUnsigned(&tmp)) _config.terminal.rows = tmp;
+        if ((el = terminal.firstChild("scrollbackLines")) && el.queryUnsigned(&tmp)) _config.terminal.scrollbackLines = tmp;
 
-        XMLElement* font = terminal->FirstChildElement("font");
+        XmlElement font = terminal.firstChild("font");
         if (font) {
-            if ((el = font->FirstChildElement("name"))) _config.terminal.fontName = el->GetText() ? el->GetText() : "";
-            if ((el = font->FirstChildElement("size"))) { el->QueryUnsignedText(&tmp); _config.terminal.fontSize = tmp; }
+            if ((el = font.firstChild("name"))) setText(_config.terminal.fontName, el);
+            if ((el = font.firstChild("size")) && el.queryUnsigned(&tmp)) _config.terminal.fontSize = tmp;
         }
     }
 
     // Parse input section
-    XMLElement* input = root->FirstChildElement("input");
+    XmlElement input = root.firstChild("input");
     if (input) {
-        XMLElement* keyboard = input->FirstChildElement("keyboard");
+        XmlElement keyboard = input.firstChild("keyboard");
         if (keyboard) {
-            XMLElement* el;
+            XmlElement el;
             unsigned int tmp;
-            if ((el = keyboard->FirstChildElement("keymapFile"))) _config.input.keyboard.keymapFile = el->GetText() ? el->GetText() : "";
-            if ((el = keyboard->FirstChildElement("debounceMs"))) { el->QueryUnsignedText(&tmp); _config.input.keyboard.debounceMs = tmp; }
+            if ((el = keyboard.firstChild("keymapFile"))) setText(_config.input.keyboard.keymapFile, el);
+            if ((el = keyboard.firstChild("debounceMs")) && el.queryUnsigned(&tmp)) _config.input.keyboard.debounceMs = tmp;
         }
 
-        XMLElement* encoder = input->FirstChildElement("encoder");
+        XmlElement encoder = input.firstChild("encoder");
         if (encoder) {
-            XMLElement* el;
+            XmlElement el;
             unsigned int tmp;
-            if ((el = encoder->FirstChildElement("pressSendsEnter"))) _config.input.encoder.pressSendsEnter = strcmp(el->GetText(), "true") == 0;
-            if ((el = encoder->FirstChildElement("rotateScrollEnabled"))) _config.input.encoder.rotateScrollEnabled = strcmp(el->GetText(), "true") == 0;
-            if ((el = encoder->FirstChildElement("rotateStepLines"))) { el->QueryUnsignedText(&tmp); _config.input.encoder.rotateStepLines = tmp; }
+            if ((el = encoder.firstChild("pressSendsEnter"))) _config.input.encoder.pressSendsEnter = el.textIs("true");
+            if ((el = encoder.firstChild("rotateScrollEnabled"))) _config.input.encoder.rotateScrollEnabled = el.textIs("true");
+            if ((el = encoder.firstChild("rotateStepLines")) && el.queryUnsigned(&tmp)) _config.input.encoder.rotateStepLines = tmp;
         }
     }
 
     // Parse haptics section
-    XMLElement* haptics = root->FirstChildElement("haptics");
+    XmlElement haptics = root.firstChild("haptics");
     if (haptics) {
-        XMLElement* el;
+        XmlElement el;
         unsigned int tmp;
-        if ((el = haptics->FirstChildElement("enabled"))) _config.haptics.enabled = strcmp(el->GetText(), "true") == 0;
-        if ((el = haptics->FirstChildElement("keypressMs"))) { el->QueryUnsignedText(&tmp); _config.haptics.keypressMs = tmp; }
-        if ((el = haptics->FirstChildElement("bellMs"))) { el->QueryUnsignedText(&tmp); _config.haptics.bellMs = tmp; }
+        if ((el = haptics.firstChild("enabled"))) _config.haptics.enabled = el.textIs("true");
+        if ((el = haptics.firstChild("keypressMs")) && el.queryUnsigned(&tmp)) _config.haptics.keypressMs = tmp;
+        if ((el = haptics.firstChild("bellMs")) && el.queryUnsigned(&tmp)) _config.haptics.bellMs = tmp;
     }
 
     // Parse ui section
-    XMLElement* ui = root->FirstChildElement("ui");
+    XmlElement ui = root.firstChild("ui");
     if (ui) {
-        XMLElement* el;
-        if ((el = ui->FirstChildElement("statusBarEnabled"))) _config.ui.statusBarEnabled = strcmp(el->GetText(), "true") == 0;
-        if ((el = ui->FirstChildElement("themeFile"))) _config.ui.themeFile = el->GetText() ? el->GetText() : "";
+        XmlElement el;
+        if ((el = ui.firstChild("statusBarEnabled"))) _config.ui.statusBarEnabled = el.textIs("true");
+        if ((el = ui.firstChild("themeFile"))) setText(_config.ui.themeFile, el);
     }
 
     // Parse logging section
-    XMLElement* logging = root->FirstChildElement("logging");
+    XmlElement logging = root.firstChild("logging");
     if (logging) {
-        XMLElement* el;
-        if ((el = logging->FirstChildElement("serialBaud"))) el->QueryUnsignedText(&_config.logging.serialBaud);
-        if ((el = logging->FirstChildElement("debugWebSocket"))) _config.logging.debugWebSocket = strcmp(el->GetText(), "true") == 0;
-        if ((el = logging->FirstChildElement("debugKeyboard"))) _config.logging.debugKeyboard = strcmp(el->GetText(), "true") == 0;
+        XmlElement el;
+        unsigned int tmp;
+        if ((el = logging.firstChild("serialBaud")) && el.queryUnsigned(&tmp)) _config.logging.serialBaud = tmp;
+        if ((el = logging.firstChild("debugWebSocket"))) _config.logging.debugWebSocket = el.textIs("true");
+        if ((el = logging.firstChild("debugKeyboard"))) _config.logging.debugKeyboard = el.textIs("true");
     }
 
     return true;
 }
 
 bool ConfigLoader::loadGatewayProfile(const char* profileName) {
-    String path = String("/config/profiles/") + profileName + ".xml";
-    Serial.printf("[ConfigLoader] Loading profile: %s\n", path.c_str());
+    char path[CONFIG_PATH_LEN + 1];
+    snprintf(path, sizeof(path), "/config/profiles/%s.xml", profileName);
+    configLog("[ConfigLoader] Loading profile: %s\n", path);
 
-    String xml = readFile(path.c_str());
-    if (xml.isEmpty()) {
-        return false;
-    }
-
-    if (!parseGatewayProfile(xml.c_str())) {
+    size_t len = readFile(path);
+    if (len == 0 || !parseGatewayProfile(fileBuf, len)) {
         return false;
     }
 
@@ -279,30 +350,26 @@ bool ConfigLoader::loadGatewayProfile(const char* profileName) {
     return true;
 }
 
-bool ConfigLoader::parseGatewayProfile(const char* xml) {
-    XMLDocument doc;
-    if (doc.Parse(xml) != XML_SUCCESS) {
-        return false;
-    }
-
-    XMLElement* root = doc.FirstChildElement("gatewayProfile");
+bool ConfigLoader::parseGatewayProfile(const char* xml, size_t len) {
+    XmlElement root = xmlRoot(xml, len, "gatewayProfile");
     if (!root) {
         return false;
     }
 
     // Gateway settings are inside <gateway> container
-    XMLElement* gateway = root->FirstChildElement("gateway");
+    XmlElement gateway = root.firstChild("gateway");
     if (!gateway) {
         Serial.println("[ConfigLoader] Missing <gateway> element in profile");
         return false;
     }
 
-    XMLElement* el;
-    if ((el = gateway->FirstChildElement("host"))) _config.gateway.host = el->GetText() ? el->GetText() : "";
-    if ((el = gateway->FirstChildElement("port"))) el->QueryUnsignedText((unsigned int*)&_config.gateway.port);
-    if ((el = gateway->FirstChildElement("path"))) _config.gateway.path = el->GetText() ? el->GetText() : "";
-    if ((el = gateway->FirstChildElement("useSsl"))) _config.gateway.useSsl = strcmp(el->GetText(), "true") == 0;
-    if ((el = gateway->FirstChildElement("sni"))) _config.gateway.sni = el->GetText() ? el->GetText() : "";
+    XmlElement el;
+    unsigned int tmp;
+    if ((el = gateway.firstChild("host"))) setText(_config.gateway.host, el);
+    if ((el = gateway.firstChild("port")) && el.queryUnsigned(&tmp)) _config.gateway.port = tmp;
+    if ((el = gateway.firstChild("path"))) setText(_config.gateway.path, el);
+    if ((el = gateway.firstChild("useSsl"))) _config.gateway.useSsl = el.textIs("true");
+    if ((el = gateway.firstChild("sni"))) setText(_config.gateway.sni, el);
 
     return true;
 }
@@ -313,85 +380,78 @@ bool ConfigLoader::loadTheme() {
     }
 
     // Ensure path starts with /
-    String path = _config.ui.themeFile;
-    if (!path.startsWith("/")) {
-        path = "/" + path;
-    }
+    char path[CONFIG_PATH_LEN + 2];
+    snprintf(path, sizeof(path), "%s%s",
+        _config.ui.themeFile.startsWith("/") ? "" : "/", _config.ui.themeFile.c_str());
 
-    Serial.printf("[ConfigLoader] Loading theme: %s\n", path.c_str());
+    configLog("[ConfigLoader] Loading theme: %s\n", path);
 
-    String xml = readFile(path.c_str());
-    if (xml.isEmpty()) {
+    size_t len = readFile(path);
+    if (len == 0) {
         return false;
     }
 
-    return parseTheme(xml.c_str());
+    return parseTheme(fileBuf, len);
 }
 
-bool ConfigLoader::parseTheme(const char* xml) {
-    XMLDocument doc;
-    if (doc.Parse(xml) != XML_SUCCESS) {
-        return false;
-    }
-
-    XMLElement* root = doc.FirstChildElement("theme");
+bool ConfigLoader::parseTheme(const char* xml, size_t len) {
+    XmlElement root = xmlRoot(xml, len, "theme");
     if (!root) {
         return false;
     }
 
-    const char* name = root->Attribute("name");
-    if (name) _config.theme.name = name;
+    setAttribute(_config.theme.name, root, "name");
 
     // Parse colors
-    XMLElement* colors = root->FirstChildElement("colors");
+    XmlElement colors = root.firstChild("colors");
     if (colors) {
-        auto parseColor = [](XMLElement* el, uint8_t* rgb) {
+        auto parseColor = [](const XmlElement& el, uint8_t* rgb) {
             if (el) {
                 int r = 0, g = 0, b = 0;
-                el->QueryIntAttribute("r", &r);
-                el->QueryIntAttribute("g", &g);
-                el->QueryIntAttribute("b", &b);
+                el.queryIntAttribute("r", &r);
+                el.queryIntAttribute("g", &g);
+                el.queryIntAttribute("b", &b);
                 rgb[0] = r; rgb[1] = g; rgb[2] = b;
             }
         };
 
-        parseColor(colors->FirstChildElement("bg"), _config.theme.colors.bg);
-        parseColor(colors->FirstChildElement("fg"), _config.theme.colors.fg);
-        parseColor(colors->FirstChildElement("muted"), _config.theme.colors.muted);
-        parseColor(colors->FirstChildElement("ok"), _config.theme.colors.ok);
-        parseColor(colors->FirstChildElement("warn"), _config.theme.colors.warn);
-        parseColor(colors->FirstChildElement("err"), _config.theme.colors.err);
-        parseColor(colors->FirstChildElement("statusBg"), _config.theme.colors.statusBg);
-        parseColor(colors->FirstChildElement("statusFg"), _config.theme.colors.statusFg);
+        parseColor(colors.firstChild("bg"), _config.theme.colors.bg);
+        parseColor(colors.firstChild("fg"), _config.theme.colors.fg);
+        parseColor(colors.firstChild("muted"), _config.theme.colors.muted);
+        parseColor(colors.firstChild("ok"), _config.theme.colors.ok);
+        parseColor(colors.firstChild("warn"), _config.theme.colors.warn);
+        parseColor(colors.firstChild("err"), _config.theme.colors.err);
+        parseColor(colors.firstChild("statusBg"), _config.theme.colors.statusBg);
+        parseColor(colors.firstChild("statusFg"), _config.theme.colors.statusFg);
     }
 
     // Parse terminal section
-    XMLElement* terminal = root->FirstChildElement("terminal");
+    XmlElement terminal = root.firstChild("terminal");
     if (terminal) {
-        XMLElement* cursor = terminal->FirstChildElement("cursor");
+        XmlElement cursor = terminal.firstChild("cursor");
         if (cursor) {
-            XMLElement* el;
-            if ((el = cursor->FirstChildElement("style"))) _config.theme.cursor.style = el->GetText() ? el->GetText() : "";
-            if ((el = cursor->FirstChildElement("blink"))) _config.theme.cursor.blink = strcmp(el->GetText(), "true") == 0;
+            XmlElement el;
+            if ((el = cursor.firstChild("style"))) setText(_config.theme.cursor.style, el);
+            if ((el = cursor.firstChild("blink"))) _config.theme.cursor.blink = el.textIs("true");
         }
 
-        XMLElement* selection = terminal->FirstChildElement("selection");
+        XmlElement selection = terminal.firstChild("selection");
         if (selection) {
-            XMLElement* el;
-            if ((el = selection->FirstChildElement("invert"))) _config.theme.selectionInvert = strcmp(el->GetText(), "true") == 0;
+            XmlElement el;
+            if ((el = selection.firstChild("invert"))) _config.theme.selectionInvert = el.textIs("true");
         }
     }
 
     // Parse statusBar section
-    XMLElement* statusBar = root->FirstChildElement("statusBar");
+    XmlElement statusBar = root.firstChild("statusBar");
     if (statusBar) {
-        XMLElement* el;
+        XmlElement el;
         unsigned int tmp;
-        if ((el = statusBar->FirstChildElement("heightPx"))) { el->QueryUnsignedText(&tmp); _config.theme.statusBar.heightPx = tmp; }
-        if ((el = statusBar->FirstChildElement("icons"))) _config.theme.statusBar.icons = strcmp(el->GetText(), "true") == 0;
-        if ((el = statusBar->FirstChildElement("showWifi"))) _config.theme.statusBar.showWifi = strcmp(el->GetText(), "true") == 0;
-        if ((el = statusBar->FirstChildElement("showWebSocket"))) _config.theme.statusBar.showWebSocket = strcmp(el->GetText(), "true") == 0;
-        if ((el = statusBar->FirstChildElement("showModifiers"))) _config.theme.statusBar.showModifiers = strcmp(el->GetText(), "true") == 0;
+        if ((el = statusBar.firstChild("heightPx")) && el.queryUnsigned(&tmp)) _config.theme.statusBar.heightPx = tmp;
+        if ((el = statusBar.firstChild("icons"))) _config.theme.statusBar.icons = el.textIs("true");
+        if ((el = statusBar.firstChild("showWifi"))) _config.theme.statusBar.showWifi = el.textIs("true");
+        if ((el = statusBar.firstChild("showWebSocket"))) _config.theme.statusBar.showWebSocket = el.textIs("true");
+        if ((el = statusBar.firstChild("showModifiers"))) _config.theme.statusBar.showModifiers = el.textIs("true");
     }
 
     return true;
@@ -403,87 +463,72 @@ bool ConfigLoader::loadKeymap() {
     }
 
     // Ensure path starts with /
-    String path = _config.input.keyboard.keymapFile;
-    if (!path.startsWith("/")) {
-        path = "/" + path;
-    }
+    char path[CONFIG_PATH_LEN + 2];
+    snprintf(path, sizeof(path), "%s%s",
+        _config.input.keyboard.keymapFile.startsWith("/") ? "" : "/", _config.input.keyboard.keymapFile.c_str());
 
-    Serial.printf("[ConfigLoader] Loading keymap: %s\n", path.c_str());
+    configLog("[ConfigLoader] Loading keymap: %s\n", path);
 
-    String xml = readFile(path.c_str());
-    if (xml.isEmpty()) {
+    size_t len = readFile(path);
+    if (len == 0) {
         Serial.println("[ConfigLoader] Keymap file not found, using defaults");
         return false;
     }
 
-    return parseKeymap(xml.c_str());
+    return parseKeymap(fileBuf, len);
 }
 
-bool ConfigLoader::parseKeymap(const char* xml) {
-    XMLDocument doc;
-    if (doc.Parse(xml) != XML_SUCCESS) {
-        Serial.printf("[ConfigLoader] Keymap XML parse error: %s\n", doc.ErrorStr());
-        return false;
-    }
-
-    XMLElement* root = doc.FirstChildElement("keymap");
+bool ConfigLoader::parseKeymap(const char* xml, size_t len) {
+    XmlElement root = xmlRoot(xml, len, "keymap");
     if (!root) {
-        Serial.println("[ConfigLoader] Missing keymap root element");
+        Serial.println("[ConfigLoader] Missing or unterminated keymap root element");
         return false;
     }
 
-    const char* name = root->Attribute("name");
-    if (name) _config.keymap.name = name;
+    setAttribute(_config.keymap.name, root, "name");
 
     // Clear existing keys and modifiers
-    _config.keymap.keys.clear();
-    _config.keymap.modifiers.clear();
+    _config.keymap.keyCount = 0;
+    _config.keymap.modifierCount = 0;
 
     // Parse keys section
-    XMLElement* keys = root->FirstChildElement("keys");
+    XmlElement keys = root.firstChild("keys");
     if (keys) {
-        for (XMLElement* key = keys->FirstChildElement("key"); key; key = key->NextSiblingElement("key")) {
-            KeyMapping km;
+        for (XmlElement key = keys.firstChild("key"); key; key = key.nextSibling("key")) {
+            if (_config.keymap.keyCount == KEYMAP_MAX_KEYS) {
+                configLog("[ConfigLoader] Keymap has more than %d keys, rest ignored\n", KEYMAP_MAX_KEYS);
+                break;
+            }
+            KeyMapping& km = _config.keymap.keys[_config.keymap.keyCount++];
+            km = KeyMapping();
             km.code = -1;  // Default: not a control key
 
-            const char* id = key->Attribute("id");
-            const char* normal = key->Attribute("normal");
-            const char* shift = key->Attribute("shift");
-
-            if (id) km.id = id;
-            if (normal) km.normal = normal;
-            if (shift) km.shift = shift;
+            setAttribute(km.id, key, "id");
+            setAttribute(km.normal, key, "normal");
+            setAttribute(km.shift, key, "shift");
 
             // Check for code attribute (control keys)
-            int code = -1;
-            if (key->QueryIntAttribute("code", &code) == XML_SUCCESS) {
-                km.code = code;
-            }
-
-            _config.keymap.keys.push_back(km);
+            key.queryIntAttribute("code", &km.code);
         }
     }
 
     // Parse modifiers section
-    XMLElement* modifiers = root->FirstChildElement("modifiers");
+    XmlElement modifiers = root.firstChild("modifiers");
     if (modifiers) {
-        for (XMLElement* mod = modifiers->FirstChildElement("modifier"); mod; mod = mod->NextSiblingElement("modifier")) {
-            ModifierDef md;
+        for (XmlElement mod = modifiers.firstChild("modifier"); mod; mod = mod.nextSibling("modifier")) {
+            if (_config.keymap.modifierCount == KEYMAP_MAX_MODIFIERS) break;
+            ModifierDef& md = _config.keymap.modifiers[_config.keymap.modifierCount++];
+            md = ModifierDef();
 
-            const char* id = mod->Attribute("id");
-            const char* mode = mod->Attribute("mode");
-
-            if (id) md.id = id;
-            if (mode) md.mode = mode;
-
-            _config.keymap.modifiers.push_back(md);
+            setAttribute(md.id, mod, "id");
+            setAttribute(md.mode, mod, "mode");
         }
     }
 
-    Serial.printf("[ConfigLoader] Loaded keymap '%s': %d keys, %d modifiers\n",
+    configLog("[ConfigLoader] Loaded keymap '%s': %d keys, %d modifiers\n",
         _config.keymap.name.c_str(),
-        _config.keymap.keys.size(),
-        _config.keymap.modifiers.size());
+        _config.keymap.keyCount,
+        _config.keymap.modifierCount);
 
     return true;
 }
@@ -505,10 +550,12 @@ bool ConfigLoader::saveWifiToNvs(const String& ssid, const String& password) {
 bool ConfigLoader::loadWifiFromNvs() {
     if (!_nvsOpen) return false;
 
-    String ssid = _prefs.getString(NVS_WIFI_SSID, "");
-    String pass = _prefs.getString(NVS_WIFI_PASS, "");
+    char ssid[CONFIG_SSID_LEN + 1] = "";
+    char pass[CONFIG_PASS_LEN + 1] = "";
+    _prefs.getString(NVS_WIFI_SSID, ssid, sizeof(ssid));
+    _prefs.getString(NVS_WIFI_PASS, pass, sizeof(pass));
 
-    if (ssid.length() > 0) {
+    if (ssid[0]) {
         _config.wifi.ssid = ssid;
         _config.wifi.password = pass;
         Serial.println("[ConfigLoader] Wi-Fi credentials loaded from NVS");
@@ -518,15 +565,21 @@ bool ConfigLoader::loadWifiFromNvs() {
     return false;
 }
 
-bool ConfigLoader::saveLastProfile(const String& profileName) {
+bool ConfigLoader::saveLastProfile(const char* profileName) {
     if (!_nvsOpen) return false;
+
+    // Reloading the last profile is the usual case: no flash write
+    char saved[CONFIG_NAME_LEN + 1];
+    if (getLastProfile(saved, sizeof(saved)) && strcmp(saved, profileName) == 0) return true;
     _prefs.putString(NVS_LAST_PROFILE, profileName);
     return true;
 }
 
-String ConfigLoader::getLastProfile() {
-    if (!_nvsOpen) return "";
-    return _prefs.getString(NVS_LAST_PROFILE, "");
+bool ConfigLoader::getLastProfile(char* name, size_t cap) {
+    if (cap > 0) name[0] = '\0';
+    if (!_nvsOpen || cap == 0) return false;
+    _prefs.getString(NVS_LAST_PROFILE, name, cap);
+    return name[0] != '\0';
 }
 
 bool ConfigLoader::clearNvs() {
@@ -555,6 +608,31 @@ void ConfigLoader::listProfiles() {
     }
 }
 
+std::vector<String> ConfigLoader::profileHosts() {
+    std::vector<String> hosts;
+    File root = LittleFS.open("/config/profiles");
+    if (!root || !root.isDirectory()) {
+        return hosts;
+    }
+
+    File file = root.openNextFile();
+    while (file) {
+        String name = file.name();
+        if (!file.isDirectory() && name.endsWith(".xml")) {
+            char path[CONFIG_PATH_LEN + 1];
+            snprintf(path, sizeof(path), "/config/profiles/%s", name.c_str());
+            size_t len = readFile(path);
+            XmlElement host = xmlRoot(fileBuf, len, "gatewayProfile").firstChild("gateway").firstChild("host");
+            char text[CONFIG_HOST_LEN + 1];
+            if (host && host.text(text, sizeof(text)) && text[0]) {
+                hosts.push_back(text);
+            }
+        }
+        file = root.openNextFile();
+    }
+    return hosts;
+}
+
 void ConfigLoader::printConfig() {
     Serial.println("\n=== Current Configuration ===");
     Serial.printf("Wi-Fi SSID: %s\n", _config.wifi.ssid.c_str());
@@ -582,5 +660,8 @@ void ConfigLoader::printConfig() {
     Serial.printf("  Cursor: %s, blink=%s\n",
         _config.theme.cursor.style.c_str(),
         _config.theme.cursor.blink ? "yes" : "no");
+    Serial.println();
+    Serial.printf("Config: %u bytes inline, last load left %d heap blocks allocated\n",
+        (unsigned)sizeof(_config), _loadHeapBlocks);
     Serial.println("==============================\n");
 }
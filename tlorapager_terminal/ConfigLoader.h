@@ -4,19 +4,33 @@
 #include <Arduino.h>
 #include <Preferences.h>
 #include <vector>
-
-// Configuration structures
+#include "inline_string.h"
+
+// Field capacities (characters, excluding the NUL)
+#define CONFIG_SSID_LEN 32       // 802.11 limit
+#define CONFIG_PASS_LEN 64       // WPA2 passphrase limit
+#define CONFIG_HOST_LEN 63
+#define CONFIG_PATH_LEN 63       // URL path, file path
+#define CONFIG_NAME_LEN 31       // Theme, font, keymap names
+#define KEYMAP_ID_LEN 11         // "COMMA", "BACKSPACE"
+#define KEYMAP_TEXT_LEN 7        // Output of one key (escape sequences included)
+#define KEYMAP_MAX_KEYS 64
+#define KEYMAP_MAX_MODIFIERS 8
+#define CONFIG_FILE_MAX 8192     // Largest XML file read (one static buffer)
+#define CONFIG_FS_PATH_MAX 128   // VFS mount point plus a file path
+
+// Configuration structures (no heap: strings are inline, arrays fixed)
 struct WifiConfig {
-    String ssid;
-    String password;
+    InlineString<CONFIG_SSID_LEN + 1> ssid;
+    InlineString<CONFIG_PASS_LEN + 1> password;
 };
 
 struct GatewayConfig {
-    String host;
+    InlineString<CONFIG_HOST_LEN + 1> host;
     uint16_t port;
-    String path;
+    InlineString<CONFIG_PATH_LEN + 1> path;
     bool useSsl;
-    String sni;  // optional SNI for SSL
+    InlineString<CONFIG_HOST_LEN + 1> sni;  // optional SNI for SSL
     uint32_t connectTimeoutMs;
     uint32_t reconnectDelayMs;
     uint32_t maxReconnectDelayMs;
@@ -27,12 +41,12 @@ struct TerminalConfig {
     uint16_t cols;
     uint16_t rows;
     uint16_t scrollbackLines;
-    String fontName;
+    InlineString<CONFIG_NAME_LEN + 1> fontName;
     uint8_t fontSize;
 };
 
 struct KeyboardConfig {
-    String keymapFile;
+    InlineString<CONFIG_PATH_LEN + 1> keymapFile;
     uint8_t debounceMs;
 };
 
@@ -55,7 +69,7 @@ struct HapticsConfig {
 
 struct UiConfig {
     bool statusBarEnabled;
-    String themeFile;
+    InlineString<CONFIG_PATH_LEN + 1> themeFile;
 };
 
 struct LoggingConfig {
@@ -76,7 +90,7 @@ struct ThemeColors {
 };
 
 struct CursorConfig {
-    String style;  // block, underline, bar
+    InlineString<12> style;  // block, underline, bar
     bool blink;
 };
 
@@ -89,7 +103,7 @@ struct StatusBarConfig {
 };
 
 struct ThemeConfig {
-    String name;
+    InlineString<CONFIG_NAME_LEN + 1> name;
     ThemeColors colors;
     CursorConfig cursor;
     bool selectionInvert;
@@ -98,21 +112,23 @@ struct ThemeConfig {
 
 // Keymap structures
 struct KeyMapping {
-    String id;           // Key identifier (e.g., "A", "1", "COMMA")
-    String normal;       // Normal character output
-    String shift;        // Shifted character output
+    InlineString<KEYMAP_ID_LEN + 1> id;        // Key identifier (e.g., "A", "1", "COMMA")
+    InlineString<KEYMAP_TEXT_LEN + 1> normal;  // Normal character output
+    InlineString<KEYMAP_TEXT_LEN + 1> shift;   // Shifted character output
     int code;            // ASCII code for control keys (-1 if using normal/shift)
 };
 
 struct ModifierDef {
-    String id;           // Modifier name (e.g., "SHIFT", "CTRL")
-    String mode;         // "oneshot" or "sticky"
+    InlineString<KEYMAP_ID_LEN + 1> id;        // Modifier name (e.g., "SHIFT", "CTRL")
+    InlineString<KEYMAP_ID_LEN + 1> mode;      // "oneshot" or "sticky"
 };
 
 struct KeymapConfig {
-    String name;
-    std::vector<KeyMapping> keys;
-    std::vector<ModifierDef> modifiers;
+    InlineString<CONFIG_NAME_LEN + 1> name;
+    KeyMapping keys[KEYMAP_MAX_KEYS];
+    uint8_t keyCount;
+    ModifierDef modifiers[KEYMAP_MAX_MODIFIERS];
+    uint8_t modifierCount;
 };
 
 struct TLoraConfig {
@@ -135,7 +151,8 @@ public:
     // Initialize filesystem and NVS
     bool begin();
 
-    // Load main config from LittleFS XML
+    // Load main config from LittleFS XML (with its theme and keymap),
+    // without heap allocations in ConfigLoader itself
     bool loadConfig(const char* path = "/config/tlora_terminal_config.xml");
 
     // Load a gateway profile and merge into current config
@@ -150,13 +167,16 @@ public:
     // NVS operations for sensitive data
     bool saveWifiToNvs(const String& ssid, const String& password);
     bool loadWifiFromNvs();
-    bool saveLastProfile(const String& profileName);
-    String getLastProfile();
+    bool saveLastProfile(const char* profileName);
+    bool getLastProfile(char* name, size_t cap);  // false if none saved
     bool clearNvs();
 
     // List available profiles
     void listProfiles();
 
+    // Gateway host of every profile (for DNS prefetch)
+    std::vector<String> profileHosts();
+
     // Access loaded config
     const TLoraConfig& getConfig() const { return _config; }
     TLoraConfig& getConfigMutable() { return _config; }
@@ -172,18 +192,23 @@ private:
     Preferences _prefs;
     bool _loaded;
     bool _nvsOpen;
+    int _loadHeapBlocks;  // Heap blocks still allocated after the last loadConfig()
 
     // Set defaults
     void setDefaults();
 
-    // Helper to read file content
-    String readFile(const char* path);
+    // loadConfig() body: main config, Wi-Fi from NVS, theme, keymap
+    bool loadConfigFiles(const char* path);
+
+    // Read a file into the static file buffer (NUL-terminated); its
+    // length, 0 if missing, unreadable or larger than CONFIG_FILE_MAX
+    size_t readFile(const char* path);
 
-    // XML parsing helpers (using TinyXML2)
-    bool parseMainConfig(const char* xml);
-    bool parseGatewayProfile(const char* xml);
-    bool parseTheme(const char* xml);
-    bool parseKeymap(const char* xml);
+    // XML parsing helpers (xml_reader, in place)
+    bool parseMainConfig(const char* xml, size_t len);
+    bool parseGatewayProfile(const char* xml, size_t len);
+    bool parseTheme(const char* xml, size_t len);
+    bool parseKeymap(const char* xml, size_t len);
 
     // NVS namespace
     static constexpr const char* NVS_NAMESPACE = "tlora_cfg";
@@ -52,10 +52,10 @@ void setup() {
     configLoader.loadConfig("/config/tlora_terminal_config.xml");
 
     // Optional: Try loading last-used gateway profile
-    String lastProfile = configLoader.getLastProfile();
-    if (lastProfile.length() > 0) {
-        Serial.printf("Loading last profile: %s\n", lastProfile.c_str());
-        configLoader.loadGatewayProfile(lastProfile.c_str());
+    char lastProfile[CONFIG_NAME_LEN + 1];
+    if (configLoader.getLastProfile(lastProfile, sizeof(lastProfile))) {
+        Serial.printf("Loading last profile: %s\n", lastProfile);
+        configLoader.loadGatewayProfile(lastProfile);
     }
 
     // Debug: print loaded config
@@ -78,9 +78,9 @@ void setup() {
 
     // Build WebSocket URL using config
     String wsUrl = String(cfg.gateway.useSsl ? "wss://" : "ws://")
-                 + cfg.gateway.host
+                 + cfg.gateway.host.c_str()
                  + ":" + String(cfg.gateway.port)
-                 + cfg.gateway.path;
+                 + cfg.gateway.path.c_str();
 
     // ... rest of your setup
 }
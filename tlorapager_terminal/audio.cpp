@@ -0,0 +1,202 @@
+/**
+ * Audio Feedback Implementation
+ */
+
+#include "audio.h"
+#include "settings.h"
+#include <LilyGoLib.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <math.h>
+
+#define AUDIO_VOLUME_STEPS 10      // The settings menu moves volume by 10%
+
+typedef struct {
+    const char *name;
+    uint16_t length;       // Samples
+    int16_t *master;       // Full scale (PSRAM)
+    int16_t *scaled;       // Current volume (DMA-capable)
+} AudioSampleBuf_t;
+
+static AudioSampleBuf_t samples[AUDIO_SAMPLE_COUNT] = {
+    {"click", AUDIO_SAMPLE_RATE * 3 / 1000, NULL, NULL},     // 3ms
+    {"bell", AUDIO_SAMPLE_RATE * 120 / 1000, NULL, NULL},    // 120ms
+};
+
+static QueueHandle_t audioQueue = NULL;
+static TaskHandle_t audioTaskHandle = NULL;
+static int16_t *mixBuf = NULL;
+static volatile uint8_t targetLevel = 0;
+static uint8_t builtLevel = 0xFF;
+
+// Mixer task only
+static uint16_t position[AUDIO_SAMPLE_COUNT];
+
+static unsigned long bellQuietAtMs = 0;
+static uint32_t played[AUDIO_SAMPLE_COUNT];
+static uint32_t coalesced = 0;
+static uint32_t queueFull = 0;
+static uint32_t triggers = 0;
+static uint32_t triggerUsMax = 0;
+static uint64_t triggerUsTotal = 0;
+
+static void renderSamples() {
+    // Click: a 4kHz square burst with a fast decay
+    AudioSampleBuf_t &click = samples[AUDIO_CLICK];
+    for (int i = 0; i < click.length; i++) {
+        float env = expf(-(float)i / (click.length / 3.0f));
+        click.master[i] = (int16_t)(((i / 2) & 1 ? 1 : -1) * env * 32767);
+    }
+
+    // Bell: 880Hz plus a quieter octave, ringing down
+    AudioSampleBuf_t &bell = samples[AUDIO_BELL];
+    for (int i = 0; i < bell.length; i++) {
+        float t = (float)i / AUDIO_SAMPLE_RATE;
+        float env = expf(-t / 0.04f);
+        float v = 0.75f * sinf(2 * M_PI * 880 * t) + 0.25f * sinf(2 * M_PI * 1760 * t);
+        bell.master[i] = (int16_t)(v * env * 32767);
+    }
+}
+
+// Perceived loudness: square of the volume step
+static void scaleSamples(uint8_t level) {
+    int32_t gain = (int32_t)AUDIO_PEAK * level * level / (AUDIO_VOLUME_STEPS * AUDIO_VOLUME_STEPS);
+    for (int s = 0; s < AUDIO_SAMPLE_COUNT; s++) {
+        for (int i = 0; i < samples[s].length; i++) {
+            samples[s].scaled[i] = (int16_t)((samples[s].master[i] * gain) >> 15);
+        }
+    }
+    builtLevel = level;
+}
+
+static bool mixChunk() {
+    bool any = false;
+    memset(mixBuf, 0, AUDIO_CHUNK * sizeof(int16_t));
+    for (int s = 0; s < AUDIO_SAMPLE_COUNT; s++) {
+        uint16_t pos = position[s];
+        if (pos >= samples[s].length) continue;
+        int n = samples[s].length - pos;
+        if (n > AUDIO_CHUNK) n = AUDIO_CHUNK;
+        const int16_t *src = samples[s].scaled + pos;
+        for (int i = 0; i < n; i++) {
+            int32_t v = mixBuf[i] + src[i];
+            mixBuf[i] = v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+        }
+        position[s] = pos + n;
+        any = true;
+    }
+    return any;
+}
+
+static void audioTask(void *pvParameters) {
+    bool tail = false;
+    uint8_t sample;
+    while (true) {
+        bool busy = false;
+        for (int s = 0; s < AUDIO_SAMPLE_COUNT; s++) {
+            if (position[s] < samples[s].length) busy = true;
+        }
+
+        // Idle: sleep on the queue. Playing: pick up triggers between chunks.
+        if (xQueueReceive(audioQueue, &sample, (busy || tail) ? 0 : portMAX_DELAY) == pdTRUE) {
+            do {
+                position[sample] = 0;
+                played[sample]++;
+            } while (xQueueReceive(audioQueue, &sample, 0) == pdTRUE);
+        }
+        if (targetLevel != builtLevel) scaleSamples(targetLevel);
+
+        bool any = mixChunk();
+        if (!any && !tail) continue;
+        // Blocks while the DMA ring is full, which paces the mix. One
+        // chunk of silence after the last sound so the ring drains quiet.
+        instance.codec.write((uint8_t *)mixBuf, AUDIO_CHUNK * sizeof(int16_t));
+        tail = any;
+    }
+}
+
+void audioBegin() {
+    if (audioTaskHandle) return;
+#ifdef USING_AUDIO_CODEC
+    for (int s = 0; s < AUDIO_SAMPLE_COUNT; s++) {
+        samples[s].master = (int16_t *)ps_malloc(samples[s].length * sizeof(int16_t));
+        samples[s].scaled = (int16_t *)heap_caps_malloc(samples[s].length * sizeof(int16_t),
+                                                         MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (samples[s].master == NULL || samples[s].scaled == NULL) {
+            Serial.println("Audio: sample allocation failed");
+            return;
+        }
+        position[s] = samples[s].length;
+    }
+    mixBuf = (int16_t *)heap_caps_malloc(AUDIO_CHUNK * sizeof(int16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    audioQueue = xQueueCreate(AUDIO_QUEUE_LEN, sizeof(uint8_t));
+    if (mixBuf == NULL || audioQueue == NULL) {
+        Serial.println("Audio: allocation failed");
+        return;
+    }
+
+    renderSamples();
+    audioSetVolume(settings.volume);
+    scaleSamples(targetLevel);
+
+    // Mono 16-bit; the volume is in the samples, the codec stays at full scale
+    if (instance.codec.open(16, 1, AUDIO_SAMPLE_RATE) != 0) {
+        Serial.println("Audio: codec open failed");
+        return;
+    }
+    instance.codec.setVolume(100);
+
+    // Core 0 next to the haptic task, above it: a late click is audible
+    xTaskCreatePinnedToCore(audioTask, "audio", 3072, NULL, 2, &audioTaskHandle, 0);
+    Serial.printf("Audio: %dHz, samples %u bytes DMA RAM\n", AUDIO_SAMPLE_RATE,
+                  (unsigned)((samples[AUDIO_CLICK].length + samples[AUDIO_BELL].length + AUDIO_CHUNK) * sizeof(int16_t)));
+#else
+    Serial.println("Audio: board has no codec");
+#endif
+}
+
+void audioSetVolume(uint8_t volume) {
+    targetLevel = (volume + AUDIO_VOLUME_STEPS / 2) / AUDIO_VOLUME_STEPS;
+    if (targetLevel > AUDIO_VOLUME_STEPS) targetLevel = AUDIO_VOLUME_STEPS;
+}
+
+bool audioPlay(AudioSample_t sample) {
+    if (!settings.soundEnabled || targetLevel == 0 || audioTaskHandle == NULL) return false;
+
+    unsigned long now = millis();
+    if (sample == AUDIO_BELL) {
+        if ((long)(bellQuietAtMs - now) > 0) {
+            coalesced++;
+            return false;
+        }
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    uint8_t s = sample;
+    bool queued = xQueueSend(audioQueue, &s, 0) == pdTRUE;
+    uint32_t us = esp_timer_get_time() - t0;
+
+    triggers++;
+    triggerUsTotal += us;
+    if (us > triggerUsMax) triggerUsMax = us;
+    if (!queued) {
+        queueFull++;
+        return false;
+    }
+    if (sample == AUDIO_BELL) {
+        bellQuietAtMs = now + samples[AUDIO_BELL].length * 1000 / AUDIO_SAMPLE_RATE + AUDIO_BELL_GAP_MS;
+    }
+    return true;
+}
+
+void audioPrintStats() {
+    Serial.printf("Audio: %s, volume step %u/%d, %u dropped (queue full), trigger avg %uus max %uus\n",
+                  audioTaskHandle == NULL ? "no codec" : (settings.soundEnabled ? "on" : "off"),
+                  (unsigned)targetLevel, AUDIO_VOLUME_STEPS, (unsigned)queueFull,
+                  triggers ? (unsigned)(triggerUsTotal / triggers) : 0, (unsigned)triggerUsMax);
+    for (int s = 0; s < AUDIO_SAMPLE_COUNT; s++) {
+        Serial.printf("  %-6s %6u played", samples[s].name, (unsigned)played[s]);
+        if (s == AUDIO_BELL) Serial.printf(" %6u coalesced", (unsigned)coalesced);
+        Serial.println();
+    }
+}
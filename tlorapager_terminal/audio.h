@@ -0,0 +1,44 @@
+/**
+ * Audio Feedback for T-LoRa Pager Terminal
+ * Key clicks and the terminal bell on the ES8311 speaker
+ *
+ * The samples are rendered once at boot and scaled to the current volume
+ * in DMA-capable RAM, so playing one is a sum into the mix chunk with no
+ * per-sample multiply. audioPlay() only queues: a task mixes the active
+ * samples chunk by chunk into the codec's I2S DMA ring, which paces it.
+ * A bell while the last one is still ringing (or within
+ * AUDIO_BELL_GAP_MS of it) is coalesced into it.
+ */
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <Arduino.h>
+
+#define AUDIO_SAMPLE_RATE 16000
+#define AUDIO_CHUNK 128            // Samples per mix / DMA write (8ms)
+#define AUDIO_QUEUE_LEN 8
+#define AUDIO_PEAK 12000           // Sample peak at 100% volume
+#define AUDIO_BELL_GAP_MS 250      // One bell per burst from the host
+
+typedef enum {
+    AUDIO_CLICK = 0,    // Keypress, menu value preview
+    AUDIO_BELL,         // BEL from the host
+    AUDIO_SAMPLE_COUNT
+} AudioSample_t;
+
+// Open the codec, render the samples and start the mixer task
+void audioBegin();
+
+// Rescale the samples to a volume (0-100, settings.volume). Done by the
+// mixer task before its next chunk.
+void audioSetVolume(uint8_t volume);
+
+// Queue a sample (no-op when sound is off). Returns false if it was
+// coalesced or the queue was full.
+bool audioPlay(AudioSample_t sample);
+
+// Played / coalesced counts and trigger cost
+void audioPrintStats();
+
+#endif // AUDIO_H
@@ -0,0 +1,681 @@
+/**
+ * On-device Benchmarks Implementation
+ */
+
+#include "bench.h"
+#include "render_kernels.h"
+#include "output_watcher.h"
+#include "vt_terminal.h"
+#include "terminal_ui.h"
+#include "ssh_transport.h"
+#include "ttyd_transport.h"
+#include "tls_client.h"
+#include "tls_session_cache.h"
+#include "kex_precompute.h"
+#include "ssh_jump.h"
+#ifdef BENCH_UI
+#include "ui_generated.h"
+#endif
+#include <lvgl.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <esp_random.h>
+#include <esp_timer.h>
+
+#define BENCH_CORPUS_FILE "/bench/rx_corpus.txt"
+#define BENCH_CORPUS_MAX (256 * 1024)
+#define BENCH_CHUNK 512  // matches the SSH read size
+#define BENCH_SCROLL_BYTES (64 * 1024)
+#define BENCH_SCROLL_CHUNK 256     // matches the sshRxDrain() batch
+#define BENCH_SCROLL_FRAME_MS 100  // matches JUMP_SCROLL_FRAME_MS
+
+#define BENCH_SESSION_CONNECTS 3
+#define BENCH_SESSION_CMD "seq 1 100000\n"  // ~590 KB of output
+#define BENCH_SESSION_QUIET_MS 1000          // Output done after this much silence
+#define BENCH_SESSION_MAX_MS 60000
+#define BENCH_TLS_CONNECTS 5
+#define BENCH_KEX_CONNECTS 3
+#define BENCH_JUMP_CONNECTS 3
+#define BENCH_KEX_IDLE_MS 2000  // Longest wait for a keypair between connects
+#define BENCH_UI_CREATES 10
+#define BENCH_UI_DIR "/config"
+
+// One full-width band of the screen (480 x 24 px)
+#define BENCH_PIXELS (480 * 24)
+#define BENCH_ROUNDS 50
+
+static uint16_t *benchAllocPixels() {
+    return (uint16_t *)heap_caps_malloc(BENCH_PIXELS * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+// Synthetic glyph coverage: mostly empty with solid strokes and AA edges
+static void benchFillAlpha(uint8_t *alpha, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t r = esp_random();
+        if ((r & 3) != 0) {
+            alpha[i] = 0;
+        } else {
+            alpha[i] = (r & 0x100) ? 255 : (uint8_t)(r >> 16);
+        }
+    }
+}
+
+static bool benchSame(const uint16_t *a, const uint16_t *b, const char *kernel,
+                      size_t offset, size_t count) {
+    if (memcmp(a, b, BENCH_PIXELS * sizeof(uint16_t)) == 0) return true;
+    Serial.printf("Bench: %s mismatch (offset=%u count=%u)\n", kernel, offset, count);
+    return false;
+}
+
+bool benchRenderSelfTest() {
+    uint16_t *a = benchAllocPixels();
+    uint16_t *b = benchAllocPixels();
+    uint8_t *alpha = (uint8_t *)malloc(BENCH_PIXELS);
+    if (!a || !b || !alpha) {
+        Serial.println("Bench: Out of memory");
+        free(a); free(b); free(alpha);
+        return false;
+    }
+
+    bool ok = true;
+    for (int round = 0; round < 200 && ok; round++) {
+        // Odd offsets and lengths exercise the alignment head/tail paths
+        size_t offset = esp_random() & 1;
+        size_t count = esp_random() % (BENCH_PIXELS - 1);
+        uint16_t color = (uint16_t)esp_random();
+
+        for (size_t i = 0; i < BENCH_PIXELS; i++) {
+            a[i] = b[i] = (uint16_t)esp_random();
+        }
+        benchFillAlpha(alpha, BENCH_PIXELS);
+
+        rkBlendA8To565(a + offset, alpha, count, color);
+        rkBlendA8To565Ref(b + offset, alpha, count, color);
+        ok = benchSame(a, b, "blend", offset, count) && ok;
+
+        rkFill565(a + offset, count, color);
+        rkFill565Ref(b + offset, count, color);
+        ok = benchSame(a, b, "fill", offset, count) && ok;
+
+        rkSwap565(a + offset, count);
+        rkSwap565Ref(b + offset, count);
+        ok = benchSame(a, b, "swap", offset, count) && ok;
+    }
+
+    Serial.printf("Bench: render kernels %s\n", ok ? "bit-exact" : "FAILED");
+    free(a); free(b); free(alpha);
+    return ok;
+}
+
+static void benchReport(const char *name, int64_t fastUs, int64_t refUs) {
+    float pixels = (float)BENCH_PIXELS * BENCH_ROUNDS;
+    float fast = fastUs > 0 ? pixels / fastUs : 0;
+    float ref = refUs > 0 ? pixels / refUs : 0;
+    Serial.printf("  %-6s %8.1f px/us  (scalar %6.1f px/us, x%.2f)\n",
+                  name, fast, ref, ref > 0 ? fast / ref : 0);
+}
+
+void benchRenderKernels() {
+    uint16_t *buf = benchAllocPixels();
+    uint8_t *alpha = (uint8_t *)malloc(BENCH_PIXELS);
+    if (!buf || !alpha) {
+        Serial.println("Bench: Out of memory");
+        free(buf); free(alpha);
+        return;
+    }
+    benchFillAlpha(alpha, BENCH_PIXELS);
+    rkFill565Ref(buf, BENCH_PIXELS, 0x0000);
+
+    Serial.printf("Bench: render kernels (%d px x %d rounds)\n", BENCH_PIXELS, BENCH_ROUNDS);
+
+    int64_t t0, fastUs, refUs;
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkFill565(buf, BENCH_PIXELS, (uint16_t)i);
+    fastUs = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkFill565Ref(buf, BENCH_PIXELS, (uint16_t)i);
+    refUs = esp_timer_get_time() - t0;
+    benchReport("fill", fastUs, refUs);
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkBlendA8To565(buf, alpha, BENCH_PIXELS, 0x07E0);
+    fastUs = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkBlendA8To565Ref(buf, alpha, BENCH_PIXELS, 0x07E0);
+    refUs = esp_timer_get_time() - t0;
+    benchReport("blend", fastUs, refUs);
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkSwap565(buf, BENCH_PIXELS);
+    fastUs = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ROUNDS; i++) rkSwap565Ref(buf, BENCH_PIXELS);
+    refUs = esp_timer_get_time() - t0;
+    benchReport("swap", fastUs, refUs);
+
+    // All zero means LVGL was built without lv_blend_rk.h
+    Serial.printf("  LVGL hooks so far: %u px filled, %u blended, %u swapped\n",
+                  (unsigned)rkHookStats.filled, (unsigned)rkHookStats.blended,
+                  (unsigned)rkHookStats.swapped);
+
+    free(buf);
+    free(alpha);
+}
+
+// Load the recorded corpus, or synthesise tail -f style log output
+static size_t benchLoadCorpus(char *buf, size_t cap) {
+    size_t len = 0;
+
+    File file = LittleFS.open(BENCH_CORPUS_FILE, "r");
+    if (file) {
+        len = file.read((uint8_t *)buf, cap);
+        file.close();
+        Serial.printf("Bench: corpus %s (%u bytes)\n", BENCH_CORPUS_FILE, len);
+        if (len > 0) return len;
+    }
+
+    static const char *levels[] = {"INFO", "DEBUG", "INFO", "WARN", "INFO", "INFO", "DEBUG", "ERROR"};
+    uint32_t seq = 0;
+    while (len + 128 < cap) {
+        len += snprintf(buf + len, cap - len,
+                        "2026-01-01T12:%02u:%02u.%03u %-5s worker-%u: request id=%08x took %ums\n",
+                        (seq / 60000) % 60, (seq / 1000) % 60, seq % 1000,
+                        levels[seq & 7], seq % 8, esp_random(), esp_random() % 500);
+        seq++;
+    }
+    Serial.printf("Bench: synthetic corpus (%u bytes)\n", len);
+    return len;
+}
+
+// Same per-byte work as sshRxOffer()
+static void benchRingCopy(char *ring, int *head, const char *data, int len) {
+    for (int i = 0; i < len; i++) {
+        ring[*head] = data[i];
+        *head = (*head + 1) % 2048;
+    }
+}
+
+void benchWatcher() {
+    char *corpus = (char *)ps_malloc(BENCH_CORPUS_MAX);
+    char *ring = (char *)malloc(2048);
+    if (!corpus || !ring) {
+        Serial.println("Bench: Out of memory");
+        free(corpus); free(ring);
+        return;
+    }
+    size_t len = benchLoadCorpus(corpus, BENCH_CORPUS_MAX);
+    int head = 0;
+    int64_t t0;
+
+    // Baseline: RX path without the watcher
+    t0 = esp_timer_get_time();
+    for (size_t off = 0; off < len; off += BENCH_CHUNK) {
+        int n = min((size_t)BENCH_CHUNK, len - off);
+        benchRingCopy(ring, &head, corpus + off, n);
+    }
+    int64_t baseUs = esp_timer_get_time() - t0;
+
+    // Watcher alone
+    t0 = esp_timer_get_time();
+    for (size_t off = 0; off < len; off += BENCH_CHUNK) {
+        watcherScan(corpus + off, min((size_t)BENCH_CHUNK, len - off));
+    }
+    int64_t scanUs = esp_timer_get_time() - t0;
+
+    // RX path with the watcher inline
+    t0 = esp_timer_get_time();
+    for (size_t off = 0; off < len; off += BENCH_CHUNK) {
+        int n = min((size_t)BENCH_CHUNK, len - off);
+        watcherScan(corpus + off, n);
+        benchRingCopy(ring, &head, corpus + off, n);
+    }
+    int64_t withUs = esp_timer_get_time() - t0;
+
+    // Don't let benchmark hits buzz the pager
+    watcherTakeMatch();
+
+    float mb = len / (1024.0f * 1024.0f);
+    Serial.printf("  scan      %7.2f MB/s\n", scanUs > 0 ? mb * 1e6f / scanUs : 0);
+    Serial.printf("  rx path   %7.2f MB/s\n", baseUs > 0 ? mb * 1e6f / baseUs : 0);
+    Serial.printf("  rx+watch  %7.2f MB/s  (overhead %.1f%%)\n",
+                  withUs > 0 ? mb * 1e6f / withUs : 0,
+                  baseUs > 0 ? 100.0f * (withUs - baseUs) / baseUs : 0);
+
+    free(corpus);
+    free(ring);
+}
+
+// Feed the corpus in drain-sized batches, drawing every batch or only on
+// the frame interval. Each draw is flushed to the panel so its cost counts.
+static int64_t benchScrollRun(const char *data, size_t len, bool jump, uint32_t *frames) {
+    termModel.reset();
+    *frames = 0;
+    int64_t t0 = esp_timer_get_time();
+    unsigned long lastFrameMs = millis();
+
+    for (size_t off = 0; off < len; off += BENCH_SCROLL_CHUNK) {
+        termModel.write(data + off, min((size_t)BENCH_SCROLL_CHUNK, len - off));
+        if (!jump || millis() - lastFrameMs >= BENCH_SCROLL_FRAME_MS) {
+            if (terminalRender()) {
+                lv_refr_now(NULL);
+                (*frames)++;
+            }
+            lastFrameMs = millis();
+        }
+    }
+    if (terminalRender()) {
+        lv_refr_now(NULL);
+        (*frames)++;
+    }
+    return esp_timer_get_time() - t0;
+}
+
+void benchJumpScroll() {
+    char *text = (char *)ps_malloc(BENCH_SCROLL_BYTES);
+    char *corpus = (char *)ps_malloc(BENCH_SCROLL_BYTES * 2);
+    if (!text || !corpus) {
+        Serial.println("Bench: Out of memory");
+        free(text); free(corpus);
+        return;
+    }
+
+    // The PTY turns LF into CRLF, so the terminal sees CRLF
+    size_t textLen = benchLoadCorpus(text, BENCH_SCROLL_BYTES);
+    size_t len = 0;
+    for (size_t i = 0; i < textLen; i++) {
+        if (text[i] == '\n') corpus[len++] = '\r';
+        corpus[len++] = text[i];
+    }
+    free(text);
+
+    uint32_t normalFrames, jumpFrames;
+    int64_t normalUs = benchScrollRun(corpus, len, false, &normalFrames);
+    int64_t jumpUs = benchScrollRun(corpus, len, true, &jumpFrames);
+
+    float kb = len / 1024.0f;
+    Serial.printf("Bench: cat %u bytes (%d x %d terminal)\n", (unsigned)len, termModel.cols(), termModel.rows());
+    Serial.printf("  normal   %8.1f KB/s  %5u frames  %7.1fms\n",
+                  normalUs > 0 ? kb * 1e6f / normalUs : 0, (unsigned)normalFrames, normalUs / 1000.0f);
+    Serial.printf("  jump     %8.1f KB/s  %5u frames  %7.1fms  (x%.1f)\n",
+                  jumpUs > 0 ? kb * 1e6f / jumpUs : 0, (unsigned)jumpFrames, jumpUs / 1000.0f,
+                  jumpUs > 0 ? (float)normalUs / jumpUs : 0);
+
+    // Leave a clean screen rather than the tail of the corpus
+    termModel.reset();
+    terminalRender();
+    free(corpus);
+}
+
+typedef struct {
+    const SessionTransport_t *transport;
+    void *target;
+} BenchSessionTarget_t;
+
+static BenchSessionTarget_t benchTargets[2];
+static volatile bool benchTaskDone = false;
+
+// Read until the remote has been quiet for quietMs; returns bytes seen
+static uint32_t benchSessionDrain(const SessionTransport_t *t, uint32_t quietMs,
+                                  int64_t *firstUs, int64_t *lastUs) {
+    static char buf[2048];
+    uint32_t total = 0;
+    unsigned long start = millis();
+    unsigned long lastByte = millis();
+    *firstUs = *lastUs = 0;
+
+    while (millis() - lastByte < quietMs && millis() - start < BENCH_SESSION_MAX_MS) {
+        int n = t->read(buf, sizeof(buf));
+        if (n < 0) break;
+        if (n == 0) {
+            vTaskDelay(1);
+            continue;
+        }
+        int64_t now = esp_timer_get_time();
+        if (total == 0) *firstUs = now;
+        *lastUs = now;
+        total += n;
+        lastByte = millis();
+    }
+    return total;
+}
+
+static void benchSessionRun(const SessionTransport_t *t, void *target) {
+    uint16_t cols = termModel.cols(), rows = termModel.rows();
+    float sumMs = 0, minMs = 0;
+    int connects = 0;
+
+    for (int i = 0; i < BENCH_SESSION_CONNECTS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        if (!t->open(target, cols, rows)) continue;
+        float ms = (esp_timer_get_time() - t0) / 1000.0f;
+        t->close();
+        sumMs += ms;
+        if (connects == 0 || ms < minMs) minMs = ms;
+        connects++;
+    }
+    if (connects == 0) {
+        Serial.printf("  %-5s connect failed\n", t->name);
+        return;
+    }
+
+    // Throughput: wait out the login banner, then time the bulk output
+    float kbps = 0;
+    uint32_t bytes = 0;
+    if (t->open(target, cols, rows)) {
+        int64_t firstUs, lastUs;
+        benchSessionDrain(t, 500, &firstUs, &lastUs);
+        t->write(BENCH_SESSION_CMD, strlen(BENCH_SESSION_CMD));
+        bytes = benchSessionDrain(t, BENCH_SESSION_QUIET_MS, &firstUs, &lastUs);
+        if (lastUs > firstUs) kbps = bytes / 1024.0f * 1e6f / (lastUs - firstUs);
+        t->close();
+    }
+
+    Serial.printf("  %-5s connect %7.1fms avg %7.1fms min (%d/%d)  throughput %7.1f KB/s (%u bytes)\n",
+                  t->name, sumMs / connects, minMs, connects, BENCH_SESSION_CONNECTS,
+                  kbps, (unsigned)bytes);
+}
+
+// Network benchmarks run in their own task (libssh and mbedTLS need
+// a large stack); the caller waits for it to finish
+static bool benchRunTask(TaskFunction_t fn, const char *name, uint32_t stack, void *param) {
+    benchTaskDone = false;
+    if (xTaskCreatePinnedToCore(fn, name, stack, param, 5, NULL, 1) != pdPASS) {
+        Serial.println("Bench: Out of memory");
+        return false;
+    }
+    while (!benchTaskDone) {
+        delay(50);
+    }
+    return true;
+}
+
+static void benchSessionTask(void *param) {
+    for (int i = 0; i < 2; i++) {
+        if (benchTargets[i].transport) {
+            benchSessionRun(benchTargets[i].transport, benchTargets[i].target);
+        }
+    }
+    benchTaskDone = true;
+    vTaskDelete(NULL);
+}
+
+void benchSession(ServerConfig_t *server, GatewayConfig *gateway) {
+    bool haveSsh = server != NULL && strlen(server->host) > 0;
+    bool haveTtyd = gateway != NULL && gateway->host.length() > 0;
+
+    Serial.printf("Bench: session (%d connects, `seq 1 100000`)\n", BENCH_SESSION_CONNECTS);
+    if (!haveSsh) Serial.println("  SSH   not configured");
+    if (!haveTtyd) Serial.println("  ttyd  not configured");
+
+    benchTargets[0].transport = haveSsh ? &sshTransport : NULL;
+    benchTargets[0].target = server;
+    benchTargets[1].transport = haveTtyd ? &ttydTransport : NULL;
+    benchTargets[1].target = gateway;
+
+    benchRunTask(benchSessionTask, "bench_session", 51200, NULL);
+}
+
+// Handshake times for one mode; resume=false forgets the host first
+static void benchTlsRun(GatewayConfig *gw, bool resume) {
+    TlsClient client;
+    const char *sni = gw->sni.length() > 0 ? gw->sni.c_str() : NULL;
+    uint32_t timeoutMs = gw->connectTimeoutMs ? gw->connectTimeoutMs : 4000;
+    char key[80];
+    snprintf(key, sizeof(key), "%s:%u", sni ? sni : gw->host.c_str(), gw->port);
+
+    // Prime the cache so the first resumed connect has a session to offer
+    if (resume && !client.connect(gw->host.c_str(), gw->port, sni, timeoutMs)) {
+        Serial.println("  connect failed");
+        return;
+    }
+    client.stop();
+
+    float sumMs = 0, minMs = 0, tcpMs = 0;
+    int connects = 0, resumed = 0;
+    for (int i = 0; i < BENCH_TLS_CONNECTS; i++) {
+        if (!resume) tlsCacheForget(key);
+        if (!client.connect(gw->host.c_str(), gw->port, sni, timeoutMs)) continue;
+        float ms = client.handshakeUs() / 1000.0f;
+        tcpMs += client.tcpUs() / 1000.0f;
+        if (client.resumed()) resumed++;
+        client.stop();
+        sumMs += ms;
+        if (connects == 0 || ms < minMs) minMs = ms;
+        connects++;
+    }
+    if (connects == 0) {
+        Serial.printf("  %-7s connect failed\n", resume ? "resumed" : "full");
+        return;
+    }
+    Serial.printf("  %-7s handshake %7.1fms avg %7.1fms min  (TCP %.1fms, %d/%d resumed)\n",
+                  resume ? "resumed" : "full", sumMs / connects, minMs, tcpMs / connects,
+                  resumed, connects);
+}
+
+static void benchTlsTask(void *param) {
+    GatewayConfig *gw = (GatewayConfig *)param;
+    benchTlsRun(gw, false);
+    benchTlsRun(gw, true);
+    benchTaskDone = true;
+    vTaskDelete(NULL);
+}
+
+void benchTls(GatewayConfig *gateway) {
+    if (gateway == NULL || gateway->host.length() == 0 || !gateway->useSsl) {
+        Serial.println("Bench: tls needs a gateway profile with useSsl");
+        return;
+    }
+    Serial.printf("Bench: TLS handshake to %s:%u (%d connects each)\n",
+                  gateway->host.c_str(), gateway->port, BENCH_TLS_CONNECTS);
+    benchRunTask(benchTlsTask, "bench_tls", 16384, gateway);
+}
+
+// Average connect phases over BENCH_KEX_CONNECTS connects
+static bool benchKexRun(ServerConfig_t *server, bool precompute, float *avgMs) {
+    kexPrecomputeSetEnabled(precompute);
+    memset(avgMs, 0, SSH_PHASE_COUNT * sizeof(float));
+    int connects = 0;
+
+    for (int i = 0; i < BENCH_KEX_CONNECTS; i++) {
+        // A reconnect after some idle time: the keypair is ready
+        unsigned long start = millis();
+        while (precompute && !kexPrecomputeReady() && millis() - start < BENCH_KEX_IDLE_MS) {
+            delay(10);
+        }
+        if (!sshTransport.open(server, termModel.cols(), termModel.rows())) continue;
+        const SshConnectTiming_t *t = sshConnectTiming();
+        for (int p = 0; p < SSH_PHASE_COUNT; p++) avgMs[p] += t->us[p] / 1000.0f;
+        sshTransport.close();
+        connects++;
+    }
+    for (int p = 0; p < SSH_PHASE_COUNT; p++) {
+        if (connects) avgMs[p] /= connects;
+    }
+    return connects > 0;
+}
+
+static void benchKexTask(void *param) {
+    ServerConfig_t *server = (ServerConfig_t *)param;
+    bool wasEnabled = kexPrecomputeEnabled();
+    float inlineMs[SSH_PHASE_COUNT], precompMs[SSH_PHASE_COUNT];
+
+    bool ok = benchKexRun(server, false, inlineMs) && benchKexRun(server, true, precompMs);
+    kexPrecomputeSetEnabled(wasEnabled);
+
+    if (!ok) {
+        Serial.println("  connect failed");
+    } else {
+        float inlineTotal = 0, precompTotal = 0;
+        Serial.println("  phase       inline  precomputed");
+        for (int p = 0; p < SSH_PHASE_COUNT; p++) {
+            Serial.printf("  %-8s %7.1fms  %7.1fms\n", sshPhaseNames[p], inlineMs[p], precompMs[p]);
+            inlineTotal += inlineMs[p];
+            precompTotal += precompMs[p];
+        }
+        Serial.printf("  total    %7.1fms  %7.1fms  (saved %.1fms)\n",
+                      inlineTotal, precompTotal, inlineTotal - precompTotal);
+    }
+    kexPrecomputePrintStatus();
+    benchTaskDone = true;
+    vTaskDelete(NULL);
+}
+
+void benchKex(ServerConfig_t *server) {
+    if (server == NULL || strlen(server->host) == 0) {
+        Serial.println("Bench: kex needs an SSH server");
+        return;
+    }
+    Serial.printf("Bench: SSH connect phases, kex key inline vs precomputed (%d connects each)\n",
+                  BENCH_KEX_CONNECTS);
+    benchRunTask(benchKexTask, "bench_kex", 51200, server);
+}
+
+// Average open() time and bastion phase; cold closes the bastion first
+static void benchJumpRun(ServerConfig_t *server, bool cold) {
+    float sumMs = 0, jumpMs = 0;
+    int connects = 0;
+
+    for (int i = 0; i < BENCH_JUMP_CONNECTS; i++) {
+        if (cold) jumpDisconnect();
+        int64_t t0 = esp_timer_get_time();
+        if (!sshTransport.open(server, termModel.cols(), termModel.rows())) continue;
+        sumMs += (esp_timer_get_time() - t0) / 1000.0f;
+        jumpMs += sshConnectTiming()->us[SSH_PHASE_JUMP] / 1000.0f;
+        sshTransport.close();
+        connects++;
+    }
+    if (connects == 0) {
+        Serial.printf("  %-7s connect failed\n", cold ? "new" : "reused");
+        return;
+    }
+    Serial.printf("  %-7s connect %7.1fms avg (bastion %7.1fms)  (%d/%d)\n",
+                  cold ? "new" : "reused", sumMs / connects, jumpMs / connects,
+                  connects, BENCH_JUMP_CONNECTS);
+}
+
+static void benchJumpTask(void *param) {
+    ServerConfig_t *server = (ServerConfig_t *)param;
+    benchJumpRun(server, true);
+    benchJumpRun(server, false);
+    jumpPrintStatus();
+    benchTaskDone = true;
+    vTaskDelete(NULL);
+}
+
+void benchJump(ServerConfig_t *server) {
+    if (server == NULL || strlen(server->jump.host) == 0) {
+        Serial.println("Bench: jump needs an SSH server with a jump host");
+        return;
+    }
+    Serial.printf("Bench: %s via %s, new vs reused bastion session (%d connects each)\n",
+                  server->host, server->jump.host, BENCH_JUMP_CONNECTS);
+    benchRunTask(benchJumpTask, "bench_jump", 51200, server);
+}
+
+#ifdef BENCH_UI
+static uint32_t benchCountObjs(lv_obj_t *obj) {
+    uint32_t n = 1;
+    for (uint32_t i = 0; i < lv_obj_get_child_count(obj); i++) {
+        n += benchCountObjs(lv_obj_get_child(obj, i));
+    }
+    return n;
+}
+
+#if LV_USE_XML
+// Read a whole file; caller frees
+static char *benchReadFile(File &f) {
+    size_t len = f.size();
+    char *buf = (char *)ps_malloc(len + 1);
+    if (buf) {
+        len = f.read((uint8_t *)buf, len);
+        buf[len] = '\0';
+    }
+    return buf;
+}
+
+// Register globals.xml and every component under dir; returns the count
+static int benchRegisterXml(const char *dir) {
+    File d = LittleFS.open(dir);
+    if (!d || !d.isDirectory()) return 0;
+    int count = 0;
+    for (File f = d.openNextFile(); f; f = d.openNextFile()) {
+        const char *name = f.name();
+        if (f.isDirectory()) {
+            // Profiles are config, not UI
+            if (strcmp(name, "profiles") != 0) {
+                char sub[64];
+                snprintf(sub, sizeof(sub), "%s/%s", dir, name);
+                count += benchRegisterXml(sub);
+            }
+            continue;
+        }
+        const char *ext = strrchr(name, '.');
+        if (!ext || strcmp(ext, ".xml") != 0 || strcmp(name, "project.xml") == 0) continue;
+        char *xml = benchReadFile(f);
+        if (!xml) continue;
+        char component[32];
+        snprintf(component, sizeof(component), "%.*s", (int)(ext - name), name);
+        if (lv_xml_register_component_from_data(component, xml) == LV_RESULT_OK) count++;
+        free(xml);
+    }
+    return count;
+}
+#endif
+
+void benchUi() {
+    uiGenInit();
+
+    int64_t genUs = 0;
+    uint32_t objs = 0;
+    for (int i = 0; i < BENCH_UI_CREATES; i++) {
+        int64_t t0 = esp_timer_get_time();
+        lv_obj_t *screen = uiGenCreateTerminalScreen(NULL);
+        genUs += esp_timer_get_time() - t0;
+        objs = benchCountObjs(screen);
+        lv_obj_delete(screen);
+    }
+    Serial.printf("Bench: terminal screen, %u objects, average of %d creates\n", (unsigned)objs, BENCH_UI_CREATES);
+    Serial.printf("  generated C   %7.2fms\n", genUs / 1000.0f / BENCH_UI_CREATES);
+
+#if LV_USE_XML
+    // The runtime loader resolves the same names the generator folded in
+    for (int i = 0; i < uiFontCount; i++) {
+        lv_xml_register_font(NULL, uiFonts[i].name, (const lv_font_t *)uiFonts[i].ptr);
+    }
+    for (int i = 0; i < uiImageCount; i++) {
+        lv_xml_register_image(NULL, uiImages[i].name, uiImages[i].ptr);
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    int files = benchRegisterXml(BENCH_UI_DIR);
+    int64_t parseUs = esp_timer_get_time() - t0;
+    if (files == 0) {
+        Serial.println("  runtime XML   no XML under " BENCH_UI_DIR " (pio run -t uploadfs)");
+        return;
+    }
+
+    int64_t xmlUs = 0;
+    for (int i = 0; i < BENCH_UI_CREATES; i++) {
+        t0 = esp_timer_get_time();
+        lv_obj_t *screen = (lv_obj_t *)lv_xml_create(NULL, "terminal", NULL);
+        xmlUs += esp_timer_get_time() - t0;
+        if (!screen) {
+            Serial.println("  runtime XML   lv_xml_create failed");
+            return;
+        }
+        lv_obj_delete(screen);
+    }
+    Serial.printf("  runtime XML   %7.2fms  (x%.1f) + %.1fms once to parse %d files\n",
+                  xmlUs / 1000.0f / BENCH_UI_CREATES, genUs > 0 ? (float)xmlUs / genUs : 0,
+                  parseUs / 1000.0f, files);
+#else
+    Serial.println("  runtime XML   not built (LV_USE_XML is 0 in lv_conf.h)");
+#endif
+}
+#else
+void benchUi() {
+    // The generated screen is not part of the firmware
+    Serial.println("Bench: ui is only in the bench build (pio run -e t-lora-pager-bench)");
+}
+#endif
@@ -0,0 +1,51 @@
+/**
+ * On-device Benchmarks for T-LoRa Pager Terminal
+ * Micro-benchmarks and self-checks, run from the serial console
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+#include "settings.h"
+#include "ConfigLoader.h"
+
+// Check the fast render kernels against the scalar references.
+// Returns true if every kernel is bit-exact.
+bool benchRenderSelfTest();
+
+// Measure render kernel throughput (pixels per microsecond), and show
+// how many pixels LVGL has sent through them
+void benchRenderKernels();
+
+// Output watcher overhead on a high-volume RX corpus
+// (/bench/rx_corpus.txt on LittleFS, or synthetic log output)
+void benchWatcher();
+
+// `cat bigfile` through the terminal model and display: bytes/s with
+// every batch drawn vs jump scroll (clears the terminal afterwards)
+void benchJumpScroll();
+
+// Connect time and bulk output throughput, SSH server vs ttyd gateway
+// (either may be NULL/unconfigured and is then skipped). Run with no
+// session open; blocks the UI until done.
+void benchSession(ServerConfig_t *server, GatewayConfig *gateway);
+
+// TLS handshake time to the gateway: full (cache forgotten) vs resumed.
+// Run with no session open; leaves a fresh session in the cache.
+void benchTls(GatewayConfig *gateway);
+
+// SSH connect phase times with the ephemeral kex key computed inline
+// vs ahead of time at idle. Run with no session open.
+void benchKex(ServerConfig_t *server);
+
+// Connect time through the server's jump host with a new bastion
+// session each time vs the persistent one. Run with no session open.
+void benchJump(ServerConfig_t *server);
+
+// Terminal screen creation time: generated C (ui_generated.cpp) vs
+// parsing the XML from LittleFS at run time (needs LV_USE_XML). Only in
+// the t-lora-pager-bench build (BENCH_UI); elsewhere it says so.
+void benchUi();
+
+#endif // BENCH_H
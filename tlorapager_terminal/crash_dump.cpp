@@ -0,0 +1,369 @@
+/**
+ * Crash Dump Implementation
+ */
+
+#include "crash_dump.h"
+#include "ssh_transport.h"
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+// Core dumps to flash in ELF format (the one with a summary)
+#if CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH && CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF
+#define CRASH_CORE_DUMPS 1
+#include <esp_core_dump.h>
+#endif
+
+#define CRASH_SAMPLE_MAGIC 0x48454150   // "HEAP"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t uptimeS;
+    uint32_t freeInternal;
+    uint32_t minInternal;       // Low-water mark since boot
+    uint32_t largestInternal;
+    uint32_t freePsram;
+    uint32_t failedSize;        // Last allocation that failed, 0: none
+    uint32_t failedCaps;
+} CrashHeapSample_t;
+
+typedef struct {
+    uint32_t coreSize;          // With excPc, ties the record to its core
+    uint32_t excPc;
+    uint8_t reason;             // esp_reset_reason_t
+    bool heapValid;
+    CrashHeapSample_t heap;
+} CrashRecord_t;                // As saved in NVS
+
+// Survives the panic reset (not a power cycle)
+RTC_NOINIT_ATTR static CrashHeapSample_t rtcSample;
+
+static const esp_partition_t *corePart = NULL;
+static uint32_t coreOffset = 0;
+static uint32_t coreSize = 0;
+static uint32_t corePc = 0;             // Crash PC, 0: no summary
+static volatile bool pending = false;
+static CrashRecord_t record;
+static bool haveRecord = false;
+static unsigned long lastSampleMs = 0;
+
+#ifdef CRASH_CORE_DUMPS
+static esp_core_dump_summary_t summary;
+static bool haveSummary = false;
+#endif
+
+typedef struct {
+    uint32_t sent;
+    char buf[CRASH_CHUNK];
+} UploadSource_t;
+
+// Upload on the live session; buf holds [pos, len) of the current chunk
+static struct {
+    SshExecChannel_t channel;
+    char *buf;
+    uint32_t pos, len;
+    uint32_t sent;
+    bool eofSent;
+    unsigned long startMs;
+    char reply[32];
+    int replyLen;
+} upload;
+
+static const char* resetName(uint8_t reason) {
+    switch (reason) {
+        case ESP_RST_PANIC: return "panic";
+        case ESP_RST_INT_WDT: return "interrupt watchdog";
+        case ESP_RST_TASK_WDT: return "task watchdog";
+        case ESP_RST_WDT: return "watchdog";
+        case ESP_RST_BROWNOUT: return "brownout";
+        default: return "reset";
+    }
+}
+
+static bool isCrash(esp_reset_reason_t reason) {
+    return reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+           reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+}
+
+// Runs in the failing caller's context: only note it
+static void allocFailed(size_t size, uint32_t caps, const char *function) {
+    rtcSample.failedSize = size;
+    rtcSample.failedCaps = caps;
+}
+
+void crashDumpBegin() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    CrashHeapSample_t sample = rtcSample;
+    bool sampleValid = reason != ESP_RST_POWERON && sample.magic == CRASH_SAMPLE_MAGIC;
+    memset(&rtcSample, 0, sizeof(rtcSample));
+    heap_caps_register_failed_alloc_callback(allocFailed);
+
+#ifdef CRASH_CORE_DUMPS
+    size_t addr = 0, size = 0;
+    esp_err_t err = esp_core_dump_image_get(&addr, &size);
+    corePart = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_COREDUMP, NULL);
+    if (err != ESP_OK || corePart == NULL) {
+        if (isCrash(reason)) {
+            Serial.printf("Crash: reset by %s, no core dump (%s)\n", resetName(reason), esp_err_to_name(err));
+        }
+        return;
+    }
+    coreOffset = addr - corePart->address;
+    coreSize = size;
+    haveSummary = esp_core_dump_get_summary(&summary) == ESP_OK;
+    corePc = haveSummary ? summary.exc_pc : 0;
+    pending = true;
+
+    // The heap sample belongs to this core only if this boot is the crash
+    Preferences prefs;
+    if (prefs.begin(CRASH_NVS_NAMESPACE, false)) {
+        if (isCrash(reason)) {
+            memset(&record, 0, sizeof(record));
+            record.coreSize = coreSize;
+            record.excPc = corePc;
+            record.reason = reason;
+            record.heapValid = sampleValid;
+            if (sampleValid) record.heap = sample;
+            prefs.putBytes("record", &record, sizeof(record));
+        }
+        haveRecord = prefs.getBytes("record", &record, sizeof(record)) == sizeof(record) &&
+                     record.coreSize == coreSize && record.excPc == corePc;
+        prefs.end();
+    }
+    Serial.printf("Crash: core dump in flash, %u bytes%s\n", (unsigned)coreSize,
+                  isCrash(reason) ? " (this reset)" : "");
+#else
+    if (isCrash(reason)) {
+        Serial.printf("Crash: reset by %s; flash core dumps are off in this build\n", resetName(reason));
+    }
+#endif
+}
+
+bool crashDumpPending() {
+    return pending;
+}
+
+void crashDumpShow(void (*print)(const char *text)) {
+    if (!pending) return;
+    char line[96];
+
+#ifdef CRASH_CORE_DUMPS
+    if (haveSummary) {
+        snprintf(line, sizeof(line), "Crash: %s in task '%.16s'",
+                 haveRecord ? resetName(record.reason) : "panic", summary.exc_task);
+        print(line);
+        if (haveRecord && record.heapValid) {
+            snprintf(line, sizeof(line), ", %u:%02u after boot",
+                     (unsigned)(record.heap.uptimeS / 60), (unsigned)(record.heap.uptimeS % 60));
+            print(line);
+        }
+        snprintf(line, sizeof(line), "\n  PC 0x%08x, exception cause %u, address 0x%08x\n  Backtrace:",
+                 (unsigned)summary.exc_pc, (unsigned)summary.ex_info.exc_cause,
+                 (unsigned)summary.ex_info.exc_vaddr);
+        print(line);
+        for (uint32_t i = 0; i < summary.exc_bt_info.depth && i < 16; i++) {
+            snprintf(line, sizeof(line), "%s 0x%08x", i > 0 && i % 6 == 0 ? "\n            " : "",
+                     (unsigned)summary.exc_bt_info.bt[i]);
+            print(line);
+        }
+        print(summary.exc_bt_info.corrupted ? " (corrupted)\n" : "\n");
+    } else {
+        print("Crash: core dump has no summary (not ELF format)\n");
+    }
+#endif
+
+    if (haveRecord && record.heapValid) {
+        const CrashHeapSample_t &h = record.heap;
+        snprintf(line, sizeof(line), "  Heap %uKB free, %uKB at least, %uKB largest block; PSRAM %uKB free\n",
+                 (unsigned)(h.freeInternal / 1024), (unsigned)(h.minInternal / 1024),
+                 (unsigned)(h.largestInternal / 1024), (unsigned)(h.freePsram / 1024));
+        print(line);
+        if (h.failedSize > 0) {
+            snprintf(line, sizeof(line), "  Last failed allocation: %u bytes (caps 0x%x)\n",
+                     (unsigned)h.failedSize, (unsigned)h.failedCaps);
+            print(line);
+        }
+    } else {
+        print("  Heap state not recorded\n");
+    }
+    snprintf(line, sizeof(line), "  Core %uKB: rotary+U uploads it on the next SSH connect\n\n",
+             (unsigned)((coreSize + 1023) / 1024));
+    print(line);
+}
+
+void crashDumpSampleHeap() {
+    unsigned long now = millis();
+    if (lastSampleMs != 0 && now - lastSampleMs < CRASH_SAMPLE_MS) return;
+    lastSampleMs = now;
+
+    rtcSample.uptimeS = now / 1000;
+    rtcSample.freeInternal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    rtcSample.minInternal = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    rtcSample.largestInternal = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    rtcSample.freePsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    rtcSample.magic = CRASH_SAMPLE_MAGIC;
+}
+
+// Straight from flash, one chunk per channel write
+static int readChunk(void *ctx, const char **data) {
+    UploadSource_t *src = (UploadSource_t *)ctx;
+    uint32_t n = min((uint32_t)CRASH_CHUNK, coreSize - src->sent);
+    if (n == 0) return 0;
+    if (esp_partition_read(corePart, coreOffset + src->sent, src->buf, n) != ESP_OK) return -1;
+    src->sent += n;
+    *data = src->buf;
+    return n;
+}
+
+// `cat` into a file named after the firmware and the crash PC, then
+// report what arrived
+static void uploadCommand(char *command, size_t cap) {
+    const char *sha = "unknown";
+#ifdef CRASH_CORE_DUMPS
+    if (haveSummary) sha = (const char *)summary.app_elf_sha256;
+#endif
+    char name[48];
+    snprintf(name, sizeof(name), CRASH_UPLOAD_DIR "/core-%.8s-%08x.bin", sha, (unsigned)corePc);
+    snprintf(command, cap, "mkdir -p " CRASH_UPLOAD_DIR " && cat > %s && wc -c < %s", name, name);
+    Serial.printf("Crash: uploading %u bytes to %s\n", (unsigned)coreSize, name);
+}
+
+// Erase the core once the server holds all of it
+static bool uploadVerify(uint32_t sent, const char *reply, unsigned long ms) {
+    uint32_t stored = strtoul(reply, NULL, 10);
+    if (sent != coreSize || stored != coreSize) {
+        Serial.printf("Crash: upload failed (%u sent, %u stored)\n", (unsigned)sent, (unsigned)stored);
+        return false;
+    }
+    Serial.printf("Crash: uploaded in %lums\n", ms);
+    crashDumpErase();
+    return true;
+}
+
+bool crashDumpUploadStart() {
+    if (!pending || upload.channel != NULL) return false;
+    upload.buf = (char *)malloc(CRASH_CHUNK);
+    if (upload.buf == NULL) return false;
+
+    char command[160];
+    uploadCommand(command, sizeof(command));
+    upload.channel = sshExecStart(command);
+    if (upload.channel == NULL) {
+        free(upload.buf);
+        upload.buf = NULL;
+        return false;
+    }
+    upload.pos = upload.len = 0;
+    upload.sent = 0;
+    upload.eofSent = false;
+    upload.replyLen = 0;
+    upload.reply[0] = '\0';
+    upload.startMs = millis();
+    return true;
+}
+
+static CrashUploadState_t uploadEnd(bool ok) {
+    crashDumpUploadAbort();
+    if (ok) ok = uploadVerify(upload.sent, upload.reply, millis() - upload.startMs);
+    return ok ? CRASH_UPLOAD_DONE : CRASH_UPLOAD_FAILED;
+}
+
+CrashUploadState_t crashDumpUploadStep() {
+    if (upload.channel == NULL) return CRASH_UPLOAD_FAILED;
+    if (millis() - upload.startMs > CRASH_UPLOAD_TIMEOUT_MS) {
+        Serial.println("Crash: upload timed out");
+        return uploadEnd(false);
+    }
+
+    // One chunk from flash at a time, written as the window allows
+    if (upload.sent < coreSize) {
+        if (upload.pos == upload.len) {
+            uint32_t n = min((uint32_t)CRASH_CHUNK, coreSize - upload.sent);
+            if (esp_partition_read(corePart, coreOffset + upload.sent, upload.buf, n) != ESP_OK) {
+                return uploadEnd(false);
+            }
+            upload.pos = 0;
+            upload.len = n;
+        }
+        int n = sshExecWrite(upload.channel, upload.buf + upload.pos, upload.len - upload.pos);
+        if (n < 0) return uploadEnd(false);
+        upload.pos += n;
+        upload.sent += n;
+        return CRASH_UPLOAD_RUNNING;
+    }
+    if (!upload.eofSent) {
+        if (!sshExecEof(upload.channel)) return uploadEnd(false);
+        upload.eofSent = true;
+        return CRASH_UPLOAD_RUNNING;
+    }
+
+    // `wc -c` output until the command's stdout ends
+    int room = sizeof(upload.reply) - 1 - upload.replyLen;
+    int n = room > 0 ? sshExecRead(upload.channel, upload.reply + upload.replyLen, room) : -1;
+    if (n > 0) {
+        upload.replyLen += n;
+        upload.reply[upload.replyLen] = '\0';
+    }
+    return n >= 0 ? CRASH_UPLOAD_RUNNING : uploadEnd(true);
+}
+
+void crashDumpUploadAbort() {
+    if (upload.channel) {
+        sshExecClose(upload.channel);
+        upload.channel = NULL;
+    }
+    free(upload.buf);
+    upload.buf = NULL;
+}
+
+bool crashDumpUpload(ServerConfig_t *server) {
+    if (!pending) return false;
+
+    char command[160];
+    uploadCommand(command, sizeof(command));
+
+    // Chunk buffer on the caller's (session task) stack, only while uploading
+    UploadSource_t src;
+    src.sent = 0;
+    char reply[32];
+    unsigned long start = millis();
+    if (!sshExecSend(server, command, readChunk, &src, reply, sizeof(reply), CRASH_UPLOAD_TIMEOUT_MS)) {
+        Serial.println("Crash: upload failed");
+        return false;
+    }
+    return uploadVerify(src.sent, reply, millis() - start);
+}
+
+void crashDumpErase() {
+    if (!pending) return;
+    pending = false;
+    if (esp_partition_erase_range(corePart, 0, corePart->size) != ESP_OK) {
+        Serial.println("Crash: erase failed");
+    }
+    Preferences prefs;
+    if (prefs.begin(CRASH_NVS_NAMESPACE, false)) {
+        prefs.remove("record");
+        prefs.end();
+    }
+    haveRecord = false;
+    Serial.println("Crash: core dump erased");
+}
+
+static void serialPrint(const char *text) {
+    Serial.print(text);
+}
+
+void crashDumpPrintStatus() {
+    if (!pending) {
+        Serial.println("Crash: no core dump");
+    } else {
+        crashDumpShow(serialPrint);
+    }
+    Serial.printf("Crash: heap now %uKB free, %uKB at least, %uKB largest block%s\n",
+                  (unsigned)(rtcSample.freeInternal / 1024), (unsigned)(rtcSample.minInternal / 1024),
+                  (unsigned)(rtcSample.largestInternal / 1024),
+                  rtcSample.failedSize ? ", an allocation failed" : "");
+}
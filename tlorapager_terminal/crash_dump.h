@@ -0,0 +1,71 @@
+/**
+ * Crash Dumps for T-LoRa Pager Terminal
+ * Core dump detection at boot, on-screen summary and upload to the host
+ *
+ * On a panic ESP-IDF writes a core dump into the coredump partition
+ * (partitions_custom.csv). At boot crashDumpBegin() looks for one and
+ * reads its summary: the crashed task, PC, exception cause and the
+ * backtrace. Heap state is not in the core, so the UI loop samples it
+ * into RTC memory once a second (crashDumpSampleHeap()), and the sample
+ * that survived the reset is saved to NVS next to the dump.
+ *
+ * The upload streams the raw partition image straight from flash into
+ * `cat` on the server, through an exec channel opened on the live SSH
+ * session next to the shell, a chunk per session task pass between the
+ * shell's reads. The dump is erased once the server has confirmed the
+ * byte count. Decode it on the host with
+ * espcoredump.py info_corefile -t raw -c FILE firmware.elf.
+ */
+
+#ifndef CRASH_DUMP_H
+#define CRASH_DUMP_H
+
+#include <Arduino.h>
+#include "settings.h"
+
+#define CRASH_NVS_NAMESPACE "crash"
+#define CRASH_SAMPLE_MS 1000         // Heap sample interval
+#define CRASH_CHUNK 2048             // Flash read / channel write size
+#define CRASH_UPLOAD_DIR "pager-cores"
+#define CRASH_UPLOAD_TIMEOUT_MS 30000
+
+typedef enum {
+    CRASH_UPLOAD_RUNNING = 0,
+    CRASH_UPLOAD_DONE,         // Stored on the server, erased here
+    CRASH_UPLOAD_FAILED
+} CrashUploadState_t;
+
+// Look for a core dump from an earlier crash (call early in setup())
+void crashDumpBegin();
+
+// A core dump is waiting to be uploaded
+bool crashDumpPending();
+
+// Summary lines for the terminal (call after the UI is up)
+void crashDumpShow(void (*print)(const char *text));
+
+// Record heap state for the next crash (call from the UI loop)
+void crashDumpSampleHeap();
+
+// Start the upload on the open SSH session (session task only).
+// Returns false if the exec channel did not open.
+bool crashDumpUploadStart();
+
+// Send what the channel window takes now, or collect the server's byte
+// count. Call between the shell's reads until it is no longer RUNNING.
+CrashUploadState_t crashDumpUploadStep();
+
+// Close the exec channel early (before the session closes)
+void crashDumpUploadAbort();
+
+// mosh has no SSH session: upload over a login of its own, blocking for
+// the transfer (session task)
+bool crashDumpUpload(ServerConfig_t *server);
+
+// Forget the core without uploading it
+void crashDumpErase();
+
+// Summary and heap sample on the serial console (`core` command)
+void crashDumpPrintStatus();
+
+#endif // CRASH_DUMP_H
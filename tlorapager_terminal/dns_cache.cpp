@@ -0,0 +1,428 @@
+/**
+ * DNS Cache Implementation
+ */
+
+#include "dns_cache.h"
+#include "settings.h"
+#include <WiFi.h>
+#include <ESPmDNS.h>
+#include <Preferences.h>
+#include <esp_random.h>
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+
+typedef enum {
+    DNS_SRC_DNS,
+    DNS_SRC_MDNS,
+    DNS_SRC_SYSTEM   // WiFi.hostByName(): no TTL
+} DnsSource_t;
+
+typedef struct {
+    char host[MAX_HOST_LEN];
+    uint32_t ip;
+    uint32_t ttl;         // Seconds
+    uint8_t source;
+} DnsRecord_t;            // As saved in NVS
+
+typedef struct {
+    DnsRecord_t rec;
+    bool used;
+    bool thisBoot;        // Resolved since boot, so resolvedMs is meaningful
+    uint32_t resolvedMs;
+    uint32_t resolveUs;   // Last network lookup
+    uint32_t hits;
+} DnsSlot_t;
+
+static DnsSlot_t slots[DNS_CACHE_SLOTS];
+static SemaphoreHandle_t cacheLock = NULL;    // slots[]
+static SemaphoreHandle_t resolveLock = NULL;  // One network lookup at a time, and NVS
+static QueueHandle_t prefetchQueue = NULL;
+static Preferences cachePrefs;
+static bool nvsOpen = false;
+static bool mdnsStarted = false;
+
+static uint32_t lookups = 0;
+static uint32_t staleServed = 0;
+static uint32_t resolved = 0;
+static uint32_t failures = 0;
+static uint32_t prefetched = 0;
+
+static const char *const sourceNames[] = {"dns", "mdns", "system"};
+
+static bool isLocalName(const char *host) {
+    size_t len = strlen(host);
+    return len > 6 && strcasecmp(host + len - 6, ".local") == 0;
+}
+
+// Caller holds cacheLock
+static DnsSlot_t *findSlot(const char *host) {
+    for (int i = 0; i < DNS_CACHE_SLOTS; i++) {
+        if (slots[i].used && strcasecmp(slots[i].rec.host, host) == 0) return &slots[i];
+    }
+    return NULL;
+}
+
+// Seconds until expiry; negative once expired. Only for thisBoot slots.
+static int32_t slotTtlLeft(const DnsSlot_t *slot) {
+    return (int32_t)slot->rec.ttl - (int32_t)((millis() - slot->resolvedMs) / 1000);
+}
+
+static bool slotFresh(const DnsSlot_t *slot) {
+    return slot->thisBoot && slotTtlLeft(slot) > 0;
+}
+
+// Caller holds resolveLock
+static void cacheSave() {
+    if (!nvsOpen) nvsOpen = cachePrefs.begin(DNS_CACHE_NVS_NAMESPACE, false);
+    if (!nvsOpen) return;
+
+    DnsRecord_t records[DNS_CACHE_SLOTS];
+    memset(records, 0, sizeof(records));
+    int count = 0;
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    for (int i = 0; i < DNS_CACHE_SLOTS; i++) {
+        if (slots[i].used) records[count++] = slots[i].rec;
+    }
+    xSemaphoreGive(cacheLock);
+
+    if (count == 0) {
+        cachePrefs.remove("records");
+    } else {
+        cachePrefs.putBytes("records", records, count * sizeof(DnsRecord_t));
+    }
+}
+
+// Record a network answer; NVS is only rewritten when an address changes
+static void cacheStore(const char *host, uint32_t ip, uint32_t ttl, uint8_t source, uint32_t us) {
+    bool changed;
+
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    DnsSlot_t *slot = findSlot(host);
+    changed = !slot || slot->rec.ip != ip;
+    if (!slot) {
+        // Free slot, or the one closest to expiry (saved ones first)
+        slot = &slots[0];
+        for (int i = 0; i < DNS_CACHE_SLOTS; i++) {
+            if (!slots[i].used) {
+                slot = &slots[i];
+                break;
+            }
+            if (!slots[i].thisBoot ||
+                (slot->thisBoot && slotTtlLeft(&slots[i]) < slotTtlLeft(slot))) {
+                slot = &slots[i];
+            }
+        }
+        memset(slot, 0, sizeof(*slot));
+        strlcpy(slot->rec.host, host, sizeof(slot->rec.host));
+        slot->used = true;
+    }
+    slot->rec.ip = ip;
+    slot->rec.ttl = min(ttl, (uint32_t)DNS_MAX_TTL_S);
+    slot->rec.source = source;
+    slot->thisBoot = true;
+    slot->resolvedMs = millis();
+    slot->resolveUs = us;
+    xSemaphoreGive(cacheLock);
+
+    if (changed) cacheSave();
+}
+
+// Skip a (possibly compressed) name; returns the offset after it or -1
+static int skipName(const uint8_t *msg, int len, int pos) {
+    while (pos < len) {
+        uint8_t b = msg[pos];
+        if (b == 0) return pos + 1;
+        if ((b & 0xC0) == 0xC0) return pos + 2 <= len ? pos + 2 : -1;
+        pos += b + 1;
+    }
+    return -1;
+}
+
+// The reply echoes our question: one entry, same QNAME (any case),
+// QTYPE and QCLASS. The query's question is uncompressed, so is the echo.
+static bool sameQuestion(const uint8_t *reply, int len, const uint8_t *query, int queryLen) {
+    if (len < queryLen || reply[4] != 0 || reply[5] != 1) return false;
+    for (int i = 12; i < queryLen - 4; i++) {
+        if (tolower(reply[i]) != tolower(query[i])) return false;
+    }
+    return memcmp(reply + queryLen - 4, query + queryLen - 4, 4) == 0;
+}
+
+// A-record query to the DHCP-provided server; the answer's lowest TTL
+// (CNAME chain included) is the cache lifetime
+static bool queryUnicast(const char *host, uint32_t *ip, uint32_t *ttl) {
+    uint32_t server = WiFi.dnsIP(0);
+    if (server == 0) return false;
+
+    uint8_t msg[512];
+    uint16_t id = esp_random();
+    int n = 0;
+    msg[n++] = id >> 8;
+    msg[n++] = id;
+    msg[n++] = 0x01;  // RD
+    msg[n++] = 0x00;
+    msg[n++] = 0;
+    msg[n++] = 1;     // QDCOUNT
+    memset(msg + n, 0, 6);
+    n += 6;
+    for (const char *label = host; *label;) {
+        const char *dot = strchr(label, '.');
+        int labelLen = dot ? dot - label : strlen(label);
+        if (labelLen == 0 || labelLen > 63 || n + labelLen + 6 > (int)sizeof(msg)) return false;
+        msg[n++] = labelLen;
+        memcpy(msg + n, label, labelLen);
+        n += labelLen;
+        label += labelLen + (dot ? 1 : 0);
+    }
+    msg[n++] = 0;
+    msg[n++] = 0;
+    msg[n++] = 1;     // QTYPE A
+    msg[n++] = 0;
+    msg[n++] = 1;     // QCLASS IN
+    int queryLen = n;
+
+    int fd = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0) return false;
+    struct timeval tv = {DNS_QUERY_TIMEOUT_MS / 1000, (DNS_QUERY_TIMEOUT_MS % 1000) * 1000};
+    lwip_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(53);
+    addr.sin_addr.s_addr = server;
+    // Connected: the stack drops datagrams from any other address or port
+    if (lwip_connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        lwip_close(fd);
+        return false;
+    }
+
+    bool found = false;
+    uint8_t query[sizeof(msg)];
+    memcpy(query, msg, queryLen);
+    for (int attempt = 0; attempt < 2 && !found; attempt++) {
+        if (lwip_send(fd, query, queryLen, 0) != queryLen) break;
+
+        int len;
+        while ((len = lwip_recv(fd, msg, sizeof(msg), 0)) > 0) {
+            // A response with our ID to our question, then RCODE 0
+            if (len < 12 || msg[0] != (uint8_t)(id >> 8) || msg[1] != (uint8_t)id) continue;
+            if (!(msg[2] & 0x80) || !sameQuestion(msg, len, query, queryLen)) continue;
+            if ((msg[3] & 0x0F) != 0) {
+                lwip_close(fd);
+                return false;  // NXDOMAIN and friends: asking again will not help
+            }
+            int answers = (msg[6] << 8) | msg[7];
+            int pos = queryLen;
+
+            uint32_t minTtl = DNS_MAX_TTL_S;
+            for (int i = 0; i < answers && pos >= 0; i++) {
+                pos = skipName(msg, len, pos);
+                if (pos < 0 || pos + 10 > len) break;
+                uint16_t type = (msg[pos] << 8) | msg[pos + 1];
+                uint16_t cls = (msg[pos + 2] << 8) | msg[pos + 3];
+                uint32_t rrTtl = ((uint32_t)msg[pos + 4] << 24) | (msg[pos + 5] << 16) |
+                                 (msg[pos + 6] << 8) | msg[pos + 7];
+                uint16_t rdLen = (msg[pos + 8] << 8) | msg[pos + 9];
+                pos += 10;
+                if (pos + rdLen > len) break;
+                minTtl = min(minTtl, rrTtl);
+                if (type == 1 && cls == 1 && rdLen == 4 && !found) {
+                    memcpy(ip, msg + pos, 4);
+                    found = true;
+                }
+                pos += rdLen;
+            }
+            *ttl = minTtl;
+            break;
+        }
+    }
+    lwip_close(fd);
+    return found;
+}
+
+static bool queryMdns(const char *host, uint32_t *ip) {
+    if (!mdnsStarted) mdnsStarted = MDNS.begin(DNS_MDNS_HOSTNAME);
+    if (!mdnsStarted) return false;
+
+    char name[MAX_HOST_LEN];
+    strlcpy(name, host, sizeof(name));
+    name[strlen(name) - 6] = '\0';  // Drop ".local"
+    IPAddress addr = MDNS.queryHost(name, DNS_MDNS_TIMEOUT_MS);
+    *ip = (uint32_t)addr;
+    return *ip != 0;
+}
+
+// Network lookup under resolveLock; a request already answered by a
+// concurrent lookup (prefetch vs connect) is served from the cache
+static bool resolveNow(const char *host, uint32_t *ip, bool force) {
+    xSemaphoreTake(resolveLock, portMAX_DELAY);
+
+    if (!force) {
+        xSemaphoreTake(cacheLock, portMAX_DELAY);
+        DnsSlot_t *slot = findSlot(host);
+        bool fresh = slot && slotFresh(slot);
+        if (fresh) *ip = slot->rec.ip;
+        xSemaphoreGive(cacheLock);
+        if (fresh) {
+            xSemaphoreGive(resolveLock);
+            return true;
+        }
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    uint32_t ttl = DNS_DEFAULT_TTL_S;
+    uint8_t source;
+    bool ok;
+    if (isLocalName(host)) {
+        source = DNS_SRC_MDNS;
+        ttl = DNS_MDNS_TTL_S;
+        ok = queryMdns(host, ip);
+    } else {
+        source = DNS_SRC_DNS;
+        ok = queryUnicast(host, ip, &ttl);
+        if (!ok) {
+            IPAddress addr;
+            source = DNS_SRC_SYSTEM;
+            ttl = DNS_DEFAULT_TTL_S;
+            ok = WiFi.hostByName(host, addr) && (uint32_t)addr != 0;
+            *ip = (uint32_t)addr;
+        }
+    }
+    uint32_t us = esp_timer_get_time() - t0;
+
+    if (ok) {
+        resolved++;
+        cacheStore(host, *ip, ttl, source, us);
+    } else {
+        failures++;
+        Serial.printf("DNS: Cannot resolve %s\n", host);
+    }
+    xSemaphoreGive(resolveLock);
+    return ok;
+}
+
+static void prefetchTask(void *param) {
+    char host[MAX_HOST_LEN];
+    while (true) {
+        if (xQueueReceive(prefetchQueue, host, portMAX_DELAY) != pdTRUE) continue;
+        if (WiFi.status() != WL_CONNECTED) continue;
+        uint32_t ip;
+        if (resolveNow(host, &ip, false)) prefetched++;
+    }
+}
+
+void dnsCacheBegin() {
+    if (cacheLock) return;
+    cacheLock = xSemaphoreCreateMutex();
+    resolveLock = xSemaphoreCreateMutex();
+    prefetchQueue = xQueueCreate(2 * DNS_CACHE_SLOTS, MAX_HOST_LEN);
+
+    // Addresses from the last boot, age unknown: stale until re-resolved
+    nvsOpen = cachePrefs.begin(DNS_CACHE_NVS_NAMESPACE, false);
+    if (nvsOpen) {
+        DnsRecord_t records[DNS_CACHE_SLOTS];
+        size_t len = cachePrefs.getBytesLength("records");
+        if (len > 0 && len <= sizeof(records) && len % sizeof(DnsRecord_t) == 0 &&
+            cachePrefs.getBytes("records", records, len) == len) {
+            for (size_t i = 0; i < len / sizeof(DnsRecord_t); i++) {
+                slots[i].rec = records[i];
+                slots[i].rec.host[MAX_HOST_LEN - 1] = '\0';
+                slots[i].used = true;
+            }
+        }
+    }
+
+    xTaskCreatePinnedToCore(prefetchTask, "dns_prefetch", 6144, NULL, 2, NULL, 0);
+}
+
+DnsAnswer_t dnsResolve(const char *host, uint32_t *ip) {
+    IPAddress literal;
+    if (literal.fromString(host)) {
+        *ip = (uint32_t)literal;
+        return DNS_ANSWER_LITERAL;
+    }
+
+    lookups++;
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    DnsSlot_t *slot = findSlot(host);
+    DnsAnswer_t answer = DNS_ANSWER_NONE;
+    if (slot) {
+        if (slotFresh(slot)) {
+            answer = DNS_ANSWER_CACHED;
+        } else if (!slot->thisBoot || -slotTtlLeft(slot) < DNS_STALE_MAX_S) {
+            answer = DNS_ANSWER_STALE;
+        }
+        if (answer != DNS_ANSWER_NONE) {
+            *ip = slot->rec.ip;
+            slot->hits++;
+        }
+    }
+    xSemaphoreGive(cacheLock);
+
+    if (answer == DNS_ANSWER_STALE) {
+        staleServed++;
+        dnsPrefetch(host);
+        return answer;
+    }
+    if (answer == DNS_ANSWER_CACHED) return answer;
+    return resolveNow(host, ip, false) ? DNS_ANSWER_RESOLVED : DNS_ANSWER_NONE;
+}
+
+bool dnsRefresh(const char *host, uint32_t *ip) {
+    return resolveNow(host, ip, true);
+}
+
+void dnsPrefetch(const char *host) {
+    if (!prefetchQueue || !host || !host[0]) return;
+
+    IPAddress literal;
+    if (literal.fromString(host)) return;
+
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    DnsSlot_t *slot = findSlot(host);
+    bool fresh = slot && slotFresh(slot);
+    xSemaphoreGive(cacheLock);
+    if (fresh) return;
+
+    char item[MAX_HOST_LEN];
+    strlcpy(item, host, sizeof(item));
+    xQueueSend(prefetchQueue, item, 0);
+}
+
+void dnsClear() {
+    xSemaphoreTake(resolveLock, portMAX_DELAY);
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    memset(slots, 0, sizeof(slots));
+    xSemaphoreGive(cacheLock);
+    cacheSave();
+    xSemaphoreGive(resolveLock);
+    lookups = staleServed = resolved = failures = prefetched = 0;
+    Serial.println("DNS: Cache cleared");
+}
+
+void dnsPrintStatus() {
+    Serial.printf("DNS cache (%d slots): %u lookups, %u stale served, %u resolved (%u prefetched), %u failed\n",
+                  DNS_CACHE_SLOTS, (unsigned)lookups, (unsigned)staleServed,
+                  (unsigned)resolved, (unsigned)prefetched, (unsigned)failures);
+
+    xSemaphoreTake(cacheLock, portMAX_DELAY);
+    for (int i = 0; i < DNS_CACHE_SLOTS; i++) {
+        const DnsSlot_t *slot = &slots[i];
+        if (!slot->used) continue;
+        char ttlText[24];
+        if (!slot->thisBoot) {
+            snprintf(ttlText, sizeof(ttlText), "saved");
+        } else if (slotFresh(slot)) {
+            snprintf(ttlText, sizeof(ttlText), "%lds left", (long)slotTtlLeft(slot));
+        } else {
+            snprintf(ttlText, sizeof(ttlText), "expired");
+        }
+        Serial.printf("  %-32s %-15s %-6s %-12s %u hits",
+                      slot->rec.host, IPAddress(slot->rec.ip).toString().c_str(),
+                      sourceNames[slot->rec.source % 3], ttlText, (unsigned)slot->hits);
+        if (slot->thisBoot) Serial.printf(", resolved in %.1fms", slot->resolveUs / 1000.0f);
+        Serial.println();
+    }
+    xSemaphoreGive(cacheLock);
+}
@@ -0,0 +1,60 @@
+/**
+ * DNS Cache for T-LoRa Pager Terminal
+ * Host name -> IPv4 address, TTL-respecting, kept in NVS across reboots
+ *
+ * Unicast names are looked up with a small A-record query of our own,
+ * which (unlike WiFi.hostByName) gives us the TTL; `.local` names go to
+ * mDNS. Configured hosts are prefetched by a background task when Wi-Fi
+ * connects, so a connect normally finds its address already cached.
+ *
+ * There is no wall clock, so the age of an address saved by the last
+ * boot is unknown: those, and addresses past their TTL, are stale. A
+ * stale address is still handed out at once (and re-resolved in the
+ * background); netConnect() re-resolves and retries if connecting to it
+ * fails. Only a host never seen before waits for the network.
+ */
+
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <Arduino.h>
+
+#define DNS_CACHE_SLOTS 8
+#define DNS_CACHE_NVS_NAMESPACE "dns_cache"
+#define DNS_QUERY_TIMEOUT_MS 1500      // Per attempt, 2 attempts
+#define DNS_MDNS_TIMEOUT_MS 2000
+#define DNS_MDNS_HOSTNAME "tlora-pager"
+#define DNS_DEFAULT_TTL_S 300          // When the resolver does not tell us
+#define DNS_MDNS_TTL_S 120             // RFC 6762 host record TTL
+#define DNS_MAX_TTL_S 86400
+#define DNS_STALE_MAX_S 3600           // Expired longer than this: wait for a fresh answer
+
+// Load the saved addresses and start the prefetch task
+void dnsCacheBegin();
+
+// How the last dnsResolve() was answered
+typedef enum {
+    DNS_ANSWER_NONE,      // Failed
+    DNS_ANSWER_LITERAL,   // Host was an IP address
+    DNS_ANSWER_CACHED,    // Within its TTL
+    DNS_ANSWER_STALE,     // Expired or from the last boot; refresh queued
+    DNS_ANSWER_RESOLVED   // Waited for the network
+} DnsAnswer_t;
+
+// Address of host (network byte order, as in sin_addr.s_addr).
+// Blocks only when the host is not cached at all.
+DnsAnswer_t dnsResolve(const char *host, uint32_t *ip);
+
+// Resolve on the network now, bypassing the cache (and update it)
+bool dnsRefresh(const char *host, uint32_t *ip);
+
+// Queue host for background resolution unless its address is fresh
+void dnsPrefetch(const char *host);
+
+// Drop everything (RAM and NVS)
+void dnsClear();
+
+// Print cached hosts, TTLs and hit counts to Serial
+void dnsPrintStatus();
+
+#endif // DNS_CACHE_H
@@ -0,0 +1,138 @@
+/**
+ * Haptic Engine Implementation
+ */
+
+#include "haptics.h"
+#include "settings.h"
+#include <LilyGoLib.h>
+#include <esp_timer.h>
+
+#define HAPTIC_MAX_STEPS 3
+
+typedef struct {
+    uint8_t effects[HAPTIC_MAX_STEPS];   // DRV2605 library effects, 0 ends
+    const char *name;
+} HapticPattern_t;
+
+static const HapticPattern_t patterns[HAPTIC_EVENT_COUNT] = {
+    {{1, 0, 0}, "click"},      // Strong click
+    {{10, 0, 0}, "tick"},      // Double click
+    {{47, 0, 0}, "bump"},      // Buzz
+    {{1, 1, 0}, "double"},
+    {{0, 0, 0}, "key"},        // Timed, buzzMs
+    {{0, 0, 0}, "bell"},       // Timed, buzzMs
+    {{14, 14, 0}, "alert"},    // Strong buzz, twice
+};
+
+static QueueHandle_t hapticQueue = NULL;
+static TaskHandle_t hapticTaskHandle = NULL;
+static volatile bool playing = false;
+
+static bool configEnabled = true;
+static uint8_t buzzMs[HAPTIC_EVENT_COUNT];      // Timed events only
+static uint16_t minGapMs[HAPTIC_EVENT_COUNT];
+static unsigned long lastQueuedMs[HAPTIC_EVENT_COUNT];
+
+static uint32_t played[HAPTIC_EVENT_COUNT];
+static uint32_t rateLimited[HAPTIC_EVENT_COUNT];
+static uint32_t queueFull = 0;
+static uint32_t i2cUsMax = 0;
+static uint64_t i2cUsTotal = 0;
+
+static void hapticTask(void *pvParameters) {
+    uint8_t event;
+    while (true) {
+        if (xQueueReceive(hapticQueue, &event, portMAX_DELAY) != pdTRUE) continue;
+        playing = true;
+
+        int64_t t0 = esp_timer_get_time();
+        uint32_t us;
+        if (buzzMs[event]) {
+            instance.drv.setWaveform(0, HAPTIC_LONG_BUZZ);
+            instance.drv.setWaveform(1, 0);
+            instance.drv.run();
+            us = esp_timer_get_time() - t0;
+            vTaskDelay(pdMS_TO_TICKS(buzzMs[event]));
+            t0 = esp_timer_get_time();
+            instance.drv.stop();
+            us += esp_timer_get_time() - t0;
+        } else {
+            const HapticPattern_t &p = patterns[event];
+            int slot = 0;
+            for (; slot < HAPTIC_MAX_STEPS && p.effects[slot]; slot++) {
+                instance.drv.setWaveform(slot, p.effects[slot]);
+            }
+            instance.drv.setWaveform(slot, 0);
+            instance.drv.run();
+            us = esp_timer_get_time() - t0;
+        }
+
+        i2cUsTotal += us;
+        if (us > i2cUsMax) i2cUsMax = us;
+        played[event]++;
+        playing = false;
+    }
+}
+
+void hapticsBegin() {
+    if (hapticTaskHandle) return;
+    hapticQueue = xQueueCreate(HAPTIC_QUEUE_LEN, sizeof(uint8_t));
+    if (hapticQueue == NULL) {
+        Serial.println("Haptics: queue allocation failed");
+        return;
+    }
+    // Core 0 at low priority, next to the Wi-Fi stack's housekeeping
+    xTaskCreatePinnedToCore(hapticTask, "haptics", 3072, NULL, 1, &hapticTaskHandle, 0);
+}
+
+void hapticsConfigure(const HapticsConfig &config) {
+    configEnabled = config.enabled;
+    buzzMs[HAPTIC_KEY] = config.keypressMs;
+    buzzMs[HAPTIC_BELL] = config.bellMs;
+    memset(minGapMs, 0, sizeof(minGapMs));
+    minGapMs[HAPTIC_KEY] = config.keypressMs * HAPTIC_REPEAT_GAP;
+    minGapMs[HAPTIC_BELL] = config.bellMs * HAPTIC_REPEAT_GAP;
+    minGapMs[HAPTIC_ALERT] = HAPTIC_ALERT_GAP_MS;
+}
+
+bool hapticPlay(HapticEvent_t event) {
+    if (!settings.hapticEnabled || !configEnabled || hapticQueue == NULL) return false;
+    if ((event == HAPTIC_KEY || event == HAPTIC_BELL) && buzzMs[event] == 0) return false;
+
+    unsigned long now = millis();
+    if (lastQueuedMs[event] != 0 && now - lastQueuedMs[event] < minGapMs[event]) {
+        rateLimited[event]++;
+        return false;
+    }
+
+    uint8_t e = event;
+    if (xQueueSend(hapticQueue, &e, 0) != pdTRUE) {
+        queueFull++;
+        return false;
+    }
+    lastQueuedMs[event] = now;
+    return true;
+}
+
+void hapticsWaitIdle(uint32_t timeoutMs) {
+    if (hapticQueue == NULL) return;
+    unsigned long start = millis();
+    while ((uxQueueMessagesWaiting(hapticQueue) > 0 || playing) && millis() - start < timeoutMs) {
+        delay(5);
+    }
+    delay(HAPTIC_SETTLE_MS);  // The motor is still running the last pattern
+}
+
+void hapticsPrintStats() {
+    uint32_t total = 0;
+    for (int i = 0; i < HAPTIC_EVENT_COUNT; i++) total += played[i];
+
+    Serial.printf("Haptics: %s, %u played, %u dropped (queue full), I2C avg %uus max %uus\n",
+                  settings.hapticEnabled && configEnabled ? "on" : "off", (unsigned)total,
+                  (unsigned)queueFull, total ? (unsigned)(i2cUsTotal / total) : 0, (unsigned)i2cUsMax);
+    for (int i = 0; i < HAPTIC_EVENT_COUNT; i++) {
+        if (played[i] == 0 && rateLimited[i] == 0) continue;
+        Serial.printf("  %-7s %6u played %6u rate-limited (gap %ums)\n", patterns[i].name,
+                      (unsigned)played[i], (unsigned)rateLimited[i], (unsigned)minGapMs[i]);
+    }
+}
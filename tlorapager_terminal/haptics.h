@@ -0,0 +1,54 @@
+/**
+ * Haptic Engine for T-LoRa Pager Terminal
+ * Haptic events queued for a low-priority task that drives the DRV2605,
+ * so the I2C writes never run on the UI loop
+ *
+ * hapticPlay() only queues. Repeats of one event closer together than
+ * its minimum gap are dropped (key repeat, bell storms), as are events
+ * when the queue is full: a late buzz is worse than none.
+ *
+ * Keypress and bell buzzes last HapticsConfig.keypressMs and bellMs:
+ * the motor runs the library's long buzz and is stopped after that
+ * long. A length of 0 turns that buzz off.
+ */
+
+#ifndef HAPTICS_H
+#define HAPTICS_H
+
+#include <Arduino.h>
+#include "ConfigLoader.h"
+
+#define HAPTIC_QUEUE_LEN 8
+#define HAPTIC_REPEAT_GAP 4        // Repeat gap in buzz lengths (key, bell)
+#define HAPTIC_ALERT_GAP_MS 2000   // One alert buzz per burst of matches
+#define HAPTIC_SETTLE_MS 150       // Longest pattern, for hapticsWaitIdle()
+#define HAPTIC_LONG_BUZZ 118       // Library effect that runs until stopped
+
+typedef enum {
+    HAPTIC_CLICK = 0,   // Menu select, mode toggles
+    HAPTIC_TICK,        // Menu value change
+    HAPTIC_BUMP,        // Scrolled to the end of a list
+    HAPTIC_DOUBLE,      // Destructive action confirmed
+    HAPTIC_KEY,         // Keypress, timed (HapticsConfig.keypressMs)
+    HAPTIC_BELL,        // BEL from the host, timed (HapticsConfig.bellMs)
+    HAPTIC_ALERT,       // Output watcher match
+    HAPTIC_EVENT_COUNT
+} HapticEvent_t;
+
+// Start the haptic task
+void hapticsBegin();
+
+// Enable flag and buzz lengths from the loaded config
+void hapticsConfigure(const HapticsConfig &config);
+
+// Queue an event (no-op when haptics are off, or for a timed event with
+// length 0). Returns false if it was rate-limited or the queue was full.
+bool hapticPlay(HapticEvent_t event);
+
+// Block until queued patterns have played (before a restart)
+void hapticsWaitIdle(uint32_t timeoutMs);
+
+// Played / dropped counts and I2C time
+void hapticsPrintStats();
+
+#endif // HAPTICS_H
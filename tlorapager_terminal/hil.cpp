@@ -0,0 +1,267 @@
+/**
+ * Hardware-in-the-Loop Protocol Implementation
+ */
+
+#include "hil.h"
+#include "pipeline_stats.h"
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+typedef struct {
+    const char *name;
+    uint32_t ms;
+} HilBootMark_t;
+
+static HilBootMark_t bootMarks[HIL_BOOT_MARKS];
+static int bootMarkCount = 0;
+
+static uint8_t payload[HIL_MAX_PAYLOAD];
+static uint8_t reply[HIL_MAX_PAYLOAD + 9];
+
+// Display refreshes since the last STATS_RESET
+static volatile uint32_t displayFrames = 0;
+static volatile uint64_t displayUs = 0;
+static int64_t refrStartUs = 0;
+static bool refrDrew = false;
+
+// The one KEY / REPLAY_WAIT in progress
+static uint8_t waitCmd = 0;
+static uint8_t waitSeq = 0;
+static int64_t waitStartUs = 0;
+static uint32_t waitFrames = 0;
+static volatile uint32_t waitResultUs = 0;
+static volatile bool waitDone = false;
+static int keyPending = -1;
+
+static uint16_t crc16(uint16_t crc, const uint8_t *data, size_t len) {
+    while (len--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// In one write, so log output from other tasks cannot split the frame
+static void sendReply(uint8_t cmd, uint8_t seq, HilStatus_t status, const void *data, uint16_t len) {
+    reply[0] = HIL_SYNC0;
+    reply[1] = HIL_SYNC1;
+    reply[2] = cmd | 0x80;
+    reply[3] = seq;
+    reply[4] = status;
+    reply[5] = len & 0xFF;
+    reply[6] = len >> 8;
+    if (len) memcpy(reply + 7, data, len);
+    uint16_t crc = crc16(0xFFFF, reply + 2, 5 + len);
+    reply[7 + len] = crc & 0xFF;
+    reply[8 + len] = crc >> 8;
+    Serial.write(reply, 9 + len);
+}
+
+static bool readExact(uint8_t *buf, size_t len, unsigned long deadline) {
+    size_t got = 0;
+    while (got < len) {
+        if (Serial.available()) {
+            buf[got++] = Serial.read();
+        } else if ((long)(millis() - deadline) > 0) {
+            return false;
+        } else {
+            delay(1);
+        }
+    }
+    return true;
+}
+
+// Refresh timing; a refresh with nothing to draw is not a frame
+static void refrEventCb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_REFR_START) {
+        refrStartUs = esp_timer_get_time();
+        refrDrew = false;
+    } else if (code == LV_EVENT_RENDER_START) {
+        refrDrew = true;
+    } else if (code == LV_EVENT_REFR_READY && refrDrew) {
+        int64_t now = esp_timer_get_time();
+        displayFrames++;
+        displayUs += now - refrStartUs;
+
+        // A typed key is on screen once the text area changed and was drawn
+        if (waitCmd == HIL_KEY && keyPending < 0 && !waitDone &&
+            pipelineStats.renderFrames != waitFrames) {
+            waitResultUs = now - waitStartUs;
+            waitDone = true;
+        }
+    }
+}
+
+void hilBegin() {
+    lv_display_t *disp = lv_display_get_default();
+    if (disp == NULL) return;
+    lv_display_add_event_cb(disp, refrEventCb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refrEventCb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, refrEventCb, LV_EVENT_REFR_READY, NULL);
+}
+
+void hilBootMark(const char *phase) {
+    for (int i = 0; i < bootMarkCount; i++) {
+        if (strcmp(bootMarks[i].name, phase) == 0) return;
+    }
+    if (bootMarkCount < HIL_BOOT_MARKS) {
+        bootMarks[bootMarkCount].name = phase;
+        bootMarks[bootMarkCount].ms = millis();
+        bootMarkCount++;
+    }
+}
+
+bool hilTakeKey(char *key) {
+    if (keyPending < 0) return false;
+    *key = (char)keyPending;
+    keyPending = -1;
+    return true;
+}
+
+static void fillCounters(HilCounters_t *c) {
+    const PipelineStats_t &s = pipelineStats;
+    memset(c, 0, sizeof(*c));
+    c->uptimeMs = millis();
+    c->windowMs = (esp_timer_get_time() - s.sinceUs) / 1000;
+    c->rxBytes = s.rxBytes;
+    c->rxDropped = s.rxDropped;
+    c->rxPauses = s.rxPauses;
+    c->renderBytes = s.renderBytes;
+    c->renderCalls = s.renderCalls;
+    c->renderUs = (uint32_t)s.renderUs;
+    c->renderFrames = s.renderFrames;
+    c->jumpScrolls = s.jumpScrolls;
+    c->displayFrames = displayFrames;
+    c->displayUs = (uint32_t)displayUs;
+    c->txKeys = s.txKeys;
+    c->txBytes = s.txBytes;
+    c->heapFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    c->heapLargest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    c->heapMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    c->psramFree = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+}
+
+static void startWait(uint8_t cmd, uint8_t seq) {
+    waitCmd = cmd;
+    waitSeq = seq;
+    waitStartUs = esp_timer_get_time();
+    waitFrames = pipelineStats.renderFrames;
+    waitDone = false;
+}
+
+static void handleFrame(uint8_t cmd, uint8_t seq, uint16_t len) {
+    switch (cmd) {
+        case HIL_PING: {
+            uint8_t out[5 + 32];
+            uint32_t up = millis();
+            out[0] = HIL_PROTOCOL_VERSION;
+            memcpy(out + 1, &up, 4);
+            int n = snprintf((char *)out + 5, sizeof(out) - 5, "%s %s", __DATE__, __TIME__);
+            sendReply(cmd, seq, HIL_OK, out, 5 + n);
+            break;
+        }
+        case HIL_STATS_RESET:
+            statsReset();
+            displayFrames = 0;
+            displayUs = 0;
+            sendReply(cmd, seq, HIL_OK, NULL, 0);
+            break;
+        case HIL_COUNTERS: {
+            HilCounters_t c;
+            fillCounters(&c);
+            sendReply(cmd, seq, HIL_OK, &c, sizeof(c));
+            break;
+        }
+        case HIL_BOOT: {
+            uint8_t out[1 + HIL_BOOT_MARKS * 37];
+            int n = 1;
+            out[0] = bootMarkCount;
+            for (int i = 0; i < bootMarkCount; i++) {
+                uint8_t nameLen = min(strlen(bootMarks[i].name), (size_t)32);
+                memcpy(out + n, &bootMarks[i].ms, 4);
+                out[n + 4] = nameLen;
+                memcpy(out + n + 5, bootMarks[i].name, nameLen);
+                n += 5 + nameLen;
+            }
+            sendReply(cmd, seq, HIL_OK, out, n);
+            break;
+        }
+        case HIL_REPLAY_DATA: {
+            if (sessionActive()) {
+                sendReply(cmd, seq, HIL_ERR_BUSY, NULL, 0);
+                break;
+            }
+            uint16_t accepted = sshRxOffer((const char *)payload, len);
+            sendReply(cmd, seq, HIL_OK, &accepted, 2);
+            break;
+        }
+        case HIL_REPLAY_WAIT:
+        case HIL_KEY:
+            if (waitCmd != 0 || (cmd == HIL_KEY && len != 1)) {
+                sendReply(cmd, seq, waitCmd ? HIL_ERR_BUSY : HIL_ERR_LENGTH, NULL, 0);
+                break;
+            }
+            if (cmd == HIL_KEY) keyPending = payload[0];
+            startWait(cmd, seq);
+            break;
+        case HIL_COMMAND: {
+            payload[min((int)len, HIL_MAX_PAYLOAD - 1)] = '\0';
+            unsigned long start = millis();
+            serialCommand(String((const char *)payload));
+            uint32_t ms = millis() - start;
+            sendReply(cmd, seq, HIL_OK, &ms, 4);
+            break;
+        }
+        default:
+            sendReply(cmd, seq, HIL_ERR_UNKNOWN, NULL, 0);
+            break;
+    }
+}
+
+void hilPoll() {
+    unsigned long deadline = millis() + HIL_FRAME_TIMEOUT_MS;
+    uint8_t hdr[6];
+
+    if (!readExact(hdr, 2, deadline) || hdr[0] != HIL_SYNC0 || hdr[1] != HIL_SYNC1) return;
+    if (!readExact(hdr + 2, 4, deadline)) return;
+    uint8_t cmd = hdr[2];
+    uint8_t seq = hdr[3];
+    uint16_t len = hdr[4] | (hdr[5] << 8);
+    if (len > HIL_MAX_PAYLOAD) {
+        sendReply(cmd, seq, HIL_ERR_LENGTH, NULL, 0);
+        return;
+    }
+
+    uint8_t crcBytes[2];
+    if (!readExact(payload, len, deadline) || !readExact(crcBytes, 2, deadline)) return;
+    uint16_t crc = crc16(crc16(0xFFFF, hdr + 2, 4), payload, len);
+    if (crc != (crcBytes[0] | (crcBytes[1] << 8))) {
+        sendReply(cmd, seq, HIL_ERR_CRC, NULL, 0);
+        return;
+    }
+    handleFrame(cmd, seq, len);
+}
+
+void hilLoop() {
+    if (waitCmd == 0) return;
+
+    if (waitCmd == HIL_REPLAY_WAIT && sshRxPending() == 0) {
+        waitResultUs = esp_timer_get_time() - waitStartUs;
+        waitDone = true;
+    }
+
+    if (waitDone) {
+        uint32_t us = waitResultUs;
+        sendReply(waitCmd, waitSeq, HIL_OK, &us, 4);
+    } else if (esp_timer_get_time() - waitStartUs > HIL_WAIT_TIMEOUT_MS * 1000LL) {
+        sendReply(waitCmd, waitSeq, HIL_ERR_TIMEOUT, NULL, 0);
+        keyPending = -1;
+    } else {
+        return;
+    }
+    waitCmd = 0;
+}
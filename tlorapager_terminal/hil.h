@@ -0,0 +1,93 @@
+/**
+ * Hardware-in-the-Loop Protocol for T-LoRa Pager Terminal
+ * Binary commands on the USB serial port, for tools/hil_bench.py
+ *
+ * Frames share the port with the text console and the log: they start
+ * with the sync bytes A5 5A, which no text line begins with, and carry a
+ * CRC so the host can pick replies out of interleaved log output.
+ *
+ *   request:  A5 5A cmd seq len(u16) payload crc(u16)
+ *   reply:    A5 5A cmd|0x80 seq status len(u16) payload crc(u16)
+ *
+ * Integers are little-endian; the CRC is CRC-16/CCITT-FALSE over
+ * everything after the sync bytes. KEY and REPLAY_WAIT reply once the
+ * result is in (or after HIL_WAIT_TIMEOUT_MS); the rest reply at once.
+ */
+
+#ifndef HIL_H
+#define HIL_H
+
+#include <Arduino.h>
+
+#define HIL_SYNC0 0xA5
+#define HIL_SYNC1 0x5A
+#define HIL_PROTOCOL_VERSION 1
+#define HIL_MAX_PAYLOAD 1024
+#define HIL_FRAME_TIMEOUT_MS 200   // Rest of a frame after its first byte
+#define HIL_WAIT_TIMEOUT_MS 5000   // Longest KEY / REPLAY_WAIT
+#define HIL_BOOT_MARKS 16
+
+typedef enum {
+    HIL_PING = 0x01,         // -> version u8, uptime ms u32, build string
+    HIL_STATS_RESET = 0x02,  // Start a new counter window
+    HIL_COUNTERS = 0x03,     // -> HilCounters_t
+    HIL_BOOT = 0x04,         // -> count u8, then {ms u32, len u8, name}
+    HIL_REPLAY_DATA = 0x10,  // Bytes into the RX ring as if from the host -> accepted u16
+    HIL_REPLAY_WAIT = 0x11,  // Reply when the RX ring is drained and drawn
+    HIL_KEY = 0x20,          // Type key (u8) -> us until a frame shows it, u32
+    HIL_COMMAND = 0x30       // Run a text console command; its output is logged as text
+} HilCmd_t;
+
+typedef enum {
+    HIL_OK = 0,
+    HIL_ERR_CRC,
+    HIL_ERR_UNKNOWN,
+    HIL_ERR_BUSY,      // Session open, or another wait pending
+    HIL_ERR_TIMEOUT,
+    HIL_ERR_LENGTH
+} HilStatus_t;
+
+// Reply to HIL_COUNTERS (packed, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t uptimeMs;
+    uint32_t windowMs;        // Since the last STATS_RESET
+    uint32_t rxBytes;
+    uint32_t rxDropped;
+    uint32_t rxPauses;
+    uint32_t renderBytes;
+    uint32_t renderCalls;
+    uint32_t renderUs;        // Parse + text area update
+    uint32_t renderFrames;    // Text area updates
+    uint32_t jumpScrolls;
+    uint32_t displayFrames;   // LVGL refreshes that drew
+    uint32_t displayUs;       // Time in those refreshes
+    uint32_t txKeys;
+    uint32_t txBytes;
+    uint32_t heapFree;        // Internal RAM
+    uint32_t heapLargest;
+    uint32_t heapMinFree;     // Low-water mark since boot
+    uint32_t psramFree;
+} HilCounters_t;
+
+// Hook the display refresh events (after LVGL is up)
+void hilBegin();
+
+// Record a boot phase as done now (first call per name counts)
+void hilBootMark(const char *phase);
+
+// Read and answer one frame; call when the next serial byte is HIL_SYNC0
+void hilPoll();
+
+// Finish a pending KEY / REPLAY_WAIT (each loop)
+void hilLoop();
+
+// Key typed by HIL_KEY, if any, for the keyboard handler
+bool hilTakeKey(char *key);
+
+// Provided by the sketch
+int sshRxOffer(const char *data, int len);  // Bytes that fit in the RX ring
+int sshRxPending();                          // Bytes not yet drawn
+bool sessionActive();
+void serialCommand(const String &cmd);
+
+#endif // HIL_H
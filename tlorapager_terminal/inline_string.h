@@ -0,0 +1,48 @@
+/**
+ * Fixed-Capacity Inline String for T-LoRa Pager Terminal
+ * A char array with the read side of Arduino String's interface
+ *
+ * Config fields were Arduino Strings: one heap buffer each, reallocated
+ * while parsing, all allocated early in boot and alive forever. This
+ * keeps the text inside the struct instead. Assigning text longer than
+ * the capacity truncates it and returns false.
+ */
+
+#ifndef INLINE_STRING_H
+#define INLINE_STRING_H
+
+#include <Arduino.h>
+
+template <size_t N>
+class InlineString {
+public:
+    InlineString() { _buf[0] = '\0'; }
+    InlineString(const char* s) { assign(s); }
+
+    InlineString& operator=(const char* s) { assign(s); return *this; }
+    InlineString& operator=(const String& s) { assign(s.c_str()); return *this; }
+
+    // Copy s (NULL = empty); false if it had to be truncated
+    bool assign(const char* s) {
+        size_t n = s ? strlen(s) : 0;
+        bool fits = n < N;
+        if (!fits) n = N - 1;
+        if (n) memcpy(_buf, s, n);
+        _buf[n] = '\0';
+        return fits;
+    }
+
+    const char* c_str() const { return _buf; }
+    size_t length() const { return strlen(_buf); }
+    bool isEmpty() const { return _buf[0] == '\0'; }
+    bool startsWith(const char* prefix) const { return strncmp(_buf, prefix, strlen(prefix)) == 0; }
+    bool operator==(const char* s) const { return strcmp(_buf, s) == 0; }
+    bool operator!=(const char* s) const { return strcmp(_buf, s) != 0; }
+
+    static constexpr size_t capacity() { return N - 1; }
+
+private:
+    char _buf[N];
+};
+
+#endif // INLINE_STRING_H
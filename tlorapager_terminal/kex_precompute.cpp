@@ -0,0 +1,144 @@
+/**
+ * SSH Key Exchange Precompute Implementation
+ */
+
+#include "kex_precompute.h"
+#include <esp_random.h>
+#include <esp_timer.h>
+#include <mbedtls/ecp.h>
+
+static uint8_t readyPriv[KEX_KEY_SIZE];
+static uint8_t readyPub[KEX_KEY_SIZE];
+static volatile bool ready = false;
+static volatile bool enabled = true;
+static portMUX_TYPE kexMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t kexTaskHandle = NULL;
+
+static uint32_t generated = 0;
+static uint32_t used = 0;
+static uint32_t inlineKeys = 0;
+static uint64_t keygenUsTotal = 0;
+
+static int kexRng(void *, unsigned char *buf, size_t len) {
+    esp_fill_random(buf, len);
+    return 0;
+}
+
+// X25519 with the base point: pub = clamp(priv) * 9
+static bool kexScalarmultBase(uint8_t *pub, const uint8_t *priv) {
+    uint8_t k[KEX_KEY_SIZE];
+    memcpy(k, priv, sizeof(k));
+    k[0] &= 248;
+    k[31] &= 127;
+    k[31] |= 64;
+
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point q;
+    mbedtls_mpi d;
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&q);
+    mbedtls_mpi_init(&d);
+
+    bool ok = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_CURVE25519) == 0 &&
+              mbedtls_mpi_read_binary_le(&d, k, sizeof(k)) == 0 &&
+              mbedtls_ecp_mul(&grp, &q, &d, &grp.G, kexRng, NULL) == 0 &&
+              mbedtls_mpi_write_binary_le(&q.X, pub, KEX_KEY_SIZE) == 0;
+
+    mbedtls_mpi_free(&d);
+    mbedtls_ecp_point_free(&q);
+    mbedtls_ecp_group_free(&grp);
+    memset(k, 0, sizeof(k));
+    return ok;
+}
+
+// Lowest priority: only runs when the UI and network have nothing to do
+static void kexTask(void *param) {
+    uint8_t priv[KEX_KEY_SIZE];
+    uint8_t pub[KEX_KEY_SIZE];
+
+    while (true) {
+        if (enabled && !ready) {
+            int64_t t0 = esp_timer_get_time();
+            esp_fill_random(priv, sizeof(priv));
+            if (kexScalarmultBase(pub, priv)) {
+                keygenUsTotal += esp_timer_get_time() - t0;
+                generated++;
+                portENTER_CRITICAL(&kexMux);
+                if (enabled) {
+                    memcpy(readyPriv, priv, sizeof(priv));
+                    memcpy(readyPub, pub, sizeof(pub));
+                    ready = true;
+                }
+                portEXIT_CRITICAL(&kexMux);
+            }
+            memset(priv, 0, sizeof(priv));
+        }
+        // Woken when a keypair is taken or precompute is re-enabled
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+void kexPrecomputeBegin() {
+    if (kexTaskHandle) return;
+    xTaskCreatePinnedToCore(kexTask, "kex_precompute", 6144, NULL, 1, &kexTaskHandle, 0);
+}
+
+void kexPrecomputeSetEnabled(bool on) {
+    enabled = on;
+    if (!on) {
+        portENTER_CRITICAL(&kexMux);
+        memset(readyPriv, 0, sizeof(readyPriv));
+        ready = false;
+        portEXIT_CRITICAL(&kexMux);
+    } else if (kexTaskHandle) {
+        xTaskNotifyGive(kexTaskHandle);
+    }
+}
+
+bool kexPrecomputeEnabled() {
+    return enabled;
+}
+
+bool kexPrecomputeReady() {
+    return ready;
+}
+
+uint32_t kexPrecomputeUsed() {
+    return used;
+}
+
+void kexPrecomputePrintStatus() {
+    Serial.printf("Kex precompute: %s, keypair %s\n",
+                  enabled ? "on" : "off", ready ? "ready" : "not ready");
+    Serial.printf("  generated %u (avg %.1fms), used %u, computed inline %u\n",
+                  (unsigned)generated, generated ? keygenUsTotal / 1000.0f / generated : 0,
+                  (unsigned)used, (unsigned)inlineKeys);
+}
+
+// libssh's curve25519 kex calls crypto_scalarmult_base(pubkey, privkey)
+// right after filling privkey with random bytes. Hand it the ready
+// keypair instead: privkey is a writable buffer in the session's crypto
+// state, and one random key is as good as another as long as it is used
+// once. Nothing ready: hand the call on to libssh's own implementation.
+extern "C" int __real_crypto_scalarmult_base(unsigned char *q, const unsigned char *n);
+
+extern "C" int __wrap_crypto_scalarmult_base(unsigned char *q, const unsigned char *n) {
+    bool took = false;
+    portENTER_CRITICAL(&kexMux);
+    if (ready) {
+        memcpy((unsigned char *)n, readyPriv, KEX_KEY_SIZE);
+        memcpy(q, readyPub, KEX_KEY_SIZE);
+        memset(readyPriv, 0, sizeof(readyPriv));
+        ready = false;
+        took = true;
+    }
+    portEXIT_CRITICAL(&kexMux);
+
+    if (took) {
+        used++;
+        if (kexTaskHandle) xTaskNotifyGive(kexTaskHandle);
+        return 0;
+    }
+    inlineKeys++;
+    return __real_crypto_scalarmult_base(q, n);
+}
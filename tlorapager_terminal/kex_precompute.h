@@ -0,0 +1,37 @@
+/**
+ * SSH Key Exchange Precompute for T-LoRa Pager Terminal
+ * Ephemeral curve25519 keypairs generated ahead of time, at idle
+ *
+ * libssh generates the client's ephemeral key inside ssh_connect(),
+ * after TCP connect and the banner exchange. A low-priority task keeps
+ * one keypair ready instead, and the linker redirects libssh's
+ * crypto_scalarmult_base() here (-Wl,--wrap in platformio.ini) so kex
+ * starts with it. Each keypair is handed out once; the shared secret
+ * still depends on the server's key and is computed during kex.
+ */
+
+#ifndef KEX_PRECOMPUTE_H
+#define KEX_PRECOMPUTE_H
+
+#include <Arduino.h>
+
+#define KEX_KEY_SIZE 32
+
+// Start the background task and compute the first keypair
+void kexPrecomputeBegin();
+
+// Turn precomputation on/off (off: libssh computes keys inline)
+void kexPrecomputeSetEnabled(bool enabled);
+bool kexPrecomputeEnabled();
+
+// True if a keypair is waiting for the next connect
+bool kexPrecomputeReady();
+
+// Keypairs handed to libssh so far (changes across a connect if kex
+// started with a precomputed one)
+uint32_t kexPrecomputeUsed();
+
+// Print keypairs made, used and computed inline to Serial
+void kexPrecomputePrintStatus();
+
+#endif // KEX_PRECOMPUTE_H
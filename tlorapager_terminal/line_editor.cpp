@@ -0,0 +1,292 @@
+/**
+ * Local Line Editor Implementation
+ */
+
+#include "line_editor.h"
+
+static VtTerminal *term = NULL;
+static LineEditSendFn sendFn = NULL;
+static bool enabled = false;
+
+// Line being edited; its echo starts at the host's cursor (anchor)
+static char line[LINE_EDIT_MAX];
+static int lineLen = 0;
+static int cursor = 0;
+static bool anchored = false;
+static int anchorX = 0;
+static int anchorY = 0;
+
+static char killBuf[LINE_EDIT_MAX];
+static int killLen = 0;
+
+// History ring, newest at historyNext - 1
+static char history[LINE_HISTORY_MAX][LINE_EDIT_MAX];
+static int historyCount = 0;
+static int historyNext = 0;
+static int historyPos = -1;       // Entries back while browsing, -1 = editing
+static char draft[LINE_EDIT_MAX]; // Line being edited before browsing
+
+static uint32_t keysEdited = 0;
+static uint32_t linesSent = 0;
+static uint32_t writes = 0;
+
+// The host's attributes, put back after the echo
+static uint8_t hostAttr = 0;
+
+static void echoCup(int x, int y) {
+    char seq[16];
+    int n = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", y + 1, x + 1);
+    term->write(seq, n);
+}
+
+// Echo in plain attributes, whatever SGR the host left set
+static void echoBegin() {
+    hostAttr = term->attr();
+    if (hostAttr) term->write("\x1b[m", 3);
+}
+
+static void echoEnd() {
+    if (!hostAttr) return;
+    char seq[16];
+    int n = snprintf(seq, sizeof(seq), "\x1b[%s%s%sm",
+                     hostAttr & VT_ATTR_BOLD ? ";1" : "",
+                     hostAttr & VT_ATTR_UNDERLINE ? ";4" : "",
+                     hostAttr & VT_ATTR_REVERSE ? ";7" : "");
+    term->write(seq, n);
+}
+
+// Clear from the anchor down and leave the cursor where the host had it.
+// The echo is only drawn with the parser idle, and host output always
+// comes after an erase, so the parser is idle here too.
+static void erase() {
+    if (!anchored || !term->idle()) return;
+    echoBegin();
+    echoCup(anchorX, anchorY);
+    term->write("\x1b[J", 3);
+    echoEnd();
+    anchored = false;
+}
+
+// Drawn between host sequences only: mid-sequence (a CSI, OSC, DCS or
+// UTF-8 character split across reads) the echo would end up inside it.
+// lineEditShow() draws it once the host's output is back in ground state.
+static void redraw() {
+    if (!term->idle()) return;
+    if (!anchored) {
+        anchorX = term->cursorX();
+        anchorY = term->cursorY();
+        anchored = true;
+    }
+    echoBegin();
+    int cols = term->cols();
+    echoCup(anchorX, anchorY);
+    term->write("\x1b[J", 3);
+    term->write(line, lineLen);
+
+    // A line running past the bottom row scrolled the screen
+    if (lineLen > 0) {
+        int lastRow = anchorY + (anchorX + lineLen - 1) / cols;
+        if (lastRow > term->cursorY()) anchorY -= lastRow - term->cursorY();
+    }
+
+    int pos = anchorX + cursor;
+    int x = pos % cols;
+    int y = anchorY + pos / cols;
+    if (y >= term->rows()) {
+        x = cols - 1;
+        y = term->rows() - 1;
+    }
+    echoCup(x, y);
+    echoEnd();
+}
+
+static void sendHost(const char *data, size_t len) {
+    sendFn(data, len);
+    writes++;
+}
+
+static void clearLine() {
+    lineLen = 0;
+    cursor = 0;
+    historyPos = -1;
+}
+
+static void historyAdd() {
+    if (lineLen == 0) return;
+    line[lineLen] = '\0';
+    if (historyCount > 0) {
+        const char *last = history[(historyNext + LINE_HISTORY_MAX - 1) % LINE_HISTORY_MAX];
+        if (strcmp(last, line) == 0) return;
+    }
+    memcpy(history[historyNext], line, lineLen + 1);
+    historyNext = (historyNext + 1) % LINE_HISTORY_MAX;
+    if (historyCount < LINE_HISTORY_MAX) historyCount++;
+}
+
+// dir 1 = older, -1 = newer (back to the draft)
+static void historyMove(int dir) {
+    int pos = historyPos + dir;
+    if (pos < -1 || pos >= historyCount) return;
+    if (historyPos == -1) {
+        memcpy(draft, line, lineLen);
+        draft[lineLen] = '\0';
+    }
+    historyPos = pos;
+    const char *src = pos < 0 ? draft :
+                      history[(historyNext + LINE_HISTORY_MAX - 1 - pos) % LINE_HISTORY_MAX];
+    lineLen = cursor = strlen(src);
+    memcpy(line, src, lineLen);
+}
+
+static void insert(const char *text, int n) {
+    if (lineLen + n > LINE_EDIT_MAX - 1) return;
+    memmove(line + cursor + n, line + cursor, lineLen - cursor);
+    memcpy(line + cursor, text, n);
+    lineLen += n;
+    cursor += n;
+}
+
+static void killRange(int from, int to) {
+    if (to <= from) return;
+    killLen = to - from;
+    memcpy(killBuf, line + from, killLen);
+    memmove(line + from, line + to, lineLen - to);
+    lineLen -= killLen;
+    cursor = from;
+}
+
+static void deleteAt(int pos) {
+    if (pos < 0 || pos >= lineLen) return;
+    memmove(line + pos, line + pos + 1, lineLen - pos - 1);
+    lineLen--;
+    if (cursor > pos) cursor--;
+}
+
+// Hand the pending text to the host as typed so far
+static void flushPending() {
+    erase();
+    if (lineLen > 0) sendHost(line, lineLen);
+    clearLine();
+}
+
+void lineEditBegin(VtTerminal *t, LineEditSendFn fn) {
+    term = t;
+    sendFn = fn;
+}
+
+void lineEditSetEnabled(bool on) {
+    if (!on && enabled) flushPending();
+    enabled = on;
+    Serial.printf("Line: %s mode\n", on ? "line" : "raw");
+}
+
+bool lineEditEnabled() {
+    return enabled;
+}
+
+bool lineEditActive() {
+    return enabled && term && sendFn && !term->altScreen();
+}
+
+bool lineEditKey(char key) {
+    unsigned char c = key;
+    keysEdited++;
+
+    switch (c) {
+        case '\r':
+        case '\n': {
+            // Same newline as a raw Enter
+            char out[LINE_EDIT_MAX];
+            erase();
+            memcpy(out, line, lineLen);
+            out[lineLen] = '\n';
+            sendHost(out, lineLen + 1);
+            historyAdd();
+            clearLine();
+            linesSent++;
+            return true;
+        }
+        case 0x03:  // ^C: drop the line; the caller interrupts the host
+            erase();
+            clearLine();
+            return false;
+        case 0x7F:
+        case '\b':
+            deleteAt(cursor - 1);
+            break;
+        case 0x01:  // ^A
+            cursor = 0;
+            break;
+        case 0x05:  // ^E
+            cursor = lineLen;
+            break;
+        case 0x02:  // ^B
+            if (cursor > 0) cursor--;
+            break;
+        case 0x06:  // ^F
+            if (cursor < lineLen) cursor++;
+            break;
+        case 0x04:  // ^D: EOF to the host on an empty line
+            if (lineLen == 0) {
+                keysEdited--;
+                return false;
+            }
+            deleteAt(cursor);
+            break;
+        case 0x0B:  // ^K
+            killRange(cursor, lineLen);
+            break;
+        case 0x15:  // ^U
+            killRange(0, cursor);
+            break;
+        case 0x17: {  // ^W
+            int from = cursor;
+            while (from > 0 && line[from - 1] == ' ') from--;
+            while (from > 0 && line[from - 1] != ' ') from--;
+            killRange(from, cursor);
+            break;
+        }
+        case 0x19:  // ^Y
+            insert(killBuf, killLen);
+            break;
+        case 0x10:  // ^P
+            historyMove(1);
+            break;
+        case 0x0E:  // ^N
+            historyMove(-1);
+            break;
+        default:
+            if (c >= 32 && c < 127) {
+                insert(&key, 1);
+                break;
+            }
+            // Tab, Esc and the rest: the host's readline takes over
+            keysEdited--;
+            flushPending();
+            return false;
+    }
+
+    redraw();
+    return true;
+}
+
+void lineEditHide() {
+    erase();
+}
+
+void lineEditShow() {
+    if (lineLen > 0 && !term->altScreen()) redraw();
+}
+
+void lineEditReset() {
+    anchored = false;
+    clearLine();
+}
+
+void lineEditPrintStatus() {
+    Serial.printf("Line: %s mode (raw while the host uses the alternate screen)\n",
+                  enabled ? "line" : "raw");
+    Serial.printf("  %u keys edited locally, %u lines sent in %u writes (raw: %u writes)\n",
+                  (unsigned)keysEdited, (unsigned)linesSent, (unsigned)writes, (unsigned)keysEdited);
+    Serial.printf("  history %d/%d lines\n", historyCount, LINE_HISTORY_MAX);
+}
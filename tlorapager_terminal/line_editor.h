@@ -0,0 +1,56 @@
+/**
+ * Local Line Editor for T-LoRa Pager Terminal
+ * readline-style editing on the pager, whole lines sent on Enter
+ *
+ * Raw mode sends every keystroke as its own write, which over SSH is a
+ * ~100 byte packet (MAC, padding, TCP/IP) and an echo round trip. In
+ * line mode the command is edited locally - echo is drawn straight into
+ * the terminal model, in plain attributes and only while its parser is
+ * between host sequences - and goes out as one write on Enter; the host's
+ * own echo then replaces the local one. Keys with no local meaning (Tab,
+ * Esc, other control keys) send the pending text plus the key, so the
+ * host's completion still works. While the host is on the alternate
+ * screen (vim, less, top) keys bypass the editor.
+ *
+ * Keys: ^A/^E home/end, ^B/^F left/right, ^P/^N history, ^K/^U kill to
+ * end/start, ^W kill word, ^Y yank, ^D delete (EOF on an empty line).
+ */
+
+#ifndef LINE_EDITOR_H
+#define LINE_EDITOR_H
+
+#include <Arduino.h>
+#include "vt_terminal.h"
+
+#define LINE_EDIT_MAX 240       // Longest line + NUL (fits the TX ring with its newline)
+#define LINE_HISTORY_MAX 16     // Lines kept for ^P/^N
+
+typedef void (*LineEditSendFn)(const char *data, size_t len);
+
+// Echo goes to term; finished lines and pass-through text go to send
+void lineEditBegin(VtTerminal *term, LineEditSendFn send);
+
+// Turn line mode on/off (off sends any pending text raw)
+void lineEditSetEnabled(bool enabled);
+bool lineEditEnabled();
+
+// True if keys should go through lineEditKey() now: enabled and the
+// host is not on the alternate screen
+bool lineEditActive();
+
+// Handle one key. Returns false if the caller should send it raw (after
+// any pending text, which has already been sent). Redraws the echo.
+bool lineEditKey(char key);
+
+// Around host output: take the echo off the screen and put the host's
+// cursor back, then redraw the pending line after the output
+void lineEditHide();
+void lineEditShow();
+
+// Forget the pending line without sending it (disconnect)
+void lineEditReset();
+
+// Print mode, history and write counts to Serial
+void lineEditPrintStatus();
+
+#endif // LINE_EDITOR_H
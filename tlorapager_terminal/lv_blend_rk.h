@@ -0,0 +1,60 @@
+/**
+ * LVGL Blend Hooks for T-LoRa Pager Terminal
+ * Routes LVGL's software renderer through render_kernels.h
+ *
+ * LVGL includes this file into its own C sources when
+ * LV_USE_DRAW_SW_ASM is LV_DRAW_SW_ASM_CUSTOM and
+ * LV_DRAW_SW_ASM_CUSTOM_INCLUDE names it (tlorapager_terminal/lv_conf.h
+ * sets both for the device, sim/lv_conf.h for the simulator). Each hook
+ * either does the whole job and returns LV_RESULT_OK, or returns
+ * LV_RESULT_INVALID and LVGL runs its own loop:
+ * - opaque colour fill into RGB565: rkFill565() per row
+ * - opaque colour through an A8 mask (glyphs, antialiased edges):
+ *   rkBlendA8To565() per row
+ * - lv_draw_sw_rgb565_swap() (the flush, before the SPI write):
+ *   rkSwap565()
+ * Translucent fills and image blends stay with LVGL.
+ */
+
+#ifndef LV_BLEND_RK_H
+#define LV_BLEND_RK_H
+
+#include "lvgl.h"
+#include "lvgl_private.h"   // lv_draw_sw_blend_fill_dsc_t fields
+#include "render_kernels.h"
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) lv_blend_rk_fill(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc) lv_blend_rk_mask(dsc)
+#define LV_DRAW_SW_RGB565_SWAP(buf, px) lv_blend_rk_swap(buf, px)
+
+static inline lv_result_t lv_blend_rk_fill(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    uint16_t color = lv_color_to_u16(dsc->color);
+    uint8_t *row = (uint8_t *)dsc->dest_buf;
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        rkFill565((uint16_t *)row, (size_t)dsc->dest_w, color);
+        row += dsc->dest_stride;
+    }
+    rkHookStats.filled += (uint32_t)(dsc->dest_w * dsc->dest_h);
+    return LV_RESULT_OK;
+}
+
+static inline lv_result_t lv_blend_rk_mask(lv_draw_sw_blend_fill_dsc_t *dsc) {
+    uint16_t color = lv_color_to_u16(dsc->color);
+    uint8_t *row = (uint8_t *)dsc->dest_buf;
+    const uint8_t *mask = dsc->mask_buf;
+    for (int32_t y = 0; y < dsc->dest_h; y++) {
+        rkBlendA8To565((uint16_t *)row, mask, (size_t)dsc->dest_w, color);
+        row += dsc->dest_stride;
+        mask += dsc->mask_stride;
+    }
+    rkHookStats.blended += (uint32_t)(dsc->dest_w * dsc->dest_h);
+    return LV_RESULT_OK;
+}
+
+static inline lv_result_t lv_blend_rk_swap(void *buf, uint32_t px) {
+    rkSwap565((uint16_t *)buf, px);
+    rkHookStats.swapped += px;
+    return LV_RESULT_OK;
+}
+
+#endif // LV_BLEND_RK_H
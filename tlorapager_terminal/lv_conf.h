@@ -0,0 +1,22 @@
+/**
+ * LVGL Configuration for T-LoRa Pager Terminal
+ * LilyGoLib's lv_conf.h, with the software renderer's hooks pointed at
+ * the render kernels (lv_blend_rk.h)
+ *
+ * platformio.ini puts this directory ahead of LilyGoLib/src, so LVGL
+ * finds this file first; it pulls in the board's own with
+ * #include_next and then overrides the hook settings, whatever the
+ * board's file says about them.
+ */
+
+#ifndef TLORA_LV_CONF_H
+#define TLORA_LV_CONF_H
+
+#include_next "lv_conf.h"
+
+#undef LV_USE_DRAW_SW_ASM
+#define LV_USE_DRAW_SW_ASM LV_DRAW_SW_ASM_CUSTOM
+#undef LV_DRAW_SW_ASM_CUSTOM_INCLUDE
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lv_blend_rk.h"
+
+#endif // TLORA_LV_CONF_H
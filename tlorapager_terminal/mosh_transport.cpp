@@ -0,0 +1,936 @@
+/**
+ * mosh Session Transport Implementation
+ */
+
+#include "mosh_transport.h"
+#include "settings.h"
+#include "ssh_transport.h"
+#include "ocb_aes.h"
+#include "vt_terminal.h"
+#include "dns_cache.h"
+#include <lwip/sockets.h>
+#include <mbedtls/base64.h>
+#include <sdkconfig.h>
+#if CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#else
+#include "esp32/rom/miniz.h"
+#endif
+
+// Transport timers, as in mosh (transportsender.h)
+#define SEND_INTERVAL_MIN 20
+#define SEND_INTERVAL_MAX 250
+#define SEND_MINDELAY 8         // Collect keystrokes this long before sending
+#define ACK_INTERVAL 3000       // Heartbeat
+#define ACK_DELAY 100           // Acknowledge new screen states within this
+
+#define DIRECTION_TO_CLIENT (1ULL << 63)
+#define SHUTDOWN_NUM UINT64_MAX
+#define FRAGMENT_HEADER 10                          // id (8), final bit | number (2)
+#define DATAGRAM_OVERHEAD (8 + OCB_TAG_LEN + 4)     // nonce, tag, timestamps
+#define FRAGMENT_PAYLOAD (MOSH_MTU - DATAGRAM_OVERHEAD - FRAGMENT_HEADER)
+#define KEYS_CHUNK 256
+
+typedef struct {
+    uint64_t num;
+    uint64_t logEnd;        // Input stream length at this state
+    unsigned long sentMs;
+} SentState_t;
+
+typedef struct {
+    uint64_t num;
+    VtTerminal *fb;
+} RecvState_t;
+
+static bool active = false;
+static bool remoteClosed = false;
+static int sock = -1;
+static struct sockaddr_in serverAddr;
+static OcbKey_t key;
+
+// Datagram layer
+static uint64_t sendSeq = 0;
+static uint64_t expectedSeq = 0;
+static int32_t savedTs = -1;
+static unsigned long savedTsAt = 0;
+static float srtt = 1000;
+static float rttvar = 500;
+static bool rttSampled = false;
+static unsigned long lastHeardMs = 0;
+static unsigned long lastHopMs = 0;
+static bool silent = false;
+
+// Our state: the user-event stream (encoded UserMessage instructions)
+static uint8_t inputLog[MOSH_INPUT_LOG_MAX];
+static uint64_t logBase = 0;   // Stream offset of inputLog[0]
+static size_t logLen = 0;
+static SentState_t sent[MOSH_SENT_MAX];   // [0] is acknowledged
+static int sentCount = 0;
+static uint64_t ackNum = 0;
+static unsigned long nextAckMs = 0;
+static unsigned long mindelayMs = 0;
+static bool mindelaySet = false;
+static uint64_t fragmentId = 0;
+
+// Server's state: screen framebuffers, sorted by number
+static VtTerminal statePool[MOSH_STATES_MAX];
+static RecvState_t states[MOSH_STATES_MAX];
+static int stateCount = 0;
+static uint64_t displayedNum = 0;
+
+// Fragment assembly (one slot of MOSH_RECV_MAX per fragment)
+static uint8_t *asmBuf = NULL;
+static uint16_t asmLen[MOSH_FRAGMENTS_MAX];
+static bool asmHave[MOSH_FRAGMENTS_MAX];
+static uint64_t asmId = 0;
+static int asmFinal = -1;
+static bool asmStarted = false;
+static uint8_t *inflateBuf = NULL;
+
+// Display output staged for read()
+static char *outBuf = NULL;
+static size_t outLen = 0;
+static size_t outPos = 0;
+
+static uint8_t rxPacket[MOSH_RECV_MAX];
+static uint8_t rxPlain[MOSH_RECV_MAX];
+static uint8_t txPacket[MOSH_MTU];
+static uint8_t txPlain[MOSH_MTU];
+static uint8_t instBuf[MOSH_INPUT_LOG_MAX + 64];
+static uint8_t zBuf[MOSH_INPUT_LOG_MAX + 64 + 16];
+
+// Counters
+static uint32_t packetsIn = 0;
+static uint32_t packetsOut = 0;
+static uint32_t authFailures = 0;
+static uint32_t statesApplied = 0;
+static uint32_t diffsDropped = 0;
+static uint32_t repaints = 0;
+static uint32_t retransmits = 0;
+static uint32_t portHops = 0;
+static uint32_t keysDropped = 0;
+
+// ---------------------------------------------------------------------------
+// Encoding helpers
+// ---------------------------------------------------------------------------
+
+static bool due(unsigned long now, unsigned long t) {
+    return (long)(now - t) >= 0;
+}
+
+static uint16_t timestamp16() {
+    return (uint16_t)(millis() & 0xFFFF);
+}
+
+static void putBe16(uint8_t *p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static void putBe64(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+static uint16_t getBe16(const uint8_t *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static uint64_t getBe64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = v << 8 | p[i];
+    return v;
+}
+
+// Protocol buffers, just the wire format mosh's messages need
+static size_t pbVarint(uint8_t *out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static size_t pbVarintLen(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static size_t pbVarintField(uint8_t *out, uint32_t field, uint64_t v) {
+    size_t n = pbVarint(out, field << 3);
+    return n + pbVarint(out + n, v);
+}
+
+static size_t pbBytesHeader(uint8_t *out, uint32_t field, size_t len) {
+    size_t n = pbVarint(out, field << 3 | 2);
+    return n + pbVarint(out + n, len);
+}
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} PbReader;
+
+static bool pbReadVarint(PbReader *r, uint64_t *v) {
+    uint64_t result = 0;
+    for (int shift = 0; r->p < r->end && shift < 64; shift += 7) {
+        uint8_t b = *r->p++;
+        result |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Next field: varints in *value, length-delimited fields in *data/*len.
+// False at the end or on malformed input.
+static bool pbNext(PbReader *r, uint32_t *field, uint64_t *value, const uint8_t **data, size_t *len) {
+    if (r->p >= r->end) return false;
+    uint64_t tag, n;
+    if (!pbReadVarint(r, &tag)) return false;
+    *field = (uint32_t)(tag >> 3);
+    *value = 0;
+    *data = NULL;
+    *len = 0;
+
+    switch (tag & 7) {
+        case 0:
+            return pbReadVarint(r, value);
+        case 1:
+            n = 8;
+            break;
+        case 2:
+            if (!pbReadVarint(r, &n) || n > (uint64_t)(r->end - r->p)) return false;
+            *data = r->p;
+            *len = n;
+            break;
+        case 5:
+            n = 4;
+            break;
+        default:
+            return false;
+    }
+    if (n > (uint64_t)(r->end - r->p)) return false;
+    r->p += n;
+    return true;
+}
+
+// zlib stream of stored blocks: the server only needs to inflate it,
+// and keystroke diffs are too small to be worth compressing
+static size_t zlibStore(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t pos = 0, off = 0;
+    out[pos++] = 0x78;
+    out[pos++] = 0x01;
+    do {
+        size_t n = len - off > 65535 ? 65535 : len - off;
+        out[pos++] = off + n == len ? 1 : 0;  // BFINAL, BTYPE 00
+        out[pos++] = n & 0xFF;
+        out[pos++] = n >> 8;
+        out[pos++] = ~n & 0xFF;
+        out[pos++] = (~n >> 8) & 0xFF;
+        if (n > 0) memcpy(out + pos, in + off, n);
+        pos += n;
+        off += n;
+    } while (off < len);
+
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < len; i++) {
+        a = (a + in[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    out[pos++] = b >> 8;
+    out[pos++] = b;
+    out[pos++] = a >> 8;
+    out[pos++] = a;
+    return pos;
+}
+
+// ---------------------------------------------------------------------------
+// Datagram layer
+// ---------------------------------------------------------------------------
+
+static uint32_t rto() {
+    float t = ceilf(srtt + 4 * rttvar);
+    if (t < 50) t = 50;
+    if (t > 1000) t = 1000;
+    return (uint32_t)t;
+}
+
+static uint32_t sendInterval() {
+    uint32_t i = (uint32_t)ceilf(srtt / 2);
+    if (i < SEND_INTERVAL_MIN) i = SEND_INTERVAL_MIN;
+    if (i > SEND_INTERVAL_MAX) i = SEND_INTERVAL_MAX;
+    return i;
+}
+
+static void rttSample(float r) {
+    if (!rttSampled) {
+        srtt = r;
+        rttvar = r / 2;
+        rttSampled = true;
+    } else {
+        rttvar = 0.75f * rttvar + 0.25f * fabsf(srtt - r);
+        srtt = 0.875f * srtt + 0.125f * r;
+    }
+}
+
+static bool openSocket() {
+    if (sock >= 0) lwip_close(sock);
+    // Unbound: a fresh ephemeral port, which the server adopts on receipt
+    sock = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    return sock >= 0;
+}
+
+static void sendDatagram(const uint8_t *payload, size_t len) {
+    if (sock < 0 || len + DATAGRAM_OVERHEAD > sizeof(txPacket)) return;
+
+    unsigned long now = millis();
+    uint16_t reply = 0xFFFF;
+    if (savedTs >= 0 && now - savedTsAt < 1000) {
+        reply = (uint16_t)(savedTs + (now - savedTsAt));
+        savedTs = -1;
+    }
+    putBe16(txPlain, timestamp16());
+    putBe16(txPlain + 2, reply);
+    memcpy(txPlain + 4, payload, len);
+
+    uint8_t nonce[OCB_NONCE_LEN] = {0};
+    putBe64(nonce + 4, sendSeq++);  // Direction bit clear: to server
+    memcpy(txPacket, nonce + 4, 8);
+    ocbEncrypt(&key, nonce, txPlain, len + 4, txPacket + 8);
+
+    lwip_sendto(sock, txPacket, 8 + len + 4 + OCB_TAG_LEN, 0,
+                (struct sockaddr *)&serverAddr, sizeof(serverAddr));
+    packetsOut++;
+}
+
+static void sendInstruction(uint64_t oldNum, uint64_t newNum, const uint8_t *diff, size_t diffLen) {
+    size_t n = 0;
+    n += pbVarintField(instBuf + n, 1, MOSH_PROTOCOL_VERSION);
+    n += pbVarintField(instBuf + n, 2, oldNum);
+    n += pbVarintField(instBuf + n, 3, newNum);
+    n += pbVarintField(instBuf + n, 4, ackNum);
+    n += pbVarintField(instBuf + n, 5, sent[0].num);  // throwaway_num
+    n += pbBytesHeader(instBuf + n, 6, diffLen);
+    if (diffLen > 0) memcpy(instBuf + n, diff, diffLen);
+    n += diffLen;
+    size_t zlen = zlibStore(instBuf, n, zBuf);
+
+    uint8_t frag[FRAGMENT_HEADER + FRAGMENT_PAYLOAD];
+    uint64_t id = fragmentId++;
+    uint16_t num = 0;
+    size_t off = 0;
+    do {
+        size_t chunk = zlen - off > FRAGMENT_PAYLOAD ? FRAGMENT_PAYLOAD : zlen - off;
+        bool final = off + chunk == zlen;
+        putBe64(frag, id);
+        putBe16(frag + 8, (final ? 0x8000 : 0) | num++);
+        memcpy(frag + FRAGMENT_HEADER, zBuf + off, chunk);
+        sendDatagram(frag, FRAGMENT_HEADER + chunk);
+        off += chunk;
+    } while (off < zlen);
+}
+
+// ---------------------------------------------------------------------------
+// Sender: our user-event stream
+// ---------------------------------------------------------------------------
+
+static bool appendInput(const uint8_t *entry, size_t len) {
+    if (logLen + len > sizeof(inputLog)) {
+        if (keysDropped++ == 0) Serial.println("mosh: Input backlog full, dropping keys");
+        return false;
+    }
+    memcpy(inputLog + logLen, entry, len);
+    logLen += len;
+    if (!mindelaySet) {
+        mindelayMs = millis();
+        mindelaySet = true;
+    }
+    return true;
+}
+
+// UserMessage.instruction { keystroke (2) { keys (4) } }
+static void queueKeystroke(const char *keys, size_t len) {
+    uint8_t entry[KEYS_CHUNK + 16];
+    size_t ks = 1 + pbVarintLen(len) + len;
+    size_t in = 1 + pbVarintLen(ks) + ks;
+    size_t n = pbBytesHeader(entry, 1, in);
+    n += pbBytesHeader(entry + n, 2, ks);
+    n += pbBytesHeader(entry + n, 4, len);
+    memcpy(entry + n, keys, len);
+    appendInput(entry, n + len);
+}
+
+// UserMessage.instruction { resize (3) { width (5), height (6) } }
+static void queueResize(uint16_t cols, uint16_t rows) {
+    uint8_t msg[16], entry[32];
+    size_t m = pbVarintField(msg, 5, cols);
+    m += pbVarintField(msg + m, 6, rows);
+    size_t in = 1 + pbVarintLen(m) + m;
+    size_t n = pbBytesHeader(entry, 1, in);
+    n += pbBytesHeader(entry + n, 3, m);
+    memcpy(entry + n, msg, m);
+    appendInput(entry, n + m);
+}
+
+static void addSentState(uint64_t num, uint64_t logEnd, unsigned long now) {
+    if (sentCount == MOSH_SENT_MAX) {
+        // Forget one from the middle, as mosh does: the oldest in-flight
+        // states must stay, so they can time out and send us back to the
+        // acknowledged base
+        int drop = MOSH_SENT_MAX - MOSH_SENT_MAX / 2;
+        memmove(&sent[drop], &sent[drop + 1], (MOSH_SENT_MAX - drop - 1) * sizeof(SentState_t));
+        sentCount--;
+    }
+    sent[sentCount].num = num;
+    sent[sentCount].logEnd = logEnd;
+    sent[sentCount].sentMs = now;
+    sentCount++;
+}
+
+static void processAck(uint64_t ack) {
+    for (int i = 0; i < sentCount; i++) {
+        if (sent[i].num != ack) continue;
+        if (i > 0) {
+            memmove(sent, sent + i, (sentCount - i) * sizeof(SentState_t));
+            sentCount -= i;
+        }
+        // Events up to the acknowledged state are on the server for good
+        size_t drop = sent[0].logEnd - logBase;
+        if (drop > 0 && drop <= logLen) {
+            memmove(inputLog, inputLog + drop, logLen - drop);
+            logLen -= drop;
+            logBase += drop;
+        }
+        return;
+    }
+}
+
+// Diff against the state the server most likely has: the newest one
+// sent within a timeout, else the acknowledged one (retransmission)
+static void tick() {
+    if (sock < 0 || sentCount == 0) return;
+    unsigned long now = millis();
+    int last = sentCount - 1;
+
+    int assumed = 0;
+    for (int i = 1; i < sentCount; i++) {
+        if (now - sent[i].sentMs < rto() + ACK_DELAY) {
+            assumed = i;
+        } else {
+            break;
+        }
+    }
+    uint64_t oldNum = sent[assumed].num;
+    size_t diffOff = sent[assumed].logEnd - logBase;
+    size_t diffLen = logLen - diffOff;
+    uint64_t curEnd = logBase + logLen;
+
+    if (diffLen == 0) {
+        if (due(now, nextAckMs)) {
+            // Empty ack / heartbeat: a new state number with no new events
+            addSentState(sent[last].num + 1, curEnd, now);
+            sendInstruction(oldNum, sent[sentCount - 1].num, NULL, 0);
+            nextAckMs = now + ACK_INTERVAL;
+        }
+        return;
+    }
+
+    unsigned long nextSend;
+    bool fresh = curEnd != sent[last].logEnd;
+    if (fresh) {
+        unsigned long a = mindelayMs + SEND_MINDELAY;
+        unsigned long b = sent[last].sentMs + sendInterval();
+        nextSend = due(a, b) ? a : b;
+    } else {
+        nextSend = sent[last].sentMs + rto() + ACK_DELAY;
+    }
+    if (!due(now, nextSend) && !due(now, nextAckMs)) return;
+
+    uint64_t newNum;
+    if (fresh) {
+        newNum = sent[last].num + 1;
+        addSentState(newNum, curEnd, now);
+    } else {
+        newNum = sent[last].num;
+        sent[last].sentMs = now;
+        retransmits++;
+    }
+    sendInstruction(oldNum, newNum, inputLog + diffOff, diffLen);
+    nextAckMs = now + ACK_INTERVAL;
+    mindelaySet = false;
+}
+
+// ---------------------------------------------------------------------------
+// Receiver: server screen states
+// ---------------------------------------------------------------------------
+
+static VtTerminal *freeFramebuffer() {
+    for (int p = 0; p < MOSH_STATES_MAX; p++) {
+        bool used = false;
+        for (int i = 0; i < stateCount; i++) {
+            if (states[i].fb == &statePool[p]) used = true;
+        }
+        if (!used) return &statePool[p];
+    }
+    return NULL;
+}
+
+static void stageOutput(const uint8_t *data, size_t len, bool *overflow) {
+    if (*overflow) return;
+    if (outLen + len > MOSH_OUT_MAX) {
+        *overflow = true;
+        return;
+    }
+    memcpy(outBuf + outLen, data, len);
+    outLen += len;
+}
+
+static void stageRepaint(const VtTerminal *fb) {
+    outPos = 0;
+    outLen = fb->renderRepaint(outBuf, MOSH_OUT_MAX);
+    repaints++;
+}
+
+// HostMessage { instruction (1) { hostbytes (2) { hoststring (4) } | resize (3) | echoack (7) } }
+static void applyHostMessage(VtTerminal *fb, const uint8_t *diff, size_t len, bool echo, bool *overflow) {
+    PbReader r = {diff, diff + len};
+    uint32_t field;
+    uint64_t value;
+    const uint8_t *data;
+    size_t dlen;
+
+    while (pbNext(&r, &field, &value, &data, &dlen)) {
+        if (field != 1 || data == NULL) continue;
+        PbReader ir = {data, data + dlen};
+        uint32_t f2;
+        const uint8_t *d2;
+        size_t l2;
+        while (pbNext(&ir, &f2, &value, &d2, &l2)) {
+            // The server follows our resize events; its resize instructions
+            // only restate that, so the grid keeps its size
+            if (f2 != 2 || d2 == NULL) continue;
+            PbReader hr = {d2, d2 + l2};
+            uint32_t f3;
+            const uint8_t *d3;
+            size_t l3;
+            while (pbNext(&hr, &f3, &value, &d3, &l3)) {
+                if (f3 != 4 || d3 == NULL) continue;
+                fb->write((const char *)d3, l3);
+                if (echo) stageOutput(d3, l3, overflow);
+            }
+        }
+    }
+}
+
+static void processThrowaway(uint64_t throwaway) {
+    // Never drop the newest state
+    int keep = 0;
+    for (int i = 0; i < stateCount; i++) {
+        if (states[i].num >= throwaway || i == stateCount - 1) {
+            states[keep++] = states[i];
+        }
+    }
+    stateCount = keep;
+}
+
+static void processInstruction(const uint8_t *data, size_t len) {
+    PbReader r = {data, data + len};
+    uint64_t version = 0, oldNum = 0, newNum = 0, ack = 0, throwaway = 0, value;
+    const uint8_t *diff = NULL, *d;
+    size_t diffLen = 0, dlen;
+    uint32_t field;
+
+    while (pbNext(&r, &field, &value, &d, &dlen)) {
+        switch (field) {
+            case 1: version = value; break;
+            case 2: oldNum = value; break;
+            case 3: newNum = value; break;
+            case 4: ack = value; break;
+            case 5: throwaway = value; break;
+            case 6: diff = d; diffLen = dlen; break;
+            default: break;  // chaff
+        }
+    }
+    if (version != MOSH_PROTOCOL_VERSION) {
+        diffsDropped++;
+        return;
+    }
+    processAck(ack);
+
+    for (int i = 0; i < stateCount; i++) {
+        if (states[i].num == newNum) return;  // Duplicate
+    }
+    processThrowaway(throwaway);
+
+    int ref = -1;
+    for (int i = 0; i < stateCount; i++) {
+        if (states[i].num == oldNum) ref = i;
+    }
+    // Base state discarded or never received, or no room: the server
+    // resends against an acknowledged state after its timeout
+    if (ref < 0 || stateCount == MOSH_STATES_MAX) {
+        diffsDropped++;
+        return;
+    }
+
+    VtTerminal *fb = freeFramebuffer();
+    fb->copyScreenFrom(*states[ref].fb);
+    bool newest = newNum > states[stateCount - 1].num;
+    bool incremental = newest && oldNum == displayedNum;
+    bool overflow = false;
+    applyHostMessage(fb, diff, diffLen, incremental, &overflow);
+
+    int pos = stateCount;
+    while (pos > 0 && states[pos - 1].num > newNum) {
+        states[pos] = states[pos - 1];
+        pos--;
+    }
+    states[pos].num = newNum;
+    states[pos].fb = fb;
+    stateCount++;
+    statesApplied++;
+
+    // The display follows the newest state: replay the same diff if it
+    // shows the base, otherwise repaint it from the framebuffer
+    if (newest) {
+        if (!incremental || overflow) stageRepaint(fb);
+        displayedNum = newNum;
+    }
+    ackNum = states[stateCount - 1].num;
+    if (diffLen > 0) {
+        unsigned long ackBy = millis() + ACK_DELAY;
+        if (due(nextAckMs, ackBy)) nextAckMs = ackBy;
+    }
+    if (newNum == SHUTDOWN_NUM) {
+        remoteClosed = true;
+        nextAckMs = millis();
+        Serial.println("mosh: Server ended the session");
+    }
+}
+
+static void addFragment(const uint8_t *data, size_t len) {
+    if (len < FRAGMENT_HEADER) return;
+    uint64_t id = getBe64(data);
+    uint16_t combined = getBe16(data + 8);
+    bool final = combined & 0x8000;
+    int num = combined & 0x7FFF;
+    data += FRAGMENT_HEADER;
+    len -= FRAGMENT_HEADER;
+    if (num >= MOSH_FRAGMENTS_MAX) {
+        diffsDropped++;
+        return;
+    }
+
+    if (!asmStarted || id != asmId) {
+        asmId = id;
+        asmStarted = true;
+        asmFinal = -1;
+        memset(asmHave, 0, sizeof(asmHave));
+    }
+    if (asmHave[num]) return;
+    memcpy(asmBuf + num * MOSH_RECV_MAX, data, len);
+    asmLen[num] = len;
+    asmHave[num] = true;
+    if (final) asmFinal = num;
+
+    if (asmFinal < 0) return;
+    for (int i = 0; i <= asmFinal; i++) {
+        if (!asmHave[i]) return;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i <= asmFinal; i++) {
+        memmove(asmBuf + total, asmBuf + i * MOSH_RECV_MAX, asmLen[i]);
+        total += asmLen[i];
+    }
+    asmStarted = false;
+
+    size_t n = tinfl_decompress_mem_to_mem(inflateBuf, MOSH_INFLATE_MAX, asmBuf, total,
+                                           TINFL_FLAG_PARSE_ZLIB_HEADER);
+    if (n == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED) {
+        diffsDropped++;
+        return;
+    }
+    processInstruction(inflateBuf, n);
+}
+
+static void handleDatagram(const uint8_t *data, size_t len) {
+    if (len < DATAGRAM_OVERHEAD) return;
+    uint64_t directionSeq = getBe64(data);
+    if (!(directionSeq & DIRECTION_TO_CLIENT)) return;
+
+    uint8_t nonce[OCB_NONCE_LEN] = {0};
+    memcpy(nonce + 4, data, 8);
+    if (!ocbDecrypt(&key, nonce, data + 8, len - 8, rxPlain)) {
+        authFailures++;
+        return;
+    }
+    size_t plen = len - 8 - OCB_TAG_LEN;
+    packetsIn++;
+
+    uint64_t seq = directionSeq & ~DIRECTION_TO_CLIENT;
+    unsigned long now = millis();
+    if (seq >= expectedSeq) {
+        expectedSeq = seq + 1;
+        savedTs = getBe16(rxPlain);
+        savedTsAt = now;
+        uint16_t reply = getBe16(rxPlain + 2);
+        if (reply != 0xFFFF) {
+            uint16_t r = timestamp16() - reply;
+            if (r < 5000) rttSample(r);
+        }
+        lastHeardMs = now;
+        if (silent) {
+            silent = false;
+            Serial.println("mosh: Server is back");
+        }
+    }
+    addFragment(rxPlain + 4, plen - 4);
+}
+
+static void receiveDatagrams() {
+    for (int i = 0; i < 16 && sock >= 0; i++) {
+        int n = lwip_recvfrom(sock, rxPacket, sizeof(rxPacket), MSG_DONTWAIT, NULL, NULL);
+        if (n <= 0) break;
+        handleDatagram(rxPacket, n);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Session transport
+// ---------------------------------------------------------------------------
+
+static bool moshAlloc(uint16_t cols, uint16_t rows) {
+    if (!asmBuf) asmBuf = (uint8_t *)ps_malloc(MOSH_FRAGMENTS_MAX * MOSH_RECV_MAX);
+    if (!inflateBuf) inflateBuf = (uint8_t *)ps_malloc(MOSH_INFLATE_MAX);
+    if (!outBuf) outBuf = (char *)ps_malloc(MOSH_OUT_MAX);
+    if (!asmBuf || !inflateBuf || !outBuf) return false;
+    for (int i = 0; i < MOSH_STATES_MAX; i++) {
+        if (!statePool[i].begin(cols, rows, 0)) return false;
+    }
+    return true;
+}
+
+static void moshReset() {
+    unsigned long now = millis();
+    sendSeq = expectedSeq = 0;
+    savedTs = -1;
+    srtt = 1000;
+    rttvar = 500;
+    rttSampled = false;
+    lastHeardMs = lastHopMs = now;
+    silent = false;
+    remoteClosed = false;
+
+    logBase = 0;
+    logLen = 0;
+    sentCount = 0;
+    addSentState(0, 0, now);
+    ackNum = 0;
+    nextAckMs = now;
+    mindelaySet = false;
+    fragmentId = 0;
+
+    // Both sides start from a blank screen, state 0
+    statePool[0].reset();
+    states[0].num = 0;
+    states[0].fb = &statePool[0];
+    stateCount = 1;
+    displayedNum = 0;
+    asmStarted = false;
+    stageRepaint(&statePool[0]);
+
+    packetsIn = packetsOut = authFailures = 0;
+    statesApplied = diffsDropped = repaints = retransmits = portHops = keysDropped = 0;
+}
+
+static void moshRelease() {
+    if (sock >= 0) {
+        lwip_close(sock);
+        sock = -1;
+    }
+    ocbFree(&key);
+    active = false;
+    // begin() with no size only frees the grids
+    for (int i = 0; i < MOSH_STATES_MAX; i++) {
+        statePool[i].begin(0, 0, 0);
+    }
+    stateCount = 0;
+}
+
+static bool moshOpen(void *target, uint16_t cols, uint16_t rows) {
+    ServerConfig_t *server = (ServerConfig_t *)target;
+    if (strlen(server->jump.host) > 0) {
+        Serial.println("mosh: Jump hosts are not supported (UDP goes straight to the server)");
+        return false;
+    }
+    if (!moshAlloc(cols, rows)) {
+        Serial.println("mosh: Out of memory");
+        moshRelease();
+        return false;
+    }
+
+    // Bootstrap: mosh-server prints "MOSH CONNECT <port> <key>" and detaches
+    Serial.printf("mosh: Starting mosh-server on %s\n", server->host);
+    char reply[512];
+    if (!sshExec(server, MOSH_SERVER_CMD, "MOSH CONNECT", reply, sizeof(reply), 15000)) {
+        moshRelease();
+        return false;
+    }
+    const char *line = strstr(reply, "MOSH CONNECT ");
+    unsigned port = 0;
+    char keyText[32] = {0};
+    if (line == NULL || sscanf(line, "MOSH CONNECT %u %31s", &port, keyText) != 2 ||
+        strlen(keyText) != 22) {
+        Serial.printf("mosh: mosh-server did not start: %.120s\n", reply);
+        moshRelease();
+        return false;
+    }
+
+    // 22 base64 characters without padding: the 128-bit session key
+    char padded[sizeof(keyText) + 2];
+    uint8_t secret[OCB_KEY_LEN];
+    size_t olen = 0;
+    snprintf(padded, sizeof(padded), "%s==", keyText);
+    bool keyOk = mbedtls_base64_decode(secret, sizeof(secret), &olen,
+                                       (const uint8_t *)padded, 24) == 0 &&
+                 olen == OCB_KEY_LEN && ocbInit(&key, secret);
+    memset(secret, 0, sizeof(secret));
+    memset(keyText, 0, sizeof(keyText));
+    if (!keyOk) {
+        Serial.println("mosh: Bad session key");
+        moshRelease();
+        return false;
+    }
+
+    uint32_t ip;
+    if (dnsResolve(server->host, &ip) == DNS_ANSWER_NONE) {
+        Serial.printf("mosh: Cannot resolve %s\n", server->host);
+        moshRelease();
+        return false;
+    }
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    serverAddr.sin_addr.s_addr = ip;
+
+    moshReset();
+    if (!openSocket()) {
+        Serial.println("mosh: UDP socket failed");
+        moshRelease();
+        return false;
+    }
+    active = true;
+    queueResize(cols, rows);
+
+    // First screen state, so a blocked UDP port fails here and not later
+    unsigned long start = millis();
+    while (packetsIn == 0 && millis() - start < MOSH_CONNECT_TIMEOUT_MS) {
+        receiveDatagrams();
+        tick();
+        delay(5);
+    }
+    if (packetsIn == 0) {
+        Serial.printf("mosh: No UDP reply from %s:%u (firewall?)\n", server->host, port);
+        moshRelease();
+        return false;
+    }
+    Serial.printf("mosh: Session up on UDP %s:%u (RTT %.0fms)\n", server->host, port, srtt);
+    return true;
+}
+
+static int moshRead(char *buf, int room) {
+    if (!active) return -1;
+    receiveDatagrams();
+    tick();
+
+    unsigned long now = millis();
+    if (!silent && now - lastHeardMs > 5000) {
+        silent = true;
+        Serial.println("mosh: No contact with server for 5s");
+    }
+    // Roaming: a new port (and source address) after a silence; the
+    // server replies to wherever its last authentic datagram came from
+    if (now - lastHeardMs > MOSH_PORT_HOP_MS && now - lastHopMs > MOSH_PORT_HOP_MS) {
+        if (openSocket()) portHops++;
+        lastHopMs = now;
+        Serial.println("mosh: Switching UDP port");
+    }
+
+    if (outPos < outLen) {
+        size_t n = outLen - outPos;
+        if (n > (size_t)room) n = room;
+        memcpy(buf, outBuf + outPos, n);
+        outPos += n;
+        if (outPos == outLen) outPos = outLen = 0;
+        return n;
+    }
+    return remoteClosed ? -1 : 0;
+}
+
+static int moshWrite(const char *data, int len) {
+    if (!active) return -1;
+    for (int off = 0; off < len; off += KEYS_CHUNK) {
+        int n = len - off > KEYS_CHUNK ? KEYS_CHUNK : len - off;
+        queueKeystroke(data + off, n);
+    }
+    tick();
+    return len;
+}
+
+static bool moshIsOpen() {
+    return active && !(remoteClosed && outPos >= outLen);
+}
+
+static void moshClose() {
+    if (active && !remoteClosed && sock >= 0) {
+        // Ask the server to shut down (new state -1), as the mosh client does
+        for (int i = 0; i < 3; i++) {
+            sendInstruction(sent[0].num, SHUTDOWN_NUM, NULL, 0);
+            delay(20);
+        }
+    } else if (remoteClosed && sock >= 0) {
+        tick();  // Acknowledge the server's shutdown
+    }
+    moshRelease();
+}
+
+void moshPrintStatus() {
+    if (!active) {
+        Serial.println("mosh: not connected");
+        return;
+    }
+    unsigned long now = millis();
+    Serial.printf("mosh: %s:%u, RTT %.0fms (timeout %ums), last heard %lums ago\n",
+                  inet_ntoa(serverAddr.sin_addr), ntohs(serverAddr.sin_port),
+                  srtt, (unsigned)rto(), now - lastHeardMs);
+    Serial.printf("  packets in %u, out %u, auth failures %u, port hops %u\n",
+                  (unsigned)packetsIn, (unsigned)packetsOut, (unsigned)authFailures, (unsigned)portHops);
+    Serial.printf("  screen states applied %u (held %d), dropped %u, repaints %u\n",
+                  (unsigned)statesApplied, stateCount, (unsigned)diffsDropped, (unsigned)repaints);
+    Serial.printf("  input: %u bytes unacknowledged, %u retransmits, %u keys dropped\n",
+                  (unsigned)logLen, (unsigned)retransmits, (unsigned)keysDropped);
+}
+
+// No flow control: when the display falls behind, newer states supersede older ones
+const SessionTransport_t moshTransport = {
+    "mosh",
+    moshOpen,
+    moshRead,
+    moshWrite,
+    moshIsOpen,
+    NULL,
+    NULL,       // Screen state pool is sized at connect
+    moshClose
+};
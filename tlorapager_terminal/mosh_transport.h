@@ -0,0 +1,41 @@
+/**
+ * mosh Session Transport for T-LoRa Pager Terminal
+ * State Synchronization Protocol client (open() target: ServerConfig_t *)
+ *
+ * An SSH exec starts `mosh-server new` and reads back its UDP port and
+ * session key; SSH is closed again. From then on the session is AES-OCB
+ * datagrams: keystrokes go up as a user-event stream, the server sends
+ * screen-state diffs (VT byte strings) against states we acknowledged.
+ * Each diff is applied to a copy of the state it refers to, and the
+ * newest state drives the display. With no TCP connection to lose, the
+ * session survives Wi-Fi roams and DHCP changes; after a silence the
+ * client hops to a new UDP port and the server follows.
+ *
+ * Unlike SSH/ttyd, output is staged: diffs arrive compressed and whole.
+ */
+
+#ifndef MOSH_TRANSPORT_H
+#define MOSH_TRANSPORT_H
+
+#include "session.h"
+
+#define MOSH_SERVER_CMD "mosh-server new -s -c 8 -l LANG=C.UTF-8"
+#define MOSH_PROTOCOL_VERSION 2
+
+#define MOSH_MTU 1200               // Largest datagram sent
+#define MOSH_RECV_MAX 2048          // Largest datagram accepted
+#define MOSH_STATES_MAX 6           // Server screen states kept as diff bases
+#define MOSH_SENT_MAX 32            // Our states awaiting acknowledgement
+#define MOSH_FRAGMENTS_MAX 16       // Largest instruction received, in datagrams
+#define MOSH_INFLATE_MAX 32768      // Largest instruction after decompression
+#define MOSH_INPUT_LOG_MAX 4096     // Unacknowledged keystrokes kept
+#define MOSH_OUT_MAX 16384          // Display output staged per read
+#define MOSH_CONNECT_TIMEOUT_MS 5000
+#define MOSH_PORT_HOP_MS 10000      // Silence before switching UDP port
+
+extern const SessionTransport_t moshTransport;
+
+// Print timing, loss and state counters to Serial
+void moshPrintStatus();
+
+#endif // MOSH_TRANSPORT_H
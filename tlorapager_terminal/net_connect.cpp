@@ -0,0 +1,75 @@
+/**
+ * TCP Connect Helper Implementation
+ */
+
+#include "net_connect.h"
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+
+static int connectAddr(uint32_t ip, uint16_t port, uint32_t timeoutMs) {
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = ip;
+
+    // Non-blocking connect so the timeout applies
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int rc = lwip_connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+    if (rc < 0 && errno != EINPROGRESS) {
+        lwip_close(fd);
+        return -1;
+    }
+
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv = {(time_t)(timeoutMs / 1000), (suseconds_t)((timeoutMs % 1000) * 1000)};
+    int err = 0;
+    socklen_t errLen = sizeof(err);
+    if (lwip_select(fd + 1, NULL, &wfds, NULL, &tv) <= 0 ||
+        lwip_getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) < 0 || err != 0) {
+        lwip_close(fd);
+        return -1;
+    }
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+
+    // Keystrokes should not wait for Nagle
+    int one = 1;
+    lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+int netConnect(const char *host, uint16_t port, uint32_t timeoutMs,
+               DnsAnswer_t *answer, uint32_t *resolveUs) {
+    uint32_t ip;
+    int64_t t0 = esp_timer_get_time();
+    DnsAnswer_t how = dnsResolve(host, &ip);
+    uint32_t us = esp_timer_get_time() - t0;
+    if (answer) *answer = how;
+    if (resolveUs) *resolveUs = us;
+    if (how == DNS_ANSWER_NONE) {
+        Serial.printf("Net: Cannot resolve %s\n", host);
+        return -1;
+    }
+    if (how != DNS_ANSWER_STALE) return connectAddr(ip, port, timeoutMs);
+
+    int fd = connectAddr(ip, port, min(timeoutMs, (uint32_t)NET_STALE_CONNECT_MS));
+    if (fd >= 0) return fd;
+
+    // The saved address did not answer: look the host up again
+    t0 = esp_timer_get_time();
+    uint32_t fresh;
+    bool ok = dnsRefresh(host, &fresh);
+    if (resolveUs) *resolveUs = us + (esp_timer_get_time() - t0);
+    if (!ok) return -1;
+    if (answer) *answer = DNS_ANSWER_RESOLVED;
+    if (fresh != ip) {
+        Serial.printf("Net: %s moved to %s\n", host, IPAddress(fresh).toString().c_str());
+    }
+    return connectAddr(fresh, port, timeoutMs);
+}
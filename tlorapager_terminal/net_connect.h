@@ -0,0 +1,24 @@
+/**
+ * TCP Connect Helper for T-LoRa Pager Terminal
+ * Resolve (through the DNS cache) and connect with a timeout, returning
+ * a plain lwIP socket
+ */
+
+#ifndef NET_CONNECT_H
+#define NET_CONNECT_H
+
+#include <Arduino.h>
+#include "dns_cache.h"
+
+// First try on a stale cached address: a host that moved should not
+// cost the whole connect timeout before it is looked up again
+#define NET_STALE_CONNECT_MS 2000
+
+// Blocking socket connected to host:port with TCP_NODELAY set, or -1.
+// The caller owns the socket (lwip_close, or hand it to a library).
+// answer/resolveUs (optional) report how the address was found and the
+// time spent on it, retries included.
+int netConnect(const char *host, uint16_t port, uint32_t timeoutMs,
+               DnsAnswer_t *answer = NULL, uint32_t *resolveUs = NULL);
+
+#endif // NET_CONNECT_H
@@ -0,0 +1,136 @@
+/**
+ * AES-128-OCB3 Implementation
+ */
+
+#include "ocb_aes.h"
+#include <string.h>
+
+static void xorBlock(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+    for (int i = 0; i < 16; i++) dst[i] = a[i] ^ b[i];
+}
+
+// Multiply by x in GF(2^128)
+static void doubleBlock(uint8_t *dst, const uint8_t *src) {
+    uint8_t carry = src[0] >> 7;
+    for (int i = 0; i < 15; i++) {
+        dst[i] = (src[i] << 1) | (src[i + 1] >> 7);
+    }
+    dst[15] = (src[15] << 1) ^ (carry ? 0x87 : 0);
+}
+
+static int ntz(uint32_t i) {
+    return __builtin_ctz(i);
+}
+
+bool ocbInit(OcbKey_t *key, const uint8_t secret[OCB_KEY_LEN]) {
+    mbedtls_aes_init(&key->enc);
+    mbedtls_aes_init(&key->dec);
+    if (mbedtls_aes_setkey_enc(&key->enc, secret, 128) != 0 ||
+        mbedtls_aes_setkey_dec(&key->dec, secret, 128) != 0) {
+        ocbFree(key);
+        return false;
+    }
+
+    uint8_t zero[16] = {0};
+    mbedtls_aes_crypt_ecb(&key->enc, MBEDTLS_AES_ENCRYPT, zero, key->lStar);
+    doubleBlock(key->lDollar, key->lStar);
+    doubleBlock(key->l[0], key->lDollar);
+    for (int i = 1; i < OCB_L_COUNT; i++) {
+        doubleBlock(key->l[i], key->l[i - 1]);
+    }
+    return true;
+}
+
+void ocbFree(OcbKey_t *key) {
+    mbedtls_aes_free(&key->enc);
+    mbedtls_aes_free(&key->dec);
+    memset(key->lStar, 0, sizeof(key->lStar));
+    memset(key->lDollar, 0, sizeof(key->lDollar));
+    memset(key->l, 0, sizeof(key->l));
+}
+
+// Offset_0 from the nonce (RFC 7253 section 4.2, TAGLEN = 128)
+static void initialOffset(OcbKey_t *key, const uint8_t *nonce, uint8_t *offset) {
+    uint8_t n[16] = {0, 0, 0, 1};
+    memcpy(n + 4, nonce, OCB_NONCE_LEN);
+    int bottom = n[15] & 0x3F;
+    n[15] &= 0xC0;
+
+    uint8_t stretch[24];
+    mbedtls_aes_crypt_ecb(&key->enc, MBEDTLS_AES_ENCRYPT, n, stretch);
+    for (int i = 0; i < 8; i++) {
+        stretch[16 + i] = stretch[i] ^ stretch[i + 1];
+    }
+
+    // Offset_0 = Stretch[1+bottom..128+bottom]
+    int byteShift = bottom / 8, bitShift = bottom % 8;
+    for (int i = 0; i < 16; i++) {
+        uint8_t hi = stretch[i + byteShift];
+        uint8_t lo = stretch[i + byteShift + 1];
+        offset[i] = bitShift ? (uint8_t)((hi << bitShift) | (lo >> (8 - bitShift))) : hi;
+    }
+}
+
+// Shared by both directions: the checksum is always over the plaintext
+static void ocbCrypt(OcbKey_t *key, const uint8_t *nonce, const uint8_t *in, size_t len,
+                     uint8_t *out, bool encrypt, uint8_t *tag) {
+    uint8_t offset[16], checksum[16] = {0}, tmp[16];
+    initialOffset(key, nonce, offset);
+
+    size_t blocks = len / 16;
+    for (size_t i = 1; i <= blocks; i++) {
+        const uint8_t *src = in + (i - 1) * 16;
+        uint8_t *dst = out + (i - 1) * 16;
+        xorBlock(offset, offset, key->l[ntz(i) < OCB_L_COUNT ? ntz(i) : OCB_L_COUNT - 1]);
+        xorBlock(tmp, src, offset);
+        mbedtls_aes_crypt_ecb(encrypt ? &key->enc : &key->dec,
+                              encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, tmp, tmp);
+        if (encrypt) xorBlock(checksum, checksum, src);
+        xorBlock(dst, tmp, offset);
+        if (!encrypt) xorBlock(checksum, checksum, dst);
+    }
+
+    size_t rest = len % 16;
+    if (rest > 0) {
+        uint8_t pad[16];
+        const uint8_t *src = in + blocks * 16;
+        uint8_t *dst = out + blocks * 16;
+        xorBlock(offset, offset, key->lStar);
+        mbedtls_aes_crypt_ecb(&key->enc, MBEDTLS_AES_ENCRYPT, offset, pad);
+        for (size_t i = 0; i < rest; i++) dst[i] = src[i] ^ pad[i];
+
+        // Checksum_* ^= P_* || 1 || 0...
+        const uint8_t *plain = encrypt ? src : dst;
+        memset(tmp, 0, sizeof(tmp));
+        memcpy(tmp, plain, rest);
+        tmp[rest] = 0x80;
+        xorBlock(checksum, checksum, tmp);
+    }
+
+    xorBlock(tmp, checksum, offset);
+    xorBlock(tmp, tmp, key->lDollar);
+    mbedtls_aes_crypt_ecb(&key->enc, MBEDTLS_AES_ENCRYPT, tmp, tag);
+}
+
+void ocbEncrypt(OcbKey_t *key, const uint8_t nonce[OCB_NONCE_LEN],
+                const uint8_t *in, size_t len, uint8_t *out) {
+    ocbCrypt(key, nonce, in, len, out, true, out + len);
+}
+
+bool ocbDecrypt(OcbKey_t *key, const uint8_t nonce[OCB_NONCE_LEN],
+                const uint8_t *in, size_t len, uint8_t *out) {
+    if (len < OCB_TAG_LEN) return false;
+    len -= OCB_TAG_LEN;
+
+    uint8_t tag[16];
+    ocbCrypt(key, nonce, in, len, out, false, tag);
+
+    // Constant time compare
+    uint8_t diff = 0;
+    for (int i = 0; i < OCB_TAG_LEN; i++) diff |= tag[i] ^ in[len + i];
+    if (diff != 0) {
+        memset(out, 0, len);
+        return false;
+    }
+    return true;
+}
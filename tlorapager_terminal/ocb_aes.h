@@ -0,0 +1,41 @@
+/**
+ * AES-128-OCB3 for T-LoRa Pager Terminal
+ * Authenticated encryption (RFC 7253) as used by mosh
+ *
+ * 96-bit nonces, 128-bit tags, no associated data. Built on the
+ * mbedTLS AES block cipher (hardware accelerated on the ESP32).
+ */
+
+#ifndef OCB_AES_H
+#define OCB_AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mbedtls/aes.h>
+
+#define OCB_KEY_LEN 16
+#define OCB_NONCE_LEN 12
+#define OCB_TAG_LEN 16
+#define OCB_L_COUNT 16   // Offsets for messages up to 2^16 blocks
+
+typedef struct {
+    mbedtls_aes_context enc;
+    mbedtls_aes_context dec;
+    uint8_t lStar[16];
+    uint8_t lDollar[16];
+    uint8_t l[OCB_L_COUNT][16];
+} OcbKey_t;
+
+bool ocbInit(OcbKey_t *key, const uint8_t secret[OCB_KEY_LEN]);
+void ocbFree(OcbKey_t *key);
+
+// out receives len bytes of ciphertext followed by the tag
+void ocbEncrypt(OcbKey_t *key, const uint8_t nonce[OCB_NONCE_LEN],
+                const uint8_t *in, size_t len, uint8_t *out);
+
+// in is ciphertext followed by the tag (len includes it). Writes
+// len - OCB_TAG_LEN bytes of plaintext; false if authentication fails.
+bool ocbDecrypt(OcbKey_t *key, const uint8_t nonce[OCB_NONCE_LEN],
+                const uint8_t *in, size_t len, uint8_t *out);
+
+#endif // OCB_AES_H
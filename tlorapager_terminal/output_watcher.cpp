@@ -0,0 +1,225 @@
+/**
+ * Output Watcher Implementation
+ *
+ * The automaton is compiled to a dense DFA (goto + failure links folded
+ * into one transition table) over a reduced alphabet: every byte that
+ * appears in a pattern gets its own class, everything else maps to
+ * class 0. Scanning is then one table lookup and one OR per byte.
+ */
+
+#include "output_watcher.h"
+#include <LittleFS.h>
+
+#define WATCH_NO_STATE 0xFFFF
+
+// Patterns
+static char patterns[WATCH_MAX_PATTERNS][WATCH_MAX_PATTERN_LEN];
+static int patternCount = 0;
+static uint32_t patternHits[WATCH_MAX_PATTERNS];
+
+// Automaton
+static uint8_t byteClass[256];
+static uint16_t classCount = 0;
+static uint16_t stateCount = 0;
+static uint16_t *delta = NULL;    // stateCount x classCount
+static uint16_t *outMask = NULL;  // pattern bitmask per state
+
+// Scan state (SSH task only)
+static uint16_t scanState = 0;
+
+// Pending matches (SSH task -> UI loop)
+static volatile uint32_t pendingMask = 0;
+
+static inline uint8_t foldCase(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+static void addPattern(const char *text) {
+    if (patternCount >= WATCH_MAX_PATTERNS) return;
+    size_t len = strlen(text);
+    if (len == 0 || len >= WATCH_MAX_PATTERN_LEN) return;
+    strcpy(patterns[patternCount++], text);
+}
+
+static void loadPatterns() {
+    patternCount = 0;
+
+    if (LittleFS.begin(false)) {
+        File file = LittleFS.open(WATCH_PATTERNS_FILE, "r");
+        if (file) {
+            while (file.available()) {
+                String line = file.readStringUntil('\n');
+                line.trim();
+                if (line.length() == 0 || line.startsWith("#")) continue;
+                addPattern(line.c_str());
+            }
+            file.close();
+        }
+    }
+
+    if (patternCount == 0) {
+        addPattern("ERROR");
+        addPattern("FAILED");
+    }
+}
+
+static bool buildAutomaton() {
+    free(delta);
+    free(outMask);
+    delta = NULL;
+    outMask = NULL;
+
+    // Alphabet reduction
+    memset(byteClass, 0, sizeof(byteClass));
+    classCount = 1;
+    for (int p = 0; p < patternCount; p++) {
+        for (const char *c = patterns[p]; *c; c++) {
+            uint8_t f = foldCase((uint8_t)*c);
+            if (byteClass[f] == 0) {
+                if (classCount == 255) return false;
+                byteClass[f] = classCount++;
+            }
+        }
+    }
+    for (int c = 'A'; c <= 'Z'; c++) {
+        byteClass[c] = byteClass[foldCase(c)];
+    }
+
+    delta = (uint16_t *)malloc(WATCH_MAX_STATES * classCount * sizeof(uint16_t));
+    outMask = (uint16_t *)calloc(WATCH_MAX_STATES, sizeof(uint16_t));
+    uint16_t *fail = (uint16_t *)calloc(WATCH_MAX_STATES, sizeof(uint16_t));
+    if (!delta || !outMask || !fail) {
+        free(fail);
+        return false;
+    }
+    memset(delta, 0xFF, WATCH_MAX_STATES * classCount * sizeof(uint16_t));
+    stateCount = 1;
+
+    // Trie
+    for (int p = 0; p < patternCount; p++) {
+        uint16_t s = 0;
+        for (const char *c = patterns[p]; *c; c++) {
+            uint16_t *next = &delta[s * classCount + byteClass[(uint8_t)*c]];
+            if (*next == WATCH_NO_STATE) {
+                if (stateCount >= WATCH_MAX_STATES) {
+                    free(fail);
+                    return false;
+                }
+                *next = stateCount++;
+            }
+            s = *next;
+        }
+        outMask[s] |= (1 << p);
+    }
+
+    // Failure links, breadth first; missing edges become DFA transitions
+    uint16_t *order = (uint16_t *)malloc(stateCount * sizeof(uint16_t));
+    if (!order) {
+        free(fail);
+        return false;
+    }
+    int head = 0, tail = 0;
+
+    for (uint16_t c = 0; c < classCount; c++) {
+        uint16_t u = delta[c];
+        if (u == WATCH_NO_STATE) {
+            delta[c] = 0;
+        } else {
+            fail[u] = 0;
+            order[tail++] = u;
+        }
+    }
+
+    while (head < tail) {
+        uint16_t r = order[head++];
+        for (uint16_t c = 0; c < classCount; c++) {
+            uint16_t u = delta[r * classCount + c];
+            uint16_t viaFail = delta[fail[r] * classCount + c];
+            if (u == WATCH_NO_STATE) {
+                delta[r * classCount + c] = viaFail;
+            } else {
+                fail[u] = viaFail;
+                outMask[u] |= outMask[viaFail];
+                order[tail++] = u;
+            }
+        }
+    }
+
+    free(order);
+    free(fail);
+
+    // Trim tables to the states actually used
+    uint16_t *shrunk = (uint16_t *)realloc(delta, stateCount * classCount * sizeof(uint16_t));
+    if (shrunk) delta = shrunk;
+    shrunk = (uint16_t *)realloc(outMask, stateCount * sizeof(uint16_t));
+    if (shrunk) outMask = shrunk;
+
+    scanState = 0;
+    return true;
+}
+
+bool watcherInit() {
+    loadPatterns();
+    memset(patternHits, 0, sizeof(patternHits));
+
+    if (!buildAutomaton()) {
+        Serial.println("Watcher: Pattern set too large, disabled");
+        free(delta);
+        free(outMask);
+        delta = NULL;
+        outMask = NULL;
+        return false;
+    }
+
+    Serial.printf("Watcher: %d patterns, %u states, %u classes (%u bytes)\n",
+                  patternCount, stateCount, classCount,
+                  (unsigned)(stateCount * (classCount + 1) * sizeof(uint16_t)));
+    return true;
+}
+
+void watcherScan(const char *data, size_t len) {
+    if (delta == NULL) return;
+
+    const uint16_t *d = delta;
+    const uint16_t *out = outMask;
+    const uint16_t cc = classCount;
+    uint16_t s = scanState;
+    uint32_t hits = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        s = d[s * cc + byteClass[(uint8_t)data[i]]];
+        hits |= out[s];
+    }
+
+    scanState = s;
+    if (hits) {
+        __atomic_fetch_or(&pendingMask, hits, __ATOMIC_RELAXED);
+    }
+}
+
+int watcherTakeMatch() {
+    uint32_t mask = __atomic_exchange_n(&pendingMask, 0, __ATOMIC_RELAXED);
+    if (mask == 0) return -1;
+
+    int first = -1;
+    for (int p = 0; p < patternCount; p++) {
+        if (mask & (1 << p)) {
+            patternHits[p]++;
+            if (first < 0) first = p;
+        }
+    }
+    return first;
+}
+
+const char* watcherPatternName(int index) {
+    if (index < 0 || index >= patternCount) return "";
+    return patterns[index];
+}
+
+void watcherPrintStatus() {
+    Serial.printf("Watcher: %d patterns (%s)\n", patternCount,
+                  delta ? "active" : "disabled");
+    for (int p = 0; p < patternCount; p++) {
+        Serial.printf("  %-24s %u alerts\n", patterns[p], (unsigned)patternHits[p]);
+    }
+}
@@ -0,0 +1,35 @@
+/**
+ * Output Watcher for T-LoRa Pager Terminal
+ * Multi-pattern matcher (Aho-Corasick) run inline on the SSH RX stream.
+ * Matches raise an alert that the UI loop turns into haptics and a
+ * status-bar badge.
+ */
+
+#ifndef OUTPUT_WATCHER_H
+#define OUTPUT_WATCHER_H
+
+#include <Arduino.h>
+
+#define WATCH_MAX_PATTERNS 16
+#define WATCH_MAX_PATTERN_LEN 48
+#define WATCH_MAX_STATES 512
+#define WATCH_PATTERNS_FILE "/config/watch_patterns.txt"
+
+// Load patterns from LittleFS (falls back to ERROR/FAILED) and compile
+// the automaton. Call once before the SSH task starts.
+bool watcherInit();
+
+// Feed received bytes (SSH task). Matching is case-insensitive and
+// continues across calls, so patterns split between reads still match.
+void watcherScan(const char *data, size_t len);
+
+// Take the pending match (UI loop). Returns the pattern index, or -1.
+int watcherTakeMatch();
+
+// Pattern text for an index returned by watcherTakeMatch()
+const char* watcherPatternName(int index);
+
+// Print patterns and match counters to Serial
+void watcherPrintStatus();
+
+#endif // OUTPUT_WATCHER_H
@@ -0,0 +1,53 @@
+/**
+ * Pipeline Statistics Implementation
+ */
+
+#include "pipeline_stats.h"
+#include <esp_timer.h>
+
+PipelineStats_t pipelineStats;
+
+void statsReset() {
+    memset(&pipelineStats, 0, sizeof(pipelineStats));
+    pipelineStats.sinceUs = esp_timer_get_time();
+}
+
+const char* statsBottleneck() {
+    const PipelineStats_t &s = pipelineStats;
+    uint64_t windowUs = esp_timer_get_time() - s.sinceUs;
+
+    if (s.rxBytes == 0 || windowUs == 0) return "idle";
+
+    // Reading held off for the display a third of the time or more
+    if (s.rxPausedUs * 3 >= windowUs) return "renderer";
+
+    // Mostly polling an empty channel: the link/server sets the pace
+    if (s.rxEmptyPolls > s.rxReads) return "network";
+
+    // Always data waiting and never paused: decrypt/read is the limit
+    return "ssh task";
+}
+
+void statsPrint() {
+    const PipelineStats_t &s = pipelineStats;
+    uint64_t windowUs = esp_timer_get_time() - s.sinceUs;
+    float secs = windowUs / 1e6f;
+
+    Serial.printf("Stats: %.1fs window\n", secs);
+    Serial.printf("  network  %u bytes in %u reads (%.1f KB/s), %u empty polls, %.1fms reading\n",
+                  (unsigned)s.rxBytes, (unsigned)s.rxReads,
+                  secs > 0 ? s.rxBytes / 1024.0f / secs : 0,
+                  (unsigned)s.rxEmptyPolls, s.rxReadUs / 1000.0f);
+    Serial.printf("  rx ring  peak %u bytes, %u pauses (%.1fms paused), %u dropped\n",
+                  s.rxPeakFill, (unsigned)s.rxPauses, s.rxPausedUs / 1000.0f,
+                  (unsigned)s.rxDropped);
+    Serial.printf("  render   %u bytes in %u batches, %.1fms (%.1f KB/s while rendering)\n",
+                  (unsigned)s.renderBytes, (unsigned)s.renderCalls, s.renderUs / 1000.0f,
+                  s.renderUs > 0 ? s.renderBytes * 1e6f / 1024.0f / s.renderUs : 0);
+    Serial.printf("  frames   %u drawn, %u jump scrolls\n",
+                  (unsigned)s.renderFrames, (unsigned)s.jumpScrolls);
+    Serial.printf("  input    %u keys, %u commands in %u writes (%.1f per command), %u bytes\n",
+                  (unsigned)s.txKeys, (unsigned)s.txLines, (unsigned)s.txWrites,
+                  s.txLines > 0 ? (float)s.txWrites / s.txLines : 0, (unsigned)s.txBytes);
+    Serial.printf("  bottleneck: %s\n", statsBottleneck());
+}
@@ -0,0 +1,50 @@
+/**
+ * Pipeline Statistics for T-LoRa Pager Terminal
+ * Counters for the SSH -> RX ring -> renderer pipeline
+ */
+
+#ifndef PIPELINE_STATS_H
+#define PIPELINE_STATS_H
+
+#include <Arduino.h>
+
+typedef struct {
+    // Network stage (SSH task)
+    uint32_t rxBytes;        // Bytes read from the channel
+    uint32_t rxReads;        // Reads that returned data
+    uint32_t rxEmptyPolls;   // Polls with nothing to read
+    uint64_t rxReadUs;       // Time in reads that returned data (decrypt)
+    uint32_t rxPauses;       // High watermark crossings
+    uint64_t rxPausedUs;     // Time reading was paused for the renderer
+    uint32_t rxDropped;      // Bytes lost to a full ring (must stay 0)
+    uint16_t rxPeakFill;     // Highest RX ring fill
+
+    // Render stage (UI loop)
+    uint32_t renderBytes;    // Bytes drained to the display
+    uint32_t renderCalls;    // Drain batches
+    uint64_t renderUs;       // Time spent parsing and rendering
+    uint32_t renderFrames;   // Text area updates
+    uint32_t jumpScrolls;    // Backlogs handled in jump scroll mode
+
+    // Input stage (keyboard -> session)
+    uint32_t txKeys;         // Keys typed while connected
+    uint32_t txLines;        // Enter presses (commands)
+    uint32_t txWrites;       // Session writes (~ packets sent)
+    uint32_t txBytes;        // Bytes written
+
+    // Start of the measurement window
+    uint64_t sinceUs;
+} PipelineStats_t;
+
+extern PipelineStats_t pipelineStats;
+
+// Start a new measurement window
+void statsReset();
+
+// Name of the stage currently limiting throughput
+const char* statsBottleneck();
+
+// Print counters and the bottleneck to Serial
+void statsPrint();
+
+#endif // PIPELINE_STATS_H
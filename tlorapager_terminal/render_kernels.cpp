@@ -0,0 +1,164 @@
+/**
+ * Render Kernels Implementation
+ *
+ * The fast paths work on 32-bit words (two RGB565 pixels per store).
+ * The blend spreads a pixel over a 32-bit word (green in the upper
+ * half) to mix all three channels with one multiply, as LVGL does, and
+ * skips transparent coverage four pixels at a time.
+ */
+
+#include "render_kernels.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#define RK_HOT IRAM_ATTR
+#else
+#define RK_HOT
+#endif
+
+// 0x07E0F81F: green moved to bits 21-26, red/blue stay in the low half
+#define RK_SPREAD_MASK 0x07E0F81FUL
+
+RkHookStats_t rkHookStats;
+
+static inline uint32_t rkSpread(uint16_t c) {
+    return ((uint32_t)c | ((uint32_t)c << 16)) & RK_SPREAD_MASK;
+}
+
+// lv_color_16_16_mix(): 8-bit coverage rounded to a 0..32 weight
+static inline uint16_t rkMix(uint16_t fg, uint16_t bg, uint8_t alpha) {
+    if (alpha == 255) return fg;
+    if (alpha == 0 || fg == bg) return bg;
+    uint32_t mix = ((uint32_t)alpha + 4) >> 3;
+    uint32_t b = rkSpread(bg);
+    uint32_t s = ((((rkSpread(fg) - b) * mix) >> 5) + b) & RK_SPREAD_MASK;
+    return (uint16_t)((s >> 16) | s);
+}
+
+static inline uint16_t rkSwap(uint16_t c) {
+    return (uint16_t)((c << 8) | (c >> 8));
+}
+
+static inline uint32_t rkSwapPair(uint32_t w) {
+    return ((w & 0x00FF00FFUL) << 8) | ((w >> 8) & 0x00FF00FFUL);
+}
+
+// ---------------------------------------------------------------------------
+// Reference kernels
+// ---------------------------------------------------------------------------
+
+void rkFill565Ref(uint16_t *dst, size_t count, uint16_t color) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+void rkBlendA8To565Ref(uint16_t *dst, const uint8_t *alpha, size_t count, uint16_t color) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = rkMix(color, dst[i], alpha[i]);
+    }
+}
+
+void rkSwap565Ref(uint16_t *buf, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        buf[i] = rkSwap(buf[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fast kernels
+// ---------------------------------------------------------------------------
+
+RK_HOT void rkFill565(uint16_t *dst, size_t count, uint16_t color) {
+    // Align to a word boundary
+    if (count && ((uintptr_t)dst & 2)) {
+        *dst++ = color;
+        count--;
+    }
+
+    uint32_t pair = ((uint32_t)color << 16) | color;
+    uint32_t *w = (uint32_t *)dst;
+    size_t words = count >> 1;
+
+    // 8 pixels per iteration
+    while (words >= 4) {
+        w[0] = pair;
+        w[1] = pair;
+        w[2] = pair;
+        w[3] = pair;
+        w += 4;
+        words -= 4;
+    }
+    while (words--) {
+        *w++ = pair;
+    }
+
+    if (count & 1) {
+        *(uint16_t *)w = color;
+    }
+}
+
+RK_HOT void rkBlendA8To565(uint16_t *dst, const uint8_t *alpha, size_t count, uint16_t color) {
+    uint32_t fs = rkSpread(color);
+    size_t i = 0;
+
+    while (i < count) {
+        // Glyph cells are mostly empty, strokes mostly solid: whole quads
+        // of weight 0 (alpha < 4) are skipped, of weight 32 stored
+        if (i + 4 <= count) {
+            uint32_t quad;
+            memcpy(&quad, alpha + i, 4);
+            if ((quad & 0xFCFCFCFCUL) == 0) {
+                i += 4;
+                continue;
+            }
+            if (quad == 0xFFFFFFFFUL) {
+                dst[i] = dst[i + 1] = dst[i + 2] = dst[i + 3] = color;
+                i += 4;
+                continue;
+            }
+        }
+
+        uint32_t a = alpha[i];
+        uint16_t bg = dst[i];
+        if (a == 255) {
+            dst[i] = color;
+        } else if (a >= 4 && bg != color) {
+            uint32_t b = rkSpread(bg);
+            uint32_t s = ((((fs - b) * ((a + 4) >> 3)) >> 5) + b) & RK_SPREAD_MASK;
+            dst[i] = (uint16_t)((s >> 16) | s);
+        }
+        i++;
+    }
+}
+
+RK_HOT void rkSwap565(uint16_t *buf, size_t count) {
+    if (count && ((uintptr_t)buf & 2)) {
+        *buf = rkSwap(*buf);
+        buf++;
+        count--;
+    }
+
+    uint32_t *w = (uint32_t *)buf;
+    size_t words = count >> 1;
+
+    // 8 pixels per iteration
+    while (words >= 4) {
+        w[0] = rkSwapPair(w[0]);
+        w[1] = rkSwapPair(w[1]);
+        w[2] = rkSwapPair(w[2]);
+        w[3] = rkSwapPair(w[3]);
+        w += 4;
+        words -= 4;
+    }
+    while (words--) {
+        *w = rkSwapPair(*w);
+        w++;
+    }
+
+    if (count & 1) {
+        uint16_t *p = (uint16_t *)w;
+        *p = rkSwap(*p);
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * Render Kernels for T-LoRa Pager Terminal
+ * RGB565 pixel loops on the render path: solid fills, A8 glyph blending
+ * and the byte swap for the SPI panel
+ *
+ * LVGL's software renderer calls them through its custom blend hooks
+ * (lv_blend_rk.h): solid rectangles and text backgrounds are fills,
+ * glyphs are A8 masks blended over the background, and the flush swaps
+ * each buffer with lv_draw_sw_rgb565_swap() before the SPI write. The
+ * sixel decoder fills its tiles with the same fill kernel.
+ *
+ * Each kernel has a portable scalar reference version. The fast
+ * versions must stay bit-exact with the references (see
+ * tests/render_kernels_test.cpp, and benchRenderSelfTest() in bench.h
+ * on the device).
+ */
+
+#ifndef RENDER_KERNELS_H
+#define RENDER_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fast kernels (word-at-a-time, placed in IRAM on the ESP32)
+void rkFill565(uint16_t *dst, size_t count, uint16_t color);
+void rkBlendA8To565(uint16_t *dst, const uint8_t *alpha, size_t count, uint16_t color);
+void rkSwap565(uint16_t *buf, size_t count);
+
+// Scalar reference kernels. The blend is LVGL's lv_color_16_16_mix()
+// per pixel, so the hooked renderer draws what LVGL's own loop would.
+void rkFill565Ref(uint16_t *dst, size_t count, uint16_t color);
+void rkBlendA8To565Ref(uint16_t *dst, const uint8_t *alpha, size_t count, uint16_t color);
+void rkSwap565Ref(uint16_t *buf, size_t count);
+
+// Pixels that went through the LVGL hooks, to see they are in use
+typedef struct {
+    uint32_t filled;
+    uint32_t blended;
+    uint32_t swapped;
+} RkHookStats_t;
+
+extern RkHookStats_t rkHookStats;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RENDER_KERNELS_H
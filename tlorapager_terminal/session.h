@@ -0,0 +1,42 @@
+/**
+ * Session Transport Interface for T-LoRa Pager Terminal
+ * Common shape for SSH, ttyd and mosh sessions, driven by the session task
+ *
+ * All calls are made from the session task. read() is non-blocking and
+ * writes straight into the caller's buffer (a span of the RX ring); SSH
+ * and ttyd read the socket there directly. mosh is the exception: its
+ * screen-state diffs arrive compressed and have to be staged.
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <Arduino.h>
+
+typedef struct {
+    const char *name;
+
+    // Connect, authenticate and start a cols x rows terminal. Blocking;
+    // logs and returns false on failure with everything released.
+    bool (*open)(void *target, uint16_t cols, uint16_t rows);
+
+    // Bytes of terminal output read into buf (up to room), 0 if nothing
+    // is waiting, < 0 if the session ended
+    int (*read)(char *buf, int room);
+
+    // Send keystrokes as one unit; returns len or < 0 on error
+    int (*write)(const char *data, int len);
+
+    bool (*isOpen)();
+
+    // Flow control hint from the RX ring watermarks (may be NULL)
+    void (*setPaused)(bool paused);
+
+    // Tell the host the terminal size changed (may be NULL: the new
+    // size applies from the next connect)
+    void (*resize)(uint16_t cols, uint16_t rows);
+
+    void (*close)();
+} SessionTransport_t;
+
+#endif // SESSION_H
@@ -49,6 +49,7 @@ void settingsReset() {
     // Display defaults
     settings.brightness = 200;
     settings.theme = THEME_GREEN_ON_BLACK;
+    settings.wideTerminal = false;
 
     // WiFi defaults
     settings.wifiNetworkCount = 1;
@@ -65,6 +66,7 @@ void settingsReset() {
     strcpy(settings.localServer.password, "archie");
     settings.localServer.useSSL = false;  // Not used for SSH
     settings.localServer.enabled = true;
+    settings.localServer.jump.port = 22;  // No jump host (host empty)
 
     // Remote SSH server (Tailscale)
     strcpy(settings.remoteServer.host, "100.107.239.11");  // Tailscale IP
@@ -74,8 +76,11 @@ void settingsReset() {
     strcpy(settings.remoteServer.password, "archie");
     settings.remoteServer.useSSL = false;  // Not used for SSH
     settings.remoteServer.enabled = true;
+    settings.remoteServer.jump.port = 22;  // No jump host (host empty)
 
     settings.preferRemote = false;  // Use local first
+    settings.transport = TRANSPORT_SSH;
+    settings.telnet.port = 23;  // No target (host empty)
 
     // System defaults - Sound
     settings.soundEnabled = true;
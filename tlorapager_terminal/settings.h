@@ -33,6 +33,14 @@ typedef struct {
     bool enabled;
 } WiFiNetwork_t;
 
+// SSH bastion in front of a server (ProxyJump)
+typedef struct {
+    char host[MAX_HOST_LEN];   // Empty: connect directly
+    uint16_t port;
+    char username[32];
+    char password[32];
+} JumpHostConfig_t;
+
 // Server configuration
 typedef struct {
     char host[MAX_HOST_LEN];
@@ -42,10 +50,27 @@ typedef struct {
     char password[32];
     bool useSSL;
     bool enabled;
+    JumpHostConfig_t jump;     // Reach host through this bastion
 } ServerConfig_t;
 
+// Telnet / raw TCP target (console servers, PDUs)
+typedef struct {
+    char host[MAX_HOST_LEN];
+    uint16_t port;
+    bool raw;                  // Plain TCP: no telnet commands, CR for Enter
+} TelnetConfig_t;
+
+// Session transport
+typedef enum {
+    TRANSPORT_SSH = 0,         // Local/remote SSH server below
+    TRANSPORT_TTYD,            // ttyd WebSocket gateway (ConfigLoader profile)
+    TRANSPORT_MOSH,            // mosh to the SSH server below (SSH bootstrap)
+    TRANSPORT_TELNET,          // Telnet / raw TCP target below
+    TRANSPORT_COUNT
+} Transport_t;
+
 // Settings version - increment to force reset on structure change
-#define SETTINGS_VERSION 12  // SSH support
+#define SETTINGS_VERSION 16  // Wide terminal
 
 // Complete settings structure
 typedef struct {
@@ -55,6 +80,7 @@ typedef struct {
     // Display settings
     uint8_t brightness;        // 0-255
     Theme_t theme;
+    bool wideTerminal;         // 132-column PTY, panned on screen
 
     // WiFi networks (priority order)
     WiFiNetwork_t wifiNetworks[MAX_WIFI_NETWORKS];
@@ -65,6 +91,8 @@ typedef struct {
     ServerConfig_t localServer;   // Local ttyd server
     ServerConfig_t remoteServer;  // Remote ttyd server
     bool preferRemote;            // Try remote first
+    Transport_t transport;        // SSH, ttyd gateway, mosh or telnet
+    TelnetConfig_t telnet;        // Lab gear without SSH
 
     // System - Sound
     bool soundEnabled;
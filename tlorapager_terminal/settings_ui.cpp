@@ -5,6 +5,9 @@
 
 #include "settings_ui.h"
 #include "settings.h"
+#include "terminal_ui.h"
+#include "haptics.h"
+#include "audio.h"
 #include <WiFi.h>
 #include <LilyGoLib.h>
 
@@ -14,36 +17,6 @@ static int selectedIndex = 0;
 static int scrollOffset = 0;
 static int maxVisibleItems = 5;
 
-// Haptic feedback functions
-void playHapticClick() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 1);
-    instance.drv.setWaveform(1, 0);
-    instance.drv.run();
-}
-
-void playHapticTick() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 10);
-    instance.drv.setWaveform(1, 0);
-    instance.drv.run();
-}
-
-void playHapticBump() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 47);
-    instance.drv.setWaveform(1, 0);
-    instance.drv.run();
-}
-
-void playHapticDouble() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 1);
-    instance.drv.setWaveform(1, 1);
-    instance.drv.setWaveform(2, 0);
-    instance.drv.run();
-}
-
 // LVGL objects
 static lv_obj_t *settingsScreen = NULL;
 static lv_obj_t *menuContainer = NULL;
@@ -248,7 +221,7 @@ static void createMainMenu() {
 }
 
 static void createDisplayMenu() {
-    const int totalItems = 3;
+    const int totalItems = 4;
     createMenuContainer("DISPLAY", totalItems);
     createMenuList();
 
@@ -259,9 +232,10 @@ static void createDisplayMenu() {
     addMenuItem(menuList, "Brightness", buf, 1);
 
     addMenuItem(menuList, "Theme", themeColors[settings.theme].name, 2);
+    addMenuItem(menuList, "Columns", settings.wideTerminal ? "132 (pan)" : "80", 3);
 
     if (menuStatusLabel) {
-        lv_label_set_text(menuStatusLabel, "Rotate to adjust, click Back to return");
+        lv_label_set_text(menuStatusLabel, "Rotate to adjust, click to toggle");
     }
 }
 
@@ -526,7 +500,7 @@ static void createAboutMenu() {
 }
 
 static void goBack() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     switch (currentMenu) {
         case MENU_MAIN:
             settingsUIHide();
@@ -557,7 +531,7 @@ static void goBack() {
 }
 
 static void handleMainMenuSelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     scrollOffset = 0;
     switch (selectedIndex) {
         case 0:
@@ -597,9 +571,14 @@ static void handleMainMenuSelect() {
 }
 
 static void handleDisplaySelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     if (selectedIndex == 0) {
         goBack();
+    } else if (selectedIndex == 3) {
+        settings.wideTerminal = !settings.wideTerminal;
+        settingsSave();
+        if (terminalResize(terminalColumns(), termModel.rows())) sessionResize();
+        createDisplayMenu();
     }
 }
 
@@ -628,6 +607,7 @@ static void handleSystemAdjust(int direction) {
         case 1:
             settings.soundEnabled = !settings.soundEnabled;
             settingsSave();
+            audioPlay(AUDIO_CLICK);
             createSystemMenu();
             break;
         case 2:
@@ -637,13 +617,15 @@ static void handleSystemAdjust(int direction) {
                 if (newVol > 100) newVol = 100;
                 settings.volume = newVol;
                 settingsSave();
+                audioSetVolume(settings.volume);
+                audioPlay(AUDIO_CLICK);  // Preview
                 createSystemMenu();
             }
             break;
         case 3:
             settings.hapticEnabled = !settings.hapticEnabled;
             settingsSave();
-            playHapticClick();
+            hapticPlay(HAPTIC_CLICK);
             createSystemMenu();
             break;
         case 4:
@@ -653,7 +635,7 @@ static void handleSystemAdjust(int direction) {
                 if (newHap > 100) newHap = 100;
                 settings.hapticIntensity = newHap;
                 settingsSave();
-                playHapticTick();
+                hapticPlay(HAPTIC_TICK);
                 createSystemMenu();
             }
             break;
@@ -671,7 +653,7 @@ static void handleSystemAdjust(int direction) {
 }
 
 static void handleSystemSelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     switch (selectedIndex) {
         case 0:
             goBack();
@@ -683,14 +665,14 @@ static void handleSystemSelect() {
             handleSystemAdjust(1);
             break;
         case 7:
-            playHapticDouble();
+            hapticPlay(HAPTIC_DOUBLE);
             settingsReset();
             settingsSave();
             createSystemMenu();
             break;
         case 8:
-            playHapticDouble();
-            delay(200);
+            hapticPlay(HAPTIC_DOUBLE);
+            hapticsWaitIdle(500);
             ESP.restart();
             break;
     }
@@ -729,7 +711,7 @@ static void deleteWiFiNetwork(int index) {
 }
 
 static void handleWiFiListSelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     if (selectedIndex == 0) {
         goBack();
     } else if (selectedIndex == 1) {
@@ -752,7 +734,7 @@ static void handleWiFiListSelect() {
 }
 
 static void handleWiFiScanSelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     if (selectedIndex == 0) {
         goBack();
     } else if (selectedIndex <= scanCount) {
@@ -764,7 +746,7 @@ static void handleWiFiScanSelect() {
 extern void connectToServer();
 
 static void handleServerSelect() {
-    playHapticClick();
+    hapticPlay(HAPTIC_CLICK);
     ServerConfig_t *server = editingRemoteServer ? &settings.remoteServer : &settings.localServer;
 
     switch (selectedIndex) {
@@ -821,7 +803,7 @@ static void saveWiFiNetwork(const char* ssid, const char* password) {
 
 void settingsUICancelInput() {
     Serial.println("Input cancelled");
-    playHapticBump();
+    hapticPlay(HAPTIC_BUMP);
     wifiSSID[0] = '\0';
     wifiPass[0] = '\0';
     editingField = 0;
@@ -861,7 +843,7 @@ void settingsUIHandleKey(char key) {
 
                 if (strlen(wifiSSID) > 0) {
                     saveWiFiNetwork(wifiSSID, wifiPass);
-                    playHapticClick();
+                    hapticPlay(HAPTIC_CLICK);
                 }
 
                 wifiSSID[0] = '\0';
@@ -902,7 +884,7 @@ void settingsUIHandleKey(char key) {
                     break;
             }
             settingsSave();
-            playHapticClick();
+            hapticPlay(HAPTIC_CLICK);
 
             serverEditField = -1;
             MenuState_t targetMenu = editingRemoteServer ? MENU_SERVER_REMOTE : MENU_SERVER_LOCAL;
@@ -949,15 +931,15 @@ void settingsUIHandleKey(char key) {
 
 void settingsUIHandleRotary(int direction) {
     if (direction == 0) {
-        playHapticClick();
+        hapticPlay(HAPTIC_CLICK);
         settingsUIHandleKey('\n');
         return;
     }
 
-    playHapticTick();
+    hapticPlay(HAPTIC_TICK);
 
     // Adjust values in display menu
-    if (currentMenu == MENU_DISPLAY && selectedIndex > 0) {
+    if (currentMenu == MENU_DISPLAY && (selectedIndex == 1 || selectedIndex == 2)) {
         handleDisplayAdjust(direction);
         return;
     }
@@ -972,7 +954,7 @@ void settingsUIHandleRotary(int direction) {
     int maxItems = 0;
     switch (currentMenu) {
         case MENU_MAIN: maxItems = 7; break;
-        case MENU_DISPLAY: maxItems = 3; break;
+        case MENU_DISPLAY: maxItems = 4; break;
         case MENU_WIFI_LIST: maxItems = settings.wifiNetworkCount + 3; break;
         case MENU_WIFI_SCAN: maxItems = scanCount + 1; break;
         case MENU_SERVER_LOCAL:
@@ -0,0 +1,406 @@
+/**
+ * Sixel Images Implementation
+ */
+
+#include "sixel.h"
+#include "render_kernels.h"
+#include <string.h>
+
+#define SIXEL_PARAM_MAX 0x7FFF
+
+// VT340 default palette, RGB percent
+static const uint8_t vt340Palette[16][3] = {
+    {0, 0, 0},    {20, 20, 80}, {80, 13, 13}, {20, 80, 20},
+    {80, 20, 80}, {20, 80, 80}, {80, 80, 20}, {53, 53, 53},
+    {26, 26, 26}, {33, 33, 60}, {60, 26, 26}, {33, 60, 33},
+    {60, 33, 60}, {33, 60, 60}, {60, 60, 33}, {80, 80, 80},
+};
+
+static uint16_t rgb565(uint32_t r, uint32_t g, uint32_t b) {
+    return ((r * 255 / 100) >> 3) << 11 | ((g * 255 / 100) >> 2) << 5 | ((b * 255 / 100) >> 3);
+}
+
+// DEC hue puts blue at 0 degrees, red at 120 and green at 240
+static uint16_t hls565(uint32_t h, uint32_t l, uint32_t s) {
+    h = (h + 240) % 360;
+    int32_t c = (100 - (l > 50 ? 2 * l - 100 : 100 - 2 * l)) * (int32_t)s / 100;
+    int32_t x = c * (60 - (int32_t)(h % 120 > 60 ? h % 120 - 60 : 60 - h % 120)) / 60;
+    int32_t m = (int32_t)l - c / 2;
+    int32_t r = 0, g = 0, b = 0;
+    switch (h / 60) {
+        case 0: r = c; g = x; break;
+        case 1: r = x; g = c; break;
+        case 2: g = c; b = x; break;
+        case 3: g = x; b = c; break;
+        case 4: r = x; b = c; break;
+        default: r = c; b = x; break;
+    }
+    return rgb565(r + m, g + m, b + m);
+}
+
+// ---------------------------------------------------------------------------
+// Tile cache
+// ---------------------------------------------------------------------------
+
+SixelCache::SixelCache()
+    : decoded(0), placeholders(0), evicted(0), workMax(0),
+      _tiles(NULL), _tileCount(0), _tilesFree(0), _cellW(0), _cellH(0), _age(0), _serial(0) {
+    memset(_used, 0, sizeof(_used));
+    memset(_images, 0, sizeof(_images));
+}
+
+size_t SixelCache::tileBytes(uint8_t cellW, uint8_t cellH) {
+    return (size_t)SIXEL_TILE_COLS * cellW * cellH * sizeof(uint16_t);
+}
+
+int SixelCache::begin(void *mem, size_t bytes, uint8_t cellW, uint8_t cellH) {
+    clearAll();
+    _tiles = (uint16_t *)mem;
+    _cellW = cellW;
+    _cellH = cellH;
+    size_t each = tileBytes(cellW, cellH);
+    _tileCount = (mem && each) ? bytes / each : 0;
+    if (_tileCount > SIXEL_MAX_TILES) _tileCount = SIXEL_MAX_TILES;
+    _tilesFree = _tileCount;
+    memset(_used, 0, sizeof(_used));
+    return _tileCount;
+}
+
+SixelImage* SixelCache::newImage(bool alt, int16_t top, uint16_t left) {
+    SixelImage *slot = NULL;
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        if (!_images[i].used) {
+            slot = &_images[i];
+            break;
+        }
+        if (slot == NULL || _images[i].age < slot->age) slot = &_images[i];
+    }
+    if (slot->used) {
+        drop(slot);
+        evicted++;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    for (int r = 0; r < SIXEL_MAX_ROWS; r++) slot->tile[r] = -1;
+    slot->used = true;
+    slot->alt = alt;
+    slot->top = top;
+    slot->left = left;
+    slot->age = ++_age;
+    touch(slot);
+    return slot;
+}
+
+int16_t SixelCache::allocTile(const SixelImage *keep) {
+    while (true) {
+        if (_tilesFree > 0) {
+            for (int t = 0; t < _tileCount; t++) {
+                if (!(_used[t / 32] & (1u << (t % 32)))) {
+                    _used[t / 32] |= 1u << (t % 32);
+                    _tilesFree--;
+                    return t;
+                }
+            }
+        }
+
+        // Full: the oldest other image goes
+        SixelImage *oldest = NULL;
+        for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+            SixelImage &img = _images[i];
+            if (!img.used || &img == keep) continue;
+            if (oldest == NULL || img.age < oldest->age) oldest = &img;
+        }
+        if (oldest == NULL) return -1;
+        drop(oldest);
+        evicted++;
+    }
+}
+
+void SixelCache::drop(SixelImage *img) {
+    for (int r = 0; r < SIXEL_MAX_ROWS; r++) {
+        int16_t t = img->tile[r];
+        if (t < 0) continue;
+        _used[t / 32] &= ~(1u << (t % 32));
+        _tilesFree++;
+        img->tile[r] = -1;
+    }
+    img->used = false;
+}
+
+// Images move with the rows they are on. Scrolling the whole screen up
+// takes them into history (still drawn while part of one is on screen)
+// and brings up the one being decoded as it grows past the bottom. One
+// cut by a scroll region, or pushed off the bottom, is dropped.
+void SixelCache::scroll(bool alt, int top, int bottom, int n, bool fullScreen) {
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        SixelImage &img = _images[i];
+        if (!img.used || img.alt != alt) continue;
+        int first = img.top;
+        int last = img.top + img.rows - 1;
+        if (last < top || first > bottom) continue;
+
+        bool inside = first >= top && last <= bottom;
+        if (!inside && !fullScreen) {
+            drop(&img);
+            continue;
+        }
+        img.top += n;
+        first += n;
+        last += n;
+        if (last < top || first > bottom || (n > 0 && last > bottom)) drop(&img);
+    }
+}
+
+void SixelCache::clear(bool alt) {
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        if (_images[i].used && _images[i].alt == alt) drop(&_images[i]);
+    }
+}
+
+void SixelCache::clearAll() {
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        if (_images[i].used) drop(&_images[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+// ---------------------------------------------------------------------------
+
+SixelDecoder::SixelDecoder()
+    : _cache(NULL), _img(NULL), _active(false), _status(SIXEL_OK), _maxCols(0), _maxRows(0),
+      _state(SX_DATA), _command(0), _nparams(0), _color(0), _background(0), _repeat(1),
+      _x(0), _band(0), _srcW(0), _srcH(0), _fillW(0), _work(0) {
+    memset(_params, 0, sizeof(_params));
+    memset(_palette, 0, sizeof(_palette));
+}
+
+void SixelDecoder::start(SixelCache *cache, SixelImage *img, uint16_t maxCols, uint8_t maxRows) {
+    abort();
+    _cache = cache;
+    _img = img;
+    _active = true;
+    _status = img ? SIXEL_OK : SIXEL_NO_MEMORY;
+    _maxCols = maxCols > SIXEL_TILE_COLS ? SIXEL_TILE_COLS : maxCols;
+    _maxRows = maxRows > SIXEL_MAX_ROWS ? SIXEL_MAX_ROWS : maxRows;
+    _state = SX_DATA;
+    _nparams = 0;
+    _repeat = 1;
+    _x = 0;
+    _band = 0;
+    _srcW = _srcH = 0;
+    _fillW = 0;
+
+    // Each image starts from the default palette (xterm's private registers)
+    memset(_palette, 0, sizeof(_palette));
+    for (int i = 0; i < 16; i++) {
+        _palette[i] = rgb565(vt340Palette[i][0], vt340Palette[i][1], vt340Palette[i][2]);
+    }
+    _color = 0;
+    _background = _palette[0];
+}
+
+void SixelDecoder::frame() {
+    if (_cache && _work > _cache->workMax) _cache->workMax = _work;
+    _work = 0;
+}
+
+void SixelDecoder::abort() {
+    if (_img && _img->used) _cache->drop(_img);
+    _img = NULL;
+    _active = false;
+    _srcW = _srcH = 0;
+}
+
+void SixelDecoder::fail(SixelStatus_t status) {
+    if (_img && _img->used) _cache->drop(_img);
+    _img = NULL;
+    if (_status == SIXEL_OK) _status = status;
+}
+
+uint8_t SixelDecoder::rows() const {
+    uint32_t rows = (_srcH + SIXEL_HOST_CELL_H - 1) / SIXEL_HOST_CELL_H;
+    return rows > _maxRows ? _maxRows : rows;
+}
+
+uint8_t SixelDecoder::cols() const {
+    uint32_t cols = (_srcW + SIXEL_HOST_CELL_W - 1) / SIXEL_HOST_CELL_W;
+    return cols > _maxCols ? _maxCols : cols;
+}
+
+SixelStatus_t SixelDecoder::finish() {
+    if (!_active) return SIXEL_OK;
+    if (_state == SX_PARAM) command();
+    _active = false;
+
+    if (_img && !_img->used) fail(SIXEL_NO_MEMORY);  // Dropped under us
+    if (_img && _img->rows == 0) {
+        _cache->drop(_img);  // No pixels
+    } else if (_img) {
+        _img->done = true;
+        _cache->touch(_img);
+        _cache->decoded++;
+    } else if (_cache && rows() > 0) {
+        _cache->placeholders++;
+    }
+    _img = NULL;
+    return _status;
+}
+
+bool SixelDecoder::put(uint8_t c) {
+    if (!_active) return false;
+
+    if (_state == SX_PARAM) {
+        if (c >= '0' && c <= '9') {
+            if (_nparams == 0) _nparams = 1;
+            uint32_t v = _params[_nparams - 1] * 10 + (c - '0');
+            _params[_nparams - 1] = v > SIXEL_PARAM_MAX ? SIXEL_PARAM_MAX : v;
+            return _img != NULL;
+        }
+        if (c == ';') {
+            if (_nparams == 0) _nparams = 1;
+            if (_nparams < SIXEL_MAX_PARAMS) _params[_nparams++] = 0;
+            return _img != NULL;
+        }
+        command();
+        _state = SX_DATA;
+        if (_img && _command == '"') {
+            _img->cols = cols();
+            _img->rows = rows();
+        }
+    }
+
+    if (c >= '?' && c <= '~') {
+        paint(c - '?', _repeat);
+        _repeat = 1;
+    } else if (c == '$') {  // Graphics CR
+        _x = 0;
+    } else if (c == '-') {  // Graphics NL
+        _x = 0;
+        if (_band < SIXEL_PARAM_MAX) _band++;
+    } else if (c == '!' || c == '#' || c == '"') {
+        _state = SX_PARAM;
+        _command = c;
+        _nparams = 0;
+        memset(_params, 0, sizeof(_params));
+    }
+    // Anything else (CR, LF between bands) is ignored
+    return _img != NULL;
+}
+
+void SixelDecoder::command() {
+    switch (_command) {
+        case '!':  // Repeat the next sixel
+            _repeat = _params[0] > 0 ? _params[0] : 1;
+            break;
+        case '#':  // Select, or define and select, a color register
+            if (_nparams == 0) break;
+            _color = _params[0] % SIXEL_COLORS;
+            if (_nparams >= 5) {
+                uint16_t a = _params[2], b = _params[3], c = _params[4];
+                if (_params[1] == 1) {
+                    _palette[_color] = hls565(a % 361, b > 100 ? 100 : b, c > 100 ? 100 : c);
+                } else if (_params[1] == 2) {
+                    _palette[_color] = rgb565(a > 100 ? 100 : a, b > 100 ? 100 : b, c > 100 ? 100 : c);
+                }
+            }
+            break;
+        case '"':  // Raster attributes: Pan;Pad;Ph;Pv (the size, up front)
+            if (_nparams >= 4) {
+                if (_params[2] > _srcW) _srcW = _params[2];
+                if (_params[3] > _srcH) _srcH = _params[3];
+            }
+            break;
+    }
+}
+
+// Tiles are only cleared as wide as the image is (the renderer shows
+// cols() cells of each), and widened with it. Clearing is not paint, so
+// it is not charged to the frame's work.
+void SixelDecoder::fillTo(uint16_t width) {
+    if (width <= _fillW) return;
+    uint8_t cellH = _cache->cellH();
+    uint16_t stride = _cache->tileWidth();
+    for (int r = 0; r < SIXEL_MAX_ROWS; r++) {
+        if (_img->tile[r] < 0) continue;
+        uint16_t *p = _cache->tile(_img->tile[r]);
+        for (uint8_t y = 0; y < cellH; y++) {
+            rkFill565(p + (uint32_t)y * stride + _fillW, width - _fillW, _background);
+        }
+    }
+    _fillW = width;
+}
+
+uint16_t* SixelDecoder::pixelRow(uint16_t y) {
+    uint8_t cellH = _cache->cellH();
+    uint8_t row = y / cellH;
+    if (_img->tile[row] < 0) {
+        int16_t t = _cache->allocTile(_img);
+        if (t < 0) {
+            fail(SIXEL_NO_MEMORY);
+            return NULL;
+        }
+        uint16_t *p = _cache->tile(t);
+        uint16_t stride = _cache->tileWidth();
+        for (uint8_t ty = 0; ty < cellH; ty++) {
+            rkFill565(p + (uint32_t)ty * stride, _fillW, _background);
+        }
+        _img->tile[row] = t;
+    }
+    return _cache->tile(_img->tile[row]) + (uint32_t)(y % cellH) * _cache->tileWidth();
+}
+
+// Pixels are mapped to our cells as they come: each source pixel lands
+// on the target pixel under it (nearest), and a background pixel never
+// overwrites another color there, so one-pixel lines survive the scale.
+void SixelDecoder::paint(uint8_t bits, uint16_t repeat) {
+    uint32_t x0 = _x;
+    uint32_t x1 = x0 + repeat;
+    _x = x1 > SIXEL_PARAM_MAX ? SIXEL_PARAM_MAX : x1;
+    _work++;
+    if (bits == 0) return;
+
+    // Extent (for the placeholder too)
+    if (_x > _srcW) _srcW = _x;
+    int high = 5;
+    while (!(bits & (1 << high))) high--;
+    uint32_t bottom = (uint32_t)_band * 6 + high + 1;
+    if (bottom > _srcH) _srcH = bottom > SIXEL_PARAM_MAX ? SIXEL_PARAM_MAX : bottom;
+
+    if (_img == NULL) return;
+    if (!_img->used) {
+        fail(SIXEL_NO_MEMORY);
+        return;
+    }
+    uint32_t maxX = (uint32_t)_maxCols * SIXEL_HOST_CELL_W;
+    uint32_t maxY = (uint32_t)_maxRows * SIXEL_HOST_CELL_H;
+    if (x0 >= maxX) return;
+    if (x1 > maxX) x1 = maxX;
+
+    uint8_t cellW = _cache->cellW();
+    uint8_t cellH = _cache->cellH();
+    uint32_t tx0 = x0 * cellW / SIXEL_HOST_CELL_W;
+    uint32_t tx1 = (x1 - 1) * cellW / SIXEL_HOST_CELL_W;
+    uint16_t color = _palette[_color];
+    bool isBackground = color == _background;
+    fillTo(cols() * cellW);
+
+    for (int b = 0; b <= high; b++) {
+        if (!(bits & (1 << b))) continue;
+        uint32_t y = (uint32_t)_band * 6 + b;
+        if (y >= maxY) break;
+        uint16_t *row = pixelRow(y * cellH / SIXEL_HOST_CELL_H);
+        if (row == NULL) return;
+        // Background never covers another color, and over itself is a no-op
+        if (!isBackground) {
+            rkFill565(row + tx0, tx1 - tx0 + 1, color);
+            _work += tx1 - tx0 + 1;
+        }
+    }
+
+    _img->cols = cols();
+    _img->rows = rows();
+    _img->srcWidth = _srcW;
+    _img->srcHeight = _srcH;
+    _cache->touch(_img);
+}
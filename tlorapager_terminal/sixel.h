@@ -0,0 +1,164 @@
+/**
+ * Sixel Images for T-LoRa Pager Terminal
+ * Streaming sixel decoder and the tile cache it draws into
+ *
+ * Hosts size sixel images for cells of SIXEL_HOST_CELL_W x _H pixels.
+ * The decoder scales each pixel to our cell size as it arrives, so an
+ * image covers the cells the host expects and no full-size copy is ever
+ * held. Pixels go into tiles from a fixed pool (one tile per cell row of
+ * an image, RGB565, in memory handed to begin()); the oldest image is
+ * evicted when the pool runs out.
+ *
+ * Decoding work is capped per frame (SIXEL_FRAME_WORK, see frame()). An
+ * image over it pauses (paused()) and the model takes the rest of its
+ * data in the next frames, so how an image decodes does not depend on
+ * how its bytes arrive. Only an image the pool cannot hold is dropped,
+ * with a placeholder in its place. Like the VT model this has no
+ * platform dependencies and never allocates.
+ */
+
+#ifndef SIXEL_H
+#define SIXEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SIXEL_HOST_CELL_W 10      // Cell size hosts assume (VT340, xterm)
+#define SIXEL_HOST_CELL_H 20
+#define SIXEL_TILE_COLS 80        // Image width limit, in cells
+#define SIXEL_MAX_ROWS 24         // Image height limit, in cells
+#define SIXEL_MAX_IMAGES 8
+#define SIXEL_MAX_TILES 128       // Pool size limit (tile bitmap)
+#define SIXEL_COLORS 256
+#define SIXEL_FRAME_WORK 100000   // Pixels painted per frame (a few ms at 240MHz)
+#define SIXEL_MAX_PARAMS 5
+
+typedef enum {
+    SIXEL_OK = 0,
+    SIXEL_NO_MEMORY,     // No cache, or the image needs more tiles than it has
+} SixelStatus_t;
+
+typedef struct {
+    bool used;
+    bool alt;                      // Drawn on the alternate screen
+    bool done;                     // Fully decoded
+    int16_t top;                   // Screen row (negative: partly in history)
+    uint16_t left;                 // Column
+    uint8_t cols, rows;            // Cells covered
+    uint16_t srcWidth, srcHeight;  // Host pixels
+    uint32_t serial;               // Changes with the pixels (redraw)
+    uint32_t age;                  // Eviction order
+    int16_t tile[SIXEL_MAX_ROWS];  // Tile per cell row, -1: none
+} SixelImage;
+
+class SixelCache {
+public:
+    SixelCache();
+
+    // Bytes of one tile for a cell size
+    static size_t tileBytes(uint8_t cellW, uint8_t cellH);
+
+    // Tiles are carved from mem (e.g. PSRAM); returns the tile count
+    int begin(void *mem, size_t bytes, uint8_t cellW, uint8_t cellH);
+
+    uint8_t cellW() const { return _cellW; }
+    uint8_t cellH() const { return _cellH; }
+    uint16_t tileWidth() const { return SIXEL_TILE_COLS * _cellW; }  // Pixels (stride)
+    int tileCount() const { return _tileCount; }
+    int tilesFree() const { return _tilesFree; }
+
+    // Pixels of a tile, tileWidth() x cellH()
+    uint16_t* tile(int16_t index) const { return _tiles + (size_t)index * tileWidth() * _cellH; }
+
+    // Image slots, in no particular order (check .used)
+    const SixelImage& image(int i) const { return _images[i]; }
+
+    // Model side
+    SixelImage* newImage(bool alt, int16_t top, uint16_t left);
+    int16_t allocTile(const SixelImage *keep);  // Evicts other images; -1: none
+    void touch(SixelImage *img) { img->serial = ++_serial; }
+    void drop(SixelImage *img);
+    void scroll(bool alt, int top, int bottom, int n, bool fullScreen);
+    void clear(bool alt);
+    void clearAll();
+
+    // Counters for the `sixel` command
+    uint32_t decoded, placeholders, evicted;
+    uint32_t workMax;  // Most decode work (pixels painted, bytes) in one frame
+
+private:
+    uint16_t *_tiles;
+    int _tileCount;
+    int _tilesFree;
+    uint8_t _cellW, _cellH;
+    uint32_t _age;
+    uint32_t _serial;
+    uint32_t _used[SIXEL_MAX_TILES / 32];  // Tiles in use
+    SixelImage _images[SIXEL_MAX_IMAGES];
+};
+
+class SixelDecoder {
+public:
+    SixelDecoder();
+
+    // New image from newImage(), at most maxCols x maxRows cells. img
+    // NULL: only the size is tracked (for the placeholder).
+    void start(SixelCache *cache, SixelImage *img, uint16_t maxCols, uint8_t maxRows);
+
+    // One byte of sixel data. Returns false once the image was dropped
+    // (no memory); bytes are still taken to size the placeholder.
+    bool put(uint8_t c);
+
+    // This frame's work is used up: the caller holds the image's next
+    // bytes until frame()
+    bool paused() const { return _img != NULL && _work >= SIXEL_FRAME_WORK; }
+
+    // End of data (ST). Returns how it went.
+    SixelStatus_t finish();
+
+    // Stop without finishing (RIS, resize): the image is dropped
+    void abort();
+
+    // A new frame: the work cap starts over
+    void frame();
+
+    bool active() const { return _active; }
+    uint8_t rows() const;          // Cell rows the data reached so far
+    uint8_t cols() const;
+    uint16_t srcWidth() const { return _srcW; }
+    uint16_t srcHeight() const { return _srcH; }
+    SixelImage* image() const { return _img; }
+
+private:
+    enum State { SX_DATA, SX_PARAM };
+
+    SixelCache *_cache;
+    SixelImage *_img;
+    bool _active;
+    SixelStatus_t _status;
+    uint16_t _maxCols;
+    uint8_t _maxRows;
+
+    State _state;
+    uint8_t _command;   // ! # " while collecting parameters
+    uint16_t _params[SIXEL_MAX_PARAMS];
+    uint8_t _nparams;
+
+    uint16_t _palette[SIXEL_COLORS];  // RGB565
+    uint16_t _color;                  // Register
+    uint16_t _background;             // Register 0 color at the start (RGB565)
+    uint16_t _repeat;
+    uint16_t _x;                      // Host pixels
+    uint16_t _band;                   // Six-pixel rows
+    uint16_t _srcW, _srcH;            // Extent reached, or the raster size
+    uint16_t _fillW;                  // Tile pixels cleared to the background, per row
+    uint32_t _work;
+
+    void command();
+    void paint(uint8_t bits, uint16_t repeat);
+    void fail(SixelStatus_t status);
+    void fillTo(uint16_t width);
+    uint16_t* pixelRow(uint16_t y);
+};
+
+#endif // SIXEL_H
@@ -0,0 +1,215 @@
+/**
+ * Soak Test Implementation
+ */
+
+#include "soak.h"
+#include "settings.h"
+#include "settings_ui.h"
+#include "terminal_ui.h"
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+
+#define SOAK_MENU_ITEMS 6        // Submenus of the main settings menu
+#define SOAK_UI_PUMP_MS 100
+
+typedef struct {
+    const char *name;
+    bool higherIsBetter;
+    uint32_t tolerance;
+} SoakMetricInfo_t;
+
+static const SoakMetricInfo_t metricInfo[SOAK_METRIC_COUNT] = {
+    {"heap_free", true, 2048},
+    {"heap_largest", true, 4096},
+    {"heap_blocks", false, 16},
+    {"psram_free", true, 8192},
+    {"lv_used", false, 1024},
+    {"lv_largest", true, 2048},
+    {"lv_blocks", false, 8},
+    {"stack_loop", true, 256},
+    {"stack_session", true, 256},
+    {"connect_ms", false, 2000},
+};
+
+typedef struct {
+    uint32_t value;          // This iteration
+    bool recorded;
+    uint32_t windowWorst;    // Window in progress
+    int windowSamples;
+    uint32_t windows[SOAK_MAX_WINDOWS];
+    int windowCount;
+} SoakTrack_t;
+
+static SoakTrack_t tracks[SOAK_METRIC_COUNT];
+static uint32_t iterations = 0;
+static int failedConnects = 0;
+static char failure[96];
+
+static bool worse(SoakMetric_t m, uint32_t a, uint32_t b) {
+    return metricInfo[m].higherIsBetter ? a < b : a > b;
+}
+
+// How much worse than the baseline a value is (negative: better)
+static int64_t worseBy(SoakMetric_t m, uint32_t value, uint32_t base) {
+    int64_t d = (int64_t)value - base;
+    return metricInfo[m].higherIsBetter ? -d : d;
+}
+
+void soakBegin() {
+    memset(tracks, 0, sizeof(tracks));
+    iterations = 0;
+    failedConnects = 0;
+    failure[0] = '\0';
+}
+
+void soakRecord(SoakMetric_t metric, uint32_t value) {
+    tracks[metric].value = value;
+    tracks[metric].recorded = true;
+}
+
+void soakSampleMemory() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_INTERNAL);
+    soakRecord(SOAK_HEAP_FREE, info.total_free_bytes);
+    soakRecord(SOAK_HEAP_LARGEST, info.largest_free_block);
+    soakRecord(SOAK_HEAP_BLOCKS, info.allocated_blocks);
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0) {
+        soakRecord(SOAK_PSRAM_FREE, heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+    }
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    soakRecord(SOAK_LV_USED, mon.total_size - mon.free_size);
+    soakRecord(SOAK_LV_LARGEST, mon.free_biggest_size);
+    soakRecord(SOAK_LV_BLOCKS, mon.used_cnt);
+#endif
+}
+
+void soakConnectFailed() {
+    if (++failedConnects >= SOAK_MAX_FAILED_CONNECTS && failure[0] == '\0') {
+        snprintf(failure, sizeof(failure), "%d connects in a row failed", failedConnects);
+    }
+}
+
+void soakExerciseUi(void (*pump)(uint32_t ms)) {
+    // Each submenu from a fresh main menu: createMenuContainer() and
+    // clearMenu() on every step, as when browsing by hand
+    for (int item = 1; item <= SOAK_MENU_ITEMS; item++) {
+        settingsUIShow();
+        pump(SOAK_UI_PUMP_MS);
+        for (int i = 0; i < item; i++) settingsUIHandleRotary(1);
+        settingsUIHandleRotary(0);
+        pump(SOAK_UI_PUMP_MS);
+        settingsUIHandleKey('q');  // Back to the main menu
+        pump(SOAK_UI_PUMP_MS);
+        settingsUIHide();
+        pump(SOAK_UI_PUMP_MS);
+    }
+
+    // Every theme, without saving to NVS
+    Theme_t saved = settings.theme;
+    for (int t = 0; t < THEME_COUNT; t++) {
+        settings.theme = (Theme_t)t;
+        applyTheme();
+        pump(SOAK_UI_PUMP_MS);
+    }
+    settings.theme = saved;
+    applyTheme();
+    pump(SOAK_UI_PUMP_MS);
+}
+
+// Least-squares line through n windows from the first given, in how
+// much worse than the baseline each is: slope per window, and the
+// line's value at the last of them (end, if not NULL)
+static double trendLine(SoakMetric_t m, const SoakTrack_t &t, int first, int n, double *end) {
+    double sy = 0, sxy = 0;
+    for (int i = 0; i < n; i++) {
+        double y = (double)worseBy(m, t.windows[first + i], t.windows[0]);
+        sy += y;
+        sxy += i * y;
+    }
+    double sx = n * (n - 1) / 2.0;
+    double sxx = (n - 1) * n * (2 * n - 1) / 6.0;
+    double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    if (end) *end = sy / n + slope * (n - 1 - sx / n);
+    return slope;
+}
+
+// Close a window and judge its metric
+static void closeWindow(SoakMetric_t m) {
+    SoakTrack_t &t = tracks[m];
+    if (t.windowCount == SOAK_MAX_WINDOWS) {
+        // Keep the baseline, drop the oldest after it
+        memmove(&t.windows[1], &t.windows[2], (SOAK_MAX_WINDOWS - 2) * sizeof(uint32_t));
+        t.windowCount--;
+    }
+    t.windows[t.windowCount++] = t.windowWorst;
+    t.windowSamples = 0;
+    const int n = SOAK_TREND_WINDOWS;
+    if (t.windowCount <= 2 * n) return;
+
+    // A leak slopes the bad way in both the newest n windows and the n
+    // before them; a one-off step can only be in one of the two
+    double end;
+    double slope = trendLine(m, t, t.windowCount - n, n, &end);
+    double older = trendLine(m, t, t.windowCount - 2 * n, n, NULL);
+    double minSlope = (double)metricInfo[m].tolerance / SOAK_MAX_WINDOWS;
+
+    if (slope >= minSlope && older >= minSlope && end > metricInfo[m].tolerance && failure[0] == '\0') {
+        snprintf(failure, sizeof(failure), "%s worse by %ld per window over %d windows: %u -> %u",
+                 metricInfo[m].name, (long)(slope + 0.5), 2 * n, (unsigned)t.windows[0],
+                 (unsigned)t.windowWorst);
+    }
+}
+
+bool soakEndIteration() {
+    char line[256];
+    int n = snprintf(line, sizeof(line), "Soak: %u", (unsigned)iterations + 1);
+
+    for (int m = 0; m < SOAK_METRIC_COUNT; m++) {
+        SoakTrack_t &t = tracks[m];
+        if (!t.recorded) continue;
+        if (n < (int)sizeof(line)) {
+            n += snprintf(line + n, sizeof(line) - n, " %s=%u", metricInfo[m].name, (unsigned)t.value);
+        }
+        if (m == SOAK_CONNECT_MS) failedConnects = 0;
+
+        if (iterations >= SOAK_WARMUP) {
+            if (t.windowSamples == 0 || worse((SoakMetric_t)m, t.value, t.windowWorst)) {
+                t.windowWorst = t.value;
+            }
+            if (++t.windowSamples == SOAK_WINDOW) closeWindow((SoakMetric_t)m);
+        }
+        t.recorded = false;
+    }
+    Serial.println(line);
+
+    iterations++;
+    if (failure[0]) {
+        Serial.printf("Soak: FAIL after %u iterations: %s\n", (unsigned)iterations, failure);
+        return false;
+    }
+    return true;
+}
+
+uint32_t soakIterations() {
+    return iterations;
+}
+
+const char* soakFailure() {
+    return failure[0] ? failure : NULL;
+}
+
+void soakPrintSummary() {
+    Serial.printf("Soak: %u iterations, %s\n", (unsigned)iterations,
+                  failure[0] ? failure : "no worsening trend");
+    for (int m = 0; m < SOAK_METRIC_COUNT; m++) {
+        const SoakTrack_t &t = tracks[m];
+        if (t.windowCount == 0) continue;
+        uint32_t base = t.windows[0];
+        uint32_t last = t.windows[t.windowCount - 1];
+        Serial.printf("  %-14s %10u -> %-10u (%+ld) over %d windows\n", metricInfo[m].name,
+                      (unsigned)base, (unsigned)last, (long)last - (long)base, t.windowCount);
+    }
+}
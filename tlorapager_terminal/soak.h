@@ -0,0 +1,73 @@
+/**
+ * Soak Test for T-LoRa Pager Terminal
+ * Per-iteration memory and stack samples, and leak / fragmentation
+ * trend detection over hours of connect / receive / UI / disconnect
+ *
+ * The driver (the sketch's `soak` command, or `sim --soak`) runs one
+ * cycle per iteration, records its samples and calls soakEndIteration().
+ * Samples are grouped in windows of SOAK_WINDOW iterations, each reduced
+ * to its worst value. A metric fails when least-squares lines through
+ * its last SOAK_TREND_WINDOWS windows, and through the as many before
+ * them, both slope the bad way at a rate that would use up its tolerance
+ * within SOAK_MAX_WINDOWS windows, and the newest line ends worse than
+ * the first window by more than the tolerance. Slow and noisy leaks
+ * fail; a one-off dip or a cache filling up once, which fall in one of
+ * the two spans and then level off, do not.
+ */
+
+#ifndef SOAK_H
+#define SOAK_H
+
+#include <Arduino.h>
+
+#define SOAK_WARMUP 3            // Iterations not judged (caches filling)
+#define SOAK_WINDOW 10           // Iterations per window
+#define SOAK_TREND_WINDOWS 8     // Windows per fitted trend line (two are fitted)
+#define SOAK_MAX_WINDOWS 64      // Kept per metric (first one is the baseline)
+#define SOAK_MAX_FAILED_CONNECTS 3
+
+typedef enum {
+    SOAK_HEAP_FREE = 0,      // Internal RAM
+    SOAK_HEAP_LARGEST,       // Largest free block (fragmentation)
+    SOAK_HEAP_BLOCKS,        // Live allocations
+    SOAK_PSRAM_FREE,
+    SOAK_LV_USED,            // LVGL heap (built-in allocator only)
+    SOAK_LV_LARGEST,
+    SOAK_LV_BLOCKS,
+    SOAK_STACK_LOOP,         // Stack never used, UI loop task
+    SOAK_STACK_SESSION,      // Stack never used, last session task
+    SOAK_CONNECT_MS,
+    SOAK_METRIC_COUNT
+} SoakMetric_t;
+
+// Start a new run (forgets all samples)
+void soakBegin();
+
+// Record this iteration's value of a metric. Metrics not recorded in an
+// iteration are left out of it.
+void soakRecord(SoakMetric_t metric, uint32_t value);
+
+// Record heap and LVGL memory (call with the UI idle)
+void soakSampleMemory();
+
+// A connect that failed or timed out; SOAK_MAX_FAILED_CONNECTS in a row
+// fail the run
+void soakConnectFailed();
+
+// Open every settings menu and close it again, then cycle through all
+// themes. pump(ms) runs the UI loop for that long.
+void soakExerciseUi(void (*pump)(uint32_t ms));
+
+// Log the iteration and judge the trends. Returns false once the run
+// has failed (see soakFailure()).
+bool soakEndIteration();
+
+uint32_t soakIterations();
+
+// Why the run failed, or NULL
+const char* soakFailure();
+
+// Baseline, latest window and change of every metric
+void soakPrintSummary();
+
+#endif // SOAK_H
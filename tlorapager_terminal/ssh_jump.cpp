@@ -0,0 +1,281 @@
+/**
+ * SSH Jump Host Implementation
+ */
+
+#include "ssh_jump.h"
+#include "net_connect.h"
+#include "libssh_esp32.h"
+#include <libssh/libssh.h>
+#include <lwip/sockets.h>
+
+static ssh_session bastion = NULL;
+static JumpHostConfig_t bastionCfg;
+static bool bastionOk = false;
+static uint32_t bastionHandshakes = 0;
+
+// Tunnel: bastion channel <-> relay task <-> loopback socket pair
+static ssh_channel tunnel = NULL;
+static int relayFd = -1;
+// Set when a relay task is created, cleared only once its relayDone
+// token has been taken, so each relay's token is taken exactly once
+static bool relayRunning = false;
+static volatile bool relayStop = false;
+static SemaphoreHandle_t relayDone = NULL;  // Given by the relay task as it exits
+static char relayBuf[JUMP_RELAY_BUF];
+static char tunnelTarget[MAX_HOST_LEN + 8];
+static uint32_t tunnelsOpened = 0;
+static uint32_t relayBytesDown = 0;
+static uint32_t relayBytesUp = 0;
+
+static void bastionRelease() {
+    if (bastion) {
+        ssh_disconnect(bastion);
+        ssh_free(bastion);
+        bastion = NULL;
+    }
+    bastionOk = false;
+}
+
+// Stop the relay and wait until it no longer uses the bastion session
+// (libssh sessions are not thread-safe). False if it is stuck inside
+// libssh: the bastion is then marked unusable and must not be touched.
+static bool relayStopAndWait() {
+    if (!relayRunning) return true;
+    relayStop = true;
+    if (xSemaphoreTake(relayDone, pdMS_TO_TICKS(JUMP_RELAY_STOP_MS)) == pdTRUE) {
+        relayRunning = false;
+        return true;
+    }
+    Serial.println("Jump: Relay did not stop, bastion session unusable");
+    bastionOk = false;
+    return false;
+}
+
+// A connected TCP pair over lwIP loopback (no socketpair() in lwIP)
+static bool loopbackPair(int *inner, int *outer) {
+    int lfd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (lfd < 0) return false;
+
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int c = -1, s = -1;
+    if (lwip_bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+        lwip_listen(lfd, 1) == 0 &&
+        lwip_getsockname(lfd, (struct sockaddr *)&addr, &len) == 0) {
+        c = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (c >= 0 && lwip_connect(c, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            s = lwip_accept(lfd, NULL, NULL);
+        }
+    }
+    lwip_close(lfd);
+    if (s < 0) {
+        if (c >= 0) lwip_close(c);
+        return false;
+    }
+
+    int one = 1;
+    lwip_setsockopt(c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    lwip_setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    *inner = c;
+    *outer = s;
+    return true;
+}
+
+static bool relaySend(const char *data, int len) {
+    while (len > 0) {
+        int n = lwip_send(relayFd, data, len, 0);
+        if (n > 0) {
+            data += n;
+            len -= n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && !relayStop) {
+            vTaskDelay(1);  // Inner session not reading: hold the channel window shut
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sole user of the bastion session while a tunnel is open
+static void relayTask(void *param) {
+    lwip_fcntl(relayFd, F_SETFL, lwip_fcntl(relayFd, F_GETFL, 0) | O_NONBLOCK);
+
+    while (!relayStop) {
+        bool moved = false;
+
+        // Target -> inner session
+        int n = ssh_channel_read_nonblocking(tunnel, relayBuf, sizeof(relayBuf), 0);
+        if (n > 0) {
+            if (!relaySend(relayBuf, n)) break;
+            relayBytesDown += n;
+            moved = true;
+        } else if (n == SSH_ERROR) {
+            Serial.printf("Jump: Bastion error: %s\n", ssh_get_error(bastion));
+            bastionOk = false;
+            break;
+        } else if (ssh_channel_is_eof(tunnel) || !ssh_channel_is_open(tunnel)) {
+            break;
+        }
+
+        // Inner session -> target
+        n = lwip_recv(relayFd, relayBuf, sizeof(relayBuf), 0);
+        if (n > 0) {
+            if (ssh_channel_write(tunnel, relayBuf, n) != n) {
+                bastionOk = false;
+                break;
+            }
+            relayBytesUp += n;
+            moved = true;
+        } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            break;  // Inner session closed its socket
+        }
+
+        if (!moved) {
+            // Idle: wake early for keystrokes, poll the channel every 2ms
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(relayFd, &rfds);
+            struct timeval tv = {0, 2000};
+            lwip_select(relayFd + 1, &rfds, NULL, NULL, &tv);
+        }
+    }
+
+    lwip_close(relayFd);
+    relayFd = -1;
+    if (ssh_channel_is_open(tunnel)) {
+        ssh_channel_send_eof(tunnel);
+        ssh_channel_close(tunnel);
+    }
+    ssh_channel_free(tunnel);
+    tunnel = NULL;
+    Serial.printf("Jump: Tunnel to %s closed\n", tunnelTarget);
+    xSemaphoreGive(relayDone);
+    vTaskDelete(NULL);
+}
+
+bool jumpConnect(const JumpHostConfig_t *jump, uint32_t timeoutMs, bool *reused) {
+    uint16_t port = jump->port ? jump->port : 22;
+    *reused = false;
+    if (!relayStopAndWait()) return false;
+
+    if (bastion && bastionOk && ssh_is_connected(bastion) &&
+        strcmp(bastionCfg.host, jump->host) == 0 && bastionCfg.port == port &&
+        strcmp(bastionCfg.username, jump->username) == 0) {
+        *reused = true;
+        return true;
+    }
+    bastionRelease();
+
+    libssh_begin();
+    bastion = ssh_new();
+    if (bastion == NULL) {
+        Serial.println("Jump: Failed to create session");
+        return false;
+    }
+
+    long timeout = timeoutMs / 1000;
+    unsigned int portOpt = port;
+    ssh_options_set(bastion, SSH_OPTIONS_HOST, jump->host);
+    ssh_options_set(bastion, SSH_OPTIONS_PORT, &portOpt);
+    ssh_options_set(bastion, SSH_OPTIONS_USER, jump->username);
+    ssh_options_set(bastion, SSH_OPTIONS_TIMEOUT, &timeout);
+    ssh_options_set(bastion, SSH_OPTIONS_STRICTHOSTKEYCHECK, 0);
+
+    Serial.printf("Jump: Connecting to bastion %s@%s:%d\n", jump->username, jump->host, port);
+
+    int fd = netConnect(jump->host, port, timeoutMs);
+    if (fd < 0) {
+        Serial.println("Jump: Bastion connection failed: TCP connect");
+        bastionRelease();
+        return false;
+    }
+    socket_t sock = fd;
+    ssh_options_set(bastion, SSH_OPTIONS_FD, &sock);
+
+    if (ssh_connect(bastion) != SSH_OK) {
+        Serial.printf("Jump: Bastion connection failed: %s\n", ssh_get_error(bastion));
+        bastionRelease();
+        return false;
+    }
+    if (ssh_userauth_password(bastion, NULL, jump->password) != SSH_AUTH_SUCCESS) {
+        Serial.printf("Jump: Bastion auth failed: %s\n", ssh_get_error(bastion));
+        bastionRelease();
+        return false;
+    }
+
+    bastionCfg = *jump;
+    bastionCfg.port = port;
+    bastionOk = true;
+    bastionHandshakes++;
+    Serial.println("Jump: Bastion ready");
+    return true;
+}
+
+int jumpOpenTunnel(const char *host, uint16_t port) {
+    if (!bastionOk || !relayStopAndWait()) return -1;
+    if (relayDone == NULL) relayDone = xSemaphoreCreateBinary();
+    if (relayDone == NULL) return -1;
+
+    ssh_channel ch = ssh_channel_new(bastion);
+    if (ch == NULL) return -1;
+    if (ssh_channel_open_forward(ch, host, port, "127.0.0.1", 22) != SSH_OK) {
+        Serial.printf("Jump: Tunnel to %s:%u failed: %s\n", host, port, ssh_get_error(bastion));
+        ssh_channel_free(ch);
+        if (!ssh_is_connected(bastion)) bastionOk = false;
+        return -1;
+    }
+
+    int inner, outer;
+    if (!loopbackPair(&inner, &outer)) {
+        Serial.println("Jump: Loopback socket pair failed");
+        ssh_channel_close(ch);
+        ssh_channel_free(ch);
+        return -1;
+    }
+
+    tunnel = ch;
+    relayFd = outer;
+    relayBytesDown = relayBytesUp = 0;
+    relayStop = false;
+    relayRunning = true;
+    snprintf(tunnelTarget, sizeof(tunnelTarget), "%s:%u", host, port);
+    if (xTaskCreatePinnedToCore(relayTask, "jump_relay", JUMP_RELAY_STACK, NULL, 5, NULL, 1) != pdPASS) {
+        relayRunning = false;
+        lwip_close(inner);
+        lwip_close(outer);
+        relayFd = -1;
+        ssh_channel_close(ch);
+        ssh_channel_free(ch);
+        tunnel = NULL;
+        return -1;
+    }
+    tunnelsOpened++;
+    return inner;
+}
+
+void jumpDisconnect() {
+    if (!relayStopAndWait()) return;
+    if (bastion) {
+        Serial.printf("Jump: Closing bastion %s\n", bastionCfg.host);
+    }
+    bastionRelease();
+}
+
+void jumpPrintStatus() {
+    if (bastion && bastionOk) {
+        Serial.printf("Jump: bastion %s@%s:%u up (%u handshakes, %u tunnels)\n",
+                      bastionCfg.username, bastionCfg.host, bastionCfg.port,
+                      (unsigned)bastionHandshakes, (unsigned)tunnelsOpened);
+    } else {
+        Serial.printf("Jump: no bastion session (%u handshakes, %u tunnels)\n",
+                      (unsigned)bastionHandshakes, (unsigned)tunnelsOpened);
+    }
+    if (relayRunning && tunnel != NULL) {
+        Serial.printf("  tunnel to %s: %u bytes down, %u up\n",
+                      tunnelTarget, (unsigned)relayBytesDown, (unsigned)relayBytesUp);
+    }
+}
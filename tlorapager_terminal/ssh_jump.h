@@ -0,0 +1,39 @@
+/**
+ * SSH Jump Host for T-LoRa Pager Terminal
+ * One persistent bastion session, tunnels to targets through it
+ *
+ * Like ProxyJump: the target's SSH session runs over a direct-tcpip
+ * channel of an authenticated bastion session. The bastion session is
+ * kept between connects, so reaching another target (or reconnecting)
+ * costs one handshake instead of two. libssh 0.10 has no ProxyJump, so
+ * the channel is relayed to a loopback socket the inner session uses.
+ */
+
+#ifndef SSH_JUMP_H
+#define SSH_JUMP_H
+
+#include <Arduino.h>
+#include "settings.h"
+
+#define JUMP_RELAY_BUF 2048
+#define JUMP_RELAY_STACK 12288
+#define JUMP_RELAY_STOP_MS 1000   // Wait for the relay to let go of the bastion
+
+// Make sure an authenticated session to the bastion is up, reusing the
+// current one if it is for the same host and user. Sets *reused. Fails
+// while a stuck relay task still holds the old bastion session.
+bool jumpConnect(const JumpHostConfig_t *jump, uint32_t timeoutMs, bool *reused);
+
+// Open a direct-tcpip channel to host:port through the bastion and
+// return a connected socket for the inner session, or -1. The tunnel
+// closes when the inner session closes its socket.
+int jumpOpenTunnel(const char *host, uint16_t port);
+
+// Close the tunnel (if any) and the bastion session. A relay that does
+// not stop keeps the session; it is freed once the relay has exited.
+void jumpDisconnect();
+
+// Print bastion and tunnel state to Serial
+void jumpPrintStatus();
+
+#endif // SSH_JUMP_H
@@ -0,0 +1,346 @@
+/**
+ * SSH Session Transport Implementation
+ */
+
+#include "ssh_transport.h"
+#include "settings.h"
+#include "kex_precompute.h"
+#include "net_connect.h"
+#include "ssh_jump.h"
+#include "libssh_esp32.h"
+#include <libssh/libssh.h>
+#include <esp_timer.h>
+
+static ssh_session sshSession = NULL;
+static ssh_channel sshChannel = NULL;
+
+const char *const sshPhaseNames[SSH_PHASE_COUNT] = {
+    "jump", "dns", "tcp", "kex", "auth", "channel", "pty", "shell"
+};
+static SshConnectTiming_t timing;
+static SshConnectTiming_t pending;
+static int64_t phaseStartUs = 0;
+
+static void phaseStart() {
+    phaseStartUs = esp_timer_get_time();
+}
+
+static void phaseEnd(SshPhase_t phase) {
+    int64_t now = esp_timer_get_time();
+    pending.us[phase] = now - phaseStartUs;
+    phaseStartUs = now;
+}
+
+const SshConnectTiming_t *sshConnectTiming() {
+    return &timing;
+}
+
+static void sshRelease() {
+    if (sshChannel) {
+        ssh_channel_close(sshChannel);
+        ssh_channel_free(sshChannel);
+        sshChannel = NULL;
+    }
+    if (sshSession) {
+        ssh_disconnect(sshSession);
+        ssh_free(sshSession);
+        sshSession = NULL;
+    }
+}
+
+// Socket to the server through its jump host. A reused bastion session
+// may have been dropped by the bastion while idle: retry once on a fresh one.
+static int sshJumpSocket(ServerConfig_t *server, uint32_t timeoutMs) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = false;
+        if (!jumpConnect(&server->jump, timeoutMs, &reused)) break;
+        phaseEnd(SSH_PHASE_JUMP);
+        pending.jumpReused = reused;
+
+        int fd = jumpOpenTunnel(server->host, server->port);
+        if (fd >= 0 || !reused) return fd;
+        jumpDisconnect();
+        phaseStart();
+    }
+    return -1;
+}
+
+// Connect and authenticate (phases jump..auth); NULL on failure
+static ssh_session sshLogin(ServerConfig_t *server) {
+    int rc;
+
+    // Initialize libssh
+    libssh_begin();
+
+    // Create SSH session
+    ssh_session session = ssh_new();
+    if (session == NULL) {
+        Serial.println("SSH: Failed to create session");
+        return NULL;
+    }
+
+    // Set SSH options
+    ssh_options_set(session, SSH_OPTIONS_HOST, server->host);
+    ssh_options_set(session, SSH_OPTIONS_PORT, &server->port);
+    ssh_options_set(session, SSH_OPTIONS_USER, server->username);
+
+    // Set timeout (10 seconds)
+    long timeout = 10;
+    ssh_options_set(session, SSH_OPTIONS_TIMEOUT, &timeout);
+
+    // Disable strict host key checking for embedded device
+    ssh_options_set(session, SSH_OPTIONS_STRICTHOSTKEYCHECK, 0);
+
+    Serial.printf("SSH: Connecting to %s@%s:%d\n", server->username, server->host, server->port);
+    memset(&pending, 0, sizeof(pending));
+
+    // TCP connect here rather than in ssh_connect() so it is timed on
+    // its own; libssh takes over the socket and closes it
+    phaseStart();
+    int fd;
+    if (strlen(server->jump.host) > 0) {
+        fd = sshJumpSocket(server, timeout * 1000);
+    } else {
+        phaseEnd(SSH_PHASE_JUMP);
+        fd = netConnect(server->host, server->port, timeout * 1000,
+                        &pending.dnsAnswer, &pending.us[SSH_PHASE_DNS]);
+    }
+    if (fd < 0) {
+        Serial.println("SSH: Connection failed: TCP connect");
+        ssh_free(session);
+        return NULL;
+    }
+    socket_t sock = fd;
+    ssh_options_set(session, SSH_OPTIONS_FD, &sock);
+    phaseEnd(SSH_PHASE_TCP);
+    pending.us[SSH_PHASE_TCP] -= pending.us[SSH_PHASE_DNS];
+
+    // Banner and key exchange
+    uint32_t kexUsed = kexPrecomputeUsed();
+    rc = ssh_connect(session);
+    if (rc != SSH_OK) {
+        Serial.printf("SSH: Connection failed: %s\n", ssh_get_error(session));
+        ssh_free(session);
+        return NULL;
+    }
+
+    phaseEnd(SSH_PHASE_KEX);
+    pending.kexPrecomputed = kexPrecomputeUsed() != kexUsed;
+
+    Serial.println("SSH: Connected, authenticating...");
+
+    // Authenticate with password
+    rc = ssh_userauth_password(session, NULL, server->password);
+    if (rc != SSH_AUTH_SUCCESS) {
+        Serial.printf("SSH: Auth failed: %s\n", ssh_get_error(session));
+        ssh_disconnect(session);
+        ssh_free(session);
+        return NULL;
+    }
+
+    phaseEnd(SSH_PHASE_AUTH);
+    return session;
+}
+
+static bool sshOpen(void *target, uint16_t cols, uint16_t rows) {
+    ServerConfig_t *server = (ServerConfig_t *)target;
+    int rc;
+
+    sshSession = sshLogin(server);
+    if (sshSession == NULL) return false;
+
+    Serial.println("SSH: Authenticated, opening channel...");
+
+    // Create channel
+    sshChannel = ssh_channel_new(sshSession);
+    if (sshChannel == NULL) {
+        Serial.println("SSH: Failed to create channel");
+        sshRelease();
+        return false;
+    }
+
+    // Open session on channel
+    rc = ssh_channel_open_session(sshChannel);
+    if (rc != SSH_OK) {
+        Serial.printf("SSH: Failed to open session: %s\n", ssh_get_error(sshSession));
+        sshRelease();
+        return false;
+    }
+
+    phaseEnd(SSH_PHASE_CHANNEL);
+
+    // Request PTY (same size as the terminal model)
+    rc = ssh_channel_request_pty_size(sshChannel, "xterm", cols, rows);
+    if (rc != SSH_OK) {
+        Serial.printf("SSH: Failed to request PTY: %s\n", ssh_get_error(sshSession));
+        sshRelease();
+        return false;
+    }
+
+    phaseEnd(SSH_PHASE_PTY);
+
+    // Request shell
+    rc = ssh_channel_request_shell(sshChannel);
+    if (rc != SSH_OK) {
+        Serial.printf("SSH: Failed to request shell: %s\n", ssh_get_error(sshSession));
+        sshRelease();
+        return false;
+    }
+
+    phaseEnd(SSH_PHASE_SHELL);
+    timing = pending;
+
+    Serial.print("SSH: Shell ready (");
+    for (int i = 0; i < SSH_PHASE_COUNT; i++) {
+        Serial.printf("%s%s %.1fms", i ? ", " : "", sshPhaseNames[i], timing.us[i] / 1000.0f);
+    }
+    Serial.printf("%s%s%s)\n", timing.kexPrecomputed ? ", precomputed kex key" : "",
+                  timing.jumpReused ? ", bastion reused" : "",
+                  timing.dnsAnswer == DNS_ANSWER_CACHED ? ", cached address" :
+                  timing.dnsAnswer == DNS_ANSWER_STALE ? ", saved address" : "");
+    return true;
+}
+
+static bool execRun(ServerConfig_t *server, const char *command, SshExecSource_t source,
+                    void *ctx, const char *until, char *out, size_t cap, uint32_t timeoutMs) {
+    ssh_session session = sshLogin(server);
+    if (session == NULL) return false;
+
+    ssh_channel channel = ssh_channel_new(session);
+    bool ok = channel != NULL &&
+              ssh_channel_open_session(channel) == SSH_OK &&
+              ssh_channel_request_exec(channel, command) == SSH_OK;
+    if (!ok) {
+        Serial.printf("SSH: exec failed: %s\n", ssh_get_error(session));
+    }
+
+    // stdin from the source; the write blocks while the window is shut
+    while (ok && source) {
+        const char *data;
+        int n = source(ctx, &data);
+        if (n == 0) {
+            ok = ssh_channel_send_eof(channel) == SSH_OK;
+            break;
+        }
+        if (n < 0 || ssh_channel_write(channel, data, n) != n) {
+            Serial.printf("SSH: exec input failed: %s\n", n < 0 ? "source" : ssh_get_error(session));
+            ok = false;
+        }
+    }
+
+    // stdout until EOF, or until a whole line containing `until`
+    size_t len = 0;
+    unsigned long start = millis();
+    while (ok && len + 1 < cap && millis() - start < timeoutMs) {
+        int n = ssh_channel_read_timeout(channel, out + len, cap - 1 - len, 0, 100);
+        if (n > 0) {
+            len += n;
+            out[len] = '\0';
+            const char *hit = until ? strstr(out, until) : NULL;
+            if (hit && strchr(hit, '\n')) break;
+        } else if (n < 0 || ssh_channel_is_eof(channel)) {
+            break;
+        }
+    }
+    if (cap > 0) out[len < cap ? len : cap - 1] = '\0';
+
+    if (channel) {
+        ssh_channel_close(channel);
+        ssh_channel_free(channel);
+    }
+    ssh_disconnect(session);
+    ssh_free(session);
+    return ok;
+}
+
+bool sshExec(ServerConfig_t *server, const char *command, const char *until,
+             char *out, size_t cap, uint32_t timeoutMs) {
+    return execRun(server, command, NULL, NULL, until, out, cap, timeoutMs);
+}
+
+bool sshExecSend(ServerConfig_t *server, const char *command, SshExecSource_t source,
+                 void *ctx, char *out, size_t cap, uint32_t timeoutMs) {
+    return execRun(server, command, source, ctx, NULL, out, cap, timeoutMs);
+}
+
+SshExecChannel_t sshExecStart(const char *command) {
+    if (sshSession == NULL || sshChannel == NULL) return NULL;
+    ssh_channel channel = ssh_channel_new(sshSession);
+    if (channel == NULL) return NULL;
+    if (ssh_channel_open_session(channel) != SSH_OK ||
+        ssh_channel_request_exec(channel, command) != SSH_OK) {
+        Serial.printf("SSH: exec channel failed: %s\n", ssh_get_error(sshSession));
+        ssh_channel_free(channel);
+        return NULL;
+    }
+    return channel;
+}
+
+// Never more than the window: a full one would block the shell too
+int sshExecWrite(SshExecChannel_t channel, const char *data, int len) {
+    uint32_t window = ssh_channel_window_size(channel);
+    if ((uint32_t)len > window) len = window;
+    if (len == 0) return 0;
+    int rc = ssh_channel_write(channel, data, len);
+    return rc < 0 ? -1 : rc;
+}
+
+bool sshExecEof(SshExecChannel_t channel) {
+    return ssh_channel_send_eof(channel) == SSH_OK;
+}
+
+int sshExecRead(SshExecChannel_t channel, char *buf, int room) {
+    int n = ssh_channel_read_nonblocking(channel, buf, room, 0);
+    if (n == 0 && ssh_channel_is_eof(channel)) return -1;
+    return n;
+}
+
+void sshExecClose(SshExecChannel_t channel) {
+    ssh_channel_close(channel);
+    ssh_channel_free(channel);
+}
+
+static int sshRead(char *buf, int room) {
+    int nbytes = ssh_channel_read_nonblocking(sshChannel, buf, room, 0);
+    if (nbytes < 0) {
+        Serial.println("SSH: Read error");
+    }
+    return nbytes;
+}
+
+static int sshWrite(const char *data, int len) {
+    int rc = ssh_channel_write(sshChannel, data, len);
+    if (rc < 0) {
+        Serial.println("SSH: Write error");
+    }
+    return rc;
+}
+
+static bool sshIsOpen() {
+    return sshChannel && ssh_channel_is_open(sshChannel) && !ssh_channel_is_eof(sshChannel);
+}
+
+static void sshClose() {
+    if (sshChannel) {
+        ssh_channel_send_eof(sshChannel);
+    }
+    sshRelease();
+}
+
+static void sshResize(uint16_t cols, uint16_t rows) {
+    if (sshChannel && ssh_channel_change_pty_size(sshChannel, cols, rows) != SSH_OK) {
+        Serial.println("SSH: window-change failed");
+    }
+}
+
+// Flow control needs no hint: not reading keeps the channel window shut
+const SessionTransport_t sshTransport = {
+    "SSH",
+    sshOpen,
+    sshRead,
+    sshWrite,
+    sshIsOpen,
+    NULL,
+    sshResize,
+    sshClose
+};
@@ -0,0 +1,77 @@
+/**
+ * SSH Session Transport for T-LoRa Pager Terminal
+ * libssh shell session (open() target: ServerConfig_t *), directly
+ * or through the server's jump host (see ssh_jump.h)
+ */
+
+#ifndef SSH_TRANSPORT_H
+#define SSH_TRANSPORT_H
+
+#include "session.h"
+#include "settings.h"
+#include "dns_cache.h"
+
+extern const SessionTransport_t sshTransport;
+
+// Connect phases, in order
+typedef enum {
+    SSH_PHASE_JUMP,     // Bastion session (ProxyJump only; ~0 when reused)
+    SSH_PHASE_DNS,      // Host name lookup (~0 when cached; the bastion resolves for ProxyJump)
+    SSH_PHASE_TCP,      // TCP connect, or direct-tcpip channel via the bastion
+    SSH_PHASE_KEX,      // Banner, key exchange, host key, NEWKEYS
+    SSH_PHASE_AUTH,
+    SSH_PHASE_CHANNEL,
+    SSH_PHASE_PTY,
+    SSH_PHASE_SHELL,
+    SSH_PHASE_COUNT
+} SshPhase_t;
+
+typedef struct {
+    uint32_t us[SSH_PHASE_COUNT];
+    bool kexPrecomputed;  // Kex used a keypair made ahead of time
+    bool jumpReused;      // Went through the already open bastion session
+    DnsAnswer_t dnsAnswer;
+} SshConnectTiming_t;
+
+extern const char *const sshPhaseNames[SSH_PHASE_COUNT];
+
+// Phase times of the last successful open
+const SshConnectTiming_t *sshConnectTiming();
+
+// Run command on the server in its own connection and collect stdout
+// into out (NUL-terminated), stopping early after a full line that
+// contains `until` (may be NULL). Used to bootstrap mosh.
+bool sshExec(ServerConfig_t *server, const char *command, const char *until,
+             char *out, size_t cap, uint32_t timeoutMs);
+
+// Next piece of stdin for sshExecSend(): its length with *data set, 0 at
+// the end, negative to abort
+typedef int (*SshExecSource_t)(void *ctx, const char **data);
+
+// sshExec() that first streams source into the command's stdin, then
+// sends EOF. Uploads crash dumps from mosh sessions (no SSH session).
+bool sshExecSend(ServerConfig_t *server, const char *command, SshExecSource_t source,
+                 void *ctx, char *out, size_t cap, uint32_t timeoutMs);
+
+// Command in a second channel of the open shell session, which keeps
+// running meanwhile. Session task only, like the shell channel. Only
+// the start waits for the server (the channel open round trip); NULL
+// if there is no session or the command did not start.
+struct ssh_channel_struct;
+typedef struct ssh_channel_struct *SshExecChannel_t;
+SshExecChannel_t sshExecStart(const char *command);
+
+// Stdin, as much as the channel window takes now (0: window shut);
+// negative on error
+int sshExecWrite(SshExecChannel_t channel, const char *data, int len);
+
+// End of stdin
+bool sshExecEof(SshExecChannel_t channel);
+
+// Stdout received so far (0: none yet); negative once it has ended
+int sshExecRead(SshExecChannel_t channel, char *buf, int room);
+
+// Before the session closes
+void sshExecClose(SshExecChannel_t channel);
+
+#endif // SSH_TRANSPORT_H
@@ -0,0 +1,320 @@
+/**
+ * Telnet Session Transport Implementation
+ */
+
+#include "telnet_transport.h"
+#include "settings.h"
+#include "net_connect.h"
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+
+// Output parser states
+enum {
+    TN_DATA,
+    TN_CR,       // After CR: a NUL here is dropped (NVT "CR NUL")
+    TN_IAC,
+    TN_OPTION,   // After WILL/WONT/DO/DONT
+    TN_SB,
+    TN_SB_IAC
+};
+
+static int sock = -1;
+static bool rawMode = false;
+static bool closed = false;
+static char target[MAX_HOST_LEN + 8];
+static uint16_t termCols = 0;
+static uint16_t termRows = 0;
+static float connectMs = 0;
+
+static uint8_t state = TN_DATA;
+static uint8_t optionVerb = 0;
+static uint8_t sbBuf[TELNET_SB_MAX];
+static uint8_t sbLen = 0;
+
+// Options in effect: performed by us (WILL) and by the server (DO)
+static uint8_t localOn[32];
+static uint8_t remoteOn[32];
+
+static uint32_t bytesIn = 0;
+static uint32_t bytesOut = 0;
+static uint32_t commandsIn = 0;
+
+static bool optGet(const uint8_t *set, uint8_t opt) {
+    return set[opt >> 3] & (1 << (opt & 7));
+}
+
+static void optSet(uint8_t *set, uint8_t opt, bool on) {
+    if (on) {
+        set[opt >> 3] |= 1 << (opt & 7);
+    } else {
+        set[opt >> 3] &= ~(1 << (opt & 7));
+    }
+}
+
+static bool sendAll(const uint8_t *data, int len) {
+    unsigned long start = millis();
+    while (len > 0) {
+        int n = lwip_send(sock, data, len, 0);
+        if (n > 0) {
+            data += n;
+            len -= n;
+            bytesOut += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && millis() - start < 2000) {
+            vTaskDelay(1);
+        } else {
+            closed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sendCommand(uint8_t verb, uint8_t opt) {
+    uint8_t cmd[3] = {TELNET_IAC, verb, opt};
+    sendAll(cmd, sizeof(cmd));
+}
+
+// IAC SB opt <payload, IAC doubled> IAC SE
+static void sendSubnegotiation(uint8_t opt, const uint8_t *payload, int len) {
+    uint8_t out[6 + 2 * TELNET_SB_MAX];
+    int n = 0;
+    out[n++] = TELNET_IAC;
+    out[n++] = TELNET_SB;
+    out[n++] = opt;
+    for (int i = 0; i < len && n < (int)sizeof(out) - 3; i++) {
+        if (payload[i] == TELNET_IAC) out[n++] = TELNET_IAC;
+        out[n++] = payload[i];
+    }
+    out[n++] = TELNET_IAC;
+    out[n++] = TELNET_SE;
+    sendAll(out, n);
+}
+
+static void sendWindowSize() {
+    uint8_t naws[4] = {
+        (uint8_t)(termCols >> 8), (uint8_t)termCols,
+        (uint8_t)(termRows >> 8), (uint8_t)termRows
+    };
+    sendSubnegotiation(TELOPT_NAWS, naws, sizeof(naws));
+}
+
+// Answer only on a change of state, so the two sides cannot loop
+static void handleOption(uint8_t verb, uint8_t opt) {
+    bool weWill = opt == TELOPT_NAWS || opt == TELOPT_TTYPE || opt == TELOPT_SGA;
+    bool theyMay = opt == TELOPT_ECHO || opt == TELOPT_SGA;
+
+    switch (verb) {
+        case TELNET_DO:
+            if (!weWill) {
+                sendCommand(TELNET_WONT, opt);
+                break;
+            }
+            if (!optGet(localOn, opt)) {
+                optSet(localOn, opt, true);
+                sendCommand(TELNET_WILL, opt);
+            }
+            if (opt == TELOPT_NAWS) sendWindowSize();
+            break;
+        case TELNET_DONT:
+            if (optGet(localOn, opt)) {
+                optSet(localOn, opt, false);
+                sendCommand(TELNET_WONT, opt);
+            }
+            break;
+        case TELNET_WILL:
+            if (!theyMay) {
+                sendCommand(TELNET_DONT, opt);
+            } else if (!optGet(remoteOn, opt)) {
+                optSet(remoteOn, opt, true);
+                sendCommand(TELNET_DO, opt);
+            }
+            break;
+        case TELNET_WONT:
+            if (optGet(remoteOn, opt)) {
+                optSet(remoteOn, opt, false);
+                sendCommand(TELNET_DONT, opt);
+            }
+            break;
+    }
+}
+
+static void handleSubnegotiation() {
+    // TTYPE SEND -> TTYPE IS <name>
+    if (sbLen >= 2 && sbBuf[0] == TELOPT_TTYPE && sbBuf[1] == 1) {
+        uint8_t reply[1 + sizeof(TELNET_TERM_TYPE)];
+        reply[0] = 0;
+        memcpy(reply + 1, TELNET_TERM_TYPE, sizeof(TELNET_TERM_TYPE) - 1);
+        sendSubnegotiation(TELOPT_TTYPE, reply, sizeof(TELNET_TERM_TYPE));
+    }
+}
+
+static bool telnetOpen(void *t, uint16_t cols, uint16_t rows) {
+    TelnetConfig_t *cfg = (TelnetConfig_t *)t;
+    uint16_t port = cfg->port ? cfg->port : 23;
+
+    rawMode = cfg->raw;
+    closed = false;
+    termCols = cols;
+    termRows = rows;
+    state = TN_DATA;
+    memset(localOn, 0, sizeof(localOn));
+    memset(remoteOn, 0, sizeof(remoteOn));
+    bytesIn = bytesOut = commandsIn = 0;
+    snprintf(target, sizeof(target), "%s:%u", cfg->host, port);
+
+    Serial.printf("Telnet: Connecting to %s%s\n", target, rawMode ? " (raw TCP)" : "");
+    int64_t t0 = esp_timer_get_time();
+    sock = netConnect(cfg->host, port, TELNET_CONNECT_TIMEOUT_MS);
+    if (sock < 0) {
+        Serial.println("Telnet: Connection failed");
+        return false;
+    }
+    lwip_fcntl(sock, F_SETFL, lwip_fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    connectMs = (esp_timer_get_time() - t0) / 1000.0f;
+    Serial.printf("Telnet: TCP connected in %.1fms\n", connectMs);
+    return true;
+}
+
+// Commands are removed in place; the output never grows
+static int telnetRead(char *buf, int room) {
+    if (sock < 0 || closed) return -1;
+
+    int n = lwip_recv(sock, buf, room, MSG_DONTWAIT);
+    if (n == 0) {
+        closed = true;
+        return -1;
+    }
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        closed = true;
+        return -1;
+    }
+    bytesIn += n;
+    if (rawMode) return n;
+
+    int out = 0;
+    for (int i = 0; i < n; i++) {
+        uint8_t c = buf[i];
+        switch (state) {
+            case TN_CR:
+                state = TN_DATA;
+                if (c == 0) break;
+                // fall through
+            case TN_DATA:
+                if (c == TELNET_IAC) {
+                    state = TN_IAC;
+                } else {
+                    buf[out++] = c;
+                    if (c == '\r') state = TN_CR;
+                }
+                break;
+            case TN_IAC:
+                if (c == TELNET_IAC) {
+                    buf[out++] = c;  // Escaped 0xFF
+                    state = TN_DATA;
+                } else if (c >= TELNET_WILL && c <= TELNET_DONT) {
+                    optionVerb = c;
+                    state = TN_OPTION;
+                } else if (c == TELNET_SB) {
+                    sbLen = 0;
+                    state = TN_SB;
+                } else {
+                    state = TN_DATA;  // NOP, GA, AYT...: nothing to do
+                }
+                commandsIn++;
+                break;
+            case TN_OPTION:
+                handleOption(optionVerb, c);
+                state = TN_DATA;
+                break;
+            case TN_SB:
+                if (c == TELNET_IAC) {
+                    state = TN_SB_IAC;
+                } else if (sbLen < TELNET_SB_MAX) {
+                    sbBuf[sbLen++] = c;
+                }
+                break;
+            case TN_SB_IAC:
+                if (c == TELNET_SE) {
+                    handleSubnegotiation();
+                    state = TN_DATA;
+                } else {
+                    if (c == TELNET_IAC && sbLen < TELNET_SB_MAX) sbBuf[sbLen++] = c;
+                    state = TN_SB;
+                }
+                break;
+        }
+    }
+    return out;
+}
+
+// Enter arrives as LF: CR LF for telnet (NVT), a bare CR for raw consoles
+static int telnetWrite(const char *data, int len) {
+    if (sock < 0 || closed) return -1;
+
+    uint8_t out[512];
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        uint8_t c = data[i];
+        if (c == '\n') {
+            out[n++] = '\r';
+            if (!rawMode) out[n++] = '\n';
+        } else {
+            if (c == TELNET_IAC && !rawMode) out[n++] = TELNET_IAC;
+            out[n++] = c;
+        }
+        if (n > (int)sizeof(out) - 2 || i == len - 1) {
+            if (!sendAll(out, n)) return -1;
+            n = 0;
+        }
+    }
+    return len;
+}
+
+static bool telnetIsOpen() {
+    return sock >= 0 && !closed;
+}
+
+// Sent only once the server asked for NAWS
+static void telnetResize(uint16_t cols, uint16_t rows) {
+    termCols = cols;
+    termRows = rows;
+    if (!rawMode && optGet(localOn, TELOPT_NAWS)) sendWindowSize();
+}
+
+static void telnetClose() {
+    if (sock >= 0) {
+        lwip_close(sock);
+        sock = -1;
+    }
+}
+
+void telnetPrintStatus() {
+    if (sock < 0) {
+        Serial.println("Telnet: not connected");
+        return;
+    }
+    Serial.printf("Telnet: %s %s, TCP connect %.1fms\n", target, rawMode ? "raw" : "telnet", connectMs);
+    if (!rawMode) {
+        Serial.printf("  we: %s%s%s  server: %s%s\n",
+                      optGet(localOn, TELOPT_NAWS) ? "NAWS " : "",
+                      optGet(localOn, TELOPT_TTYPE) ? "TTYPE " : "",
+                      optGet(localOn, TELOPT_SGA) ? "SGA " : "",
+                      optGet(remoteOn, TELOPT_ECHO) ? "ECHO " : "",
+                      optGet(remoteOn, TELOPT_SGA) ? "SGA" : "");
+    }
+    Serial.printf("  %u bytes in (%u commands), %u bytes out\n",
+                  (unsigned)bytesIn, (unsigned)commandsIn, (unsigned)bytesOut);
+}
+
+// TCP flow control does the pausing: a full RX ring stops the reads
+const SessionTransport_t telnetTransport = {
+    "telnet",
+    telnetOpen,
+    telnetRead,
+    telnetWrite,
+    telnetIsOpen,
+    NULL,
+    telnetResize,
+    telnetClose
+};
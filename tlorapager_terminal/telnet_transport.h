@@ -0,0 +1,41 @@
+/**
+ * Telnet Session Transport for T-LoRa Pager Terminal
+ * Telnet or raw TCP to lab gear (open() target: TelnetConfig_t *)
+ *
+ * No handshake and no crypto: one TCP connect and the session is up.
+ * Telnet commands are filtered out of the output in place, in the
+ * caller's buffer. We agree to the server echoing and suppressing
+ * go-ahead, and report the terminal type and window size (NAWS); all
+ * other options are refused. In raw mode bytes pass through untouched
+ * and Enter sends a bare CR, as serial consoles expect.
+ */
+
+#ifndef TELNET_TRANSPORT_H
+#define TELNET_TRANSPORT_H
+
+#include "session.h"
+
+// Commands and options (RFC 854, 857, 858, 1073, 1091)
+#define TELNET_IAC  255
+#define TELNET_DONT 254
+#define TELNET_DO   253
+#define TELNET_WONT 252
+#define TELNET_WILL 251
+#define TELNET_SB   250
+#define TELNET_SE   240
+
+#define TELOPT_ECHO  1
+#define TELOPT_SGA   3
+#define TELOPT_TTYPE 24
+#define TELOPT_NAWS  31
+
+#define TELNET_TERM_TYPE "XTERM"
+#define TELNET_SB_MAX 64             // Longest subnegotiation kept
+#define TELNET_CONNECT_TIMEOUT_MS 5000
+
+extern const SessionTransport_t telnetTransport;
+
+// Print target, negotiated options and byte counts to Serial
+void telnetPrintStatus();
+
+#endif // TELNET_TRANSPORT_H
@@ -0,0 +1,425 @@
+/**
+ * Terminal Screen Implementation
+ */
+
+#include "terminal_ui.h"
+#include "settings.h"
+#include "line_editor.h"
+#include "pipeline_stats.h"
+#include <esp_heap_caps.h>
+
+// The render kernels draw LVGL's fills and glyphs (lv_blend_rk.h); a
+// board lv_conf.h found ahead of ours would silently drop them
+#if LV_USE_DRAW_SW_ASM != LV_DRAW_SW_ASM_CUSTOM
+#error "LVGL must be built with LV_USE_DRAW_SW_ASM = LV_DRAW_SW_ASM_CUSTOM (see lv_conf.h)"
+#endif
+
+lv_obj_t *terminalScreen = NULL;
+lv_obj_t *terminalTA = NULL;
+lv_obj_t *statusBar = NULL;
+lv_obj_t *termStatusLabel = NULL;
+static lv_obj_t *watchBadge = NULL;  // Output watcher alert
+static lv_obj_t *panLabel = NULL;    // Viewport columns on a wide grid
+
+VtTerminal termModel;
+static char termBuffer[TERM_BUFFER_SIZE];
+static uint32_t drawnGeneration = 0;
+static int historyOffset = 0;        // History rows below the drawn ones
+static int panX = 0;                 // First column in the viewport
+static int followX = -1, followY = -1;  // Cursor when the viewport last followed it
+
+// Sixel images: one LVGL image per cache tile, over the text
+static SixelCache termImages;
+static lv_obj_t *tileObjs[SIXEL_MAX_TILES];
+static lv_image_dsc_t tileDscs[SIXEL_MAX_TILES];
+static uint32_t drawnSerial[SIXEL_MAX_IMAGES];
+
+// Intro objects
+static lv_obj_t *introScreen = NULL;
+
+// Clean, professional 2-second intro
+void showIntro() {
+    // Create intro screen
+    introScreen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(introScreen, lv_color_black(), 0);
+    lv_scr_load(introScreen);
+    lv_task_handler();
+
+    // Single haptic pulse on start
+    hapticClick();
+
+    // Create centered logo box
+    lv_obj_t *logoBox = lv_obj_create(introScreen);
+    lv_obj_set_size(logoBox, 300, 120);
+    lv_obj_center(logoBox);
+    lv_obj_set_style_bg_color(logoBox, lv_color_hex(0x0a0a0a), 0);
+    lv_obj_set_style_border_color(logoBox, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_style_border_width(logoBox, 2, 0);
+    lv_obj_set_style_radius(logoBox, 8, 0);
+    lv_obj_set_style_pad_all(logoBox, 10, 0);
+    lv_obj_set_style_shadow_color(logoBox, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_style_shadow_width(logoBox, 25, 0);
+    lv_obj_set_style_shadow_opa(logoBox, LV_OPA_60, 0);
+    lv_obj_set_style_opa(logoBox, 0, 0);  // Start invisible
+    lv_obj_remove_flag(logoBox, LV_OBJ_FLAG_SCROLLABLE);
+
+    // Title - T-LORA
+    lv_obj_t *titleLbl = lv_label_create(logoBox);
+    lv_obj_set_style_text_font(titleLbl, &lv_font_montserrat_28, 0);
+    lv_obj_set_style_text_color(titleLbl, lv_color_hex(0x00FF00), 0);
+    lv_label_set_text(titleLbl, "T-LORA");
+    lv_obj_align(titleLbl, LV_ALIGN_TOP_MID, 0, 5);
+
+    // Subtitle - PAGER
+    lv_obj_t *subLbl = lv_label_create(logoBox);
+    lv_obj_set_style_text_font(subLbl, &lv_font_montserrat_18, 0);
+    lv_obj_set_style_text_color(subLbl, lv_color_hex(0x00AA00), 0);
+    lv_label_set_text(subLbl, "PAGER");
+    lv_obj_align(subLbl, LV_ALIGN_CENTER, 0, 5);
+
+    // Version
+    lv_obj_t *verLbl = lv_label_create(logoBox);
+    lv_obj_set_style_text_font(verLbl, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(verLbl, lv_color_hex(0x555555), 0);
+    lv_label_set_text(verLbl, "Terminal v1.0");
+    lv_obj_align(verLbl, LV_ALIGN_BOTTOM_MID, 0, -5);
+
+    lv_task_handler();
+
+    // Fade in
+    for (int i = 0; i <= 255; i += 17) {
+        lv_obj_set_style_opa(logoBox, i > 255 ? 255 : i, 0);
+        lv_task_handler();
+        delay(10);
+    }
+    lv_obj_set_style_opa(logoBox, 255, 0);
+    lv_task_handler();
+
+    // Hold
+    delay(1000);
+
+    // Fade out
+    for (int i = 255; i >= 0; i -= 17) {
+        lv_obj_set_style_opa(logoBox, i < 0 ? 0 : i, 0);
+        lv_task_handler();
+        delay(10);
+    }
+
+    hapticClick();
+
+    // Clean up
+    lv_obj_del(introScreen);
+    introScreen = NULL;
+}
+
+void setupTerminalUI() {
+    // Create terminal screen
+    terminalScreen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(terminalScreen, lv_color_black(), 0);
+
+    // Status bar at top
+    statusBar = lv_obj_create(terminalScreen);
+    lv_obj_set_size(statusBar, DISP_W, 20);
+    lv_obj_set_pos(statusBar, 0, 0);
+    lv_obj_set_style_bg_color(statusBar, lv_color_hex(0x222222), 0);
+    lv_obj_set_style_border_width(statusBar, 0, 0);
+    lv_obj_set_style_pad_all(statusBar, 2, 0);
+    lv_obj_remove_flag(statusBar, LV_OBJ_FLAG_SCROLLABLE);
+
+    termStatusLabel = lv_label_create(statusBar);
+    lv_label_set_text(termStatusLabel, "T-LoRa Terminal");
+    lv_obj_set_style_text_color(termStatusLabel, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_style_text_font(termStatusLabel, &lv_font_montserrat_12, 0);
+    lv_obj_align(termStatusLabel, LV_ALIGN_LEFT_MID, 5, 0);
+
+    watchBadge = lv_label_create(statusBar);
+    lv_label_set_text(watchBadge, "");
+    lv_obj_set_style_text_color(watchBadge, lv_color_hex(0xFF5A5A), 0);
+    lv_obj_set_style_text_font(watchBadge, &lv_font_montserrat_12, 0);
+    lv_obj_align(watchBadge, LV_ALIGN_RIGHT_MID, -5, 0);
+    lv_obj_add_flag(watchBadge, LV_OBJ_FLAG_HIDDEN);
+
+    panLabel = lv_label_create(statusBar);
+    lv_label_set_text(panLabel, "");
+    lv_obj_set_style_text_color(panLabel, lv_color_hex(0x888888), 0);
+    lv_obj_set_style_text_font(panLabel, &lv_font_montserrat_12, 0);
+    lv_obj_align(panLabel, LV_ALIGN_CENTER, 100, 0);
+    lv_obj_add_flag(panLabel, LV_OBJ_FLAG_HIDDEN);
+
+    // Terminal text area
+    terminalTA = lv_textarea_create(terminalScreen);
+    lv_obj_set_size(terminalTA, DISP_W, DISP_H - 22);
+    lv_obj_set_pos(terminalTA, 0, 21);
+    lv_obj_set_style_bg_color(terminalTA, lv_color_black(), 0);
+    lv_obj_set_style_text_color(terminalTA, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_style_text_font(terminalTA, TERM_FONT, 0);
+    lv_obj_set_style_border_width(terminalTA, 0, 0);
+    lv_obj_set_style_pad_all(terminalTA, 4, 0);
+
+    lv_textarea_set_text(terminalTA, "");
+    lv_textarea_set_cursor_click_pos(terminalTA, false);
+    // Enable scrolling for terminal
+    lv_obj_add_flag(terminalTA, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(terminalTA, LV_SCROLLBAR_MODE_AUTO);
+
+    // Terminal model sized to the PTY we request
+    memset(termBuffer, 0, sizeof(termBuffer));
+    if (!termModel.begin(terminalColumns(), TERMINAL_ROWS, TERM_SCROLLBACK)) {
+        Serial.println("Terminal: Out of memory");
+    }
+    termModel.setResponder(sshSendData);
+    lineEditBegin(&termModel, sshSendData);
+
+    // Sixel tiles in PSRAM, a cell being a text line high
+    if (termImages.tileCount() == 0) {
+        uint8_t cellH = lv_font_get_line_height(TERM_FONT);
+        size_t bytes = TERM_IMAGE_TILES * SixelCache::tileBytes(TERM_CELL_W, cellH);
+        void *tiles = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+        if (tiles == NULL || termImages.begin(tiles, bytes, TERM_CELL_W, cellH) == 0) {
+            Serial.println("Terminal: no PSRAM for images, sixel shows placeholders");
+        }
+    }
+    if (termImages.tileCount() > 0) termModel.setImageCache(&termImages);
+
+    // Load terminal screen
+    lv_scr_load(terminalScreen);
+}
+
+void applyTheme() {
+    const ThemeColors_t *theme = getCurrentTheme();
+
+    if (terminalTA) {
+        lv_obj_set_style_bg_color(terminalTA, lv_color_hex(theme->background), 0);
+        lv_obj_set_style_text_color(terminalTA, lv_color_hex(theme->foreground), 0);
+    }
+
+    if (terminalScreen) {
+        lv_obj_set_style_bg_color(terminalScreen, lv_color_hex(theme->background), 0);
+    }
+
+    if (statusBar) {
+        lv_obj_set_style_bg_color(statusBar, lv_color_hex(theme->statusBar), 0);
+    }
+
+    if (termStatusLabel) {
+        lv_obj_set_style_text_color(termStatusLabel, lv_color_hex(theme->foreground), 0);
+    }
+}
+
+void updateStatus(const char* status) {
+    if (termStatusLabel) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "T-LoRa | %s", status);
+        lv_label_set_text(termStatusLabel, buf);
+    }
+}
+
+void terminalPrint(const char* text) {
+    const char *p = text;
+    while (*p) {
+        const char *nl = strchr(p, '\n');
+        if (nl == NULL) {
+            termModel.write(p, strlen(p));
+            break;
+        }
+        termModel.write(p, nl - p);
+        termModel.write("\r\n", 2);
+        p = nl + 1;
+    }
+    terminalRender();
+}
+
+void terminalPrintChar(char c) {
+    char buf[2] = {c, '\0'};
+    terminalPrint(buf);
+}
+
+static void clampPan() {
+    int maxPan = termModel.cols() > TERM_VIEW_COLS ? termModel.cols() - TERM_VIEW_COLS : 0;
+    if (panX > maxPan) panX = maxPan;
+    if (panX < 0) panX = 0;
+}
+
+// Pan only when the cursor moved, so a manual pan stays put until then
+static void followCursor() {
+    int cx = termModel.cursorX();
+    int cy = termModel.cursorY();
+    if (cx == followX && cy == followY) return;
+    followX = cx;
+    followY = cy;
+    if (cx < panX) {
+        panX = cx - TERM_PAN_MARGIN;
+    } else if (cx >= panX + TERM_VIEW_COLS) {
+        panX = cx - TERM_VIEW_COLS + 1 + TERM_PAN_MARGIN;
+    }
+    clampPan();
+}
+
+static void updatePanLabel() {
+    if (!panLabel) return;
+    if (termModel.cols() <= TERM_VIEW_COLS) {
+        lv_obj_add_flag(panLabel, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%s%d-%d/%d%s", panX > 0 ? "<" : "", panX + 1,
+             panX + TERM_VIEW_COLS, termModel.cols(), panX + TERM_VIEW_COLS < termModel.cols() ? ">" : "");
+    lv_label_set_text(panLabel, buf);
+    lv_obj_remove_flag(panLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Each image row's tile goes on the text line its screen row was drawn
+// on (found from the cursor's line); rows above the history drawn, or
+// paged away from, are left out
+static void drawImages(size_t cursor) {
+    bool shown[SIXEL_MAX_TILES] = {false};
+    int screenTop = -1;
+    int lineH = termImages.cellH() + lv_obj_get_style_text_line_space(terminalTA, LV_PART_MAIN);
+
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        const SixelImage &img = termImages.image(i);
+        if (!img.used || img.alt != termModel.altScreen()) continue;
+        if (screenTop < 0) {
+            screenTop = 0;
+            for (size_t p = 0; p < cursor; p++) {
+                if (termBuffer[p] == '\n') screenTop++;
+            }
+            screenTop -= termModel.cursorY();
+        }
+        bool changed = img.serial != drawnSerial[i];
+        drawnSerial[i] = img.serial;
+
+        for (int r = 0; r < img.rows; r++) {
+            int16_t t = img.tile[r];
+            if (t < 0) continue;
+            int line = screenTop + img.top + r;
+            if (line < 0 || (historyOffset > 0 && img.top + r < 0)) continue;
+
+            if (tileObjs[t] == NULL) {
+                tileObjs[t] = lv_image_create(terminalTA);
+                lv_obj_remove_flag(tileObjs[t], LV_OBJ_FLAG_CLICKABLE);
+            }
+            lv_image_dsc_t &dsc = tileDscs[t];
+            if (changed || dsc.data != (const uint8_t *)termImages.tile(t)) {
+                lv_image_cache_drop(&dsc);
+                dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+                dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+                dsc.header.w = img.cols * termImages.cellW();
+                dsc.header.h = termImages.cellH();
+                dsc.header.stride = termImages.tileWidth() * sizeof(uint16_t);
+                dsc.data_size = dsc.header.stride * dsc.header.h;
+                dsc.data = (const uint8_t *)termImages.tile(t);
+                lv_image_set_src(tileObjs[t], &dsc);
+                lv_obj_invalidate(tileObjs[t]);
+            }
+            lv_obj_set_pos(tileObjs[t], (img.left - panX) * termImages.cellW(), line * lineH);
+            lv_obj_remove_flag(tileObjs[t], LV_OBJ_FLAG_HIDDEN);
+            shown[t] = true;
+        }
+    }
+    for (int t = 0; t < SIXEL_MAX_TILES; t++) {
+        if (tileObjs[t] && !shown[t]) lv_obj_add_flag(tileObjs[t], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+bool terminalRender() {
+    if (!terminalTA || termModel.generation() == drawnGeneration) return false;
+    drawnGeneration = termModel.generation();
+
+    followCursor();
+    size_t cursor = 0;
+    termModel.renderText(termBuffer, sizeof(termBuffer), historyOffset, RENDER_SCROLLBACK_LINES,
+                         panX, TERM_VIEW_COLS, &cursor);
+    lv_textarea_set_text(terminalTA, termBuffer);
+    lv_textarea_set_cursor_pos(terminalTA, cursor);
+    drawImages(cursor);
+    // Paged back: stay on the history, not the cursor
+    if (historyOffset > 0) lv_obj_scroll_to_y(terminalTA, 0, LV_ANIM_OFF);
+    updatePanLabel();
+    pipelineStats.renderFrames++;
+    return true;
+}
+
+static void setHistoryOffset(int offset) {
+    if (offset < 0) offset = 0;
+    if (offset == historyOffset) return;
+    historyOffset = offset;
+    drawnGeneration = termModel.generation() - 1;
+    terminalRender();
+}
+
+void terminalScroll(int direction) {
+    if (!terminalTA) return;
+
+    if (direction < 0 && lv_obj_get_scroll_top(terminalTA) <= 0 && !termModel.altScreen()) {
+        // Only if there is history above what is drawn
+        uint16_t len;
+        bool wrapped;
+        if (termModel.historyRow(historyOffset + RENDER_SCROLLBACK_LINES, &len, &wrapped)) {
+            setHistoryOffset(historyOffset + TERM_HISTORY_PAGE);
+        }
+        return;
+    }
+    if (direction > 0 && historyOffset > 0 && lv_obj_get_scroll_bottom(terminalTA) <= 0) {
+        setHistoryOffset(historyOffset - TERM_HISTORY_PAGE);
+        return;
+    }
+    lv_obj_scroll_by(terminalTA, 0, direction > 0 ? -TERM_ROTARY_SCROLL : TERM_ROTARY_SCROLL, LV_ANIM_ON);
+}
+
+void terminalScrollReset() {
+    setHistoryOffset(0);
+}
+
+bool terminalResize(uint16_t cols, uint16_t rows) {
+    if (!termModel.resize(cols, rows)) {
+        Serial.printf("Terminal: resize to %ux%u failed\n", cols, rows);
+        return false;
+    }
+    historyOffset = 0;
+    panX = 0;
+    followX = followY = -1;
+    terminalRender();
+    return true;
+}
+
+void terminalImageStats() {
+    int images = 0;
+    for (int i = 0; i < SIXEL_MAX_IMAGES; i++) {
+        if (termImages.image(i).used) images++;
+    }
+    Serial.printf("Sixel: %d images, %d/%d tiles free (%u bytes each, PSRAM), cell %ux%u\n",
+                  images, termImages.tilesFree(), termImages.tileCount(),
+                  (unsigned)SixelCache::tileBytes(termImages.cellW(), termImages.cellH()),
+                  termImages.cellW(), termImages.cellH());
+    Serial.printf("  %u decoded, %u placeholders, %u evicted, frame work max %u/%u\n",
+                  (unsigned)termImages.decoded, (unsigned)termImages.placeholders,
+                  (unsigned)termImages.evicted, (unsigned)termImages.workMax, SIXEL_FRAME_WORK);
+}
+
+uint16_t terminalColumns() {
+    return settings.wideTerminal ? TERM_WIDE_COLS : TERMINAL_COLS;
+}
+
+void terminalPan(int columns) {
+    int before = panX;
+    panX += columns;
+    clampPan();
+    if (panX == before) return;
+    drawnGeneration = termModel.generation() - 1;
+    terminalRender();
+}
+
+void terminalSetAlert(const char* text) {
+    if (!watchBadge) return;
+    if (text) {
+        lv_label_set_text(watchBadge, text);
+        lv_obj_remove_flag(watchBadge, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(watchBadge, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+bool terminalAlertShown() {
+    return watchBadge && !lv_obj_has_flag(watchBadge, LV_OBJ_FLAG_HIDDEN);
+}
@@ -0,0 +1,100 @@
+/**
+ * Terminal Screen for T-LoRa Pager Terminal
+ * Intro, status bar and the text area the terminal model is drawn into
+ *
+ * Kept apart from the sketch so the simulator (sim/) can build the same
+ * screen without the radio, Wi-Fi and session code. The session side is
+ * reached through sshSendData(), sessionResize() and hapticClick(), which
+ * the sketch (or the simulator) provides.
+ */
+
+#ifndef TERMINAL_UI_H
+#define TERMINAL_UI_H
+
+#include <lvgl.h>
+#include "vt_terminal.h"
+
+// Display dimensions
+#define DISP_W 480
+#define DISP_H 222
+
+// Terminal configuration
+#define TERM_FONT &lv_font_montserrat_12
+#define TERM_BUFFER_SIZE 4096
+#ifndef TERMINAL_COLS
+#define TERMINAL_COLS 80
+#endif
+#ifndef TERMINAL_ROWS
+#define TERMINAL_ROWS 20
+#endif
+#define TERM_WIDE_COLS 132           // Wide PTY (Settings > Display > Columns)
+#define TERM_VIEW_COLS TERMINAL_COLS // Columns the text area fits
+#define TERM_SCROLLBACK 200          // Lines of history kept by the model
+#define RENDER_SCROLLBACK_LINES 24   // History shown above the screen
+#define TERM_ROTARY_SCROLL 40        // Pixels per rotary detent
+#define TERM_HISTORY_PAGE 12         // History rows per detent past the top
+#define TERM_PAN_STEP 8              // Columns per detent with the button held
+#define TERM_PAN_MARGIN 8            // Columns kept beside the cursor when following it
+#define TERM_CELL_W ((DISP_W - 8) / TERM_VIEW_COLS)  // Sixel pixels per column
+#define TERM_IMAGE_TILES 32          // Sixel tile cache (PSRAM): image rows on screen
+
+// LVGL objects (exported for settings_ui)
+extern lv_obj_t *terminalScreen;
+extern lv_obj_t *terminalTA;
+extern lv_obj_t *statusBar;
+extern lv_obj_t *termStatusLabel;
+
+// Terminal state (model parsed from host output)
+extern VtTerminal termModel;
+
+// 2-second logo fade; blocks
+void showIntro();
+
+// Build the terminal screen, start the model and load the screen
+void setupTerminalUI();
+
+// Colors of the current theme
+void applyTheme();
+
+// Status bar text ("T-LoRa | status")
+void updateStatus(const char* status);
+
+// Local messages: '\n' starts a new line, as the PTY would translate it
+void terminalPrint(const char* text);
+void terminalPrintChar(char c);
+
+// Draw the model into the text area if it changed; true if drawn
+bool terminalRender();
+
+// Rotary: scroll the text area (1 = toward newer). Past the top of what
+// is drawn it pages further back into the model's scrollback.
+void terminalScroll(int direction);
+
+// Back to the newest history (on a keypress)
+void terminalScrollReset();
+
+// New model size (the session is told by the caller). Scrollback is
+// rewrapped lazily, only the rows drawn are touched.
+bool terminalResize(uint16_t cols, uint16_t rows);
+
+// PTY width from the settings: TERMINAL_COLS, or TERM_WIDE_COLS
+uint16_t terminalColumns();
+
+// A grid wider than TERM_VIEW_COLS is shown through a viewport, and only
+// its columns are drawn. The viewport follows the cursor when that moves
+// out of view; pan it by hand with this (rotary with the button held).
+void terminalPan(int columns);
+
+// Sixel cache use and decode work, to Serial
+void terminalImageStats();
+
+// Output watcher badge in the status bar (NULL hides it)
+void terminalSetAlert(const char* text);
+bool terminalAlertShown();
+
+// Provided by the sketch / simulator
+void sshSendData(const char *data, size_t len);
+void sessionResize();  // Tell the host termModel's new size
+void hapticClick();
+
+#endif // TERMINAL_UI_H
@@ -14,46 +14,77 @@
 #include <LilyGoLib.h>
 #include <LV_Helper.h>
 #include <WiFi.h>
-#include "libssh_esp32.h"
-#include <libssh/libssh.h>
+#include <esp_timer.h>
 #include "settings.h"
 #include "settings_ui.h"
-
-// Display dimensions
-#define DISP_W 480
-#define DISP_H 222
-
-// Terminal configuration
-#define TERM_FONT &lv_font_montserrat_12
-#define TERM_BUFFER_SIZE 4096
+#include "bench.h"
+#include "output_watcher.h"
+#include "pipeline_stats.h"
+#include "vt_terminal.h"
+#include "terminal_ui.h"
+#include "ConfigLoader.h"
+#include "ssh_transport.h"
+#include "ttyd_transport.h"
+#include "mosh_transport.h"
+#include "telnet_transport.h"
+#include "tls_session_cache.h"
+#include "kex_precompute.h"
+#include "ssh_jump.h"
+#include "line_editor.h"
+#include "dns_cache.h"
+#include "hil.h"
+#include "soak.h"
+#include "haptics.h"
+#include "audio.h"
+#include "crash_dump.h"
+
+// Jump scroll: with a large backlog, parse everything and only draw the
+// final screen (plus a frame now and then so the display stays alive)
+#define JUMP_SCROLL_ENTER 2048       // Backlog that switches to jump scrolling
+#define JUMP_SCROLL_FRAME_MS 100     // Draw interval while jump scrolling
+#define JUMP_SCROLL_SLICE_MS 20      // Max parse time per loop iteration
+static bool jumpScroll = false;
 
 // Rotary encoder pins defined in pins_arduino.h:
 // ROTARY_A (40), ROTARY_B (41), ROTARY_C (42 - button)
 
-// LVGL objects (exported for settings_ui)
-lv_obj_t *terminalScreen = NULL;
-lv_obj_t *terminalTA = NULL;
-lv_obj_t *statusBar = NULL;
-lv_obj_t *termStatusLabel = NULL;
-
-// Terminal state
-static char termBuffer[TERM_BUFFER_SIZE];
-static int termBufferPos = 0;
-
 // SSH state
-static ssh_session sshSession = NULL;
-static ssh_channel sshChannel = NULL;
+static const SessionTransport_t *session = &sshTransport;  // Transport of the running session
 static bool sshConnected = false;
 static bool sshConnecting = false;
 static TaskHandle_t sshTaskHandle = NULL;
+static volatile uint32_t sessionStackFree = 0;  // Stack never used by the last session task
+static volatile bool sessionResizePending = false;  // termModel size not sent to the host yet
 
 // Thread-safe ring buffer for SSH -> display
-#define SSH_RX_BUFFER_SIZE 2048
+#define SSH_RX_BUFFER_SIZE 8192
 static char sshRxBuffer[SSH_RX_BUFFER_SIZE];
 static volatile int sshRxHead = 0;
 static volatile int sshRxTail = 0;
 static SemaphoreHandle_t sshRxMutex = NULL;
 
+// Flow control: stop reading the channel above the high watermark so
+// the SSH window closes and the server throttles; resume at the low one
+#define SSH_RX_HIGH_WATER (SSH_RX_BUFFER_SIZE * 3 / 4)
+#define SSH_RX_LOW_WATER (SSH_RX_BUFFER_SIZE / 4)
+static volatile bool sshRxPaused = false;
+
+// Thread-safe ring buffer for keyboard -> SSH (written by the SSH task)
+#define SSH_TX_BUFFER_SIZE 256
+static char sshTxBuffer[SSH_TX_BUFFER_SIZE];
+static volatile int sshTxHead = 0;
+static volatile int sshTxTail = 0;
+static SemaphoreHandle_t sshTxMutex = NULL;
+static volatile bool sshTxUrgent = false;  // ^C pending, sent ahead of the queue
+
+// Ctrl-C: output is parsed but not drawn until the remote goes quiet, so
+// the model keeps its modes and the prompt comes back at once
+#define RX_QUIET_MS 150
+static volatile bool sshRxInterrupted = false;
+static uint32_t rxInterruptBytes = 0;
+static unsigned long rxInterruptStartMs = 0;
+static unsigned long rxLastByteMs = 0;
+
 // Input buffer
 static char inputBuffer[256];
 static int inputPos = 0;
@@ -66,29 +97,57 @@ static int lastRotaryA = HIGH;
 // Long press detection
 static unsigned long btnPressStart = 0;
 static bool btnWasPressed = false;
+static bool btnChordUsed = false;  // A key was pressed while held (chord)
 #define LONG_PRESS_MS 500
 
+// Soak test (`soak N`): connect, bulk output, settings menus and themes,
+// disconnect, then memory samples, once per iteration (see soak.h)
+#define SOAK_BULK_CMD "head -c 1048576 /dev/urandom | base64\n"
+#define SOAK_CONNECT_TIMEOUT_MS 30000
+#define SOAK_BULK_TIMEOUT_MS 120000
+#define SOAK_QUIET_MS 2000           // Bulk output is over after this long without
+#define SOAK_SETTLE_MS 2000          // Idle task frees the session task's stack
+typedef enum {
+    SOAK_IDLE = 0,
+    SOAK_CONNECTING,
+    SOAK_RECEIVING,
+    SOAK_DISCONNECTING,
+    SOAK_SETTLING
+} SoakState_t;
+static SoakState_t soakState = SOAK_IDLE;
+static uint32_t soakTarget = 0;      // Iterations to run, 0 = until `soak stop`
+static unsigned long soakPhaseMs = 0;
+static uint32_t soakLastBytes = 0;
+static unsigned long soakLastBytesMs = 0;
+
+// Crash dump upload, offered once per SSH connect while a core is stored
+static bool crashOffered = false;
+static volatile bool crashUploadRequested = false;  // Picked up by the session task
+static volatile int8_t crashUploadResult = -1;      // 1 uploaded, 0 failed, -1 none
+
 // Reconnection state
 static bool wasConnected = false;
 static unsigned long lastReconnectAttempt = 0;
 
 // Forward declarations
-void setupTerminalUI();
-void updateStatus(const char* status);
-void terminalPrint(const char* text);
-void terminalPrintChar(char c);
 void processKeyboard();
 void processRotary();
 void connectToWiFi();
+void prefetchHosts();
 void connectToServer();
-void sshTask(void *pvParameters);
+void sessionTask(void *pvParameters);
 void sshSendKey(char key);
+void sshSendInterrupt();
+void sshTxFlush();
 void sshDisconnect();
-void sshRxPut(const char *data, int len);
 void sshRxDrain();
-void applyTheme();
-void showIntro();
+ServerConfig_t *selectServer();
 void playStartupHaptic();
+void handleSerialCommands();
+void soakLoop();
+void processWatcher();
+void processCrashDump();
+void loadConfigAndProfile();
 
 // Rotary encoder ISR (inverted direction)
 void IRAM_ATTR rotaryISR() {
@@ -105,32 +164,66 @@ void IRAM_ATTR rotaryISR() {
     }
 }
 
+// config.xml (which loads its theme) with the last gateway profile over it
+void loadConfigAndProfile() {
+    configLoader.loadConfig();
+    char lastProfile[CONFIG_NAME_LEN + 1];
+    if (configLoader.getLastProfile(lastProfile, sizeof(lastProfile))) {
+        configLoader.loadGatewayProfile(lastProfile);
+    }
+}
+
 void setup() {
     Serial.begin(115200);
     delay(1000);
     Serial.println("\n=== T-LoRa Pager Terminal ===");
     Serial.println("Version 1.0.0");
 
+    // Core dump left by a crash (before anything else can crash)
+    crashDumpBegin();
+
     // Initialize all hardware via LilyGoLib
     Serial.println("Initializing hardware...");
     uint32_t result = instance.begin();
     Serial.printf("LilyGoLib init: 0x%08X\n", result);
+    hilBootMark("hardware");
 
     // Initialize settings from NVS
     Serial.println("Loading settings...");
     settingsInit();
+    hapticsBegin();
+    audioBegin();
+    hilBootMark("settings");
+
+    // First SSH kex keypair, computed while the UI starts
+    kexPrecomputeBegin();
+
+    // Host addresses saved by the last boot
+    dnsCacheBegin();
+
+    // Gateway profile for the ttyd transport (LittleFS + NVS)
+    Serial.println("Loading config...");
+    if (configLoader.begin()) {
+        loadConfigAndProfile();
+    }
+    hapticsConfigure(configLoader.getConfig().haptics);
+    hilBootMark("config");
 
     // Initialize LVGL
     beginLvglHelper(instance);
+    hilBegin();
+    hilBootMark("lvgl");
 
     // Apply saved brightness
     instance.setBrightness(settings.brightness);
 
     // Show cool intro animation
     showIntro();
+    hilBootMark("intro");
 
     // Setup terminal UI
     setupTerminalUI();
+    hilBootMark("ui");
 
     // Apply saved theme
     applyTheme();
@@ -151,13 +244,20 @@ void setup() {
     // Initialize settings UI
     settingsUIInit();
 
-    // Create SSH receive buffer mutex
+    // Create SSH receive/transmit buffer mutexes
     sshRxMutex = xSemaphoreCreateMutex();
+    sshTxMutex = xSemaphoreCreateMutex();
+
+    // Compile output watch patterns (before the SSH task starts)
+    watcherInit();
+    statsReset();
 
     // Connect to WiFi
     terminalPrint("T-LoRa Pager Terminal v1.0\n");
     terminalPrint("Press rotary button for settings\n\n");
+    crashDumpShow(terminalPrint);
     connectToWiFi();
+    hilBootMark("wifi");
 }
 
 void loop() {
@@ -176,7 +276,10 @@ void loop() {
         unsigned long pressDuration = millis() - btnPressStart;
         btnWasPressed = false;
 
-        if (pressDuration >= LONG_PRESS_MS) {
+        if (btnChordUsed) {
+            // Held as a modifier: no click of its own
+            btnChordUsed = false;
+        } else if (pressDuration >= LONG_PRESS_MS) {
             // Long press = go back / cancel
             if (settingsUIIsVisible()) {
                 MenuState_t state = settingsUIGetState();
@@ -200,6 +303,12 @@ void loop() {
     // Handle rotary rotation
     processRotary();
 
+    // Serial console (benchmarks, diagnostics)
+    handleSerialCommands();
+    hilLoop();
+    soakLoop();
+    crashDumpSampleHeap();
+
     // Update WiFi scan if in progress
     if (settingsUIIsVisible() && settingsUIGetState() == MENU_WIFI_SCAN) {
         settingsUIUpdateWiFiList();
@@ -210,6 +319,10 @@ void loop() {
         // Drain SSH receive buffer to display (thread-safe)
         sshRxDrain();
 
+        // Alert on watched output patterns
+        processWatcher();
+        processCrashDump();
+
         // Process keyboard input (sends to SSH)
         processKeyboard();
 
@@ -237,93 +350,16 @@ void processRotary() {
 
         if (settingsUIIsVisible()) {
             settingsUIHandleRotary(direction);
-        } else if (terminalTA) {
-            // Scroll terminal up/down
-            lv_coord_t scrollAmount = 40;  // Pixels per detent
-            if (direction > 0) {
-                // Scroll down (toward newer content)
-                lv_obj_scroll_by(terminalTA, 0, -scrollAmount, LV_ANIM_ON);
-            } else {
-                // Scroll up (toward older content)
-                lv_obj_scroll_by(terminalTA, 0, scrollAmount, LV_ANIM_ON);
-            }
+        } else if (btnWasPressed) {
+            // Turned with the button held: pan a wide grid
+            btnChordUsed = true;
+            terminalPan(direction * TERM_PAN_STEP);
+        } else {
+            terminalScroll(direction);
         }
     }
 }
 
-void setupTerminalUI() {
-    // Create terminal screen
-    terminalScreen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(terminalScreen, lv_color_black(), 0);
-
-    // Status bar at top
-    statusBar = lv_obj_create(terminalScreen);
-    lv_obj_set_size(statusBar, DISP_W, 20);
-    lv_obj_set_pos(statusBar, 0, 0);
-    lv_obj_set_style_bg_color(statusBar, lv_color_hex(0x222222), 0);
-    lv_obj_set_style_border_width(statusBar, 0, 0);
-    lv_obj_set_style_pad_all(statusBar, 2, 0);
-    lv_obj_remove_flag(statusBar, LV_OBJ_FLAG_SCROLLABLE);
-
-    termStatusLabel = lv_label_create(statusBar);
-    lv_label_set_text(termStatusLabel, "T-LoRa Terminal");
-    lv_obj_set_style_text_color(termStatusLabel, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(termStatusLabel, &lv_font_montserrat_12, 0);
-    lv_obj_align(termStatusLabel, LV_ALIGN_LEFT_MID, 5, 0);
-
-    // Terminal text area
-    terminalTA = lv_textarea_create(terminalScreen);
-    lv_obj_set_size(terminalTA, DISP_W, DISP_H - 22);
-    lv_obj_set_pos(terminalTA, 0, 21);
-    lv_obj_set_style_bg_color(terminalTA, lv_color_black(), 0);
-    lv_obj_set_style_text_color(terminalTA, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(terminalTA, TERM_FONT, 0);
-    lv_obj_set_style_border_width(terminalTA, 0, 0);
-    lv_obj_set_style_pad_all(terminalTA, 4, 0);
-
-    lv_textarea_set_text(terminalTA, "");
-    lv_textarea_set_cursor_click_pos(terminalTA, false);
-    // Enable scrolling for terminal
-    lv_obj_add_flag(terminalTA, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_scrollbar_mode(terminalTA, LV_SCROLLBAR_MODE_AUTO);
-
-    // Clear buffer
-    memset(termBuffer, 0, sizeof(termBuffer));
-    termBufferPos = 0;
-
-    // Load terminal screen
-    lv_scr_load(terminalScreen);
-}
-
-void applyTheme() {
-    const ThemeColors_t *theme = getCurrentTheme();
-
-    if (terminalTA) {
-        lv_obj_set_style_bg_color(terminalTA, lv_color_hex(theme->background), 0);
-        lv_obj_set_style_text_color(terminalTA, lv_color_hex(theme->foreground), 0);
-    }
-
-    if (terminalScreen) {
-        lv_obj_set_style_bg_color(terminalScreen, lv_color_hex(theme->background), 0);
-    }
-
-    if (statusBar) {
-        lv_obj_set_style_bg_color(statusBar, lv_color_hex(theme->statusBar), 0);
-    }
-
-    if (termStatusLabel) {
-        lv_obj_set_style_text_color(termStatusLabel, lv_color_hex(theme->foreground), 0);
-    }
-}
-
-void updateStatus(const char* status) {
-    if (termStatusLabel) {
-        char buf[64];
-        snprintf(buf, sizeof(buf), "T-LoRa | %s", status);
-        lv_label_set_text(termStatusLabel, buf);
-    }
-}
-
 // Update status bar with WiFi RSSI
 void updateStatusWithRSSI() {
     if (!termStatusLabel) return;
@@ -338,9 +374,10 @@ void updateStatusWithRSSI() {
         else signal = "*   ";
 
         if (sshConnected) {
-            snprintf(buf, sizeof(buf), "%s [%s] SSH Connected", WiFi.SSID().c_str(), signal);
+            snprintf(buf, sizeof(buf), "%s [%s] %s Connected%s", WiFi.SSID().c_str(), signal, session->name,
+                     lineEditEnabled() ? " [line]" : "");
         } else if (sshConnecting) {
-            snprintf(buf, sizeof(buf), "%s [%s] SSH Connecting...", WiFi.SSID().c_str(), signal);
+            snprintf(buf, sizeof(buf), "%s [%s] %s Connecting...", WiFi.SSID().c_str(), signal, session->name);
         } else {
             snprintf(buf, sizeof(buf), "%s [%s] Disconnected", WiFi.SSID().c_str(), signal);
         }
@@ -350,31 +387,6 @@ void updateStatusWithRSSI() {
     lv_label_set_text(termStatusLabel, buf);
 }
 
-void terminalPrint(const char* text) {
-    if (!terminalTA) return;
-
-    int len = strlen(text);
-    for (int i = 0; i < len && termBufferPos < TERM_BUFFER_SIZE - 1; i++) {
-        termBuffer[termBufferPos++] = text[i];
-    }
-    termBuffer[termBufferPos] = '\0';
-
-    // Trim buffer if too long (keep last half)
-    if (termBufferPos > TERM_BUFFER_SIZE - 256) {
-        int keepFrom = termBufferPos / 2;
-        memmove(termBuffer, termBuffer + keepFrom, termBufferPos - keepFrom + 1);
-        termBufferPos -= keepFrom;
-    }
-
-    lv_textarea_set_text(terminalTA, termBuffer);
-    lv_textarea_set_cursor_pos(terminalTA, LV_TEXTAREA_CURSOR_LAST);
-}
-
-void terminalPrintChar(char c) {
-    char buf[2] = {c, '\0'};
-    terminalPrint(buf);
-}
-
 void connectToWiFi() {
     updateStatus("Scanning WiFi...");
 
@@ -411,6 +423,7 @@ void connectToWiFi() {
         char buf[32];
         snprintf(buf, sizeof(buf), "IP: %s", WiFi.localIP().toString().c_str());
         updateStatus(buf);
+        prefetchHosts();
         connectToServer();
     } else {
         updateStatus("No WiFi");
@@ -421,217 +434,337 @@ void connectToWiFi() {
     terminalPrint("> ");
 }
 
-// Put data into SSH receive buffer (called from SSH task)
-void sshRxPut(const char *data, int len) {
-    if (sshRxMutex == NULL) return;
-    if (xSemaphoreTake(sshRxMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        for (int i = 0; i < len; i++) {
-            int nextHead = (sshRxHead + 1) % SSH_RX_BUFFER_SIZE;
-            if (nextHead != sshRxTail) {  // Buffer not full
-                sshRxBuffer[sshRxHead] = data[i];
-                sshRxHead = nextHead;
-            }
+// Bytes waiting in the SSH receive buffer
+static int sshRxCount() {
+    return (sshRxHead - sshRxTail + SSH_RX_BUFFER_SIZE) % SSH_RX_BUFFER_SIZE;
+}
+
+// Replayed output from the HIL runner: takes as much as fits and returns
+// the count; the runner sends the rest again, so nothing is dropped
+int sshRxOffer(const char *data, int len) {
+    if (sshRxMutex == NULL) return 0;
+    int n = 0;
+    if (xSemaphoreTake(sshRxMutex, portMAX_DELAY) == pdTRUE) {
+        n = min(len, SSH_RX_BUFFER_SIZE - 1 - sshRxCount());
+        for (int i = 0; i < n; i++) {
+            sshRxBuffer[sshRxHead] = data[i];
+            sshRxHead = (sshRxHead + 1) % SSH_RX_BUFFER_SIZE;
         }
         xSemaphoreGive(sshRxMutex);
     }
+    pipelineStats.rxBytes += n;
+    return n;
 }
 
-// Drain SSH receive buffer to display (called from main loop)
-void sshRxDrain() {
-    if (sshRxMutex == NULL) return;
-    if (xSemaphoreTake(sshRxMutex, pdMS_TO_TICKS(5)) == pdTRUE) {
-        char buf[256];
-        int count = 0;
+int sshRxPending() {
+    return sshRxCount();
+}
 
-        while (sshRxTail != sshRxHead && count < sizeof(buf) - 1) {
-            buf[count++] = sshRxBuffer[sshRxTail];
-            sshRxTail = (sshRxTail + 1) % SSH_RX_BUFFER_SIZE;
-        }
+bool sessionActive() {
+    return sshConnected || sshConnecting;
+}
 
-        xSemaphoreGive(sshRxMutex);
+// Contiguous free space at the ring head, for reading straight into the
+// ring (called from SSH task; only the task moves the head)
+static int sshRxReserve(char **ptr) {
+    int head = sshRxHead;
+    int room = SSH_RX_BUFFER_SIZE - 1 - (head - sshRxTail + SSH_RX_BUFFER_SIZE) % SSH_RX_BUFFER_SIZE;
+    *ptr = sshRxBuffer + head;
+    return min(room, SSH_RX_BUFFER_SIZE - head);
+}
 
-        if (count > 0) {
-            buf[count] = '\0';
-            terminalPrint(buf);
-        }
+// Publish bytes written after sshRxReserve() (called from SSH task)
+static void sshRxCommit(int len) {
+    if (xSemaphoreTake(sshRxMutex, portMAX_DELAY) == pdTRUE) {
+        sshRxHead = (sshRxHead + len) % SSH_RX_BUFFER_SIZE;
+        int fill = sshRxCount();
+        if (fill > pipelineStats.rxPeakFill) pipelineStats.rxPeakFill = fill;
+        xSemaphoreGive(sshRxMutex);
     }
 }
 
-// SSH connection task - runs in separate FreeRTOS task
-void sshTask(void *pvParameters) {
-    ServerConfig_t *server = (ServerConfig_t *)pvParameters;
-    int rc;
-
-    Serial.println("SSH Task started");
-    sshConnecting = true;
-
-    // Initialize libssh
-    libssh_begin();
+// Drain SSH receive buffer to display (called from main loop). Normally
+// each batch is drawn; with a big backlog the parser runs through as much
+// as fits in a time slice and only the latest screen is drawn. After ^C
+// nothing is drawn until the remote goes quiet.
+void sshRxDrain() {
+    static unsigned long lastFrameMs = 0;
+    static bool undrawn = false;  // Parsed after ^C, not drawn yet
+    if (sshRxMutex == NULL) return;
 
-    // Create SSH session
-    sshSession = ssh_new();
-    if (sshSession == NULL) {
-        Serial.println("SSH: Failed to create session");
-        sshConnecting = false;
-        vTaskDelete(NULL);
-        return;
-    }
+    unsigned long sliceStart = millis();
+    int fill = 0;
+    bool parsed = false;
+    char buf[256];
+    termModel.imageFrame();  // Sixel decoding: one budget per loop pass
 
-    // Set SSH options
-    ssh_options_set(sshSession, SSH_OPTIONS_HOST, server->host);
-    ssh_options_set(sshSession, SSH_OPTIONS_PORT, &server->port);
-    ssh_options_set(sshSession, SSH_OPTIONS_USER, server->username);
+    do {
+        int count = 0;
+        if (xSemaphoreTake(sshRxMutex, pdMS_TO_TICKS(5)) != pdTRUE) break;
+        if (!jumpScroll && sshRxCount() >= JUMP_SCROLL_ENTER) {
+            jumpScroll = true;
+            pipelineStats.jumpScrolls++;
+        }
+        int tail = sshRxTail;
+        while (tail != sshRxHead && count < (int)sizeof(buf)) {
+            buf[count++] = sshRxBuffer[tail];
+            tail = (tail + 1) % SSH_RX_BUFFER_SIZE;
+        }
+        fill = sshRxCount();
+        xSemaphoreGive(sshRxMutex);
 
-    // Set timeout (10 seconds)
-    long timeout = 10;
-    ssh_options_set(sshSession, SSH_OPTIONS_TIMEOUT, &timeout);
+        int taken = 0;
+        if (count > 0) {
+            if (!parsed) lineEditHide();
+            int64_t t0 = esp_timer_get_time();
+            taken = termModel.write(buf, count);
+            pipelineStats.renderUs += esp_timer_get_time() - t0;
+            pipelineStats.renderBytes += taken;
+            pipelineStats.renderCalls++;
+            parsed = true;
+
+            // Only what the model took leaves the ring: a sixel image out
+            // of decode work for this pass goes on with the rest next pass
+            xSemaphoreTake(sshRxMutex, portMAX_DELAY);
+            sshRxTail = (sshRxTail + taken) % SSH_RX_BUFFER_SIZE;
+            fill = sshRxCount();
+            xSemaphoreGive(sshRxMutex);
+        }
 
-    // Disable strict host key checking for embedded device
-    ssh_options_set(sshSession, SSH_OPTIONS_STRICTHOSTKEYCHECK, 0);
+        // Crossed the low watermark: let the reader resume right away
+        if (sshRxPaused && fill <= SSH_RX_LOW_WATER && sshTaskHandle) {
+            xTaskNotifyGive(sshTaskHandle);
+        }
+        if (count == 0 || taken < count) break;
+    } while ((jumpScroll || sshRxInterrupted) && fill > 0 && millis() - sliceStart < JUMP_SCROLL_SLICE_MS);
 
-    Serial.printf("SSH: Connecting to %s@%s:%d\n", server->username, server->host, server->port);
+    if (!parsed && !(undrawn && !sshRxInterrupted)) return;
+    lineEditShow();
 
-    // Connect
-    rc = ssh_connect(sshSession);
-    if (rc != SSH_OK) {
-        Serial.printf("SSH: Connection failed: %s\n", ssh_get_error(sshSession));
-        ssh_free(sshSession);
-        sshSession = NULL;
-        sshConnecting = false;
-        vTaskDelete(NULL);
+    // After ^C: neither drawn nor rung until the remote is quiet
+    if (sshRxInterrupted) {
+        undrawn = true;
+        termModel.takeBells();
         return;
     }
 
-    Serial.println("SSH: Connected, authenticating...");
+    // Draw every batch normally; while jump scrolling only on the frame
+    // interval and once the backlog is gone
+    if (!jumpScroll || fill == 0 || undrawn || millis() - lastFrameMs >= JUMP_SCROLL_FRAME_MS) {
+        int64_t t0 = esp_timer_get_time();
+        terminalRender();
+        pipelineStats.renderUs += esp_timer_get_time() - t0;
+        lastFrameMs = millis();
+        undrawn = false;
+    }
+    if (fill == 0) jumpScroll = false;
 
-    // Authenticate with password
-    rc = ssh_userauth_password(sshSession, NULL, server->password);
-    if (rc != SSH_AUTH_SUCCESS) {
-        Serial.printf("SSH: Auth failed: %s\n", ssh_get_error(sshSession));
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
-        sshConnecting = false;
-        vTaskDelete(NULL);
-        return;
+    // BEL from the host (a burst is one buzz and one bell)
+    if (termModel.takeBells() > 0) {
+        hapticPlay(HAPTIC_BELL);
+        audioPlay(AUDIO_BELL);
     }
+}
 
-    Serial.println("SSH: Authenticated, opening channel...");
+// Apply RX flow control watermarks (called from SSH task)
+static void sshRxFlowControl() {
+    static int64_t pausedAt = 0;
+    int fill = sshRxCount();
 
-    // Create channel
-    sshChannel = ssh_channel_new(sshSession);
-    if (sshChannel == NULL) {
-        Serial.println("SSH: Failed to create channel");
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
-        sshConnecting = false;
-        vTaskDelete(NULL);
-        return;
+    if (sshRxPaused) {
+        if (fill <= SSH_RX_LOW_WATER) {
+            sshRxPaused = false;
+            pipelineStats.rxPausedUs += esp_timer_get_time() - pausedAt;
+            if (session->setPaused) session->setPaused(false);
+        }
+    } else if (fill >= SSH_RX_HIGH_WATER) {
+        sshRxPaused = true;
+        pausedAt = esp_timer_get_time();
+        pipelineStats.rxPauses++;
+        if (session->setPaused) session->setPaused(true);
     }
+}
 
-    // Open session on channel
-    rc = ssh_channel_open_session(sshChannel);
-    if (rc != SSH_OK) {
-        Serial.printf("SSH: Failed to open session: %s\n", ssh_get_error(sshSession));
-        ssh_channel_free(sshChannel);
-        sshChannel = NULL;
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
-        sshConnecting = false;
-        vTaskDelete(NULL);
-        return;
-    }
+// Remote went quiet after ^C: the screen, with its fresh prompt, is
+// drawn again (called from SSH task)
+static void sshRxInterruptEnd() {
+    sshRxInterrupted = false;
+    Serial.printf("SSH: Interrupt: %u bytes parsed undrawn in %lums\n",
+                  (unsigned)rxInterruptBytes, millis() - rxInterruptStartMs);
+}
 
-    // Request PTY (terminal size 80x20)
-    rc = ssh_channel_request_pty_size(sshChannel, "xterm", 80, 20);
-    if (rc != SSH_OK) {
-        Serial.printf("SSH: Failed to request PTY: %s\n", ssh_get_error(sshSession));
-        ssh_channel_close(sshChannel);
-        ssh_channel_free(sshChannel);
-        sshChannel = NULL;
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
-        sshConnecting = false;
-        vTaskDelete(NULL);
-        return;
-    }
+// Session task - runs the selected transport in a separate FreeRTOS task
+void sessionTask(void *pvParameters) {
+    Serial.printf("%s task started\n", session->name);
+    sshConnecting = true;
 
-    // Request shell
-    rc = ssh_channel_request_shell(sshChannel);
-    if (rc != SSH_OK) {
-        Serial.printf("SSH: Failed to request shell: %s\n", ssh_get_error(sshSession));
-        ssh_channel_close(sshChannel);
-        ssh_channel_free(sshChannel);
-        sshChannel = NULL;
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
+    int64_t connectStart = esp_timer_get_time();
+    sessionResizePending = false;
+    if (!session->open(pvParameters, termModel.cols(), termModel.rows())) {
         sshConnecting = false;
+        sessionStackFree = uxTaskGetStackHighWaterMark(NULL);
+        sshTaskHandle = NULL;
         vTaskDelete(NULL);
         return;
     }
-
-    Serial.println("SSH: Shell ready!");
+    Serial.printf("%s: Connected in %lums\n", session->name,
+                  (unsigned long)((esp_timer_get_time() - connectStart) / 1000));
     sshConnecting = false;
     sshConnected = true;
+    hilBootMark("session");
 
     // Read loop
-    char buffer[512];
-    while (sshConnected && ssh_channel_is_open(sshChannel) && !ssh_channel_is_eof(sshChannel)) {
-        int nbytes = ssh_channel_read_nonblocking(sshChannel, buffer, sizeof(buffer) - 1, 0);
+    bool crashUploading = false;
+    while (sshConnected && session->isOpen()) {
+        // Keystrokes first (^C ahead of everything else)
+        sshTxFlush();
+        if (sessionResizePending) {
+            sessionResizePending = false;
+            if (session->resize) session->resize(termModel.cols(), termModel.rows());
+        }
+        if (crashUploadRequested && !crashUploading) {
+            if (session == &sshTransport) {
+                // A channel next to the shell, stepped between its reads
+                crashUploading = crashDumpUploadStart();
+                if (!crashUploading) crashUploadResult = 0;
+            } else {
+                // mosh: no SSH session to add a channel to
+                crashUploadResult = crashDumpUpload((ServerConfig_t *)pvParameters) ? 1 : 0;
+            }
+            if (!crashUploading) crashUploadRequested = false;
+        }
+        if (crashUploading) {
+            CrashUploadState_t state = crashDumpUploadStep();
+            if (state != CRASH_UPLOAD_RUNNING) {
+                crashUploading = false;
+                crashUploadResult = state == CRASH_UPLOAD_DONE ? 1 : 0;
+                crashUploadRequested = false;
+            }
+        }
+
+        // Read straight into the RX ring, and only what fits; while paused
+        // the transport holds the server off
+        sshRxFlowControl();
+        char *dst = NULL;
+        int room = sshRxPaused ? 0 : sshRxReserve(&dst);
+
+        int nbytes = 0;
+        if (room > 0) {
+            int64_t t0 = esp_timer_get_time();
+            nbytes = session->read(dst, room);
+            if (nbytes > 0) {
+                pipelineStats.rxReadUs += esp_timer_get_time() - t0;
+                pipelineStats.rxBytes += nbytes;
+                pipelineStats.rxReads++;
+            } else if (nbytes == 0) {
+                pipelineStats.rxEmptyPolls++;
+            }
+        }
 
         if (nbytes > 0) {
-            // Use thread-safe ring buffer instead of direct terminalPrint
-            sshRxPut(buffer, nbytes);
-            Serial.printf("SSH RX: %d bytes\n", nbytes);
+            // Match watch patterns inline, then publish for display
+            watcherScan(dst, nbytes);
+            sshRxCommit(nbytes);
+            if (sshRxInterrupted) {
+                rxInterruptBytes += nbytes;
+                rxLastByteMs = millis();
+            }
         } else if (nbytes < 0) {
-            Serial.println("SSH: Read error");
             break;
         }
 
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+        if (sshRxInterrupted && millis() - rxLastByteMs > RX_QUIET_MS) {
+            sshRxInterruptEnd();
+        }
+
+        // Fast-forward after ^C; otherwise sleep until the next poll or
+        // until a keystroke wakes us
+        if (!(sshRxInterrupted && nbytes > 0)) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        }
     }
 
-    Serial.println("SSH: Connection ended");
+    Serial.printf("%s: Connection ended\n", session->name);
     sshConnected = false;
+    if (crashUploading) crashDumpUploadAbort();
+    crashUploadRequested = false;
+    sshRxPaused = false;
+    sshRxInterrupted = false;
+    session->close();
 
-    // Cleanup
-    if (sshChannel) {
-        ssh_channel_send_eof(sshChannel);
-        ssh_channel_close(sshChannel);
-        ssh_channel_free(sshChannel);
-        sshChannel = NULL;
-    }
-    if (sshSession) {
-        ssh_disconnect(sshSession);
-        ssh_free(sshSession);
-        sshSession = NULL;
-    }
-
+    sessionStackFree = uxTaskGetStackHighWaterMark(NULL);
     sshTaskHandle = NULL;
     vTaskDelete(NULL);
 }
 
 // Send a key to SSH channel
 void sshSendKey(char key) {
-    if (!sshConnected || sshChannel == NULL) return;
+    sshSendData(&key, 1);
+}
 
-    int nbytes = ssh_channel_write(sshChannel, &key, 1);
-    if (nbytes < 0) {
-        Serial.println("SSH: Write error");
+// Queue data for the SSH channel (the SSH task owns the session)
+void sshSendData(const char *data, size_t len) {
+    if (!sshConnected || sshTxMutex == NULL) return;
+
+    if (xSemaphoreTake(sshTxMutex, portMAX_DELAY) == pdTRUE) {
+        for (size_t i = 0; i < len; i++) {
+            int nextHead = (sshTxHead + 1) % SSH_TX_BUFFER_SIZE;
+            if (nextHead == sshTxTail) {
+                Serial.println("SSH: TX queue full");
+                break;
+            }
+            sshTxBuffer[sshTxHead] = data[i];
+            sshTxHead = nextHead;
+        }
+        xSemaphoreGive(sshTxMutex);
+    }
+
+    if (sshTaskHandle) {
+        xTaskNotifyGive(sshTaskHandle);
     }
 }
 
-// Send data to SSH channel
-void sshSendData(const char *data, size_t len) {
-    if (!sshConnected || sshChannel == NULL) return;
+// Write queued keystrokes to the channel (called from SSH task)
+void sshTxFlush() {
+    if (sshTxUrgent) {
+        sshTxUrgent = false;
+        char intr = 0x03;
+        session->write(&intr, 1);
+    }
+
+    char buf[SSH_TX_BUFFER_SIZE];
+    int count = 0;
+    if (xSemaphoreTake(sshTxMutex, portMAX_DELAY) == pdTRUE) {
+        while (sshTxTail != sshTxHead) {
+            buf[count++] = sshTxBuffer[sshTxTail];
+            sshTxTail = (sshTxTail + 1) % SSH_TX_BUFFER_SIZE;
+        }
+        xSemaphoreGive(sshTxMutex);
+    }
+
+    if (count > 0) {
+        session->write(buf, count);
+        pipelineStats.txWrites++;
+        pipelineStats.txBytes += count;
+    }
+}
 
-    int nbytes = ssh_channel_write(sshChannel, data, len);
-    if (nbytes < 0) {
-        Serial.println("SSH: Write error");
+// Ctrl-C: write ^C ahead of queued keystrokes and stop drawing output
+// until the remote goes quiet, so the prompt returns immediately. Queued
+// and further output is still parsed (modes, cursor, alternate screen
+// stay right), just at full speed with no drawing in between.
+void sshSendInterrupt() {
+    if (!sshConnected) return;
+
+    if (!sshRxInterrupted) {
+        rxInterruptBytes = 0;
+        rxInterruptStartMs = rxLastByteMs = millis();
+        sshRxInterrupted = true;
+    }
+    sshTxUrgent = true;
+
+    if (sshTaskHandle) {
+        xTaskNotifyGive(sshTaskHandle);
     }
 }
 
@@ -641,57 +774,151 @@ void sshDisconnect() {
     // The task will clean up on next iteration
 }
 
-void connectToServer() {
-    static ServerConfig_t *server = NULL;
-
-    // Choose server based on preference
+// SSH server to use, by preference (NULL if none is enabled)
+ServerConfig_t *selectServer() {
     if (settings.preferRemote && settings.remoteServer.enabled) {
-        server = &settings.remoteServer;
-        terminalPrint("Connecting to remote SSH server...\n");
+        return &settings.remoteServer;
     } else if (settings.localServer.enabled) {
-        server = &settings.localServer;
-        terminalPrint("Connecting to local SSH server...\n");
+        return &settings.localServer;
     } else if (settings.remoteServer.enabled) {
-        server = &settings.remoteServer;
-        terminalPrint("Connecting to remote SSH server...\n");
+        return &settings.remoteServer;
     }
+    return NULL;
+}
 
-    if (server == NULL || strlen(server->host) == 0) {
-        terminalPrint("No server configured!\n");
-        return;
+// Resolve every configured host in the background, so the next connect
+// (to whichever server or profile) finds its address cached
+void prefetchHosts() {
+    ServerConfig_t *servers[] = {&settings.localServer, &settings.remoteServer};
+    for (ServerConfig_t *server : servers) {
+        dnsPrefetch(server->host);
+        dnsPrefetch(server->jump.host);
     }
+    dnsPrefetch(settings.telnet.host);
+    dnsPrefetch(configLoader.getConfig().gateway.host.c_str());
+    for (const String &host : configLoader.profileHosts()) {
+        dnsPrefetch(host.c_str());
+    }
+}
 
+void connectToServer() {
+    void *target = NULL;
     char msg[128];
-    snprintf(msg, sizeof(msg), "SSH: %s@%s:%d\n", server->username, server->host, server->port);
+
+    if (sshConnected || sshConnecting) {
+        terminalPrint("Already connected\n");
+        return;
+    }
+    lineEditReset();
+
+    if (settings.transport == TRANSPORT_TTYD) {
+        // ttyd gateway from the loaded profile
+        GatewayConfig *gw = &configLoader.getConfigMutable().gateway;
+        if (gw->host.length() == 0) {
+            terminalPrint("No gateway configured!\n");
+            return;
+        }
+        session = &ttydTransport;
+        target = gw;
+        snprintf(msg, sizeof(msg), "ttyd: %s://%s:%d%s\n",
+                 gw->useSsl ? "wss" : "ws", gw->host.c_str(), gw->port, gw->path.c_str());
+    } else if (settings.transport == TRANSPORT_TELNET) {
+        // Lab gear on the LAN: no handshake, no crypto
+        if (strlen(settings.telnet.host) == 0) {
+            terminalPrint("No telnet target configured!\n");
+            return;
+        }
+        session = &telnetTransport;
+        target = &settings.telnet;
+        snprintf(msg, sizeof(msg), "%s: %s:%d\n", settings.telnet.raw ? "TCP" : "telnet",
+                 settings.telnet.host, settings.telnet.port);
+    } else {
+        ServerConfig_t *server = selectServer();
+        if (server == NULL || strlen(server->host) == 0) {
+            terminalPrint("No server configured!\n");
+            return;
+        }
+        terminalPrint(server == &settings.remoteServer ?
+                      "Connecting to remote SSH server...\n" :
+                      "Connecting to local SSH server...\n");
+        session = settings.transport == TRANSPORT_MOSH ? &moshTransport : &sshTransport;
+        target = server;
+        snprintf(msg, sizeof(msg), "%s: %s@%s:%d\n", settings.transport == TRANSPORT_MOSH ? "mosh" : "SSH",
+                 server->username, server->host, server->port);
+        if (strlen(server->jump.host) > 0) {
+            snprintf(msg + strlen(msg) - 1, sizeof(msg) - strlen(msg) + 1, " via %s\n", server->jump.host);
+        }
+        Serial.printf("SSH Connect: host=%s port=%d user=%s\n",
+                      server->host, server->port, server->username);
+    }
     terminalPrint(msg);
-    Serial.printf("SSH Connect: host=%s port=%d user=%s\n",
-                  server->host, server->port, server->username);
 
-    // Start SSH task with larger stack (SSH needs ~50KB)
+    // Start session task with larger stack (SSH needs ~50KB)
     xTaskCreatePinnedToCore(
-        sshTask,           // Task function
-        "ssh_task",        // Name
+        sessionTask,       // Task function
+        "session_task",    // Name
         51200,             // Stack size (50KB for SSH)
-        server,            // Parameter
+        target,            // Parameter
         5,                 // Priority
         &sshTaskHandle,    // Task handle
         1                  // Core 1 (leave core 0 for LVGL)
     );
 
-    terminalPrint("SSH connecting...\n");
+    snprintf(msg, sizeof(msg), "%s connecting...\n", session->name);
+    terminalPrint(msg);
 }
 
 void processKeyboard() {
     char key = 0;
-    if (instance.getKeyChar(&key) <= 0) return;
+    if (instance.getKeyChar(&key) <= 0 && !hilTakeKey(&key)) return;
     if (key == 0) return;
 
     Serial.printf("Key: 0x%02X '%c'\n", key, key);
+    hapticPlay(HAPTIC_KEY);
+    audioPlay(AUDIO_CLICK);
+    terminalScrollReset();
+
+    // Rotary button + L: toggle local line editing
+    if (btnWasPressed && (key == 'l' || key == 'L')) {
+        btnChordUsed = true;
+        lineEditSetEnabled(!lineEditEnabled());
+        updateStatusWithRSSI();
+        hapticClick();
+        return;
+    }
+
+    // Rotary button + U: upload the stored core dump over SSH
+    if (btnWasPressed && (key == 'u' || key == 'U')) {
+        btnChordUsed = true;
+        if (crashOffered && crashDumpPending() && sshConnected && !crashUploadRequested) {
+            crashUploadRequested = true;
+            terminalSetAlert("Uploading crash dump...");
+            if (sshTaskHandle) xTaskNotifyGive(sshTaskHandle);
+        }
+        return;
+    }
+
+    // Any key acknowledges a watcher alert
+    if (terminalAlertShown()) {
+        terminalSetAlert(NULL);
+    }
 
     // For SSH, send keys directly - the remote shell handles everything
-    if (sshConnected && sshChannel) {
+    if (sshConnected) {
+        pipelineStats.txKeys++;
+        if (key == '\r' || key == '\n') pipelineStats.txLines++;
+
+        // Line mode: edit locally, whole lines go out on Enter
+        if (lineEditActive() && lineEditKey(key)) {
+            terminalRender();
+            return;
+        }
+
         // Handle special keys
-        if (key == '\r') {
+        if (key == 0x03) {
+            // Ctrl-C jumps the queue and skips pending output
+            sshSendInterrupt();
+        } else if (key == '\r') {
             // Send newline
             sshSendKey('\n');
         } else if (key == '\b' || key == 127 || key == 8) {
@@ -707,11 +934,7 @@ void processKeyboard() {
         if (key == '\n' || key == '\r') {
             terminalPrint("\n> ");
         } else if (key == '\b' || key == 127 || key == 8) {
-            if (termBufferPos > 0) {
-                termBufferPos--;
-                termBuffer[termBufferPos] = '\0';
-                lv_textarea_set_text(terminalTA, termBuffer);
-            }
+            terminalPrint("\b \b");
         } else if (key >= 32 && key < 127) {
             terminalPrintChar(key);
         }
@@ -731,7 +954,7 @@ void checkLongPressBackspace() {
             lastBackspaceTime = millis();
         } else if (millis() - lastBackspaceTime > 100) {
             // Repeat backspace every 100ms when held
-            if (sshConnected && sshChannel) {
+            if (sshConnected) {
                 sshSendKey(0x7F);
             }
             lastBackspaceTime = millis();
@@ -742,99 +965,405 @@ void checkLongPressBackspace() {
 }
 
 
-// Intro variables - static buffer instead of String
-static lv_obj_t *introScreen = NULL;
-static lv_obj_t *introLabel = NULL;
-#define INTRO_BUF_SIZE 512
-static char introBuffer[INTRO_BUF_SIZE];
-static int introBufPos = 0;
+// Resize the terminal model and tell the host through the session task
+static void resizeCommand(const String &cmd) {
+    int cols = 0, rows = 0;
+    if (sscanf(cmd.c_str() + 7, "%d %d", &cols, &rows) != 2 || cols < 20 || cols > 255 ||
+        rows < 4 || rows > 100) {
+        Serial.println("Usage: resize COLS ROWS (20-255 x 4-100)");
+        return;
+    }
+    int64_t t0 = esp_timer_get_time();
+    if (!terminalResize(cols, rows)) return;
+    Serial.printf("Terminal: %ux%u, redrawn in %lluus\n", cols, rows,
+                  (unsigned long long)(esp_timer_get_time() - t0));
+    sessionResize();
+}
 
-// Haptic feedback
-void hapticTick() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 10);
-    instance.drv.setWaveform(1, 0);
-    instance.drv.run();
+// Tell the host termModel's size; the session task sends it
+void sessionResize() {
+    if (!sshConnected) return;
+    if (session->resize == NULL) {
+        Serial.printf("%s: new size applies from the next connect\n", session->name);
+    }
+    sessionResizePending = true;
+    if (sshTaskHandle) xTaskNotifyGive(sshTaskHandle);
 }
 
-void hapticClick() {
-    if (!settings.hapticEnabled) return;
-    instance.drv.setWaveform(0, 1);
-    instance.drv.setWaveform(1, 0);
-    instance.drv.run();
-}
-
-// Clean, professional 2-second intro
-void showIntro() {
-    // Create intro screen
-    introScreen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(introScreen, lv_color_black(), 0);
-    lv_scr_load(introScreen);
-    lv_task_handler();
+// Serial console commands
+// "telnet HOST[:PORT] [raw]"
+static void setTelnetTarget(const String &cmd) {
+    String arg = cmd.substring(7);
+    arg.trim();
+    bool raw = arg.endsWith(" raw");
+    if (raw) {
+        arg = arg.substring(0, arg.length() - 4);
+        arg.trim();
+    }
+    if (arg.length() == 0 || arg.indexOf(' ') >= 0) {
+        Serial.println("Usage: telnet HOST[:PORT] [raw]");
+        return;
+    }
 
-    // Single haptic pulse on start
-    hapticClick();
-
-    // Create centered logo box
-    lv_obj_t *logoBox = lv_obj_create(introScreen);
-    lv_obj_set_size(logoBox, 300, 120);
-    lv_obj_center(logoBox);
-    lv_obj_set_style_bg_color(logoBox, lv_color_hex(0x0a0a0a), 0);
-    lv_obj_set_style_border_color(logoBox, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_border_width(logoBox, 2, 0);
-    lv_obj_set_style_radius(logoBox, 8, 0);
-    lv_obj_set_style_pad_all(logoBox, 10, 0);
-    lv_obj_set_style_shadow_color(logoBox, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_shadow_width(logoBox, 25, 0);
-    lv_obj_set_style_shadow_opa(logoBox, LV_OPA_60, 0);
-    lv_obj_set_style_opa(logoBox, 0, 0);  // Start invisible
-    lv_obj_remove_flag(logoBox, LV_OBJ_FLAG_SCROLLABLE);
-
-    // Title - T-LORA
-    lv_obj_t *titleLbl = lv_label_create(logoBox);
-    lv_obj_set_style_text_font(titleLbl, &lv_font_montserrat_28, 0);
-    lv_obj_set_style_text_color(titleLbl, lv_color_hex(0x00FF00), 0);
-    lv_label_set_text(titleLbl, "T-LORA");
-    lv_obj_align(titleLbl, LV_ALIGN_TOP_MID, 0, 5);
-
-    // Subtitle - PAGER
-    lv_obj_t *subLbl = lv_label_create(logoBox);
-    lv_obj_set_style_text_font(subLbl, &lv_font_montserrat_18, 0);
-    lv_obj_set_style_text_color(subLbl, lv_color_hex(0x00AA00), 0);
-    lv_label_set_text(subLbl, "PAGER");
-    lv_obj_align(subLbl, LV_ALIGN_CENTER, 0, 5);
-
-    // Version
-    lv_obj_t *verLbl = lv_label_create(logoBox);
-    lv_obj_set_style_text_font(verLbl, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_text_color(verLbl, lv_color_hex(0x555555), 0);
-    lv_label_set_text(verLbl, "Terminal v1.0");
-    lv_obj_align(verLbl, LV_ALIGN_BOTTOM_MID, 0, -5);
+    uint16_t port = 23;
+    int colon = arg.indexOf(':');
+    if (colon > 0) {
+        port = arg.substring(colon + 1).toInt();
+        arg = arg.substring(0, colon);
+    }
+    strlcpy(settings.telnet.host, arg.c_str(), sizeof(settings.telnet.host));
+    settings.telnet.port = port;
+    settings.telnet.raw = raw;
+    settingsSave();
+    Serial.printf("Telnet target: %s:%u%s (use with transport telnet)\n",
+                  settings.telnet.host, port, raw ? " raw TCP" : "");
+}
 
-    lv_task_handler();
+// "jump local|remote USER@HOST[:PORT] PASS" or "jump local|remote none"
+static void setJumpHost(const String &cmd) {
+    bool remote = cmd.startsWith("jump remote ");
+    ServerConfig_t *server = remote ? &settings.remoteServer : &settings.localServer;
+    String arg = cmd.substring(remote ? 12 : 11);
+    arg.trim();
+
+    JumpHostConfig_t jump;
+    memset(&jump, 0, sizeof(jump));
+    jump.port = 22;
+    if (arg != "none") {
+        int at = arg.indexOf('@');
+        int sp = arg.indexOf(' ');
+        if (at <= 0 || sp < at) {
+            Serial.println("Usage: jump local|remote USER@HOST[:PORT] PASS | none");
+            return;
+        }
+        String user = arg.substring(0, at);
+        String host = arg.substring(at + 1, sp);
+        String pass = arg.substring(sp + 1);
+        int colon = host.indexOf(':');
+        if (colon > 0) {
+            jump.port = host.substring(colon + 1).toInt();
+            host = host.substring(0, colon);
+        }
+        strlcpy(jump.username, user.c_str(), sizeof(jump.username));
+        strlcpy(jump.host, host.c_str(), sizeof(jump.host));
+        strlcpy(jump.password, pass.c_str(), sizeof(jump.password));
+    }
+
+    server->jump = jump;
+    settingsSave();
+    if (strlen(jump.host) > 0) {
+        Serial.printf("%s server via %s@%s:%u\n", remote ? "Remote" : "Local",
+                      jump.username, jump.host, jump.port);
+    } else {
+        Serial.printf("%s server: direct\n", remote ? "Remote" : "Local");
+    }
+}
 
-    // Fade in
-    for (int i = 0; i <= 255; i += 17) {
-        lv_obj_set_style_opa(logoBox, i > 255 ? 255 : i, 0);
+static void soakPump(uint32_t ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) {
         lv_task_handler();
-        delay(10);
+        delay(5);
     }
-    lv_obj_set_style_opa(logoBox, 255, 0);
-    lv_task_handler();
+}
 
-    // Hold
-    delay(1000);
+static void soakStartIteration() {
+    soakState = SOAK_CONNECTING;
+    soakPhaseMs = millis();
+    connectToServer();
+}
 
-    // Fade out
-    for (int i = 255; i >= 0; i -= 17) {
-        lv_obj_set_style_opa(logoBox, i < 0 ? 0 : i, 0);
-        lv_task_handler();
-        delay(10);
+static void soakCommand(const String &cmd) {
+    if (cmd == "soak stop") {
+        if (soakState != SOAK_IDLE) {
+            soakState = SOAK_IDLE;
+            sshDisconnect();
+            soakPrintSummary();
+        }
+        return;
+    }
+    if (soakState != SOAK_IDLE) {
+        Serial.printf("Soak: iteration %u running (soak stop to end)\n", (unsigned)soakIterations() + 1);
+        return;
+    }
+    if (sshConnected || sshConnecting) {
+        Serial.println("Soak: disconnect first");
+        return;
+    }
+    soakTarget = cmd.length() > 5 ? cmd.substring(5).toInt() : 0;
+    if (soakTarget > 0) {
+        Serial.printf("Soak: %u iterations\n", (unsigned)soakTarget);
+    } else {
+        Serial.println("Soak: until soak stop");
     }
+    soakBegin();
+    soakStartIteration();
+}
+
+// One step of the soak cycle per loop()
+void soakLoop() {
+    unsigned long now = millis();
+
+    switch (soakState) {
+        case SOAK_IDLE:
+            return;
+
+        case SOAK_CONNECTING:
+            if (sshConnected) {
+                soakRecord(SOAK_CONNECT_MS, now - soakPhaseMs);
+                sshSendData(SOAK_BULK_CMD, strlen(SOAK_BULK_CMD));
+                soakLastBytes = pipelineStats.renderBytes;
+                soakLastBytesMs = now;
+                soakPhaseMs = now;
+                soakState = SOAK_RECEIVING;
+            } else if ((sshTaskHandle == NULL && now - soakPhaseMs > 100) ||
+                       now - soakPhaseMs > SOAK_CONNECT_TIMEOUT_MS) {
+                Serial.println("Soak: connect failed");
+                soakConnectFailed();
+                sshDisconnect();
+                soakPhaseMs = now;
+                soakState = SOAK_DISCONNECTING;
+            }
+            break;
+
+        case SOAK_RECEIVING:
+            if (pipelineStats.renderBytes != soakLastBytes) {
+                soakLastBytes = pipelineStats.renderBytes;
+                soakLastBytesMs = now;
+            }
+            if (now - soakLastBytesMs > SOAK_QUIET_MS || now - soakPhaseMs > SOAK_BULK_TIMEOUT_MS || !sshConnected) {
+                soakExerciseUi(soakPump);
+                loadConfigAndProfile();
+                sshDisconnect();
+                soakPhaseMs = millis();
+                soakState = SOAK_DISCONNECTING;
+            }
+            break;
+
+        case SOAK_DISCONNECTING:
+            if (sshTaskHandle == NULL) {
+                soakPhaseMs = now;
+                soakState = SOAK_SETTLING;
+            }
+            break;
+
+        case SOAK_SETTLING:
+            if (now - soakPhaseMs < SOAK_SETTLE_MS) break;
+            soakSampleMemory();
+            soakRecord(SOAK_STACK_LOOP, uxTaskGetStackHighWaterMark(NULL));
+            if (sessionStackFree > 0) soakRecord(SOAK_STACK_SESSION, sessionStackFree);
+            if (!soakEndIteration() || (soakTarget > 0 && soakIterations() >= soakTarget)) {
+                soakPrintSummary();
+                soakState = SOAK_IDLE;
+            } else {
+                soakStartIteration();
+            }
+            break;
+    }
+}
+
+void handleSerialCommands() {
+    if (!Serial.available()) return;
 
-    hapticClick();
+    // Binary frame from tools/hil_bench.py
+    if (Serial.peek() == HIL_SYNC0) {
+        hilPoll();
+        return;
+    }
+
+    String cmd = Serial.readStringUntil('\n');
+    cmd.trim();
+    if (cmd.length() == 0) return;
+    serialCommand(cmd);
+}
+
+void serialCommand(const String &cmd) {
+    if (cmd == "selftest") {
+        benchRenderSelfTest();
+    } else if (cmd == "bench render") {
+        benchRenderKernels();
+    } else if (cmd == "bench watch") {
+        benchWatcher();
+    } else if (cmd == "bench scroll") {
+        benchJumpScroll();
+    } else if (cmd == "bench session") {
+        if (sshConnected || sshConnecting) {
+            Serial.println("Disconnect first");
+        } else {
+            benchSession(selectServer(), &configLoader.getConfigMutable().gateway);
+        }
+    } else if (cmd == "bench tls") {
+        if (sshConnected || sshConnecting) {
+            Serial.println("Disconnect first");
+        } else {
+            benchTls(&configLoader.getConfigMutable().gateway);
+        }
+    } else if (cmd == "bench kex") {
+        if (sshConnected || sshConnecting) {
+            Serial.println("Disconnect first");
+        } else {
+            benchKex(selectServer());
+        }
+    } else if (cmd == "config") {
+        configLoader.printConfig();
+    } else if (cmd == "profiles") {
+        configLoader.listProfiles();
+    } else if (cmd.startsWith("profile ")) {
+        String name = cmd.substring(8);
+        if (configLoader.loadGatewayProfile(name.c_str())) {
+            Serial.println("Profile loaded, used on next ttyd connect");
+        } else {
+            Serial.println("Profile not found");
+        }
+    } else if (cmd == "reload") {
+        loadConfigAndProfile();
+        hapticsConfigure(configLoader.getConfig().haptics);
+        Serial.println("Config reloaded");
+    } else if (cmd == "transport ssh" || cmd == "transport ttyd" || cmd == "transport mosh" ||
+               cmd == "transport telnet") {
+        settings.transport = cmd.endsWith("ttyd") ? TRANSPORT_TTYD :
+                             cmd.endsWith("mosh") ? TRANSPORT_MOSH :
+                             cmd.endsWith("telnet") ? TRANSPORT_TELNET : TRANSPORT_SSH;
+        settingsSave();
+        Serial.printf("Transport: %s (on next connect)\n", cmd.substring(10).c_str());
+    } else if (cmd == "stats") {
+        statsPrint();
+    } else if (cmd == "stats reset") {
+        statsReset();
+    } else if (cmd == "watch") {
+        watcherPrintStatus();
+    } else if (cmd == "tls") {
+        tlsCachePrintStatus();
+    } else if (cmd == "tls clear") {
+        tlsCacheClear();
+    } else if (cmd == "bench jump") {
+        if (sshConnected || sshConnecting) {
+            Serial.println("Disconnect first");
+        } else {
+            benchJump(selectServer());
+        }
+    } else if (cmd == "jump") {
+        jumpPrintStatus();
+    } else if (cmd == "jump off") {
+        if (sshConnected || sshConnecting) {
+            Serial.println("Disconnect first");
+        } else {
+            jumpDisconnect();
+        }
+    } else if (cmd.startsWith("jump local ") || cmd.startsWith("jump remote ")) {
+        setJumpHost(cmd);
+    } else if (cmd == "mosh") {
+        moshPrintStatus();
+    } else if (cmd == "telnet") {
+        telnetPrintStatus();
+    } else if (cmd.startsWith("telnet ")) {
+        setTelnetTarget(cmd);
+    } else if (cmd.startsWith("resize ")) {
+        resizeCommand(cmd);
+    } else if (cmd == "line") {
+        lineEditPrintStatus();
+    } else if (cmd == "line on" || cmd == "line off") {
+        lineEditSetEnabled(cmd == "line on");
+        updateStatusWithRSSI();
+    } else if (cmd == "dns") {
+        dnsPrintStatus();
+    } else if (cmd == "dns clear") {
+        dnsClear();
+    } else if (cmd == "dns prefetch") {
+        prefetchHosts();
+    } else if (cmd == "bench ui") {
+        benchUi();
+    } else if (cmd == "kex") {
+        kexPrecomputePrintStatus();
+    } else if (cmd == "kex on" || cmd == "kex off") {
+        kexPrecomputeSetEnabled(cmd == "kex on");
+        kexPrecomputePrintStatus();
+    } else if (cmd == "haptics") {
+        hapticsPrintStats();
+    } else if (cmd == "audio") {
+        audioPrintStats();
+    } else if (cmd == "sixel") {
+        terminalImageStats();
+    } else if (cmd == "core") {
+        crashDumpPrintStatus();
+    } else if (cmd == "core erase") {
+        crashDumpErase();
+    } else if (cmd == "soak" || cmd.startsWith("soak ")) {
+        soakCommand(cmd);
+    } else if (cmd == "help") {
+        Serial.println("Commands:");
+        Serial.println("  selftest      - Check render kernels against scalar reference");
+        Serial.println("  bench render  - Render kernel throughput (px/us)");
+        Serial.println("  bench watch   - Output watcher overhead on RX corpus");
+        Serial.println("  bench scroll  - cat bigfile throughput, normal vs jump scroll");
+        Serial.println("  bench session - SSH vs ttyd connect time and throughput");
+        Serial.println("  bench tls     - Full vs resumed TLS handshake to the gateway");
+        Serial.println("  bench kex     - SSH connect phases, kex key inline vs precomputed");
+        Serial.println("  config        - Print current configuration");
+        Serial.println("  profiles      - List gateway profiles");
+        Serial.println("  profile NAME  - Load gateway profile");
+        Serial.println("  reload        - Reload config from filesystem");
+        Serial.println("  transport ssh|ttyd|mosh|telnet - Session transport for the next connect");
+        Serial.println("  watch         - Show watch patterns and alert counts");
+        Serial.println("  tls           - Show cached TLS sessions");
+        Serial.println("  tls clear     - Forget all TLS sessions (RAM and NVS)");
+        Serial.println("  kex [on|off]  - Kex keypair precompute status / toggle");
+        Serial.println("  dns           - Show cached host addresses");
+        Serial.println("  dns clear     - Forget all addresses (RAM and NVS)");
+        Serial.println("  dns prefetch  - Resolve all configured hosts in the background");
+        Serial.println("  bench jump    - Connect via jump host, new vs reused bastion session");
+        Serial.println("  jump          - Bastion session status");
+        Serial.println("  jump off      - Close the bastion session");
+        Serial.println("  jump local|remote USER@HOST[:PORT] PASS | none - Set jump host");
+        Serial.println("  mosh          - mosh session RTT, loss and state counters");
+        Serial.println("  line [on|off] - Local line editing status / toggle (also rotary+L)");
+        Serial.println("  resize C R    - Terminal size in columns x rows (scrollback rewraps)");
+        Serial.println("  telnet        - Telnet session options and byte counts");
+        Serial.println("  telnet HOST[:PORT] [raw] - Set the telnet / raw TCP target");
+        Serial.println("  bench ui      - Terminal screen create time, generated C vs XML");
+        Serial.println("  stats         - RX pipeline counters and bottleneck");
+        Serial.println("  stats reset   - Start a new stats window");
+        Serial.println("  haptics       - Haptic events played / rate-limited, I2C time");
+        Serial.println("  audio         - Key clicks / bells played and coalesced, trigger cost");
+        Serial.println("  sixel         - Image tile cache use, placeholders, decode work");
+        Serial.println("  core [erase]  - Stored crash dump summary and heap at the crash / forget it");
+        Serial.println("  soak [N|stop] - Connect/receive/menus/disconnect loop, N iterations (0 = until stopped)");
+    } else {
+        Serial.printf("Unknown command: %s\n", cmd.c_str());
+    }
+}
+
+// Haptic feedback (queued, see haptics.h)
+void hapticClick() {
+    hapticPlay(HAPTIC_CLICK);
+}
+
+// Turn watcher matches from the SSH task into haptics + status badge
+void processWatcher() {
+    int match = watcherTakeMatch();
+    if (match < 0) return;
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "! %s", watcherPatternName(match));
+    terminalSetAlert(buf);
+
+    // One buzz per burst, not one per matching line
+    hapticPlay(HAPTIC_ALERT);
+}
+
+// Offer the stored core dump once per SSH connect, and report the upload
+void processCrashDump() {
+    bool sshSession = session == &sshTransport || session == &moshTransport;
+    if (!sshConnected) {
+        crashOffered = false;
+    } else if (!crashOffered && sshSession && crashDumpPending()) {
+        crashOffered = true;
+        terminalSetAlert("! crash dump: rotary+U uploads");
+        hapticPlay(HAPTIC_ALERT);
+    }
 
-    // Clean up
-    lv_obj_del(introScreen);
-    introScreen = NULL;
+    int8_t result = crashUploadResult;
+    if (result < 0) return;
+    crashUploadResult = -1;
+    terminalSetAlert(result ? "Crash dump uploaded (" CRASH_UPLOAD_DIR "/)" : "! crash dump upload failed");
 }
@@ -0,0 +1,235 @@
+/**
+ * TLS Client Implementation
+ */
+
+#include "tls_client.h"
+#include "tls_session_cache.h"
+#include "net_connect.h"
+#include <esp_timer.h>
+#include <mbedtls/version.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/error.h>
+
+#if MBEDTLS_VERSION_MAJOR >= 3
+#define TLS_STATE(ssl) ((ssl).MBEDTLS_PRIVATE(state))
+#else
+#define TLS_STATE(ssl) ((ssl).state)
+#endif
+
+// One RNG for all connections (seeding is slow)
+static mbedtls_entropy_context entropy;
+static mbedtls_ctr_drbg_context drbg;
+static bool rngReady = false;
+
+static bool tlsRngInit() {
+    if (rngReady) return true;
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+    const char *pers = "tlora_tls";
+    if (mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy,
+                              (const uint8_t *)pers, strlen(pers)) != 0) {
+        return false;
+    }
+    rngReady = true;
+    return true;
+}
+
+TlsClient::TlsClient()
+    : _active(false), _connected(false), _peek(-1),
+      _tcpUs(0), _handshakeUs(0), _resumed(false) {
+    mbedtls_net_init(&_net);
+}
+
+TlsClient::~TlsClient() {
+    stop();
+}
+
+void TlsClient::release() {
+    mbedtls_net_free(&_net);
+    if (_active) {
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_config_free(&_conf);
+        _active = false;
+    }
+    _connected = false;
+    _peek = -1;
+}
+
+int TlsClient::connect(const char *host, uint16_t port, const char *sni, uint32_t timeoutMs) {
+    stop();
+    _resumed = false;
+    _tcpUs = _handshakeUs = 0;
+    if (sni == NULL || *sni == '\0') sni = host;
+
+    if (!tlsRngInit()) {
+        Serial.println("TLS: RNG init failed");
+        return 0;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    _net.fd = netConnect(host, port, timeoutMs);
+    if (_net.fd < 0) {
+        release();
+        return 0;
+    }
+    int64_t t1 = esp_timer_get_time();
+    _tcpUs = t1 - t0;
+
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_ssl_config_init(&_conf);
+    _active = true;
+
+    int rc = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT,
+                                         MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (rc != 0) {
+        release();
+        return 0;
+    }
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &drbg);
+    mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    mbedtls_ssl_conf_read_timeout(&_conf, timeoutMs);
+
+    if (mbedtls_ssl_setup(&_ssl, &_conf) != 0 || mbedtls_ssl_set_hostname(&_ssl, sni) != 0) {
+        release();
+        return 0;
+    }
+
+    // Offer the cached session for this host
+    char key[80];
+    snprintf(key, sizeof(key), "%s:%u", sni, port);
+    mbedtls_ssl_session cached;
+    mbedtls_ssl_session_init(&cached);
+    bool offered = tlsCacheGet(key, &cached) && mbedtls_ssl_set_session(&_ssl, &cached) == 0;
+    mbedtls_ssl_session_free(&cached);
+
+    // Blocking reads with a timeout during the handshake. A server
+    // Certificate message means the server did a full handshake.
+    mbedtls_ssl_set_bio(&_ssl, &_net, mbedtls_net_send, NULL, mbedtls_net_recv_timeout);
+    bool fullHandshake = false;
+    while (TLS_STATE(_ssl) != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        rc = mbedtls_ssl_handshake_step(&_ssl);
+        if (TLS_STATE(_ssl) == MBEDTLS_SSL_SERVER_CERTIFICATE) fullHandshake = true;
+        if (rc != 0 && rc != MBEDTLS_ERR_SSL_WANT_READ && rc != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+        if (esp_timer_get_time() - t1 > (int64_t)timeoutMs * 1000) {
+            rc = MBEDTLS_ERR_SSL_TIMEOUT;
+            break;
+        }
+    }
+    if (rc != 0) {
+        char err[80];
+        mbedtls_strerror(rc, err, sizeof(err));
+        Serial.printf("TLS: Handshake with %s failed: %s\n", sni, err);
+        // A session the server chokes on is not worth offering again
+        if (offered) tlsCacheForget(key);
+        release();
+        return 0;
+    }
+    _handshakeUs = esp_timer_get_time() - t1;
+    _resumed = offered && !fullHandshake;
+
+    // Keep the fresh ticket / session ID for the next connect
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    if (mbedtls_ssl_get_session(&_ssl, &session) == 0) {
+        tlsCachePut(key, &session);
+    }
+    mbedtls_ssl_session_free(&session);
+
+    // Non-blocking from here on: available()/read() must not stall the task
+    mbedtls_net_set_nonblock(&_net);
+    mbedtls_ssl_set_bio(&_ssl, &_net, mbedtls_net_send, mbedtls_net_recv, NULL);
+    _connected = true;
+    return 1;
+}
+
+int TlsClient::connect(const char *host, uint16_t port) {
+    return connect(host, port, NULL, TLS_DEFAULT_TIMEOUT_MS);
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port, NULL, TLS_DEFAULT_TIMEOUT_MS);
+}
+
+size_t TlsClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t TlsClient::write(const uint8_t *buf, size_t size) {
+    if (!_connected) return 0;
+
+    size_t sent = 0;
+    unsigned long start = millis();
+    while (sent < size) {
+        int rc = mbedtls_ssl_write(&_ssl, buf + sent, size - sent);
+        if (rc > 0) {
+            sent += rc;
+        } else if (rc == MBEDTLS_ERR_SSL_WANT_WRITE || rc == MBEDTLS_ERR_SSL_WANT_READ) {
+            if (millis() - start > TLS_DEFAULT_TIMEOUT_MS) break;
+            delay(1);
+        } else {
+            _connected = false;
+            break;
+        }
+    }
+    return sent;
+}
+
+int TlsClient::available() {
+    if (!_connected) return _peek >= 0 ? 1 : 0;
+
+    int n = mbedtls_ssl_get_bytes_avail(&_ssl);
+    if (n == 0) {
+        // Pull in the next record, if one has arrived
+        int rc = mbedtls_ssl_read(&_ssl, NULL, 0);
+        if (rc < 0 && rc != MBEDTLS_ERR_SSL_WANT_READ && rc != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            _connected = false;
+        }
+        n = mbedtls_ssl_get_bytes_avail(&_ssl);
+    }
+    return n + (_peek >= 0 ? 1 : 0);
+}
+
+int TlsClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsClient::read(uint8_t *buf, size_t size) {
+    if (size == 0) return 0;
+
+    int got = 0;
+    if (_peek >= 0) {
+        buf[got++] = (uint8_t)_peek;
+        _peek = -1;
+        if (size == 1) return 1;
+    }
+    if (!_connected) return got > 0 ? got : -1;
+
+    int rc = mbedtls_ssl_read(&_ssl, buf + got, size - got);
+    if (rc > 0) return got + rc;
+    if (rc != MBEDTLS_ERR_SSL_WANT_READ && rc != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        _connected = false;  // Close notify, EOF or error
+    }
+    return got > 0 ? got : -1;
+}
+
+int TlsClient::peek() {
+    if (_peek < 0) {
+        uint8_t b;
+        if (read(&b, 1) == 1) _peek = b;
+    }
+    return _peek;
+}
+
+void TlsClient::stop() {
+    if (_connected) {
+        mbedtls_ssl_close_notify(&_ssl);
+    }
+    release();
+}
+
+uint8_t TlsClient::connected() {
+    return _connected || _peek >= 0;
+}
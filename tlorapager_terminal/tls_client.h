@@ -0,0 +1,62 @@
+/**
+ * TLS Client for T-LoRa Pager Terminal
+ * mbedTLS client with session resumption (see tls_session_cache.h)
+ *
+ * WiFiClientSecure gives no access to the mbedTLS session, so every
+ * reconnect paid for a full handshake. This client offers the cached
+ * ticket/session ID for the host and refreshes the cache afterwards.
+ * Like WiFiClientSecure::setInsecure(), the server is not verified.
+ */
+
+#ifndef TLS_CLIENT_H
+#define TLS_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+
+#define TLS_DEFAULT_TIMEOUT_MS 5000
+
+class TlsClient : public Client {
+public:
+    TlsClient();
+    ~TlsClient();
+
+    // TCP connect and handshake within timeoutMs, presenting sni (host
+    // if NULL). The cached session for sni:port is offered.
+    int connect(const char *host, uint16_t port, const char *sni, uint32_t timeoutMs);
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    // Timings of the last connect, and whether the handshake was abbreviated
+    uint32_t tcpUs() const { return _tcpUs; }
+    uint32_t handshakeUs() const { return _handshakeUs; }
+    bool resumed() const { return _resumed; }
+
+private:
+    mbedtls_ssl_context _ssl;
+    mbedtls_ssl_config _conf;
+    mbedtls_net_context _net;
+    bool _active;       // _ssl/_conf need freeing
+    bool _connected;
+    int _peek;          // Byte held by peek(), -1 if none
+    uint32_t _tcpUs;
+    uint32_t _handshakeUs;
+    bool _resumed;
+
+    void release();
+};
+
+#endif // TLS_CLIENT_H
@@ -0,0 +1,169 @@
+/**
+ * TLS Session Cache Implementation
+ */
+
+#include "tls_session_cache.h"
+#include <Preferences.h>
+
+typedef struct {
+    char key[72];
+    uint8_t *blob;       // mbedtls_ssl_session_save() output
+    uint16_t len;
+    uint32_t lastUsed;
+    uint32_t hits;
+} TlsCacheSlot_t;
+
+static TlsCacheSlot_t slots[TLS_CACHE_SLOTS];
+static Preferences cachePrefs;
+static bool nvsOpen = false;
+static uint32_t useCounter = 0;
+static uint32_t misses = 0;
+
+static bool cacheNvsOpen() {
+    if (!nvsOpen) {
+        nvsOpen = cachePrefs.begin(TLS_CACHE_NVS_NAMESPACE, false);
+    }
+    return nvsOpen;
+}
+
+// NVS keys are limited to 15 characters: hash the host name
+static void nvsKeyFor(const char *key, char *out, size_t cap) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (const char *p = key; *p; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    snprintf(out, cap, "s%08x", (unsigned)h);
+}
+
+static TlsCacheSlot_t *findSlot(const char *key) {
+    for (int i = 0; i < TLS_CACHE_SLOTS; i++) {
+        if (slots[i].blob && strcmp(slots[i].key, key) == 0) return &slots[i];
+    }
+    return NULL;
+}
+
+// Free slot, or the least recently used one
+static TlsCacheSlot_t *claimSlot(const char *key) {
+    TlsCacheSlot_t *victim = &slots[0];
+    for (int i = 0; i < TLS_CACHE_SLOTS; i++) {
+        if (!slots[i].blob) {
+            victim = &slots[i];
+            break;
+        }
+        if (slots[i].lastUsed < victim->lastUsed) victim = &slots[i];
+    }
+    free(victim->blob);
+    memset(victim, 0, sizeof(*victim));
+    strlcpy(victim->key, key, sizeof(victim->key));
+    return victim;
+}
+
+static bool slotStore(TlsCacheSlot_t *slot, const uint8_t *data, size_t len) {
+    uint8_t *blob = (uint8_t *)realloc(slot->blob, len);
+    if (!blob) return false;
+    memcpy(blob, data, len);
+    slot->blob = blob;
+    slot->len = len;
+    slot->lastUsed = ++useCounter;
+    return true;
+}
+
+bool tlsCacheGet(const char *key, mbedtls_ssl_session *session) {
+    TlsCacheSlot_t *slot = findSlot(key);
+
+    // Not in RAM: try what the last boot left in NVS
+    if (!slot && cacheNvsOpen()) {
+        char nvsKey[16];
+        nvsKeyFor(key, nvsKey, sizeof(nvsKey));
+        size_t len = cachePrefs.getBytesLength(nvsKey);
+        if (len > 0 && len <= TLS_CACHE_BLOB_MAX) {
+            uint8_t *buf = (uint8_t *)malloc(len);
+            if (buf && cachePrefs.getBytes(nvsKey, buf, len) == len) {
+                slot = claimSlot(key);
+                if (!slotStore(slot, buf, len)) {
+                    memset(slot, 0, sizeof(*slot));
+                    slot = NULL;
+                }
+            }
+            free(buf);
+        }
+    }
+
+    if (!slot) {
+        misses++;
+        return false;
+    }
+
+    if (mbedtls_ssl_session_load(session, slot->blob, slot->len) != 0) {
+        // Saved by a different mbedTLS build/config: unusable
+        Serial.printf("TLS: Dropping stale session for %s\n", key);
+        tlsCacheForget(key);
+        misses++;
+        return false;
+    }
+    slot->lastUsed = ++useCounter;
+    slot->hits++;
+    return true;
+}
+
+void tlsCachePut(const char *key, const mbedtls_ssl_session *session) {
+    size_t len = 0;
+    uint8_t *buf = (uint8_t *)malloc(TLS_CACHE_BLOB_MAX);
+    if (!buf) return;
+
+    int rc = mbedtls_ssl_session_save(session, buf, TLS_CACHE_BLOB_MAX, &len);
+    if (rc != 0 || len == 0) {
+        Serial.printf("TLS: Session for %s not cached (-0x%04x)\n", key, (unsigned)-rc);
+        free(buf);
+        return;
+    }
+
+    // Servers reissue tickets on every handshake; only write NVS on change
+    TlsCacheSlot_t *slot = findSlot(key);
+    bool changed = !slot || slot->len != len || memcmp(slot->blob, buf, len) != 0;
+    if (!slot) slot = claimSlot(key);
+    uint32_t hits = slot->hits;
+    slotStore(slot, buf, len);
+    slot->hits = hits;
+
+    if (changed && cacheNvsOpen()) {
+        char nvsKey[16];
+        nvsKeyFor(key, nvsKey, sizeof(nvsKey));
+        cachePrefs.putBytes(nvsKey, buf, len);
+    }
+    free(buf);
+}
+
+void tlsCacheForget(const char *key) {
+    TlsCacheSlot_t *slot = findSlot(key);
+    if (slot) {
+        free(slot->blob);
+        memset(slot, 0, sizeof(*slot));
+    }
+    if (cacheNvsOpen()) {
+        char nvsKey[16];
+        nvsKeyFor(key, nvsKey, sizeof(nvsKey));
+        cachePrefs.remove(nvsKey);
+    }
+}
+
+void tlsCacheClear() {
+    for (int i = 0; i < TLS_CACHE_SLOTS; i++) {
+        free(slots[i].blob);
+        memset(&slots[i], 0, sizeof(slots[i]));
+    }
+    if (cacheNvsOpen()) {
+        cachePrefs.clear();
+    }
+    misses = 0;
+    Serial.println("TLS: Session cache cleared");
+}
+
+void tlsCachePrintStatus() {
+    Serial.printf("TLS session cache (%d slots, %u misses)\n", TLS_CACHE_SLOTS, (unsigned)misses);
+    for (int i = 0; i < TLS_CACHE_SLOTS; i++) {
+        if (!slots[i].blob) continue;
+        Serial.printf("  %-40s %5u bytes  %u hits\n",
+                      slots[i].key, slots[i].len, (unsigned)slots[i].hits);
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * TLS Session Cache for T-LoRa Pager Terminal
+ * Session tickets / IDs per host, in RAM and in NVS across reboots
+ *
+ * Keys are "host:port" (SNI name when set). A cached session lets the
+ * next connect do an abbreviated handshake instead of a full one.
+ */
+
+#ifndef TLS_SESSION_CACHE_H
+#define TLS_SESSION_CACHE_H
+
+#include <Arduino.h>
+#include <mbedtls/ssl.h>
+
+#define TLS_CACHE_SLOTS 4              // Hosts kept in RAM
+#define TLS_CACHE_BLOB_MAX 2048        // Largest serialized session kept
+#define TLS_CACHE_NVS_NAMESPACE "tls_cache"
+
+// Restore the session for key into an initialized session object.
+// Checks RAM first, then NVS. Returns false if nothing is cached.
+bool tlsCacheGet(const char *key, mbedtls_ssl_session *session);
+
+// Remember the session of a completed handshake (RAM, and NVS if changed)
+void tlsCachePut(const char *key, const mbedtls_ssl_session *session);
+
+// Drop one host, or everything (RAM and NVS)
+void tlsCacheForget(const char *key);
+void tlsCacheClear();
+
+// Print cached hosts and hit counts to Serial
+void tlsCachePrintStatus();
+
+#endif // TLS_SESSION_CACHE_H
@@ -0,0 +1,426 @@
+/**
+ * ttyd Session Transport Implementation
+ */
+
+#include "ttyd_transport.h"
+#include "ConfigLoader.h"
+#include "tls_client.h"
+#include <WiFi.h>
+#include <esp_random.h>
+#include <esp_timer.h>
+#include <strings.h>
+#include <mbedtls/version.h>
+#include <mbedtls/base64.h>
+#include <mbedtls/sha1.h>
+
+// WebSocket opcodes (RFC 6455)
+#define WS_OP_CONT   0x0
+#define WS_OP_TEXT   0x1
+#define WS_OP_BINARY 0x2
+#define WS_OP_CLOSE  0x8
+#define WS_OP_PING   0x9
+#define WS_OP_PONG   0xA
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+static WiFiClient plainClient;
+static TlsClient tlsClient;
+static Client *conn = NULL;
+
+static bool wsOpen = false;
+static bool debugWs = false;
+static uint32_t pingIntervalMs = 0;
+static unsigned long lastRxMs = 0;
+static unsigned long lastPingMs = 0;
+
+// Incoming frame parser
+static uint8_t rxHdr[14];
+static uint8_t rxHdrLen = 0;
+static uint8_t rxHdrNeed = 2;
+static bool rxInPayload = false;
+static uint8_t rxOpcode = 0;
+static uint32_t rxRemaining = 0;   // Payload bytes left in this frame
+static bool rxMasked = false;
+static uint8_t rxMask[4];
+static uint32_t rxMaskPos = 0;
+static char rxCommand = 0;         // ttyd type of the current message, 0 = not read yet
+static uint8_t rxCtrl[125];        // Control frame payload
+static uint8_t rxCtrlLen = 0;
+
+// Ready for the next frame header (rxCommand carries over to continuations)
+static void rxReset() {
+    rxHdrLen = 0;
+    rxHdrNeed = 2;
+    rxInPayload = false;
+}
+
+static void rxUnmask(uint8_t *data, int len) {
+    if (!rxMasked) return;
+    for (int i = 0; i < len; i++) {
+        data[i] ^= rxMask[rxMaskPos++ & 3];
+    }
+}
+
+// One masked frame per call: header, optional ttyd type byte, payload
+static bool sendFrame(uint8_t opcode, char cmd, const uint8_t *data, size_t len) {
+    uint8_t frame[8 + 1 + TTYD_TX_MAX];
+    size_t plen = len + (cmd ? 1 : 0);
+    if (plen > 1 + TTYD_TX_MAX) return false;
+
+    size_t pos = 0;
+    frame[pos++] = 0x80 | opcode;
+    if (plen < 126) {
+        frame[pos++] = 0x80 | plen;
+    } else {
+        frame[pos++] = 0x80 | 126;
+        frame[pos++] = plen >> 8;
+        frame[pos++] = plen & 0xFF;
+    }
+
+    uint32_t key = esp_random();
+    uint8_t *mask = frame + pos;
+    memcpy(mask, &key, 4);
+    pos += 4;
+
+    for (size_t k = 0; k < plen; k++) {
+        uint8_t b = cmd ? (k == 0 ? (uint8_t)cmd : data[k - 1]) : data[k];
+        frame[pos + k] = b ^ mask[k & 3];
+    }
+    pos += plen;
+
+    return conn->write(frame, pos) == pos;
+}
+
+// Read the HTTP upgrade response, stopping exactly at the blank line
+static bool readHttpResponse(char *buf, size_t cap, uint32_t timeoutMs) {
+    size_t len = 0;
+    unsigned long start = millis();
+
+    while (millis() - start < timeoutMs) {
+        if (!conn->available()) {
+            if (!conn->connected()) return false;
+            delay(1);
+            continue;
+        }
+        int c = conn->read();
+        if (c < 0) continue;
+        if (len + 1 >= cap) return false;
+        buf[len++] = (char)c;
+        buf[len] = '\0';
+        if (len >= 4 && memcmp(buf + len - 4, "\r\n\r\n", 4) == 0) return true;
+    }
+    return false;
+}
+
+// Value of a response header (case-insensitive name), NULL if absent
+static const char *httpHeader(const char *resp, const char *name) {
+    size_t n = strlen(name);
+    const char *line = strstr(resp, "\r\n");
+    while (line) {
+        line += 2;
+        if (strncasecmp(line, name, n) == 0 && line[n] == ':') {
+            const char *value = line + n + 1;
+            while (*value == ' ') value++;
+            return value;
+        }
+        line = strstr(line, "\r\n");
+    }
+    return NULL;
+}
+
+// Sec-WebSocket-Accept for our key
+static void wsAcceptKey(const char *key, char *out, size_t cap) {
+    char input[64];
+    uint8_t digest[20];
+    size_t olen = 0;
+
+    snprintf(input, sizeof(input), "%s%s", key, WS_GUID);
+#if MBEDTLS_VERSION_MAJOR >= 3
+    mbedtls_sha1((const uint8_t *)input, strlen(input), digest);
+#else
+    mbedtls_sha1_ret((const uint8_t *)input, strlen(input), digest);
+#endif
+    mbedtls_base64_encode((uint8_t *)out, cap - 1, &olen, digest, sizeof(digest));
+    out[olen] = '\0';
+}
+
+static bool ttydConnect(GatewayConfig *gw, uint32_t timeoutMs) {
+    if (!gw->useSsl) {
+        conn = &plainClient;
+        if (!plainClient.connect(gw->host.c_str(), gw->port, timeoutMs)) return false;
+        plainClient.setNoDelay(true);  // Keystrokes should not wait for Nagle
+        return true;
+    }
+
+    // As with SSH host keys, the device does not verify the gateway.
+    // TlsClient resumes the cached session for this host when it can.
+    conn = &tlsClient;
+    return tlsClient.connect(gw->host.c_str(), gw->port,
+                             gw->sni.length() > 0 ? gw->sni.c_str() : NULL, timeoutMs);
+}
+
+static bool ttydOpen(void *target, uint16_t cols, uint16_t rows) {
+    GatewayConfig *gw = (GatewayConfig *)target;
+    uint32_t timeoutMs = gw->connectTimeoutMs ? gw->connectTimeoutMs : 4000;
+    const char *hostName = gw->sni.length() > 0 ? gw->sni.c_str() : gw->host.c_str();
+
+    debugWs = configLoader.getConfig().logging.debugWebSocket;
+    pingIntervalMs = gw->pingIntervalMs;
+    wsOpen = false;
+    rxReset();
+    rxCommand = 0;
+
+    Serial.printf("ttyd: Connecting to %s://%s:%d%s\n",
+                  gw->useSsl ? "wss" : "ws", gw->host.c_str(), gw->port, gw->path.c_str());
+
+    int64_t t0 = esp_timer_get_time();
+    if (!ttydConnect(gw, timeoutMs)) {
+        Serial.println("ttyd: Connection failed");
+        conn->stop();
+        return false;
+    }
+    int64_t t1 = esp_timer_get_time();
+
+    // HTTP upgrade with the "tty" subprotocol
+    uint8_t nonce[16];
+    char key[32];
+    size_t klen = 0;
+    esp_fill_random(nonce, sizeof(nonce));
+    mbedtls_base64_encode((uint8_t *)key, sizeof(key) - 1, &klen, nonce, sizeof(nonce));
+    key[klen] = '\0';
+
+    char req[384];
+    int n = snprintf(req, sizeof(req),
+                     "GET %s HTTP/1.1\r\n"
+                     "Host: %s:%u\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Key: %s\r\n"
+                     "Sec-WebSocket-Version: 13\r\n"
+                     "Sec-WebSocket-Protocol: tty\r\n"
+                     "\r\n",
+                     gw->path.length() > 0 ? gw->path.c_str() : "/ws", hostName, gw->port, key);
+    conn->write((const uint8_t *)req, n);
+
+    char resp[TTYD_HANDSHAKE_MAX];
+    if (!readHttpResponse(resp, sizeof(resp), timeoutMs)) {
+        Serial.println("ttyd: No upgrade response");
+        conn->stop();
+        return false;
+    }
+    if (strncmp(resp, "HTTP/1.1 101", 12) != 0) {
+        char *eol = strstr(resp, "\r\n");
+        if (eol) *eol = '\0';
+        Serial.printf("ttyd: Upgrade refused: %s\n", resp);
+        conn->stop();
+        return false;
+    }
+
+    char expected[32];
+    wsAcceptKey(key, expected, sizeof(expected));
+    const char *accept = httpHeader(resp, "Sec-WebSocket-Accept");
+    if (accept == NULL || strncmp(accept, expected, strlen(expected)) != 0) {
+        Serial.println("ttyd: Bad Sec-WebSocket-Accept");
+        conn->stop();
+        return false;
+    }
+    int64_t t2 = esp_timer_get_time();
+
+    // Start the terminal: JSON_DATA message with the window size
+    char init[96];
+    n = snprintf(init, sizeof(init), "{\"AuthToken\":\"\",\"columns\":%u,\"rows\":%u}", cols, rows);
+    if (!sendFrame(WS_OP_BINARY, 0, (const uint8_t *)init, n)) {
+        Serial.println("ttyd: Write error");
+        conn->stop();
+        return false;
+    }
+
+    wsOpen = true;
+    lastRxMs = lastPingMs = millis();
+    if (gw->useSsl) {
+        Serial.printf("ttyd: Terminal ready (TCP %.1fms, TLS %.1fms %s, upgrade %.1fms)\n",
+                      tlsClient.tcpUs() / 1000.0f, tlsClient.handshakeUs() / 1000.0f,
+                      tlsClient.resumed() ? "resumed" : "full", (t2 - t1) / 1000.0f);
+    } else {
+        Serial.printf("ttyd: Terminal ready (TCP %.1fms, upgrade %.1fms)\n",
+                      (t1 - t0) / 1000.0f, (t2 - t1) / 1000.0f);
+    }
+    return true;
+}
+
+// Control frame complete: answer pings, acknowledge close
+static void handleControl() {
+    if (rxOpcode == WS_OP_PING) {
+        sendFrame(WS_OP_PONG, 0, rxCtrl, rxCtrlLen);
+    } else if (rxOpcode == WS_OP_CLOSE) {
+        if (wsOpen) sendFrame(WS_OP_CLOSE, 0, rxCtrl, rxCtrlLen >= 2 ? 2 : 0);
+        wsOpen = false;
+        Serial.printf("ttyd: Closed by gateway (%u)\n",
+                      rxCtrlLen >= 2 ? (rxCtrl[0] << 8) | rxCtrl[1] : 1005);
+    }
+}
+
+// Header complete: returns false on a protocol error
+static bool parseHeader() {
+    if (rxHdrNeed == 2) {
+        uint8_t len7 = rxHdr[1] & 0x7F;
+        rxHdrNeed = 2 + (len7 == 126 ? 2 : len7 == 127 ? 8 : 0) + ((rxHdr[1] & 0x80) ? 4 : 0);
+        if (rxHdrNeed > 2) return true;  // Need the extended header first
+    }
+
+    rxOpcode = rxHdr[0] & 0x0F;
+    rxMasked = (rxHdr[1] & 0x80) != 0;
+    uint8_t len7 = rxHdr[1] & 0x7F;
+    int pos = 2;
+
+    if (len7 == 126) {
+        rxRemaining = (rxHdr[2] << 8) | rxHdr[3];
+        pos = 4;
+    } else if (len7 == 127) {
+        if (rxHdr[2] | rxHdr[3] | rxHdr[4] | rxHdr[5]) return false;  // >= 4 GB
+        rxRemaining = ((uint32_t)rxHdr[6] << 24) | (rxHdr[7] << 16) | (rxHdr[8] << 8) | rxHdr[9];
+        pos = 10;
+    } else {
+        rxRemaining = len7;
+    }
+    if (rxMasked) {
+        memcpy(rxMask, rxHdr + pos, 4);
+        rxMaskPos = 0;
+    }
+
+    if (rxOpcode >= WS_OP_CLOSE) {
+        if (rxRemaining > sizeof(rxCtrl)) return false;
+        rxCtrlLen = 0;
+    } else if (rxOpcode != WS_OP_CONT) {
+        rxCommand = 0;  // New message: type byte comes first
+    }
+
+    if (debugWs) {
+        Serial.printf("ttyd: frame op=%u len=%u\n", rxOpcode, (unsigned)rxRemaining);
+    }
+
+    rxInPayload = true;
+    return true;
+}
+
+static int ttydRead(char *buf, int room) {
+    int out = 0;
+
+    while (out < room && wsOpen) {
+        int avail = conn->available();
+        if (avail <= 0) break;
+        lastRxMs = millis();
+
+        if (!rxInPayload) {
+            int n = conn->read(rxHdr + rxHdrLen, min(avail, rxHdrNeed - rxHdrLen));
+            if (n <= 0) break;
+            rxHdrLen += n;
+            if (rxHdrLen < rxHdrNeed) continue;
+            if (!parseHeader()) {
+                Serial.println("ttyd: Protocol error");
+                wsOpen = false;
+                break;
+            }
+            if (!rxInPayload) continue;
+        } else if (rxOpcode >= WS_OP_CLOSE) {
+            int n = conn->read(rxCtrl + rxCtrlLen, min((uint32_t)avail, rxRemaining));
+            if (n <= 0) break;
+            rxUnmask(rxCtrl + rxCtrlLen, n);
+            rxCtrlLen += n;
+            rxRemaining -= n;
+        } else if (rxCommand == 0) {
+            uint8_t type;
+            if (conn->read(&type, 1) != 1) break;
+            rxUnmask(&type, 1);
+            rxCommand = (char)type;
+            rxRemaining--;
+        } else if (rxCommand == TTYD_MSG_OUTPUT) {
+            // Terminal output goes straight to the caller's buffer
+            int want = min((uint32_t)min(avail, room - out), rxRemaining);
+            int n = conn->read((uint8_t *)buf + out, want);
+            if (n <= 0) break;
+            rxUnmask((uint8_t *)buf + out, n);
+            out += n;
+            rxRemaining -= n;
+        } else {
+            // Title and preferences: not used
+            uint8_t skip[64];
+            int n = conn->read(skip, min((uint32_t)min(avail, (int)sizeof(skip)), rxRemaining));
+            if (n <= 0) break;
+            rxRemaining -= n;
+        }
+
+        if (rxInPayload && rxRemaining == 0) {
+            if (rxOpcode >= WS_OP_CLOSE) handleControl();
+            rxReset();
+        }
+    }
+
+    // Keepalive: ping when quiet, give up after two silent intervals
+    if (wsOpen && pingIntervalMs > 0) {
+        unsigned long now = millis();
+        if (now - lastRxMs > 2 * pingIntervalMs) {
+            Serial.println("ttyd: Gateway not responding");
+            wsOpen = false;
+        } else if (now - lastRxMs >= pingIntervalMs && now - lastPingMs >= pingIntervalMs) {
+            lastPingMs = now;
+            sendFrame(WS_OP_PING, 0, NULL, 0);
+        }
+    }
+
+    if (out == 0 && (!wsOpen || (!conn->connected() && !conn->available()))) {
+        return -1;
+    }
+    return out;
+}
+
+static int ttydWrite(const char *data, int len) {
+    for (int off = 0; off < len; off += TTYD_TX_MAX) {
+        int n = min(len - off, TTYD_TX_MAX);
+        if (!sendFrame(WS_OP_BINARY, TTYD_CMD_INPUT, (const uint8_t *)data + off, n)) {
+            Serial.println("ttyd: Write error");
+            return -1;
+        }
+    }
+    return len;
+}
+
+static bool ttydIsOpen() {
+    return wsOpen && conn && (conn->connected() || conn->available());
+}
+
+// Mirror the RX ring watermarks: ttyd stops reading the PTY while paused
+static void ttydSetPaused(bool paused) {
+    if (wsOpen) {
+        sendFrame(WS_OP_BINARY, paused ? TTYD_CMD_PAUSE : TTYD_CMD_RESUME, NULL, 0);
+    }
+}
+
+static void ttydResize(uint16_t cols, uint16_t rows) {
+    if (!wsOpen) return;
+    char msg[48];
+    int n = snprintf(msg, sizeof(msg), "{\"columns\":%u,\"rows\":%u}", cols, rows);
+    sendFrame(WS_OP_BINARY, TTYD_CMD_RESIZE, (const uint8_t *)msg, n);
+}
+
+static void ttydClose() {
+    if (wsOpen) {
+        const uint8_t normal[2] = {0x03, 0xE8};  // 1000: normal closure
+        sendFrame(WS_OP_CLOSE, 0, normal, sizeof(normal));
+        wsOpen = false;
+    }
+    if (conn) {
+        conn->stop();
+    }
+}
+
+const SessionTransport_t ttydTransport = {
+    "ttyd",
+    ttydOpen,
+    ttydRead,
+    ttydWrite,
+    ttydIsOpen,
+    ttydSetPaused,
+    ttydResize,
+    ttydClose
+};
@@ -0,0 +1,29 @@
+/**
+ * ttyd Session Transport for T-LoRa Pager Terminal
+ * WebSocket client for the ttyd "tty" protocol (open() target: GatewayConfig *)
+ *
+ * Output frames are parsed off the socket straight into the caller's
+ * buffer; keystrokes go out as one masked frame per write().
+ */
+
+#ifndef TTYD_TRANSPORT_H
+#define TTYD_TRANSPORT_H
+
+#include "session.h"
+
+// ttyd message types (first payload byte)
+#define TTYD_CMD_INPUT    '0'  // client -> server
+#define TTYD_CMD_RESIZE   '1'
+#define TTYD_CMD_PAUSE    '2'
+#define TTYD_CMD_RESUME   '3'
+#define TTYD_CMD_JSON     '{'
+#define TTYD_MSG_OUTPUT   '0'  // server -> client
+#define TTYD_MSG_TITLE    '1'
+#define TTYD_MSG_PREFS    '2'
+
+#define TTYD_HANDSHAKE_MAX 1024  // Longest HTTP upgrade response accepted
+#define TTYD_TX_MAX 512          // Largest keystroke frame payload
+
+extern const SessionTransport_t ttydTransport;
+
+#endif // TTYD_TRANSPORT_H
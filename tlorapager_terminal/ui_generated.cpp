@@ -0,0 +1,289 @@
+/**
+ * Generated LVGL UI Implementation - do not edit
+ * Sources: data/config (15 files)
+ */
+
+#include "ui_generated.h"
+
+lv_subject_t uiSubjects[UI_SUBJECT_COUNT];
+static char subjectBuf_wifi_ssid[64];
+static char subjectBuf_wifi_password[64];
+static char subjectBuf_gateway_host[64];
+static char subjectBuf_gateway_path[64];
+static char subjectBuf_gateway_sni[64];
+static char subjectBuf_cursor_style[64];
+static char subjectBuf_active_profile[64];
+
+static lv_style_t ui_style_screen_terminal_screen_bg;
+static lv_style_t ui_style_row_style_base;
+static lv_style_t ui_style_modifier_indicator_base;
+static lv_style_t ui_style_modifier_indicator_inactive;
+static lv_style_t ui_style_modifier_indicator_active;
+static lv_style_t ui_style_div_style_main;
+static lv_style_t ui_style_terminal_grid_grid;
+static lv_style_t ui_style_terminal_cursor_cursor;
+static lv_style_t ui_style_terminal_base;
+static lv_style_t ui_style_status_bar;
+static lv_style_t ui_style_cursor_block;
+static lv_style_t ui_style_cursor_underline;
+static lv_style_t ui_style_status_ok;
+static lv_style_t ui_style_status_warn;
+static lv_style_t ui_style_status_err;
+static lv_style_t ui_style_modifier_active;
+static lv_style_t ui_style_modifier_inactive;
+static lv_style_t ui_style_disabled;
+
+const UiAsset_t uiFonts[] = {
+    {"terminal_mono_10", &lv_font_montserrat_12},
+    {"terminal_mono_12", &lv_font_montserrat_12},
+    {"terminal_mono_14", &lv_font_montserrat_14},
+    {"ui_regular_12", &lv_font_montserrat_12},
+    {"ui_bold_12", &lv_font_montserrat_12},
+};
+const UiAsset_t uiImages[] = {
+    {"icon_wifi_0", LV_SYMBOL_WIFI},
+    {"icon_wifi_1", LV_SYMBOL_WIFI},
+    {"icon_wifi_2", LV_SYMBOL_WIFI},
+    {"icon_wifi_3", LV_SYMBOL_WIFI},
+    {"icon_wifi_off", LV_SYMBOL_WARNING},
+    {"icon_ws_connected", LV_SYMBOL_OK},
+    {"icon_ws_disconnected", LV_SYMBOL_CLOSE},
+    {"icon_ssl", LV_SYMBOL_EYE_CLOSE},
+};
+const int uiFontCount = sizeof(uiFonts) / sizeof(uiFonts[0]);
+const int uiImageCount = sizeof(uiImages) / sizeof(uiImages[0]);
+
+void uiGenInit() {
+    static bool done = false;
+    if (done) return;
+    done = true;
+
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_WIFI_SSID], subjectBuf_wifi_ssid, NULL, sizeof(subjectBuf_wifi_ssid), "YourNetworkName");
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_WIFI_PASSWORD], subjectBuf_wifi_password, NULL, sizeof(subjectBuf_wifi_password), "YourPassword");
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_WIFI_CONNECTED], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_WIFI_RSSI], -100);
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_GATEWAY_HOST], subjectBuf_gateway_host, NULL, sizeof(subjectBuf_gateway_host), "192.168.1.100");
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_GATEWAY_PORT], 7681);
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_GATEWAY_PATH], subjectBuf_gateway_path, NULL, sizeof(subjectBuf_gateway_path), "/ws");
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_GATEWAY_SSL], 0);
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_GATEWAY_SNI], subjectBuf_gateway_sni, NULL, sizeof(subjectBuf_gateway_sni), "");
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_GATEWAY_CONNECTED], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_CONNECT_TIMEOUT_MS], 4000);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_RECONNECT_DELAY_MS], 800);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_RECONNECT_DELAY_MAX_MS], 5000);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_PING_INTERVAL_MS], 15000);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_TERMINAL_COLS], 80);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_TERMINAL_ROWS], 18);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_SCROLLBACK_LINES], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_CURSOR_X], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_CURSOR_Y], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_CURSOR_VISIBLE], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_CURSOR_BLINK], 1);
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_CURSOR_STYLE], subjectBuf_cursor_style, NULL, sizeof(subjectBuf_cursor_style), "block");
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_KEYBOARD_DEBOUNCE_MS], 15);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_ENCODER_PRESS_ENTER], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_ENCODER_SCROLL], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_ENCODER_STEP_LINES], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_MOD_SHIFT], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_MOD_CTRL], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_MOD_ALT], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_MOD_FN], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_MOD_SYM], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_HAPTICS_ENABLED], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_HAPTICS_KEYPRESS_MS], 8);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_HAPTICS_BELL_MS], 40);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_STATUS_BAR_ENABLED], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_DARK_THEME], 1);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_SERIAL_BAUD], 115200);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_DEBUG_WEBSOCKET], 0);
+    lv_subject_init_int(&uiSubjects[UI_SUBJECT_DEBUG_KEYBOARD], 0);
+    lv_subject_init_string(&uiSubjects[UI_SUBJECT_ACTIVE_PROFILE], subjectBuf_active_profile, NULL, sizeof(subjectBuf_active_profile), "lan");
+
+    lv_style_init(&ui_style_screen_terminal_screen_bg);
+    lv_style_set_bg_color(&ui_style_screen_terminal_screen_bg, lv_color_hex(0x000000));
+
+    lv_style_init(&ui_style_row_style_base);
+    lv_style_set_width(&ui_style_row_style_base, LV_SIZE_CONTENT);
+    lv_style_set_height(&ui_style_row_style_base, LV_SIZE_CONTENT);
+    lv_style_set_layout(&ui_style_row_style_base, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(&ui_style_row_style_base, LV_FLEX_FLOW_ROW);
+
+    lv_style_init(&ui_style_modifier_indicator_base);
+    lv_style_set_width(&ui_style_modifier_indicator_base, 14);
+    lv_style_set_height(&ui_style_modifier_indicator_base, 14);
+    lv_style_set_radius(&ui_style_modifier_indicator_base, 2);
+    lv_style_set_text_font(&ui_style_modifier_indicator_base, &lv_font_montserrat_12);
+
+    lv_style_init(&ui_style_modifier_indicator_inactive);
+    lv_style_set_bg_opa(&ui_style_modifier_indicator_inactive, 0);
+    lv_style_set_text_color(&ui_style_modifier_indicator_inactive, lv_color_hex(0x666666));
+
+    lv_style_init(&ui_style_modifier_indicator_active);
+    lv_style_set_bg_color(&ui_style_modifier_indicator_active, lv_color_hex(0x50DCA0));
+    lv_style_set_bg_opa(&ui_style_modifier_indicator_active, 51);
+    lv_style_set_text_color(&ui_style_modifier_indicator_active, lv_color_hex(0x50DCA0));
+
+    lv_style_init(&ui_style_div_style_main);
+    lv_style_set_width(&ui_style_div_style_main, lv_pct(100));
+    lv_style_set_height(&ui_style_div_style_main, LV_SIZE_CONTENT);
+    lv_style_set_layout(&ui_style_div_style_main, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(&ui_style_div_style_main, LV_FLEX_FLOW_COLUMN);
+
+    lv_style_init(&ui_style_terminal_grid_grid);
+    lv_style_set_width(&ui_style_terminal_grid_grid, lv_pct(100));
+    lv_style_set_height(&ui_style_terminal_grid_grid, lv_pct(100));
+    lv_style_set_text_font(&ui_style_terminal_grid_grid, &lv_font_montserrat_12);
+    lv_style_set_text_color(&ui_style_terminal_grid_grid, lv_color_hex(0xE6E6E6));
+
+    lv_style_init(&ui_style_terminal_cursor_cursor);
+    lv_style_set_width(&ui_style_terminal_cursor_cursor, 4);
+    lv_style_set_height(&ui_style_terminal_cursor_cursor, 12);
+    lv_style_set_bg_color(&ui_style_terminal_cursor_cursor, lv_color_hex(0xE6E6E6));
+
+    lv_style_init(&ui_style_terminal_base);
+    lv_style_set_bg_color(&ui_style_terminal_base, lv_color_hex(0x000000));
+    lv_style_set_bg_opa(&ui_style_terminal_base, 255);
+    lv_style_set_text_color(&ui_style_terminal_base, lv_color_hex(0xE6E6E6));
+    lv_style_set_text_font(&ui_style_terminal_base, &lv_font_montserrat_12);
+    lv_style_set_pad_all(&ui_style_terminal_base, 0);
+
+    lv_style_init(&ui_style_status_bar);
+    lv_style_set_bg_color(&ui_style_status_bar, lv_color_hex(0x141414));
+    lv_style_set_bg_opa(&ui_style_status_bar, 255);
+    lv_style_set_text_color(&ui_style_status_bar, lv_color_hex(0xE6E6E6));
+    lv_style_set_text_font(&ui_style_status_bar, &lv_font_montserrat_12);
+    lv_style_set_height(&ui_style_status_bar, 18);
+    lv_style_set_pad_hor(&ui_style_status_bar, 4);
+    lv_style_set_pad_ver(&ui_style_status_bar, 2);
+
+    lv_style_init(&ui_style_cursor_block);
+    lv_style_set_bg_color(&ui_style_cursor_block, lv_color_hex(0xE6E6E6));
+    lv_style_set_bg_opa(&ui_style_cursor_block, 255);
+
+    lv_style_init(&ui_style_cursor_underline);
+    lv_style_set_border_color(&ui_style_cursor_underline, lv_color_hex(0xE6E6E6));
+    lv_style_set_border_width(&ui_style_cursor_underline, 2);
+    lv_style_set_border_side(&ui_style_cursor_underline, LV_BORDER_SIDE_BOTTOM);
+
+    lv_style_init(&ui_style_status_ok);
+    lv_style_set_text_color(&ui_style_status_ok, lv_color_hex(0x50DCA0));
+
+    lv_style_init(&ui_style_status_warn);
+    lv_style_set_text_color(&ui_style_status_warn, lv_color_hex(0xF0C850));
+
+    lv_style_init(&ui_style_status_err);
+    lv_style_set_text_color(&ui_style_status_err, lv_color_hex(0xFF5A5A));
+
+    lv_style_init(&ui_style_modifier_active);
+    lv_style_set_text_color(&ui_style_modifier_active, lv_color_hex(0x50DCA0));
+    lv_style_set_bg_opa(&ui_style_modifier_active, 51);
+
+    lv_style_init(&ui_style_modifier_inactive);
+    lv_style_set_text_color(&ui_style_modifier_inactive, lv_color_hex(0x666666));
+    lv_style_set_bg_opa(&ui_style_modifier_inactive, 0);
+
+    lv_style_init(&ui_style_disabled);
+    lv_style_set_opa(&ui_style_disabled, 153);
+}
+
+lv_obj_t *uiGenCreateTerminalScreen(UiRefs_t *refs) {
+    lv_obj_t *screen = lv_obj_create(NULL);
+    lv_obj_set_flex_flow(screen, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_width(screen, lv_pct(100));
+    lv_obj_set_height(screen, lv_pct(100));
+    lv_obj_add_style(screen, &ui_style_screen_terminal_screen_bg, 0);
+    lv_obj_t *o1 = lv_obj_create(screen);  // <row>
+    lv_obj_remove_style_all(o1);
+    lv_obj_add_style(o1, &ui_style_row_style_base, 0);
+    lv_obj_set_width(o1, lv_pct(100));
+    lv_obj_set_height(o1, 18);
+    lv_obj_set_style_flex_main_place(o1, LV_FLEX_ALIGN_SPACE_BETWEEN, 0);
+    lv_obj_set_style_flex_cross_place(o1, LV_FLEX_ALIGN_CENTER, 0);
+    lv_obj_set_style_pad_hor(o1, 4, 0);
+    lv_obj_set_style_bg_color(o1, lv_color_hex(0x141414), 0);
+    lv_obj_bind_flag_if_eq(o1, &uiSubjects[UI_SUBJECT_STATUS_BAR_ENABLED], LV_OBJ_FLAG_HIDDEN, 0);
+    lv_obj_t *o2 = lv_obj_create(o1);  // <row>
+    lv_obj_remove_style_all(o2);
+    lv_obj_add_style(o2, &ui_style_row_style_base, 0);
+    lv_obj_set_style_pad_gap(o2, 4, 0);
+    lv_obj_t *o3 = lv_obj_create(o2);  // <wifi_indicator>
+    lv_obj_t *o4 = lv_image_create(o3);  // <image>
+    lv_image_set_src(o4, LV_SYMBOL_WARNING);
+    lv_obj_set_style_text_color(o4, lv_color_hex(0xFF5A5A), 0);
+    lv_obj_bind_flag_if_eq(o4, &uiSubjects[UI_SUBJECT_WIFI_CONNECTED], LV_OBJ_FLAG_HIDDEN, 1);
+    lv_obj_t *o5 = lv_image_create(o3);  // <image>
+    lv_image_set_src(o5, LV_SYMBOL_WIFI);
+    lv_obj_set_style_text_color(o5, lv_color_hex(0x50DCA0), 0);
+    lv_obj_bind_flag_if_not_eq(o5, &uiSubjects[UI_SUBJECT_WIFI_CONNECTED], LV_OBJ_FLAG_HIDDEN, 1);
+    lv_obj_t *o6 = lv_obj_create(o2);  // <websocket_indicator>
+    lv_obj_t *o7 = lv_image_create(o6);  // <image>
+    lv_image_set_src(o7, LV_SYMBOL_CLOSE);
+    lv_obj_set_style_text_color(o7, lv_color_hex(0xFF5A5A), 0);
+    lv_obj_bind_flag_if_eq(o7, &uiSubjects[UI_SUBJECT_GATEWAY_CONNECTED], LV_OBJ_FLAG_HIDDEN, 1);
+    lv_obj_t *o8 = lv_image_create(o6);  // <image>
+    lv_image_set_src(o8, LV_SYMBOL_OK);
+    lv_obj_set_style_text_color(o8, lv_color_hex(0x50DCA0), 0);
+    lv_obj_bind_flag_if_not_eq(o8, &uiSubjects[UI_SUBJECT_GATEWAY_CONNECTED], LV_OBJ_FLAG_HIDDEN, 1);
+    lv_obj_t *o9 = lv_label_create(o1);  // <label>
+    lv_label_bind_text(o9, &uiSubjects[UI_SUBJECT_GATEWAY_HOST], NULL);
+    lv_obj_set_style_text_font(o9, &lv_font_montserrat_12, 0);
+    lv_obj_t *o10 = lv_obj_create(o1);  // <row>
+    lv_obj_remove_style_all(o10);
+    lv_obj_add_style(o10, &ui_style_row_style_base, 0);
+    lv_obj_set_style_pad_gap(o10, 2, 0);
+    lv_obj_t *o11 = lv_obj_create(o10);  // <modifier_indicator>
+    lv_obj_add_style(o11, &ui_style_modifier_indicator_base, 0);
+    lv_obj_add_style(o11, &ui_style_modifier_indicator_inactive, 0);
+    lv_obj_bind_style(o11, &ui_style_modifier_indicator_active, 0, &uiSubjects[UI_SUBJECT_MOD_SHIFT], 1);
+    lv_obj_t *o12 = lv_label_create(o11);  // <label>
+    lv_label_set_text_static(o12, "S");
+    lv_obj_set_align(o12, LV_ALIGN_CENTER);
+    lv_obj_t *o13 = lv_obj_create(o10);  // <modifier_indicator>
+    lv_obj_add_style(o13, &ui_style_modifier_indicator_base, 0);
+    lv_obj_add_style(o13, &ui_style_modifier_indicator_inactive, 0);
+    lv_obj_bind_style(o13, &ui_style_modifier_indicator_active, 0, &uiSubjects[UI_SUBJECT_MOD_CTRL], 1);
+    lv_obj_t *o14 = lv_label_create(o13);  // <label>
+    lv_label_set_text_static(o14, "C");
+    lv_obj_set_align(o14, LV_ALIGN_CENTER);
+    lv_obj_t *o15 = lv_obj_create(o10);  // <modifier_indicator>
+    lv_obj_add_style(o15, &ui_style_modifier_indicator_base, 0);
+    lv_obj_add_style(o15, &ui_style_modifier_indicator_inactive, 0);
+    lv_obj_bind_style(o15, &ui_style_modifier_indicator_active, 0, &uiSubjects[UI_SUBJECT_MOD_ALT], 1);
+    lv_obj_t *o16 = lv_label_create(o15);  // <label>
+    lv_label_set_text_static(o16, "A");
+    lv_obj_set_align(o16, LV_ALIGN_CENTER);
+    lv_obj_t *o17 = lv_obj_create(o10);  // <modifier_indicator>
+    lv_obj_add_style(o17, &ui_style_modifier_indicator_base, 0);
+    lv_obj_add_style(o17, &ui_style_modifier_indicator_inactive, 0);
+    lv_obj_bind_style(o17, &ui_style_modifier_indicator_active, 0, &uiSubjects[UI_SUBJECT_MOD_FN], 1);
+    lv_obj_t *o18 = lv_label_create(o17);  // <label>
+    lv_label_set_text_static(o18, "F");
+    lv_obj_set_align(o18, LV_ALIGN_CENTER);
+    lv_obj_t *o19 = lv_obj_create(o10);  // <modifier_indicator>
+    lv_obj_add_style(o19, &ui_style_modifier_indicator_base, 0);
+    lv_obj_add_style(o19, &ui_style_modifier_indicator_inactive, 0);
+    lv_obj_bind_style(o19, &ui_style_modifier_indicator_active, 0, &uiSubjects[UI_SUBJECT_MOD_SYM], 1);
+    lv_obj_t *o20 = lv_label_create(o19);  // <label>
+    lv_label_set_text_static(o20, "Y");
+    lv_obj_set_align(o20, LV_ALIGN_CENTER);
+    lv_obj_t *o21 = lv_obj_create(screen);  // <div>
+    lv_obj_remove_style_all(o21);
+    lv_obj_add_style(o21, &ui_style_div_style_main, 0);
+    if (refs) refs->terminal_area = o21;
+    lv_obj_set_flex_grow(o21, 1);
+    lv_obj_set_width(o21, lv_pct(100));
+    lv_obj_set_style_pad_all(o21, 2, 0);
+    lv_obj_set_style_bg_opa(o21, 0, 0);
+    lv_obj_t *o22 = lv_obj_create(o21);  // <terminal_grid>
+    lv_obj_add_style(o22, &ui_style_terminal_grid_grid, 0);
+    lv_obj_t *o23 = lv_label_create(o22);  // <label>
+    lv_label_set_text_static(o23, "");
+    if (refs) refs->terminal_text = o23;
+    lv_obj_set_width(o23, lv_pct(100));
+    lv_obj_set_height(o23, lv_pct(100));
+    lv_obj_t *o24 = lv_obj_create(o21);  // <terminal_cursor>
+    if (refs) refs->cursor = o24;
+    lv_obj_add_style(o24, &ui_style_terminal_cursor_cursor, 0);
+    lv_obj_bind_flag_if_eq(o24, &uiSubjects[UI_SUBJECT_CURSOR_VISIBLE], LV_OBJ_FLAG_HIDDEN, 0);
+    return screen;
+}
@@ -0,0 +1,84 @@
+/**
+ * Generated LVGL UI for T-LoRa Pager Terminal
+ * Built from the XML project by tools/lvgl_xml2c.py - do not edit
+ *
+ * Consts are folded into literals and components expanded inline;
+ * nothing is parsed at run time.
+ */
+
+#ifndef UI_GENERATED_H
+#define UI_GENERATED_H
+
+#include <lvgl.h>
+
+// Subjects from globals.xml
+typedef enum {
+    UI_SUBJECT_WIFI_SSID,
+    UI_SUBJECT_WIFI_PASSWORD,
+    UI_SUBJECT_WIFI_CONNECTED,
+    UI_SUBJECT_WIFI_RSSI,
+    UI_SUBJECT_GATEWAY_HOST,
+    UI_SUBJECT_GATEWAY_PORT,
+    UI_SUBJECT_GATEWAY_PATH,
+    UI_SUBJECT_GATEWAY_SSL,
+    UI_SUBJECT_GATEWAY_SNI,
+    UI_SUBJECT_GATEWAY_CONNECTED,
+    UI_SUBJECT_CONNECT_TIMEOUT_MS,
+    UI_SUBJECT_RECONNECT_DELAY_MS,
+    UI_SUBJECT_RECONNECT_DELAY_MAX_MS,
+    UI_SUBJECT_PING_INTERVAL_MS,
+    UI_SUBJECT_TERMINAL_COLS,
+    UI_SUBJECT_TERMINAL_ROWS,
+    UI_SUBJECT_SCROLLBACK_LINES,
+    UI_SUBJECT_CURSOR_X,
+    UI_SUBJECT_CURSOR_Y,
+    UI_SUBJECT_CURSOR_VISIBLE,
+    UI_SUBJECT_CURSOR_BLINK,
+    UI_SUBJECT_CURSOR_STYLE,
+    UI_SUBJECT_KEYBOARD_DEBOUNCE_MS,
+    UI_SUBJECT_ENCODER_PRESS_ENTER,
+    UI_SUBJECT_ENCODER_SCROLL,
+    UI_SUBJECT_ENCODER_STEP_LINES,
+    UI_SUBJECT_MOD_SHIFT,
+    UI_SUBJECT_MOD_CTRL,
+    UI_SUBJECT_MOD_ALT,
+    UI_SUBJECT_MOD_FN,
+    UI_SUBJECT_MOD_SYM,
+    UI_SUBJECT_HAPTICS_ENABLED,
+    UI_SUBJECT_HAPTICS_KEYPRESS_MS,
+    UI_SUBJECT_HAPTICS_BELL_MS,
+    UI_SUBJECT_STATUS_BAR_ENABLED,
+    UI_SUBJECT_DARK_THEME,
+    UI_SUBJECT_SERIAL_BAUD,
+    UI_SUBJECT_DEBUG_WEBSOCKET,
+    UI_SUBJECT_DEBUG_KEYBOARD,
+    UI_SUBJECT_ACTIVE_PROFILE,
+    UI_SUBJECT_COUNT
+} UiSubject_t;
+
+extern lv_subject_t uiSubjects[UI_SUBJECT_COUNT];
+
+// Widgets with an id, filled in by the create functions
+typedef struct {
+    lv_obj_t *cursor;
+    lv_obj_t *terminal_area;
+    lv_obj_t *terminal_text;
+} UiRefs_t;
+
+// Stand-ins for the fonts and images named in globals.xml
+typedef struct {
+    const char *name;
+    const void *ptr;
+} UiAsset_t;
+extern const UiAsset_t uiFonts[];
+extern const UiAsset_t uiImages[];
+extern const int uiFontCount;
+extern const int uiImageCount;
+
+// Styles and subjects; once, before any create
+void uiGenInit();
+
+// <screen> terminal.xml (refs may be NULL)
+lv_obj_t *uiGenCreateTerminalScreen(UiRefs_t *refs);
+
+#endif // UI_GENERATED_H
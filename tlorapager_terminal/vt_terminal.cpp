@@ -0,0 +1,1054 @@
+/**
+ * VT Terminal Model Implementation
+ */
+
+#include "vt_terminal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VT_TAB_WIDTH 8
+
+VtTerminal::VtTerminal()
+    : _cols(0), _rows(0),
+      _cellStore(NULL), _primary(NULL), _alt(NULL), _screen(NULL),
+      _sbCells(NULL), _sbCellCap(0), _sbCellUsed(0), _sbWrite(0),
+      _sbLines(NULL), _sbCapacity(0), _sbFirst(0), _sbCount(0), _sbOpen(false), _sbRowBuf(NULL),
+      _viewUp(-1), _viewSeq(0), _viewRow(0),
+      _gen(0), _bells(0), _responder(NULL),
+      _images(NULL), _sixelTop(0), _sixelLeft(0) {
+}
+
+VtTerminal::~VtTerminal() {
+    freeBuffers();
+}
+
+void VtTerminal::freeBuffers() {
+    free(_cellStore);
+    free(_primary);
+    free(_alt);
+    free(_sbCells);
+    free(_sbLines);
+    free(_sbRowBuf);
+    _cellStore = NULL;
+    _primary = _alt = _screen = NULL;
+    _sbCells = NULL;
+    _sbLines = NULL;
+    _sbRowBuf = NULL;
+}
+
+bool VtTerminal::allocScreens(uint16_t cols, uint16_t rows, VtCell **store, VtRow **primary, VtRow **alt) {
+    *store = (VtCell *)malloc(2 * rows * cols * sizeof(VtCell));
+    *primary = (VtRow *)malloc(rows * sizeof(VtRow));
+    *alt = (VtRow *)malloc(rows * sizeof(VtRow));
+    if (!*store || !*primary || !*alt) {
+        free(*store);
+        free(*primary);
+        free(*alt);
+        return false;
+    }
+    for (uint16_t y = 0; y < rows; y++) {
+        (*primary)[y].cells = *store + y * cols;
+        (*alt)[y].cells = *store + (rows + y) * cols;
+    }
+    return true;
+}
+
+bool VtTerminal::begin(uint16_t cols, uint16_t rows, uint16_t scrollbackLines) {
+    freeBuffers();
+    if (cols == 0 || rows == 0) return false;
+
+    _cols = cols;
+    _rows = rows;
+    _sbCapacity = scrollbackLines;
+    _sbCellCap = (uint32_t)scrollbackLines * cols;
+
+    if (!allocScreens(cols, rows, &_cellStore, &_primary, &_alt)) return false;
+    if (_sbCapacity > 0) {
+        _sbCells = (VtCell *)malloc(_sbCellCap * sizeof(VtCell));
+        _sbLines = (SbLine *)malloc(_sbCapacity * sizeof(SbLine));
+        _sbRowBuf = (VtCell *)malloc(cols * sizeof(VtCell));
+        if (!_sbCells || !_sbLines || !_sbRowBuf) {
+            freeBuffers();
+            return false;
+        }
+    }
+
+    reset();
+    return true;
+}
+
+bool VtTerminal::resize(uint16_t cols, uint16_t rows) {
+    if (_cellStore == NULL || cols == 0 || rows == 0) return false;
+    if (cols == _cols && rows == _rows) return true;
+
+    VtCell *store, *rowBuf = NULL;
+    VtRow *primary, *alt;
+    if (!allocScreens(cols, rows, &store, &primary, &alt)) return false;
+
+    // Images were placed for the old grid
+    _sixel.abort();
+    if (_images) _images->clearAll();
+    if (_sbCapacity > 0 && (rowBuf = (VtCell *)malloc(cols * sizeof(VtCell))) == NULL) {
+        free(store);
+        free(primary);
+        free(alt);
+        return false;
+    }
+
+    // Keep the cursor row on screen: rows above it go, to history if
+    // this is the main screen
+    uint16_t drop = _cy >= rows ? _cy - rows + 1 : 0;
+    if (_screen == _primary) {
+        for (uint16_t y = 0; y < drop; y++) pushScrollback(_primary[y]);
+    }
+    _sbOpen = false;
+
+    uint16_t keepCols = cols < _cols ? cols : _cols;
+    VtRow *oldScreens[2] = {_primary, _alt};
+    VtRow *newScreens[2] = {primary, alt};
+    for (int s = 0; s < 2; s++) {
+        uint16_t skip = oldScreens[s] == _screen ? drop : 0;
+        for (uint16_t y = 0; y < rows; y++) {
+            VtRow &dst = newScreens[s][y];
+            uint16_t from = y + skip;
+            uint16_t x = 0;
+            if (from < _rows) {
+                memcpy(dst.cells, oldScreens[s][from].cells, keepCols * sizeof(VtCell));
+                x = keepCols;
+            }
+            for (; x < cols; x++) {
+                dst.cells[x].ch = ' ';
+                dst.cells[x].attr = 0;
+            }
+            // Soft wraps were at the old width; the host repaints
+            dst.flags = 0;
+        }
+    }
+    bool onAlt = altScreen();
+
+    free(_cellStore);
+    free(_primary);
+    free(_alt);
+    _cellStore = store;
+    _primary = primary;
+    _alt = alt;
+    _screen = onAlt ? _alt : _primary;
+    if (rowBuf) {
+        free(_sbRowBuf);
+        _sbRowBuf = rowBuf;
+    }
+
+    _cols = cols;
+    _rows = rows;
+    _cy -= drop;
+    if (_cx >= cols) _cx = cols - 1;
+    if (_savedX >= cols) _savedX = cols - 1;
+    if (_savedY >= rows) _savedY = rows - 1;
+    _wrapPending = false;
+    _scrollTop = 0;
+    _scrollBottom = rows - 1;
+    _viewUp = -1;
+    _gen++;
+    return true;
+}
+
+void VtTerminal::reset() {
+    _sixel.abort();
+    _cx = _cy = 0;
+    _wrapPending = false;
+    _autoWrap = true;
+    _cursorVisible = true;
+    _attr = 0;
+    _scrollTop = 0;
+    _scrollBottom = _rows - 1;
+    _savedX = _savedY = 0;
+    _savedAttr = 0;
+    _state = ST_GROUND;
+    _nparams = 0;
+    _private = 0;
+    _inter = 0;
+    _utf8 = 0;
+    _utf8Left = 0;
+    sbClear();
+
+    _screen = _alt;
+    clearScreen();
+    _screen = _primary;
+    clearScreen();
+    _gen++;
+}
+
+bool VtTerminal::copyScreenFrom(const VtTerminal &other) {
+    if (_cellStore == NULL || other._cellStore == NULL ||
+        other._cols != _cols || other._rows != _rows) {
+        return false;
+    }
+
+    // Rows are rotated on scroll: keep each row's offset into the store
+    memcpy(_cellStore, other._cellStore, 2 * _rows * _cols * sizeof(VtCell));
+    for (uint16_t y = 0; y < _rows; y++) {
+        _primary[y].cells = _cellStore + (other._primary[y].cells - other._cellStore);
+        _primary[y].flags = other._primary[y].flags;
+        _alt[y].cells = _cellStore + (other._alt[y].cells - other._cellStore);
+        _alt[y].flags = other._alt[y].flags;
+    }
+    _screen = other._screen == other._alt ? _alt : _primary;
+
+    _cx = other._cx;
+    _cy = other._cy;
+    _wrapPending = other._wrapPending;
+    _autoWrap = other._autoWrap;
+    _cursorVisible = other._cursorVisible;
+    _attr = other._attr;
+    _scrollTop = other._scrollTop;
+    _scrollBottom = other._scrollBottom;
+    _savedX = other._savedX;
+    _savedY = other._savedY;
+    _savedAttr = other._savedAttr;
+    _state = other._state;
+    memcpy(_params, other._params, sizeof(_params));
+    _nparams = other._nparams;
+    _private = other._private;
+    _inter = other._inter;
+    _utf8 = other._utf8;
+    _utf8Left = other._utf8Left;
+    _gen++;
+    return true;
+}
+
+static size_t appendSgr(char *out, size_t pos, size_t cap, uint8_t attr) {
+    int n = snprintf(out + pos, cap - pos, "\x1b[0%s%s%sm",
+                     (attr & VT_ATTR_BOLD) ? ";1" : "",
+                     (attr & VT_ATTR_UNDERLINE) ? ";4" : "",
+                     (attr & VT_ATTR_REVERSE) ? ";7" : "");
+    return n > 0 && pos + n < cap ? pos + n : pos;
+}
+
+size_t VtTerminal::renderRepaint(char *out, size_t cap) const {
+    if (cap == 0) return 0;
+    size_t pos = 0;
+    int n = snprintf(out, cap, "\x1b[r\x1b[0m\x1b[H\x1b[2J");
+    if (n > 0 && (size_t)n < cap) pos = n;
+
+    for (uint16_t y = 0; y < _rows && _screen; y++) {
+        const VtCell *cells = _screen[y].cells;
+        // Trailing blanks are already there after the clear
+        int end = _cols;
+        while (end > 0 && cells[end - 1].ch == ' ' && cells[end - 1].attr == 0) end--;
+        if (end == 0) continue;
+
+        n = snprintf(out + pos, cap - pos, "\x1b[%u;1H", y + 1);
+        if (n <= 0 || pos + n >= cap) break;
+        pos += n;
+        uint8_t attr = 0;
+        for (int x = 0; x < end && pos + 16 < cap; x++) {
+            if (cells[x].attr != attr) {
+                attr = cells[x].attr;
+                pos = appendSgr(out, pos, cap, attr);
+            }
+            out[pos++] = cells[x].ch;
+        }
+        if (attr != 0) pos = appendSgr(out, pos, cap, 0);
+    }
+
+    // Scroll region, pen and cursor as they were
+    n = snprintf(out + pos, cap - pos, "\x1b[%u;%ur\x1b[%u;%uH\x1b[?25%c",
+                 _scrollTop + 1, _scrollBottom + 1, _cy + 1, _cx + 1, _cursorVisible ? 'h' : 'l');
+    if (n > 0 && pos + n < cap) pos += n;
+    if (_attr != 0) pos = appendSgr(out, pos, cap, _attr);
+    out[pos < cap ? pos : cap - 1] = '\0';
+    return pos;
+}
+
+const VtCell* VtTerminal::historyRow(int up, uint16_t *len, bool *wrapped) const {
+    if (up < 0 || _sbCount == 0) return NULL;
+
+    uint32_t newest = _sbFirst + _sbCount - 1;
+    if (_viewUp < 0) {
+        _viewSeq = newest;
+        _viewRow = sbRows(sbLine(newest).len) - 1;
+        _viewUp = 0;
+    }
+
+    // Walk from the last position, whole lines at a time
+    uint32_t seq = _viewSeq;
+    int row = _viewRow;
+    int steps = up - _viewUp;
+    while (steps > row) {
+        if (seq == _sbFirst) {
+            // Past the oldest line: remember its first row
+            _viewSeq = seq;
+            _viewRow = 0;
+            _viewUp = up - steps + row;
+            return NULL;
+        }
+        steps -= row + 1;
+        seq--;
+        row = sbRows(sbLine(seq).len) - 1;
+    }
+    while (steps < 0) {
+        int below = sbRows(sbLine(seq).len) - 1 - row;
+        if (-steps <= below) break;
+        steps += below + 1;
+        seq++;
+        row = 0;
+    }
+    row -= steps;
+    _viewSeq = seq;
+    _viewRow = row;
+    _viewUp = up;
+
+    const SbLine &line = sbLine(seq);
+    uint16_t off = row * _cols;
+    uint16_t n = line.len > off ? line.len - off : 0;
+    if (n > _cols) n = _cols;
+    if (len) *len = n;
+    if (wrapped) *wrapped = off + n < line.len || (seq == newest && _sbOpen && off + n == line.len);
+
+    uint32_t start = (line.start + off) % _sbCellCap;
+    if (start + n <= _sbCellCap) return _sbCells + start;
+    uint32_t first = _sbCellCap - start;
+    memcpy(_sbRowBuf, _sbCells + start, first * sizeof(VtCell));
+    memcpy(_sbRowBuf + first, _sbCells, (n - first) * sizeof(VtCell));
+    return _sbRowBuf;
+}
+
+uint32_t VtTerminal::takeBells() {
+    uint32_t n = _bells;
+    _bells = 0;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Grid operations
+// ---------------------------------------------------------------------------
+
+void VtTerminal::clearRow(VtRow &row, uint16_t from, uint16_t to) {
+    if (to > _cols) to = _cols;
+    for (uint16_t x = from; x < to; x++) {
+        row.cells[x].ch = ' ';
+        row.cells[x].attr = _attr & VT_ATTR_REVERSE;
+    }
+    if (to == _cols) row.flags = 0;
+}
+
+void VtTerminal::clearScreen() {
+    for (uint16_t y = 0; y < _rows; y++) {
+        clearRow(_screen[y], 0, _cols);
+    }
+    _sbOpen = false;
+    if (_images) _images->clear(altScreen());
+}
+
+void VtTerminal::sbClear() {
+    _sbCellUsed = 0;
+    _sbWrite = 0;
+    _sbFirst = 0;
+    _sbCount = 0;
+    _sbOpen = false;
+    _viewUp = -1;
+}
+
+void VtTerminal::sbEvict() {
+    _sbCellUsed -= sbLine(_sbFirst).len;
+    _sbFirst++;
+    _sbCount--;
+    if (_viewUp >= 0 && _viewSeq < _sbFirst) _viewUp = -1;
+}
+
+// A soft-wrapped row stays open: the next row pushed is appended to the
+// same logical line. Rows shown below the view shift it up by the rows
+// they add at the current width.
+void VtTerminal::pushScrollback(const VtRow &row) {
+    if (_sbCapacity == 0) return;
+
+    bool wrapped = row.flags & VT_ROW_WRAPPED;
+    uint32_t len = _cols;
+    if (!wrapped) {
+        while (len > 0 && row.cells[len - 1].ch == ' ' && row.cells[len - 1].attr == 0) len--;
+    }
+    uint32_t lineMax = _sbCellCap < VT_SB_LINE_MAX ? _sbCellCap : VT_SB_LINE_MAX;
+    if (len > lineMax) len = lineMax;
+
+    uint16_t rowsBefore = 0;
+    if (_sbOpen && _sbCount > 0 && sbLine(_sbFirst + _sbCount - 1).len + len <= lineMax) {
+        rowsBefore = sbRows(sbLine(_sbFirst + _sbCount - 1).len);
+    } else {
+        if (_sbCount == _sbCapacity) sbEvict();
+        SbLine &line = sbLine(_sbFirst + _sbCount);
+        line.start = _sbWrite;
+        line.len = 0;
+        _sbCount++;
+    }
+    SbLine &line = sbLine(_sbFirst + _sbCount - 1);
+    while (_sbCellCap - _sbCellUsed < len && _sbCount > 1) sbEvict();
+
+    uint32_t first = _sbCellCap - _sbWrite < len ? _sbCellCap - _sbWrite : len;
+    memcpy(_sbCells + _sbWrite, row.cells, first * sizeof(VtCell));
+    memcpy(_sbCells, row.cells + first, (len - first) * sizeof(VtCell));
+    _sbWrite = (_sbWrite + len) % _sbCellCap;
+    _sbCellUsed += len;
+    line.len += len;
+    _sbOpen = wrapped;
+
+    if (_viewUp >= 0) _viewUp += sbRows(line.len) - rowsBefore;
+}
+
+void VtTerminal::scrollUp(uint16_t top, uint16_t bottom, uint16_t n) {
+    uint16_t height = bottom - top + 1;
+    if (n > height) n = height;
+
+    for (uint16_t i = 0; i < n; i++) {
+        // Only full-width scrolls off the top of the main screen are history
+        if (top == 0 && _screen == _primary) {
+            pushScrollback(_screen[top]);
+        }
+        VtRow first = _screen[top];
+        memmove(&_screen[top], &_screen[top + 1], (height - 1) * sizeof(VtRow));
+        _screen[bottom] = first;
+        clearRow(_screen[bottom], 0, _cols);
+    }
+    imagesScrolled(top, bottom, -(int)n);
+    _gen++;
+}
+
+void VtTerminal::scrollDown(uint16_t top, uint16_t bottom, uint16_t n) {
+    uint16_t height = bottom - top + 1;
+    if (n > height) n = height;
+
+    for (uint16_t i = 0; i < n; i++) {
+        VtRow last = _screen[bottom];
+        memmove(&_screen[top + 1], &_screen[top], (height - 1) * sizeof(VtRow));
+        _screen[top] = last;
+        clearRow(_screen[top], 0, _cols);
+    }
+    imagesScrolled(top, bottom, n);
+    _gen++;
+}
+
+void VtTerminal::imagesScrolled(uint16_t top, uint16_t bottom, int n) {
+    bool fullScreen = top == 0 && bottom == _rows - 1;
+    if (_images) _images->scroll(altScreen(), top, bottom, n, fullScreen);
+    if (_sixel.active() && fullScreen) _sixelTop += n;
+}
+
+void VtTerminal::lineFeed() {
+    if (_cy == _scrollBottom) {
+        scrollUp(_scrollTop, _scrollBottom, 1);
+    } else if (_cy < _rows - 1) {
+        _cy++;
+    }
+}
+
+void VtTerminal::reverseIndex() {
+    if (_cy == _scrollTop) {
+        scrollDown(_scrollTop, _scrollBottom, 1);
+    } else if (_cy > 0) {
+        _cy--;
+    }
+}
+
+void VtTerminal::setCursor(int x, int y) {
+    if (x < 0) x = 0;
+    if (x >= _cols) x = _cols - 1;
+    if (y < 0) y = 0;
+    if (y >= _rows) y = _rows - 1;
+    _cx = x;
+    _cy = y;
+    _wrapPending = false;
+}
+
+void VtTerminal::setAltScreen(bool on) {
+    if (on == altScreen()) return;
+    if (on) {
+        _savedX = _cx;
+        _savedY = _cy;
+        _savedAttr = _attr;
+        _screen = _alt;
+        clearScreen();
+    } else {
+        _screen = _primary;
+        _cx = _savedX;
+        _cy = _savedY;
+        _attr = _savedAttr;
+    }
+    _wrapPending = false;
+    _gen++;
+}
+
+void VtTerminal::setImageCache(SixelCache *cache) {
+    _sixel.abort();
+    if (_images) _images->clearAll();
+    _images = cache;
+}
+
+void VtTerminal::sixelStart() {
+    _sixelTop = _cy;
+    _sixelLeft = _cx;
+    SixelImage *img = NULL;
+    if (_images && _images->tileCount() > 0) {
+        img = _images->newImage(altScreen(), _cy, _cx);
+    }
+    _sixel.start(_images, img, _cols - _cx, _rows);
+}
+
+// An image that grows past the bottom scrolls the screen up under it
+void VtTerminal::sixelData(uint8_t c) {
+    uint8_t before = _sixel.rows();
+    _sixel.put(c);
+    uint8_t rows = _sixel.rows();
+    if (rows == before) return;
+    int over = _sixelTop + rows - _rows;
+    if (over > 0) scrollUp(0, _rows - 1, over);
+    _gen++;
+}
+
+void VtTerminal::sixelEnd() {
+    SixelStatus_t status = _sixel.finish();
+    uint8_t rows = _sixel.rows();
+    if (rows == 0) return;
+
+    char label[40];
+    const char *why = status == SIXEL_NO_MEMORY ? ": no memory" : "";
+    snprintf(label, sizeof(label), "[sixel %ux%u%s]", (unsigned)_sixel.srcWidth(),
+             (unsigned)_sixel.srcHeight(), why);
+    if (_sixelTop >= 0 && _sixelTop < _rows) {
+        VtRow &row = _screen[_sixelTop];
+        for (int i = 0; label[i] && _sixelLeft + i < _cols; i++) {
+            row.cells[_sixelLeft + i].ch = label[i];
+            row.cells[_sixelLeft + i].attr = status == SIXEL_OK ? 0 : VT_ATTR_REVERSE;
+        }
+    }
+
+    // Cursor to the line below the image, at its left edge
+    setCursor(_sixelLeft, _sixelTop + rows - 1);
+    lineFeed();
+    _gen++;
+}
+
+void VtTerminal::putChar(uint8_t ch) {
+    if (_wrapPending) {
+        _screen[_cy].flags |= VT_ROW_WRAPPED;
+        _cx = 0;
+        lineFeed();
+        _wrapPending = false;
+    }
+
+    VtCell &cell = _screen[_cy].cells[_cx];
+    cell.ch = ch;
+    cell.attr = _attr;
+
+    if (_cx == _cols - 1) {
+        _wrapPending = _autoWrap;
+    } else {
+        _cx++;
+    }
+    _gen++;
+}
+
+// Non-ASCII code points: approximate box drawing, '?' otherwise
+uint8_t VtTerminal::mapCodepoint(uint32_t cp) const {
+    if (cp >= 0x2500 && cp <= 0x257F) {
+        uint32_t off = cp - 0x2500;
+        if (off <= 0x01 || (off >= 0x04 && off <= 0x05) || (off >= 0x08 && off <= 0x09) ||
+            off == 0x4C || off == 0x4D || off == 0x50) return '-';
+        if (off <= 0x03 || (off >= 0x06 && off <= 0x07) || (off >= 0x0A && off <= 0x0B) ||
+            off == 0x4E || off == 0x4F || off == 0x51) return '|';
+        return '+';
+    }
+    if (cp == 0x00A0) return ' ';
+    if (cp == 0x2018 || cp == 0x2019) return '\'';
+    if (cp == 0x201C || cp == 0x201D) return '"';
+    if (cp == 0x2013 || cp == 0x2014) return '-';
+    if (cp == 0x2022 || cp == 0x00B7) return '*';
+    return '?';
+}
+
+// ---------------------------------------------------------------------------
+// Parser
+// ---------------------------------------------------------------------------
+
+void VtTerminal::control(uint8_t c) {
+    switch (c) {
+        case 0x07:  // BEL
+            _bells++;
+            break;
+        case 0x08:  // BS
+            if (_cx > 0) _cx--;
+            _wrapPending = false;
+            _gen++;
+            break;
+        case 0x09: {  // HT
+            uint16_t next = (_cx / VT_TAB_WIDTH + 1) * VT_TAB_WIDTH;
+            _cx = next < _cols ? next : _cols - 1;
+            _gen++;
+            break;
+        }
+        case 0x0A:  // LF
+        case 0x0B:  // VT
+        case 0x0C:  // FF
+            lineFeed();
+            _wrapPending = false;
+            _gen++;
+            break;
+        case 0x0D:  // CR
+            _cx = 0;
+            _wrapPending = false;
+            _gen++;
+            break;
+        default:
+            break;
+    }
+}
+
+size_t VtTerminal::write(const char *data, size_t len) {
+    if (_screen == NULL) return len;
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)data[i];
+
+        // Out of decode work for this frame: the rest waits for the next
+        if (_state == ST_SIXEL && _sixel.paused()) return i;
+
+        // CAN/SUB abort any sequence; ESC restarts one
+        if (c == 0x18 || c == 0x1A) {
+            if (_sixel.active()) sixelEnd();
+            _state = ST_GROUND;
+            _utf8Left = 0;
+            continue;
+        }
+        if (c == 0x1B) {
+            if (_state == ST_OSC || _state == ST_STRING || _state == ST_SIXEL) {
+                _state = ST_STRING_ESC;  // Possible ST (ESC \)
+            } else {
+                _state = ST_ESCAPE;
+            }
+            _utf8Left = 0;
+            continue;
+        }
+
+        switch (_state) {
+            case ST_GROUND:
+                if (c < 0x20) {
+                    control(c);
+                } else if (c < 0x7F) {
+                    _utf8Left = 0;
+                    putChar(c);
+                } else if (c == 0x7F) {
+                    // DEL: ignored
+                } else if (c >= 0xC0 && c < 0xF8) {
+                    _utf8Left = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : 1;
+                    _utf8 = c & (0x3F >> _utf8Left);
+                } else if (c >= 0x80 && c < 0xC0 && _utf8Left > 0) {
+                    _utf8 = (_utf8 << 6) | (c & 0x3F);
+                    if (--_utf8Left == 0) {
+                        putChar(mapCodepoint(_utf8));
+                    }
+                } else {
+                    // Stray continuation or invalid lead byte
+                    _utf8Left = 0;
+                    putChar('?');
+                }
+                break;
+
+            case ST_ESCAPE:
+                escDispatch(c);
+                break;
+
+            case ST_ESCAPE_SKIP:
+                _state = ST_GROUND;
+                break;
+
+            case ST_CSI:
+                if (c >= '0' && c <= '9') {
+                    if (_nparams == 0) _nparams = 1;
+                    uint32_t v = _params[_nparams - 1] * 10 + (c - '0');
+                    _params[_nparams - 1] = v > VT_PARAM_MAX ? VT_PARAM_MAX : v;
+                } else if (c == ';' || c == ':') {
+                    if (_nparams == 0) _nparams = 1;
+                    if (_nparams < VT_MAX_PARAMS) {
+                        _params[_nparams++] = 0;
+                    }
+                } else if (c >= '<' && c <= '?') {
+                    _private = c;
+                } else if (c >= 0x20 && c <= 0x2F) {
+                    _inter = c;
+                } else if (c >= 0x40 && c <= 0x7E) {
+                    csiDispatch(c);
+                    _state = ST_GROUND;
+                } else if (c < 0x20) {
+                    control(c);  // C0 controls execute inside CSI
+                } else {
+                    _state = ST_GROUND;
+                }
+                break;
+
+            case ST_OSC:
+                // Window title etc: not kept, so no buffering at all
+                if (c == 0x07) _state = ST_GROUND;
+                break;
+
+            case ST_DCS:
+                if (c == 'q') {
+                    sixelStart();
+                    _state = ST_SIXEL;
+                } else if (c >= 0x40 && c <= 0x7E) {
+                    _state = ST_STRING;
+                }
+                // Parameters and intermediates are not used
+                break;
+
+            case ST_SIXEL:
+                sixelData(c);
+                break;
+
+            case ST_STRING:
+                break;
+
+            case ST_STRING_ESC:
+                if (c == '\\') {
+                    if (_sixel.active()) sixelEnd();
+                    _state = ST_GROUND;
+                } else if (c == '[') {
+                    // Unterminated string followed by a new sequence
+                    if (_sixel.active()) sixelEnd();
+                    _state = ST_ESCAPE;
+                    escDispatch(c);
+                } else {
+                    _state = _sixel.active() ? ST_SIXEL : ST_STRING;
+                }
+                break;
+        }
+    }
+    return len;
+}
+
+void VtTerminal::escDispatch(uint8_t c) {
+    _state = ST_GROUND;
+
+    switch (c) {
+        case '[':
+            _state = ST_CSI;
+            _nparams = 0;
+            _private = 0;
+            _inter = 0;
+            memset(_params, 0, sizeof(_params));
+            break;
+        case ']':
+            _state = ST_OSC;
+            break;
+        case 'P':  // DCS
+            _state = ST_DCS;
+            break;
+        case 'X':  // SOS
+        case '^':  // PM
+        case '_':  // APC
+            _state = ST_STRING;
+            break;
+        case '(':
+        case ')':
+        case '*':
+        case '+':
+        case '#':
+        case '%':
+            _state = ST_ESCAPE_SKIP;
+            break;
+        case '7':  // DECSC
+            _savedX = _cx;
+            _savedY = _cy;
+            _savedAttr = _attr;
+            break;
+        case '8':  // DECRC
+            setCursor(_savedX, _savedY);
+            _attr = _savedAttr;
+            _gen++;
+            break;
+        case 'D':  // IND
+            lineFeed();
+            _gen++;
+            break;
+        case 'E':  // NEL
+            _cx = 0;
+            lineFeed();
+            _gen++;
+            break;
+        case 'M':  // RI
+            reverseIndex();
+            _gen++;
+            break;
+        case 'c':  // RIS
+            reset();
+            break;
+        default:
+            // Keypad modes (= >) and anything unknown
+            break;
+    }
+}
+
+uint16_t VtTerminal::param(int i, uint16_t def) const {
+    if (i >= _nparams || _params[i] == 0) return def;
+    return _params[i];
+}
+
+void VtTerminal::respond(const char *text) {
+    if (_responder) _responder(text, strlen(text));
+}
+
+void VtTerminal::csiDispatch(uint8_t final) {
+    if (_inter != 0 && final != 'q') return;  // DECSCUSR etc: ignored
+
+    uint16_t n = param(0, 1);
+
+    switch (final) {
+        case '@': {  // ICH
+            VtRow &row = _screen[_cy];
+            if (n > _cols - _cx) n = _cols - _cx;
+            memmove(&row.cells[_cx + n], &row.cells[_cx], (_cols - _cx - n) * sizeof(VtCell));
+            clearRow(row, _cx, _cx + n);
+            break;
+        }
+        case 'A':  // CUU
+            setCursor(_cx, (_cy >= _scrollTop && _cy - n < _scrollTop) ? _scrollTop : _cy - n);
+            break;
+        case 'B':  // CUD
+            setCursor(_cx, (_cy <= _scrollBottom && _cy + n > _scrollBottom) ? _scrollBottom : _cy + n);
+            break;
+        case 'C':  // CUF
+            setCursor(_cx + n, _cy);
+            break;
+        case 'D':  // CUB
+            setCursor(_cx - n, _cy);
+            break;
+        case 'E':  // CNL
+            setCursor(0, _cy + n);
+            break;
+        case 'F':  // CPL
+            setCursor(0, _cy - n);
+            break;
+        case 'G':  // CHA
+        case '`':  // HPA
+            setCursor(n - 1, _cy);
+            break;
+        case 'H':  // CUP
+        case 'f':  // HVP
+            setCursor(param(1, 1) - 1, param(0, 1) - 1);
+            break;
+        case 'J': {  // ED
+            uint16_t mode = param(0, 0);
+            if (mode == 0) {
+                clearRow(_screen[_cy], _cx, _cols);
+                for (uint16_t y = _cy + 1; y < _rows; y++) clearRow(_screen[y], 0, _cols);
+            } else if (mode == 1) {
+                for (uint16_t y = 0; y < _cy; y++) clearRow(_screen[y], 0, _cols);
+                clearRow(_screen[_cy], 0, _cx + 1);
+            } else if (mode == 2) {
+                clearScreen();
+            } else if (mode == 3) {
+                sbClear();
+            }
+            break;
+        }
+        case 'K': {  // EL
+            uint16_t mode = param(0, 0);
+            if (mode == 0) clearRow(_screen[_cy], _cx, _cols);
+            else if (mode == 1) clearRow(_screen[_cy], 0, _cx + 1);
+            else if (mode == 2) clearRow(_screen[_cy], 0, _cols);
+            break;
+        }
+        case 'L':  // IL
+            if (_cy >= _scrollTop && _cy <= _scrollBottom) {
+                scrollDown(_cy, _scrollBottom, n);
+                _cx = 0;
+            }
+            break;
+        case 'M':  // DL
+            if (_cy >= _scrollTop && _cy <= _scrollBottom) {
+                // Deleted lines are not history, so don't go through scrollUp()
+                uint16_t height = _scrollBottom - _cy + 1;
+                if (n > height) n = height;
+                for (uint16_t i = 0; i < n; i++) {
+                    VtRow first = _screen[_cy];
+                    memmove(&_screen[_cy], &_screen[_cy + 1], (height - 1) * sizeof(VtRow));
+                    _screen[_scrollBottom] = first;
+                    clearRow(_screen[_scrollBottom], 0, _cols);
+                }
+                _cx = 0;
+            }
+            break;
+        case 'P': {  // DCH
+            VtRow &row = _screen[_cy];
+            if (n > _cols - _cx) n = _cols - _cx;
+            memmove(&row.cells[_cx], &row.cells[_cx + n], (_cols - _cx - n) * sizeof(VtCell));
+            clearRow(row, _cols - n, _cols);
+            break;
+        }
+        case 'S':  // SU
+            scrollUp(_scrollTop, _scrollBottom, n);
+            break;
+        case 'T':  // SD
+            if (_private == 0) scrollDown(_scrollTop, _scrollBottom, n);
+            break;
+        case 'X':  // ECH
+            clearRow(_screen[_cy], _cx, _cx + n);
+            break;
+        case 'd':  // VPA
+            setCursor(_cx, n - 1);
+            break;
+        case 'm':  // SGR
+            if (_private == 0) sgr();
+            break;
+        case 'r': {  // DECSTBM
+            uint16_t top = param(0, 1) - 1;
+            uint16_t bottom = param(1, _rows) - 1;
+            if (bottom >= _rows) bottom = _rows - 1;
+            if (top < bottom) {
+                _scrollTop = top;
+                _scrollBottom = bottom;
+                setCursor(0, 0);
+            }
+            break;
+        }
+        case 'h':
+            setMode(true);
+            break;
+        case 'l':
+            setMode(false);
+            break;
+        case 's':  // SCOSC
+            _savedX = _cx;
+            _savedY = _cy;
+            break;
+        case 'u':  // SCORC
+            setCursor(_savedX, _savedY);
+            break;
+        case 'n':  // DSR
+            if (param(0, 0) == 6) {
+                char buf[24];
+                snprintf(buf, sizeof(buf), "\x1b[%u;%uR", _cy + 1, _cx + 1);
+                respond(buf);
+            } else if (param(0, 0) == 5) {
+                respond("\x1b[0n");
+            }
+            break;
+        case 'c':  // DA
+            if (_private == 0) respond("\x1b[?1;2c");
+            break;
+        default:
+            break;
+    }
+    _gen++;
+}
+
+void VtTerminal::setMode(bool on) {
+    if (_private != '?') return;  // ANSI modes (IRM, LNM) not supported
+
+    int count = _nparams ? _nparams : 1;
+    for (int i = 0; i < count; i++) {
+        switch (_params[i]) {
+            case 7:  // DECAWM
+                _autoWrap = on;
+                if (!on) _wrapPending = false;
+                break;
+            case 25:  // DECTCEM
+                _cursorVisible = on;
+                break;
+            case 47:
+            case 1047:
+            case 1049:
+                setAltScreen(on);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void VtTerminal::sgr() {
+    if (_nparams == 0) {
+        _attr = 0;
+        return;
+    }
+
+    for (int i = 0; i < _nparams; i++) {
+        uint16_t p = _params[i];
+        switch (p) {
+            case 0: _attr = 0; break;
+            case 1: _attr |= VT_ATTR_BOLD; break;
+            case 4: _attr |= VT_ATTR_UNDERLINE; break;
+            case 7: _attr |= VT_ATTR_REVERSE; break;
+            case 22: _attr &= ~VT_ATTR_BOLD; break;
+            case 24: _attr &= ~VT_ATTR_UNDERLINE; break;
+            case 27: _attr &= ~VT_ATTR_REVERSE; break;
+            case 38:
+            case 48:
+                // Extended colour: 5;n or 2;r;g;b (colours are not kept)
+                if (i + 1 < _nparams && _params[i + 1] == 5) i += 2;
+                else if (i + 1 < _nparams && _params[i + 1] == 2) i += 4;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Text view
+// ---------------------------------------------------------------------------
+
+static size_t appendRow(char *out, size_t pos, size_t cap, const VtCell *cells, int cols, int minLen) {
+    int len = cols;
+    while (len > minLen && cells[len - 1].ch == ' ') len--;
+    for (int x = 0; x < len && pos + 1 < cap; x++) {
+        out[pos++] = cells[x].ch;
+    }
+    return pos;
+}
+
+size_t VtTerminal::renderText(char *out, size_t cap, int historyOffset, int historyRows,
+                              int firstCol, int numCols, size_t *cursorIndex) const {
+    if (cap == 0) return 0;
+    if (_screen == NULL) {
+        out[0] = '\0';
+        if (cursorIndex) *cursorIndex = 0;
+        return 0;
+    }
+
+    if (firstCol < 0 || firstCol >= _cols) firstCol = 0;
+    if (numCols <= 0 || numCols > _cols - firstCol) numCols = _cols - firstCol;
+
+    // Never let history push the screen out of the buffer
+    int maxHistory = (int)(cap / (numCols + 1)) - _rows;
+    if (historyRows > maxHistory) historyRows = maxHistory;
+    if (historyRows < 0 || historyOffset < 0 || altScreen()) historyRows = 0;
+
+    // Oldest first, from the top row that exists
+    uint16_t len;
+    bool wrapped;
+    while (historyRows > 0 && historyRow(historyOffset + historyRows - 1, &len, &wrapped) == NULL) {
+        historyRows--;
+    }
+    size_t pos = 0;
+    for (int up = historyOffset + historyRows - 1; up >= historyOffset; up--) {
+        const VtCell *cells = historyRow(up, &len, &wrapped);
+        int visible = len > firstCol ? len - firstCol : 0;
+        if (visible > numCols) visible = numCols;
+        if (visible > 0) pos = appendRow(out, pos, cap, cells + firstCol, visible, 0);
+        if (pos + 1 < cap) out[pos++] = '\n';
+    }
+
+    int cursorCol = _cx - firstCol;
+    if (cursorCol < 0) cursorCol = 0;
+    if (cursorCol > numCols) cursorCol = numCols;
+    size_t cursor = pos;
+    for (uint16_t y = 0; y < _rows; y++) {
+        size_t start = pos;
+        pos = appendRow(out, pos, cap, _screen[y].cells + firstCol, numCols, y == _cy ? cursorCol : 0);
+        if (y == _cy) cursor = start + cursorCol;
+        if (y + 1 < _rows && pos + 1 < cap) out[pos++] = '\n';
+    }
+
+    out[pos] = '\0';
+    if (cursorIndex) *cursorIndex = cursor < pos ? cursor : pos;
+    return pos;
+}
@@ -0,0 +1,231 @@
+/**
+ * VT Terminal Model for T-LoRa Pager Terminal
+ * Escape-sequence parser, cell grid and scrollback (xterm subset)
+ *
+ * The model is independent of LVGL: output is parsed into the grid at
+ * full speed and the UI decides when to draw it (see generation()).
+ */
+
+#ifndef VT_TERMINAL_H
+#define VT_TERMINAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sixel.h"
+
+#define VT_MAX_PARAMS 16
+#define VT_PARAM_MAX 9999
+#define VT_SB_LINE_MAX 1024  // Longer logical lines are split in scrollback
+
+// Cell attributes
+#define VT_ATTR_BOLD      0x01
+#define VT_ATTR_UNDERLINE 0x02
+#define VT_ATTR_REVERSE   0x04
+
+// Row flags
+#define VT_ROW_WRAPPED 0x01  // Line continues on the next row (soft wrap)
+
+typedef struct {
+    uint8_t ch;
+    uint8_t attr;
+} VtCell;
+
+typedef struct {
+    VtCell *cells;
+    uint8_t flags;
+} VtRow;
+
+// Callback for replies to the host (DSR, DA)
+typedef void (*VtResponder)(const char *data, size_t len);
+
+class VtTerminal {
+public:
+    VtTerminal();
+    ~VtTerminal();
+
+    // Allocate grid and scrollback (scrollbackLines lines of cols cells)
+    bool begin(uint16_t cols, uint16_t rows, uint16_t scrollbackLines);
+
+    // New grid size. The screens keep their top-left corner; when rows
+    // shrink below the cursor, rows off the top go to scrollback.
+    // Scrollback is not touched: it is rewrapped as rows are read.
+    bool resize(uint16_t cols, uint16_t rows);
+
+    // Parse output from the host into the model. Returns the bytes
+    // taken: fewer than len only when a sixel image has used up this
+    // frame's decode work, and the rest must be written again after the
+    // next imageFrame().
+    size_t write(const char *data, size_t len);
+
+    // Full reset (RIS)
+    void reset();
+
+    // Become a copy of other's screens, cursor, modes and parser state
+    // (scrollback is left alone). Geometry must match.
+    bool copyScreenFrom(const VtTerminal &other);
+
+    // Escape sequences that repaint this screen (text, attributes,
+    // cursor) on a terminal of the same size. Returns the length.
+    size_t renderRepaint(char *out, size_t cap) const;
+
+    void setResponder(VtResponder responder) { _responder = responder; }
+
+    // Sixel images (DCS ... q) are decoded into the cache, placed at the
+    // cursor and moved with their rows; the cursor goes to the line below.
+    // Without a cache, or with too few tiles, an image is a placeholder
+    // label in reverse video. A label is also left under every image, for the
+    // text views (history, mosh).
+    void setImageCache(SixelCache *cache);
+
+    // Start of a UI frame: sixel decoding gets a new work budget, and an
+    // image paused by write() can go on
+    void imageFrame() { _sixel.frame(); }
+
+    // Geometry and cursor
+    uint16_t cols() const { return _cols; }
+    uint16_t rows() const { return _rows; }
+    uint16_t cursorX() const { return _cx; }
+    uint16_t cursorY() const { return _cy; }
+    bool cursorVisible() const { return _cursorVisible; }
+    bool altScreen() const { return _screen == _alt; }
+
+    // Parser between sequences and characters (no CSI, OSC, DCS or
+    // UTF-8 sequence half received), so local writes cannot split one
+    bool idle() const { return _state == ST_GROUND && _utf8Left == 0; }
+
+    // Attributes (VT_ATTR_*) new characters are drawn with
+    uint8_t attr() const { return _attr; }
+
+    // Screen rows (0 = top)
+    const VtRow& row(int y) const { return _screen[y]; }
+
+    // Scrollback is kept as logical lines (soft-wrapped rows joined), so
+    // it does not depend on the width. historyRow() wraps them at the
+    // current width on the fly: row `up` above the screen (0 = just
+    // above), len cells long (the rest of the row is blank), or NULL past
+    // the oldest line. The last position looked up is kept, so reading a
+    // screen of rows in order costs one step per row, and a width change
+    // only costs the rows read afterwards. The pointer is valid until the
+    // next call.
+    int scrollbackCount() const { return _sbCount; }  // Logical lines
+    const VtCell* historyRow(int up, uint16_t *len, bool *wrapped) const;
+
+    // Bumped on every visible change; compare to skip redundant draws
+    uint32_t generation() const { return _gen; }
+
+    // BEL characters received since the last call
+    uint32_t takeBells();
+
+    // Plain-text view: historyRows rows of history, starting historyOffset
+    // rows above the screen, followed by the screen, one line per row.
+    // Only columns firstCol..firstCol+numCols-1 are copied (a viewport
+    // onto a grid wider than the display). Returns the length written and
+    // the text offset of the cursor (clamped to the viewport).
+    size_t renderText(char *out, size_t cap, int historyOffset, int historyRows,
+                      int firstCol, int numCols, size_t *cursorIndex) const;
+
+private:
+    enum State {
+        ST_GROUND,
+        ST_ESCAPE,
+        ST_ESCAPE_SKIP,   // ESC ( B etc: one designator byte follows
+        ST_CSI,
+        ST_OSC,
+        ST_DCS,           // DCS parameters, up to the final byte
+        ST_SIXEL,         // DCS q: sixel data to the decoder until ST
+        ST_STRING,        // Other DCS, SOS/PM/APC: ignored until ST
+        ST_STRING_ESC
+    };
+
+    uint16_t _cols;
+    uint16_t _rows;
+
+    // Screens (row arrays are rotated on scroll, cells never move)
+    VtCell *_cellStore;
+    VtRow *_primary;
+    VtRow *_alt;
+    VtRow *_screen;
+
+    // Scrollback: logical lines over a ring of cells, oldest evicted first
+    struct SbLine {
+        uint32_t start;     // Cell ring offset
+        uint16_t len;
+    };
+    VtCell *_sbCells;
+    uint32_t _sbCellCap;
+    uint32_t _sbCellUsed;
+    uint32_t _sbWrite;      // Next cell slot
+    SbLine *_sbLines;
+    uint16_t _sbCapacity;   // Lines
+    uint32_t _sbFirst;      // Sequence number of the oldest line
+    uint16_t _sbCount;
+    bool _sbOpen;           // Last row pushed was soft-wrapped
+    VtCell *_sbRowBuf;      // A row that straddles the end of the ring
+
+    // Last row found by historyRow() (_viewUp < 0: none)
+    mutable int _viewUp;
+    mutable uint32_t _viewSeq;
+    mutable uint16_t _viewRow;
+
+    // Cursor and modes
+    uint16_t _cx, _cy;
+    bool _wrapPending;
+    bool _autoWrap;
+    bool _cursorVisible;
+    uint8_t _attr;
+    uint16_t _scrollTop, _scrollBottom;
+    uint16_t _savedX, _savedY;
+    uint8_t _savedAttr;
+
+    // Parser
+    State _state;
+    uint16_t _params[VT_MAX_PARAMS];
+    uint8_t _nparams;
+    char _private;      // CSI private marker (? > = <)
+    char _inter;        // CSI intermediate byte
+    uint32_t _utf8;     // Partial UTF-8 code point
+    uint8_t _utf8Left;
+
+    uint32_t _gen;
+    uint32_t _bells;
+    VtResponder _responder;
+
+    // Sixel image being decoded
+    SixelCache *_images;
+    SixelDecoder _sixel;
+    int _sixelTop;
+    uint16_t _sixelLeft;
+
+    void freeBuffers();
+    bool allocScreens(uint16_t cols, uint16_t rows, VtCell **store, VtRow **primary, VtRow **alt);
+    SbLine& sbLine(uint32_t seq) const { return _sbLines[seq % _sbCapacity]; }
+    uint16_t sbRows(uint16_t len) const { return len == 0 ? 1 : (len + _cols - 1) / _cols; }
+    void sbEvict();
+    void sbClear();
+    void clearRow(VtRow &row, uint16_t from, uint16_t to);
+    void clearScreen();
+
+    void putChar(uint8_t ch);
+    void control(uint8_t c);
+    void lineFeed();
+    void reverseIndex();
+    void scrollUp(uint16_t top, uint16_t bottom, uint16_t n);
+    void scrollDown(uint16_t top, uint16_t bottom, uint16_t n);
+    void imagesScrolled(uint16_t top, uint16_t bottom, int n);
+    void pushScrollback(const VtRow &row);
+    void setCursor(int x, int y);
+    void setAltScreen(bool on);
+    void sixelStart();
+    void sixelData(uint8_t c);
+    void sixelEnd();
+
+    void escDispatch(uint8_t c);
+    void csiDispatch(uint8_t final);
+    void setMode(bool on);
+    void sgr();
+    uint16_t param(int i, uint16_t def) const;
+    void respond(const char *text);
+    uint8_t mapCodepoint(uint32_t cp) const;
+};
+
+#endif // VT_TERMINAL_H
@@ -0,0 +1,312 @@
+/**
+ * XML Reader Implementation
+ */
+
+#include "xml_reader.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool startsWith(const char* p, const char* end, const char* s) {
+    size_t n = strlen(s);
+    return (size_t)(end - p) >= n && memcmp(p, s, n) == 0;
+}
+
+// End of the name starting at p
+static const char* nameEnd(const char* p, const char* end) {
+    while (p < end && !isSpace(*p) && *p != '>' && *p != '/' && *p != '=') p++;
+    return p;
+}
+
+static bool nameIs(const char* p, const char* end, const char* name) {
+    size_t n = nameEnd(p, end) - p;
+    return strlen(name) == n && memcmp(p, name, n) == 0;
+}
+
+// Past a comment, declaration, CDATA section or DOCTYPE at p ('<');
+// NULL if it does not end
+static const char* skipMarkup(const char* p, const char* end) {
+    const char* close;
+    if (startsWith(p, end, "<!--")) {
+        close = "-->";
+    } else if (startsWith(p, end, "<![CDATA[")) {
+        close = "]]>";
+    } else if (startsWith(p, end, "<?")) {
+        close = "?>";
+    } else {
+        close = ">";
+    }
+    size_t n = strlen(close);
+    for (p += 2; (size_t)(end - p) >= n; p++) {
+        if (memcmp(p, close, n) == 0) return p + n;
+    }
+    return NULL;
+}
+
+// Next start or end tag at or after p, passing over text and other
+// markup; NULL at the end of the document or in broken markup
+static const char* nextTag(const char* p, const char* end) {
+    while (p && p < end) {
+        if (*p != '<') {
+            p++;
+        } else if (p + 1 >= end) {
+            return NULL;
+        } else if (p[1] == '!' || p[1] == '?') {
+            p = skipMarkup(p, end);
+        } else {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// '>' of the tag at p, past quoted attribute values; NULL if it does
+// not end
+static const char* tagEnd(const char* p, const char* end) {
+    char quote = 0;
+    for (p++; p < end; p++) {
+        if (quote) {
+            if (*p == quote) quote = 0;
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == '>') {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static bool selfClosing(const char* gt) {
+    return gt[-1] == '/';
+}
+
+// Past the element whose start tag is at p, children and end tag
+// included; NULL if it does not close
+static const char* skipElement(const char* p, const char* end) {
+    const char* gt = tagEnd(p, end);
+    if (gt == NULL) return NULL;
+    if (selfClosing(gt)) return gt + 1;
+
+    int depth = 1;
+    for (p = gt + 1; (p = nextTag(p, end)) != NULL; p = gt + 1) {
+        gt = tagEnd(p, end);
+        if (gt == NULL) return NULL;
+        if (p[1] == '/') {
+            if (--depth == 0) return gt + 1;
+        } else if (!selfClosing(gt)) {
+            depth++;
+        }
+    }
+    return NULL;
+}
+
+// First element called name (NULL: any) among the siblings from p on;
+// NULL at the parent's end tag
+static const char* findElement(const char* p, const char* end, const char* name) {
+    while ((p = nextTag(p, end)) != NULL && p[1] != '/') {
+        if (name == NULL || nameIs(p + 1, end, name)) return p;
+        p = skipElement(p, end);
+    }
+    return NULL;
+}
+
+static void putUtf8(uint32_t cp, char* out, size_t cap, size_t* n, bool* fits) {
+    char enc[4];
+    size_t len;
+    if (cp < 0x80) {
+        enc[0] = (char)cp;
+        len = 1;
+    } else if (cp < 0x800) {
+        enc[0] = (char)(0xC0 | cp >> 6);
+        enc[1] = (char)(0x80 | (cp & 0x3F));
+        len = 2;
+    } else if (cp < 0x10000) {
+        enc[0] = (char)(0xE0 | cp >> 12);
+        enc[1] = (char)(0x80 | (cp >> 6 & 0x3F));
+        enc[2] = (char)(0x80 | (cp & 0x3F));
+        len = 3;
+    } else {
+        enc[0] = (char)(0xF0 | cp >> 18);
+        enc[1] = (char)(0x80 | (cp >> 12 & 0x3F));
+        enc[2] = (char)(0x80 | (cp >> 6 & 0x3F));
+        enc[3] = (char)(0x80 | (cp & 0x3F));
+        len = 4;
+    }
+    // Whole characters only
+    if (*n + len >= cap) {
+        *fits = false;
+        return;
+    }
+    memcpy(out + *n, enc, len);
+    *n += len;
+}
+
+// Character or entity reference at p ('&'); its length, 0 if it is not one
+static size_t reference(const char* p, const char* stop, uint32_t* cp) {
+    static const struct {
+        const char* name;
+        char c;
+    } entities[] = {{"&lt;", '<'}, {"&gt;", '>'}, {"&amp;", '&'}, {"&quot;", '"'}, {"&apos;", '\''}};
+    for (size_t i = 0; i < sizeof(entities) / sizeof(entities[0]); i++) {
+        if (startsWith(p, stop, entities[i].name)) {
+            *cp = (uint8_t)entities[i].c;
+            return strlen(entities[i].name);
+        }
+    }
+    if (!startsWith(p, stop, "&#")) return 0;
+
+    bool hex = p + 2 < stop && (p[2] == 'x' || p[2] == 'X');
+    const char* q = p + (hex ? 3 : 2);
+    uint32_t v = 0;
+    size_t digits = 0;
+    for (; q < stop && *q != ';'; q++, digits++) {
+        int d;
+        if (*q >= '0' && *q <= '9') d = *q - '0';
+        else if (hex && *q >= 'a' && *q <= 'f') d = *q - 'a' + 10;
+        else if (hex && *q >= 'A' && *q <= 'F') d = *q - 'A' + 10;
+        else return 0;
+        v = v * (hex ? 16 : 10) + d;
+        if (v > 0x10FFFF) return 0;
+    }
+    if (q >= stop || digits == 0 || v == 0) return 0;
+    *cp = v;
+    return q + 1 - p;
+}
+
+// p..stop into out with references decoded; false if truncated
+static bool decode(const char* p, const char* stop, char* out, size_t cap) {
+    if (cap == 0) return p == stop;
+    size_t n = 0;
+    bool fits = true;
+    while (p < stop && fits) {
+        uint32_t cp;
+        size_t len = *p == '&' ? reference(p, stop, &cp) : 0;
+        if (len) {
+            putUtf8(cp, out, cap, &n, &fits);
+            p += len;
+        } else if (n + 1 < cap) {
+            out[n++] = *p++;
+        } else {
+            fits = false;
+        }
+    }
+    out[n] = '\0';
+    return fits;
+}
+
+XmlElement XmlElement::firstChild(const char* name) const {
+    if (_tag == NULL) return XmlElement();
+    const char* gt = tagEnd(_tag, _end);
+    if (gt == NULL || selfClosing(gt)) return XmlElement();
+    const char* child = findElement(gt + 1, _end, name);
+    return child ? XmlElement(child, _end) : XmlElement();
+}
+
+XmlElement XmlElement::nextSibling(const char* name) const {
+    if (_tag == NULL) return XmlElement();
+    const char* after = skipElement(_tag, _end);
+    const char* sibling = after ? findElement(after, _end, name) : NULL;
+    return sibling ? XmlElement(sibling, _end) : XmlElement();
+}
+
+void XmlElement::name(char* out, size_t cap) const {
+    if (cap == 0) return;
+    size_t n = 0;
+    if (_tag) {
+        n = nameEnd(_tag + 1, _end) - (_tag + 1);
+        if (n >= cap) n = cap - 1;
+        memcpy(out, _tag + 1, n);
+    }
+    out[n] = '\0';
+}
+
+bool XmlElement::text(char* out, size_t cap) const {
+    if (cap > 0) out[0] = '\0';
+    if (_tag == NULL) return true;
+    const char* gt = tagEnd(_tag, _end);
+    if (gt == NULL || selfClosing(gt)) return true;
+    const char* stop = (const char*)memchr(gt + 1, '<', _end - (gt + 1));
+    return decode(gt + 1, stop ? stop : _end, out, cap);
+}
+
+bool XmlElement::textIs(const char* s) const {
+    char buf[XML_NUMBER_MAX];
+    return text(buf, sizeof(buf)) && strcmp(buf, s) == 0;
+}
+
+// Whole of s as a number (0x prefix: hex), surrounding spaces allowed
+static bool parseNumber(const char* s, bool allowSign, long long* value) {
+    while (isSpace(*s)) s++;
+    if (!allowSign && *s == '-') return false;
+    bool hex = s[0] == '0' && (s[1] == 'x' || s[1] == 'X');
+    char* endp;
+    long long v = strtoll(s, &endp, hex ? 16 : 10);
+    if (endp == s) return false;
+    while (isSpace(*endp)) endp++;
+    if (*endp != '\0') return false;
+    *value = v;
+    return true;
+}
+
+bool XmlElement::queryUnsigned(unsigned int* value) const {
+    char buf[XML_NUMBER_MAX];
+    long long v;
+    if (!text(buf, sizeof(buf)) || !parseNumber(buf, false, &v) || v > 0xFFFFFFFFLL) return false;
+    *value = (unsigned int)v;
+    return true;
+}
+
+bool XmlElement::attribute(const char* name, char* out, size_t cap) const {
+    if (cap > 0) out[0] = '\0';
+    if (_tag == NULL) return false;
+    const char* gt = tagEnd(_tag, _end);
+    if (gt == NULL) return false;
+
+    const char* p = nameEnd(_tag + 1, gt);
+    while (p < gt) {
+        while (p < gt && (isSpace(*p) || *p == '/')) p++;
+        if (p >= gt) break;
+        const char* attr = p;
+        p = nameEnd(p, gt);
+        if (p == attr) return false;  // Stray '=' or the like
+        bool match = nameIs(attr, p, name);
+
+        while (p < gt && isSpace(*p)) p++;
+        if (p >= gt || *p != '=') {
+            if (match) return true;   // Bare attribute: present, empty
+            continue;
+        }
+        for (p++; p < gt && isSpace(*p); p++) {}
+        if (p >= gt || (*p != '"' && *p != '\'')) return false;
+        const char* close = (const char*)memchr(p + 1, *p, gt - (p + 1));
+        if (close == NULL) return false;
+        if (match) {
+            decode(p + 1, close, out, cap);
+            return true;
+        }
+        p = close + 1;
+    }
+    return false;
+}
+
+bool XmlElement::queryIntAttribute(const char* name, int* value) const {
+    char buf[XML_NUMBER_MAX];
+    long long v;
+    if (!attribute(name, buf, sizeof(buf)) || !parseNumber(buf, true, &v) ||
+        v < -0x80000000LL || v > 0x7FFFFFFFLL) {
+        return false;
+    }
+    *value = (int)v;
+    return true;
+}
+
+XmlElement xmlRoot(const char* doc, size_t len, const char* name) {
+    const char* end = doc + len;
+    const char* root = findElement(doc, end, name);
+    if (root == NULL || skipElement(root, end) == NULL) return XmlElement();
+    return XmlElement(root, end);
+}
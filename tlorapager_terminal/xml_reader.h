@@ -0,0 +1,72 @@
+/**
+ * XML Reader for T-LoRa Pager Terminal
+ * Element, text and attribute lookup in place, without allocating
+ *
+ * ConfigLoader's files are small XML: elements, text, attributes,
+ * comments and the declaration. tinyxml2 copied each file and built a
+ * node tree in heap pools to read a few dozen values out of it; this
+ * reads the caller's buffer where it is instead. An XmlElement is a
+ * pointer to its start tag, and each lookup scans forward from there.
+ * Text and attribute values are copied out into caller buffers with
+ * the predefined entities and character references decoded.
+ *
+ * The buffer is never written and never read past its end. Markup is
+ * not validated beyond what a lookup passes over: xmlRoot() only
+ * checks that the root element closes, and a broken tag ends the
+ * lookup that reaches it. Close tag names are not matched.
+ */
+
+#ifndef XML_READER_H
+#define XML_READER_H
+
+#include <stddef.h>
+
+#define XML_NUMBER_MAX 24   // Longest numeric text or attribute value
+
+class XmlElement {
+public:
+    XmlElement() : _tag(NULL), _end(NULL) {}
+
+    explicit operator bool() const { return _tag != NULL; }
+
+    // First child element called name (NULL: any element)
+    XmlElement firstChild(const char* name = NULL) const;
+
+    // Next element called name (NULL: any) with the same parent
+    XmlElement nextSibling(const char* name = NULL) const;
+
+    // Element name into out (truncated to fit), for messages
+    void name(char* out, size_t cap) const;
+
+    // Text up to the first child element or comment into out; "" if
+    // there is none. Returns false if it had to be truncated.
+    bool text(char* out, size_t cap) const;
+
+    // Text is exactly s
+    bool textIs(const char* s) const;
+
+    // Text as a decimal (or 0x hex) number; false, with *value
+    // unchanged, if it is not one
+    bool queryUnsigned(unsigned int* value) const;
+
+    // Attribute value into out (truncated to fit); false, with out
+    // empty, if the element does not have it
+    bool attribute(const char* name, char* out, size_t cap) const;
+
+    // Attribute as a decimal number; false, with *value unchanged, if
+    // it is missing or not a number
+    bool queryIntAttribute(const char* name, int* value) const;
+
+private:
+    XmlElement(const char* tag, const char* end) : _tag(tag), _end(end) {}
+
+    const char* _tag;   // '<' of the start tag
+    const char* _end;   // End of the document
+
+    friend XmlElement xmlRoot(const char* doc, size_t len, const char* name);
+};
+
+// Root element of doc[0..len) if it is called name and closes
+XmlElement xmlRoot(const char* doc, size_t len, const char* name);
+
+#endif // XML_READER_H
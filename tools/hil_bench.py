@@ -0,0 +1,300 @@
+#!/usr/bin/env python3
+"""
+Hardware-in-the-loop benchmark runner for T-LoRa Pager Terminal
+
+Drives a pager over its USB serial port with the binary protocol in
+tlorapager_terminal/hil.h and prints the results as JSON:
+
+    tools/hil_bench.py /dev/ttyACM0 [--corpus FILE] [--keys N]
+                       [--bench render,scroll,...] [--reset]
+                       [--out run.json] [--compare old.json]
+
+Suite:
+  firmware    protocol version, build date, uptime
+  boot        boot phase times (ms since power-on); --reset reboots first
+  throughput  corpus streamed into the RX ring (as if from the host):
+              KB/s through parser and text area, display frames/s
+  latency     --keys keystrokes (x, then backspace), time until a frame
+              shows them; with a session open they go to the remote
+  heap        free / largest block / low-water mark, internal and PSRAM
+  bench       output of the on-device `bench NAME` commands
+
+The pager's log shares the port; it is kept out of the JSON except for
+the output of --bench commands. Needs pyserial.
+"""
+
+import argparse
+import json
+import statistics
+import struct
+import sys
+import time
+
+import serial
+
+SYNC = b"\xa5\x5a"
+PROTOCOL_VERSION = 1
+
+PING = 0x01
+STATS_RESET = 0x02
+COUNTERS = 0x03
+BOOT = 0x04
+REPLAY_DATA = 0x10
+REPLAY_WAIT = 0x11
+KEY = 0x20
+COMMAND = 0x30
+
+STATUS = ["ok", "bad crc", "unknown command", "busy", "timeout", "bad length"]
+
+# HilCounters_t
+COUNTER_FIELDS = [
+    "uptime_ms", "window_ms", "rx_bytes", "rx_dropped", "rx_pauses",
+    "render_bytes", "render_calls", "render_us", "render_frames", "jump_scrolls",
+    "display_frames", "display_us", "tx_keys", "tx_bytes",
+    "heap_free", "heap_largest", "heap_min_free", "psram_free",
+]
+COUNTER_FORMAT = "<%dI" % len(COUNTER_FIELDS)
+
+REPLAY_CHUNK = 1000
+CORPUS_LINES = 4000
+
+
+class HilError(Exception):
+    pass
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+class Pager:
+    def __init__(self, port, baud):
+        self.ser = serial.Serial(port, baud, timeout=0.05)
+        self.seq = 0
+        self.buf = b""
+        self.log = []
+
+    def reset(self):
+        # EN pulse through RTS, as esptool does
+        self.ser.dtr = False
+        self.ser.rts = True
+        time.sleep(0.1)
+        self.ser.rts = False
+        self.buf = b""
+
+    def _text(self, data):
+        self.log.extend(data.decode("utf-8", "replace").splitlines())
+
+    def _next_reply(self):
+        """Parse one reply frame out of the buffer, or None"""
+        while True:
+            i = self.buf.find(SYNC)
+            if i < 0:
+                # Keep a trailing A5 that may start the next frame
+                keep = 1 if self.buf.endswith(SYNC[:1]) else 0
+                self._text(self.buf[:len(self.buf) - keep])
+                self.buf = self.buf[len(self.buf) - keep:]
+                return None
+            if i:
+                self._text(self.buf[:i])
+                self.buf = self.buf[i:]
+            if len(self.buf) < 7:
+                return None
+            length = self.buf[5] | (self.buf[6] << 8)
+            if len(self.buf) < 9 + length:
+                return None
+            body = self.buf[2:7 + length]
+            crc = self.buf[7 + length] | (self.buf[8 + length] << 8)
+            if crc != crc16(body):
+                # A5 5A inside log text: skip it and rescan
+                self._text(self.buf[:2])
+                self.buf = self.buf[2:]
+                continue
+            self.buf = self.buf[9 + length:]
+            return body[0] & 0x7F, body[1], body[2], body[5:]
+
+    def request(self, cmd, payload=b"", timeout=10.0):
+        self.seq = (self.seq + 1) & 0xFF
+        head = struct.pack("<BBH", cmd, self.seq, len(payload))
+        self.ser.write(SYNC + head + payload + struct.pack("<H", crc16(head + payload)))
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            self.buf += self.ser.read(4096)
+            while True:
+                reply = self._next_reply()
+                if reply is None:
+                    break
+                rcmd, rseq, status, data = reply
+                if rcmd == cmd and rseq == self.seq:
+                    if status:
+                        raise HilError("command 0x%02x: %s" % (cmd, STATUS[status] if status < len(STATUS) else status))
+                    return data
+        raise HilError("command 0x%02x: no reply in %.0fs" % (cmd, timeout))
+
+    def ping(self):
+        data = self.request(PING)
+        version, uptime = struct.unpack_from("<BI", data)
+        return {"protocol": version, "uptime_ms": uptime, "build": data[5:].decode("ascii", "replace")}
+
+    def counters(self):
+        return dict(zip(COUNTER_FIELDS, struct.unpack(COUNTER_FORMAT, self.request(COUNTERS))))
+
+    def boot(self):
+        data = self.request(BOOT)
+        marks, pos = {}, 1
+        for _ in range(data[0]):
+            ms, n = struct.unpack_from("<IB", data, pos)
+            marks[data[pos + 5:pos + 5 + n].decode("ascii")] = ms
+            pos += 5 + n
+        return marks
+
+    def replay(self, corpus):
+        pos = 0
+        while pos < len(corpus):
+            chunk = corpus[pos:pos + REPLAY_CHUNK]
+            accepted = struct.unpack("<H", self.request(REPLAY_DATA, chunk))[0]
+            pos += accepted
+            if accepted < len(chunk):
+                time.sleep(0.002)  # Ring full: let the renderer catch up
+        return struct.unpack("<I", self.request(REPLAY_WAIT, timeout=30))[0]
+
+    def key(self, key):
+        return struct.unpack("<I", self.request(KEY, bytes([key])))[0]
+
+    def command(self, text, timeout=120):
+        self.log = []
+        ms = struct.unpack("<I", self.request(COMMAND, text.encode(), timeout=timeout))[0]
+        return ms, [line for line in self.log if line.strip()]
+
+
+def synthetic_corpus():
+    """Log-like output with some color, CRLF as the PTY sends it"""
+    lines = []
+    for i in range(CORPUS_LINES):
+        level = ("\x1b[32mINFO\x1b[0m", "\x1b[33mWARN\x1b[0m", "\x1b[31mERROR\x1b[0m")[i % 7 % 3]
+        lines.append("2024-01-01 12:%02d:%02d %s worker-%d: request %d served in %dms"
+                     % (i // 60 % 60, i % 60, level, i % 8, i, (i * 37) % 500))
+    return ("\r\n".join(lines) + "\r\n").encode()
+
+
+def percentiles(values):
+    values = sorted(values)
+    return {
+        "n": len(values),
+        "p50": values[len(values) // 2],
+        "p95": values[min(len(values) - 1, len(values) * 95 // 100)],
+        "max": values[-1],
+        "mean": round(statistics.mean(values)),
+    }
+
+
+def run_suite(pager, args):
+    result = {"runner": PROTOCOL_VERSION, "time": time.strftime("%Y-%m-%dT%H:%M:%S")}
+
+    if args.reset:
+        pager.reset()
+        deadline = time.time() + 30
+        while True:
+            try:
+                pager.ping()
+                break
+            except HilError:
+                if time.time() > deadline:
+                    raise
+        time.sleep(args.boot_wait)
+
+    result["firmware"] = pager.ping()
+    if result["firmware"]["protocol"] != PROTOCOL_VERSION:
+        raise HilError("pager speaks protocol %d, runner %d" % (result["firmware"]["protocol"], PROTOCOL_VERSION))
+    result["boot_ms"] = pager.boot()
+
+    corpus = open(args.corpus, "rb").read() if args.corpus else synthetic_corpus()
+    pager.request(STATS_RESET)
+    drain_us = pager.replay(corpus)
+    c = pager.counters()
+    window_s = max(c["window_ms"], 1) / 1000.0
+    result["throughput"] = {
+        "bytes": len(corpus),
+        "kb_per_s": round(c["render_bytes"] / 1024.0 / window_s, 1),
+        "render_ms": round(c["render_us"] / 1000.0, 1),
+        "drain_tail_ms": round(drain_us / 1000.0, 1),
+        "text_updates": c["render_frames"],
+        "jump_scrolls": c["jump_scrolls"],
+        "display_fps": round(c["display_frames"] / window_s, 1),
+        "display_ms_per_frame": round(c["display_us"] / 1000.0 / max(c["display_frames"], 1), 2),
+        "rx_dropped": c["rx_dropped"],
+    }
+
+    if args.keys:
+        typed, erased = [], []
+        for _ in range(args.keys):
+            typed.append(pager.key(ord("x")))
+            erased.append(pager.key(8))
+        result["latency_us"] = {"key": percentiles(typed), "backspace": percentiles(erased)}
+
+    c = pager.counters()
+    result["heap"] = {k: c[k] for k in ("heap_free", "heap_largest", "heap_min_free", "psram_free")}
+
+    if args.bench:
+        result["bench"] = {}
+        for name in args.bench.split(","):
+            ms, output = pager.command("bench " + name)
+            result["bench"][name] = {"ms": ms, "output": output}
+    return result
+
+
+def flatten(d, prefix=""):
+    for k, v in d.items():
+        key = prefix + k
+        if isinstance(v, dict):
+            yield from flatten(v, key + ".")
+        elif isinstance(v, (int, float)) and not isinstance(v, bool):
+            yield key, v
+
+
+def compare(old, new):
+    before = dict(flatten(old))
+    for key, value in flatten(new):
+        if key not in before or key.endswith("uptime_ms") or key == "runner":
+            continue
+        was = before[key]
+        change = "" if was == 0 else " (%+.1f%%)" % (100.0 * (value - was) / was)
+        print("%-40s %12s -> %-12s%s" % (key, was, value, change), file=sys.stderr)
+
+
+def main():
+    p = argparse.ArgumentParser(description="T-LoRa Pager HIL benchmark runner")
+    p.add_argument("port")
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--corpus", help="terminal output to stream (default: synthetic log)")
+    p.add_argument("--keys", type=int, default=20, help="keystroke latency samples (0 to skip)")
+    p.add_argument("--bench", help="comma-separated on-device benches, e.g. render,scroll,ui")
+    p.add_argument("--reset", action="store_true", help="reboot first, for boot phase times")
+    p.add_argument("--boot-wait", type=float, default=15, help="seconds to wait after --reset")
+    p.add_argument("--out", help="write JSON here instead of stdout")
+    p.add_argument("--compare", help="earlier JSON to print differences against")
+    args = p.parse_args()
+
+    try:
+        result = run_suite(Pager(args.port, args.baud), args)
+    except (HilError, serial.SerialException) as e:
+        sys.exit("hil_bench: %s" % e)
+
+    text = json.dumps(result, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    if args.compare:
+        with open(args.compare) as f:
+            compare(json.load(f), result)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,530 @@
+#!/usr/bin/env python3
+"""
+LVGL XML to C compiler for T-LoRa Pager Terminal
+
+Turns the LVGL XML project (globals.xml, components/, screens/) into
+widget-construction code, so the device never parses XML:
+
+    tools/lvgl_xml2c.py [CONFIG_DIR] [OUT_DIR]
+
+Defaults: data/config (what is uploaded to LittleFS, so the runtime
+loader in `bench ui` reads the same files) -> tlorapager_terminal/
+ui_generated.{h,cpp}. As a PlatformIO pre-script (extra_scripts of
+env:t-lora-pager-bench only; the firmware does not use the output) it
+regenerates before each build when any XML is newer than the output.
+
+Consts (#name) are folded into literals, component instances are
+expanded inline with their props substituted, and styles become static
+lv_style_t initialized once. The fonts and images named in globals.xml
+are not in the tree; built-in fonts and LV_SYMBOL glyphs stand in for
+them (FONTS / IMAGES below).
+
+Bindings:
+  <bind_state subject= ref_value= flag="hidden"/>  parent hidden while subject == ref_value
+  <bind_state subject= ref_value> children </...>  children shown only while subject ==
+                                                   ref_value, earlier siblings only while not
+  <bind_style name= subject= ref_value=/>          style applied while subject == ref_value
+  text="$subject" (after prop substitution)      label bound to a string subject
+"""
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+FONTS = {
+    "terminal_mono_10": "lv_font_montserrat_12",
+    "terminal_mono_12": "lv_font_montserrat_12",
+    "terminal_mono_14": "lv_font_montserrat_14",
+    "ui_regular_12": "lv_font_montserrat_12",
+    "ui_bold_12": "lv_font_montserrat_12",
+}
+
+IMAGES = {
+    "icon_wifi_0": "LV_SYMBOL_WIFI",
+    "icon_wifi_1": "LV_SYMBOL_WIFI",
+    "icon_wifi_2": "LV_SYMBOL_WIFI",
+    "icon_wifi_3": "LV_SYMBOL_WIFI",
+    "icon_wifi_off": "LV_SYMBOL_WARNING",
+    "icon_ws_connected": "LV_SYMBOL_OK",
+    "icon_ws_disconnected": "LV_SYMBOL_CLOSE",
+    "icon_ssl": "LV_SYMBOL_EYE_CLOSE",
+}
+
+WIDGETS = {
+    "lv_obj": "lv_obj_create",
+    "lv_label": "lv_label_create",
+    "lv_image": "lv_image_create",
+    "button": "lv_button_create",
+    "lv_button": "lv_button_create",
+    "switch": "lv_switch_create",
+    "lv_switch": "lv_switch_create",
+}
+
+ENUMS = {
+    "layout": {"flex": "LV_LAYOUT_FLEX", "grid": "LV_LAYOUT_GRID", "none": "LV_LAYOUT_NONE"},
+    "flex_flow": {"row": "LV_FLEX_FLOW_ROW", "column": "LV_FLEX_FLOW_COLUMN",
+                  "row_wrap": "LV_FLEX_FLOW_ROW_WRAP", "column_wrap": "LV_FLEX_FLOW_COLUMN_WRAP"},
+    "flex_main_place": None,
+    "flex_cross_place": None,
+    "flex_track_place": None,
+    "border_side": {"bottom": "LV_BORDER_SIDE_BOTTOM", "top": "LV_BORDER_SIDE_TOP",
+                    "left": "LV_BORDER_SIDE_LEFT", "right": "LV_BORDER_SIDE_RIGHT",
+                    "full": "LV_BORDER_SIDE_FULL", "none": "LV_BORDER_SIDE_NONE"},
+}
+FLEX_ALIGN = {"start": "LV_FLEX_ALIGN_START", "end": "LV_FLEX_ALIGN_END",
+              "center": "LV_FLEX_ALIGN_CENTER", "space-between": "LV_FLEX_ALIGN_SPACE_BETWEEN",
+              "space-around": "LV_FLEX_ALIGN_SPACE_AROUND", "space-evenly": "LV_FLEX_ALIGN_SPACE_EVENLY"}
+for _k in ("flex_main_place", "flex_cross_place", "flex_track_place"):
+    ENUMS[_k] = FLEX_ALIGN
+
+ALIGN = {"center": "LV_ALIGN_CENTER", "top_left": "LV_ALIGN_TOP_LEFT", "top_mid": "LV_ALIGN_TOP_MID",
+         "left_mid": "LV_ALIGN_LEFT_MID", "right_mid": "LV_ALIGN_RIGHT_MID",
+         "bottom_mid": "LV_ALIGN_BOTTOM_MID"}
+
+SELECTORS = {"main": "LV_PART_MAIN", "indicator": "LV_PART_INDICATOR", "knob": "LV_PART_KNOB",
+             "scrollbar": "LV_PART_SCROLLBAR", "pressed": "LV_STATE_PRESSED",
+             "checked": "LV_STATE_CHECKED", "focused": "LV_STATE_FOCUSED",
+             "disabled": "LV_STATE_DISABLED", "default": "LV_STATE_DEFAULT"}
+
+FLAGS = {"hidden": "LV_OBJ_FLAG_HIDDEN", "clickable": "LV_OBJ_FLAG_CLICKABLE",
+         "scrollable": "LV_OBJ_FLAG_SCROLLABLE"}
+
+# XML shorthand -> LVGL style property
+PROP_ALIASES = {"gap": "pad_gap"}
+
+OBJ_ATTRS_IGNORED = {"name", "extends"}
+
+
+class CompileError(Exception):
+    pass
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def c_ident(name):
+    return re.sub(r"[^A-Za-z0-9_]", "_", name)
+
+
+class Compiler:
+    def __init__(self, config_dir):
+        self.config_dir = config_dir
+        self.consts = {}
+        self.global_styles = {}     # name -> (c_name, props)
+        self.local_styles = {}      # scope -> {name -> (c_name, props)}
+        self.subjects = []          # (name, type, default)
+        self.components = {}        # name -> Element
+        self.screens = {}           # name -> Element
+        self.used_styles = []       # c_names in init order
+        self.style_defs = {}        # c_name -> props
+        self.refs = []              # ids, in tree order
+        self.counter = 0
+        self.inputs = []
+        self.load()
+
+    # ---- Loading ---------------------------------------------------------
+
+    def parse(self, path):
+        self.inputs.append(path)
+        return ET.parse(path).getroot()
+
+    def load(self):
+        root = self.parse(os.path.join(self.config_dir, "globals.xml"))
+        for const in root.iter("const"):
+            self.consts[const.get("name")] = const.get("value")
+        styles = root.find("styles")
+        for style in (styles if styles is not None else []):
+            name = style.get("name")
+            self.global_styles[name] = ("ui_style_" + c_ident(name), self.style_props(style))
+        subjects = root.find("subjects")
+        for subject in (subjects if subjects is not None else []):
+            self.subjects.append((subject.get("name"), subject.get("type"), subject.get("default", "")))
+
+        comp_dir = os.path.join(self.config_dir, "components")
+        for dirpath, _, files in sorted(os.walk(comp_dir)):
+            for f in sorted(files):
+                if f.endswith(".xml"):
+                    self.components[f[:-4]] = self.parse(os.path.join(dirpath, f))
+        screen_dir = os.path.join(self.config_dir, "screens")
+        for f in sorted(os.listdir(screen_dir)):
+            if f.endswith(".xml"):
+                self.screens[f[:-4]] = self.parse(os.path.join(screen_dir, f))
+
+    def style_props(self, el):
+        return [(k, v) for k, v in el.attrib.items() if k not in ("name", "selector")]
+
+    # ---- Values ----------------------------------------------------------
+
+    def resolve(self, value, props=None):
+        """Fold #const and $prop references into the literal value."""
+        for _ in range(8):
+            if value.startswith("$") and props is not None and value[1:] in props:
+                value = props[value[1:]]
+            elif value.startswith("#") and value[1:] in self.consts:
+                value = self.consts[value[1:]]
+            else:
+                break
+        return value
+
+    def style_value(self, prop, raw):
+        value = raw.strip()
+        if prop.endswith("_color"):
+            if not re.fullmatch(r"#[0-9A-Fa-f]{6}", value):
+                raise CompileError("bad color %s for %s" % (raw, prop))
+            return "lv_color_hex(0x%s)" % value[1:].upper()
+        if prop.endswith("opa") or prop == "opa":
+            if value.endswith("%"):
+                return str((int(value[:-1]) * 255 + 50) // 100)
+            return str(int(value))
+        if prop == "text_font":
+            if value not in FONTS:
+                raise CompileError("unknown font %s" % value)
+            return "&" + FONTS[value]
+        if prop in ENUMS:
+            if value not in ENUMS[prop]:
+                raise CompileError("unknown %s value %s" % (prop, value))
+            return ENUMS[prop][value]
+        if prop in ("width", "height", "min_width", "min_height", "max_width", "max_height"):
+            if value == "content":
+                return "LV_SIZE_CONTENT"
+            if value.endswith("%"):
+                return "lv_pct(%d)" % int(value[:-1])
+        return str(int(value))
+
+    def selector(self, raw):
+        if not raw:
+            return "0"
+        parts = []
+        for part in raw.split("|"):
+            if part not in SELECTORS:
+                raise CompileError("unknown selector %s" % part)
+            parts.append(SELECTORS[part])
+        return " | ".join(parts)
+
+    def ref_value(self, raw):
+        if raw in ("true", "false"):
+            return "1" if raw == "true" else "0"
+        return str(int(raw))
+
+    def subject_ref(self, name):
+        for n, _, _ in self.subjects:
+            if n == name:
+                return "&uiSubjects[UI_SUBJECT_%s]" % c_ident(name).upper()
+        raise CompileError("unknown subject %s" % name)
+
+    def subject_type(self, name):
+        for n, t, _ in self.subjects:
+            if n == name:
+                return t
+        return None
+
+    # ---- Styles ----------------------------------------------------------
+
+    def use_style(self, c_name, props):
+        if c_name not in self.style_defs:
+            self.style_defs[c_name] = props
+            self.used_styles.append(c_name)
+        return c_name
+
+    def find_style(self, name, scope):
+        local = self.local_styles.get(scope, {})
+        if name in local:
+            return self.use_style(*local[name])
+        if name in self.global_styles:
+            return self.use_style(*self.global_styles[name])
+        raise CompileError("unknown style %s in %s" % (name, scope))
+
+    def register_local_styles(self, scope, root):
+        if scope in self.local_styles:
+            return
+        styles = {}
+        block = root.find("styles")
+        for style in (block if block is not None else []):
+            name = style.get("name")
+            styles[name] = ("ui_style_%s_%s" % (c_ident(scope), c_ident(name)), self.style_props(style))
+        self.local_styles[scope] = styles
+
+    # ---- Code generation -------------------------------------------------
+
+    def new_var(self):
+        self.counter += 1
+        return "o%d" % self.counter
+
+    def apply_attrs(self, out, var, el, props, scope, skip=()):
+        for key, raw in el.attrib.items():
+            if key in skip or key in OBJ_ATTRS_IGNORED:
+                continue
+            if key == "id":
+                self.refs.append(raw)
+                out.append("    if (refs) refs->%s = %s;" % (c_ident(raw), var))
+                continue
+            value = self.resolve(raw, props)
+            if key.startswith("style_"):
+                prop = PROP_ALIASES.get(key[6:], key[6:])
+                out.append("    lv_obj_set_style_%s(%s, %s, 0);" % (prop, var, self.style_value(prop, value)))
+            elif key in ("width", "height"):
+                out.append("    lv_obj_set_%s(%s, %s);" % (key, var, self.style_value(key, value)))
+            elif key == "flex_flow":
+                out.append("    lv_obj_set_flex_flow(%s, %s);" % (var, self.style_value(key, value)))
+            elif key == "flex_grow":
+                out.append("    lv_obj_set_flex_grow(%s, %d);" % (var, int(value)))
+            elif key == "align":
+                out.append("    lv_obj_set_align(%s, %s);" % (var, ALIGN[value]))
+            elif key == "text":
+                self.emit_text(out, var, value)
+            elif key == "src":
+                out.append("    lv_image_set_src(%s, %s);" % (var, self.image(value)))
+            else:
+                raise CompileError("unsupported attribute %s on <%s>" % (key, el.tag))
+
+    def emit_text(self, out, var, value):
+        # "$name" left over after prop substitution names a string subject
+        if value.startswith("$") and self.subject_type(value[1:]) == "string":
+            out.append("    lv_label_bind_text(%s, %s, NULL);" % (var, self.subject_ref(value[1:])))
+        else:
+            out.append("    lv_label_set_text_static(%s, %s);" % (var, c_string(value)))
+
+    def image(self, value):
+        name = value[1:] if value.startswith("#") else value
+        if name not in IMAGES:
+            raise CompileError("unknown image %s" % value)
+        return IMAGES[name]
+
+    def emit_children(self, out, var, el, props, scope):
+        created = []
+        for child in el:
+            tag = child.tag
+            if tag in ("styles", "api"):
+                continue
+            if tag == "style":
+                c_name = self.find_style(child.get("name"), scope)
+                out.append("    lv_obj_add_style(%s, &%s, %s);" % (var, c_name, self.selector(child.get("selector"))))
+            elif tag == "remove_style":
+                out.append("    lv_obj_remove_style_all(%s);" % var)
+            elif tag == "bind_style":
+                c_name = self.find_style(child.get("name"), scope)
+                subject = self.resolve(child.get("subject"), props)
+                out.append("    lv_obj_bind_style(%s, &%s, %s, %s, %s);" % (
+                    var, c_name, self.selector(child.get("selector")),
+                    self.subject_ref(subject), self.ref_value(child.get("ref_value"))))
+            elif tag == "bind_state":
+                subject = self.subject_ref(self.resolve(child.get("subject"), props))
+                ref = self.ref_value(child.get("ref_value"))
+                if len(child) == 0:
+                    flag = FLAGS[child.get("flag", "hidden")]
+                    out.append("    lv_obj_bind_flag_if_eq(%s, %s, %s, %s);" % (var, subject, flag, ref))
+                    continue
+                for sibling in created:
+                    out.append("    lv_obj_bind_flag_if_eq(%s, %s, LV_OBJ_FLAG_HIDDEN, %s);" % (sibling, subject, ref))
+                for inner in self.emit_children(out, var, child, props, scope):
+                    out.append("    lv_obj_bind_flag_if_not_eq(%s, %s, LV_OBJ_FLAG_HIDDEN, %s);" % (inner, subject, ref))
+            elif tag in ("text", "src"):
+                value = self.resolve((child.text or "").strip(), props)
+                if tag == "text":
+                    self.emit_text(out, var, value)
+                else:
+                    out.append("    lv_image_set_src(%s, %s);" % (var, self.image(value)))
+            else:
+                created.append(self.emit_instance(out, var, child, props, scope))
+        return created
+
+    def emit_instance(self, out, parent, el, props, scope):
+        """Create the widget or expand the component for el; returns its var."""
+        tag = el.tag
+        var = self.new_var()
+        if tag in self.components:
+            comp = self.components[tag]
+            self.register_local_styles(tag, comp)
+            view = comp.find("view")
+            api = comp.find("api")
+            comp_props = {}
+            for prop in (api if api is not None else []):
+                name = prop.get("name")
+                comp_props[name] = self.resolve(el.get(name, prop.get("default", "")), props)
+            base = view.get("extends", "lv_obj")
+            out.append("    lv_obj_t *%s = %s(%s);  // <%s>" % (var, WIDGETS[base], parent, tag))
+            self.apply_attrs(out, var, view, comp_props, tag)
+            self.emit_children(out, var, view, comp_props, tag)
+            # Instance attributes override the component's own
+            self.apply_attrs(out, var, el, props, scope, skip=set(comp_props))
+        elif tag in WIDGETS or "lv_" + tag in WIDGETS:
+            create = WIDGETS.get(tag) or WIDGETS["lv_" + tag]
+            out.append("    lv_obj_t *%s = %s(%s);" % (var, create, parent))
+            self.apply_attrs(out, var, el, props, scope)
+        else:
+            raise CompileError("unknown element <%s>" % tag)
+        self.emit_children(out, var, el, props, scope)
+        return var
+
+    def compile_screen(self, name):
+        root = self.screens[name]
+        scope = "screen_" + name
+        self.register_local_styles(scope, root)
+        view = root.find("view")
+        out = ["    lv_obj_t *screen = lv_obj_create(NULL);"]
+        self.apply_attrs(out, "screen", view, None, scope)
+        self.emit_children(out, "screen", view, None, scope)
+        out.append("    return screen;")
+        return out
+
+    # ---- Output ----------------------------------------------------------
+
+    def generate(self):
+        screens = {name: self.compile_screen(name) for name in sorted(self.screens)}
+        # Global styles are created even if no screen uses them, as the
+        # runtime loader does
+        for name in self.global_styles:
+            self.use_style(*self.global_styles[name])
+
+        config = os.path.abspath(self.config_dir)
+        sources = "%s (%d files)" % (os.path.relpath(config, os.path.dirname(os.path.dirname(config))),
+                                     len(self.inputs))
+        header = [
+            "/**",
+            " * Generated LVGL UI for T-LoRa Pager Terminal",
+            " * Built from the XML project by tools/lvgl_xml2c.py - do not edit",
+            " *",
+            " * Consts are folded into literals and components expanded inline;",
+            " * nothing is parsed at run time.",
+            " */",
+            "",
+            "#ifndef UI_GENERATED_H",
+            "#define UI_GENERATED_H",
+            "",
+            "#include <lvgl.h>",
+            "",
+            "// Subjects from globals.xml",
+            "typedef enum {",
+        ]
+        for n, t, _ in self.subjects:
+            header.append("    UI_SUBJECT_%s," % c_ident(n).upper())
+        header += ["    UI_SUBJECT_COUNT", "} UiSubject_t;", "",
+                   "extern lv_subject_t uiSubjects[UI_SUBJECT_COUNT];", ""]
+
+        refs = sorted(set(self.refs))
+        header += ["// Widgets with an id, filled in by the create functions", "typedef struct {"]
+        header += ["    lv_obj_t *%s;" % c_ident(r) for r in refs]
+        header += ["} UiRefs_t;", ""]
+        header += ["// Stand-ins for the fonts and images named in globals.xml",
+                   "typedef struct {", "    const char *name;", "    const void *ptr;", "} UiAsset_t;",
+                   "extern const UiAsset_t uiFonts[];", "extern const UiAsset_t uiImages[];",
+                   "extern const int uiFontCount;", "extern const int uiImageCount;", ""]
+        header += ["// Styles and subjects; once, before any create", "void uiGenInit();", ""]
+        for name in screens:
+            header.append("// <screen> %s.xml (refs may be NULL)" % name)
+            header.append("lv_obj_t *uiGenCreate%sScreen(UiRefs_t *refs);" % name.title().replace("_", ""))
+            header.append("")
+        header.append("#endif // UI_GENERATED_H")
+
+        src = [
+            "/**",
+            " * Generated LVGL UI Implementation - do not edit",
+            " * Sources: %s" % sources,
+            " */",
+            "",
+            '#include "ui_generated.h"',
+            "",
+            "lv_subject_t uiSubjects[UI_SUBJECT_COUNT];",
+        ]
+        for n, t, d in self.subjects:
+            if t == "string":
+                src.append("static char subjectBuf_%s[64];" % c_ident(n))
+        src.append("")
+        for c_name in self.used_styles:
+            src.append("static lv_style_t %s;" % c_name)
+        src.append("")
+
+        src.append("const UiAsset_t uiFonts[] = {")
+        for name, font in FONTS.items():
+            src.append("    {%s, &%s}," % (c_string(name), font))
+        src.append("};")
+        src.append("const UiAsset_t uiImages[] = {")
+        for name, img in IMAGES.items():
+            src.append("    {%s, %s}," % (c_string(name), img))
+        src.append("};")
+        src.append("const int uiFontCount = sizeof(uiFonts) / sizeof(uiFonts[0]);")
+        src.append("const int uiImageCount = sizeof(uiImages) / sizeof(uiImages[0]);")
+        src.append("")
+
+        src.append("void uiGenInit() {")
+        src.append("    static bool done = false;")
+        src.append("    if (done) return;")
+        src.append("    done = true;")
+        src.append("")
+        for n, t, d in self.subjects:
+            ref = "&uiSubjects[UI_SUBJECT_%s]" % c_ident(n).upper()
+            if t == "string":
+                src.append("    lv_subject_init_string(%s, subjectBuf_%s, NULL, sizeof(subjectBuf_%s), %s);"
+                           % (ref, c_ident(n), c_ident(n), c_string(d)))
+            elif t == "bool":
+                src.append("    lv_subject_init_int(%s, %s);" % (ref, self.ref_value(d)))
+            else:
+                src.append("    lv_subject_init_int(%s, %d);" % (ref, int(d)))
+        for c_name in self.used_styles:
+            src.append("")
+            src.append("    lv_style_init(&%s);" % c_name)
+            for prop, raw in self.style_defs[c_name]:
+                prop = PROP_ALIASES.get(prop, prop)
+                value = self.style_value(prop, self.resolve(raw))
+                src.append("    lv_style_set_%s(&%s, %s);" % (prop, c_name, value))
+        src.append("}")
+
+        for name, body in screens.items():
+            src.append("")
+            src.append("lv_obj_t *uiGenCreate%sScreen(UiRefs_t *refs) {" % name.title().replace("_", ""))
+            src += body
+            src.append("}")
+
+        return "\n".join(header) + "\n", "\n".join(src) + "\n"
+
+
+def generate(config_dir, out_dir):
+    compiler = Compiler(config_dir)
+    header, source = compiler.generate()
+    for name, text in (("ui_generated.h", header), ("ui_generated.cpp", source)):
+        path = os.path.join(out_dir, name)
+        old = open(path).read() if os.path.exists(path) else None
+        if old != text:
+            with open(path, "w") as f:
+                f.write(text)
+    return compiler.inputs
+
+
+def xml_files(config_dir):
+    for dirpath, _, files in os.walk(config_dir):
+        for f in files:
+            if f.endswith(".xml"):
+                yield os.path.join(dirpath, f)
+
+
+def stale(config_dir, out_dir):
+    outputs = [os.path.join(out_dir, n) for n in ("ui_generated.h", "ui_generated.cpp")]
+    if not all(os.path.exists(p) for p in outputs):
+        return True
+    newest = max(os.path.getmtime(p) for p in xml_files(config_dir))
+    return newest > min(os.path.getmtime(p) for p in outputs)
+
+
+def main(argv):
+    # __file__ is not defined when SCons runs this, but paths are passed then
+    root = os.path.dirname(os.path.dirname(os.path.abspath(argv[0])))
+    config_dir = argv[1] if len(argv) > 1 else os.path.join(root, "data", "config")
+    out_dir = argv[2] if len(argv) > 2 else os.path.join(root, "tlorapager_terminal")
+    try:
+        inputs = generate(config_dir, out_dir)
+    except (CompileError, ET.ParseError, KeyError) as e:
+        sys.exit("lvgl_xml2c: %s" % e)
+    print("lvgl_xml2c: %d XML files -> %s/ui_generated.{h,cpp}" % (len(inputs), os.path.relpath(out_dir)))
+
+
+if "Import" in globals():
+    # PlatformIO extra script (SCons provides Import and env)
+    Import("env")  # noqa: F821
+    _config = os.path.join(env.subst("$PROJECT_DIR"), "data", "config")  # noqa: F821
+    _out = env.subst("$PROJECT_SRC_DIR")  # noqa: F821
+    if stale(_config, _out):
+        main(["lvgl_xml2c", _config, _out])
+elif __name__ == "__main__":
+    main(sys.argv)